@@ -5,6 +5,8 @@
 
 #include <linux/delay.h>
 #include <linux/mm.h>
+#include <linux/nodemask.h>
+#include <linux/numa.h>
 #include <linux/sched/mm.h>
 #include <linux/slab.h>
 #include <linux/vmalloc.h>
@@ -81,6 +83,7 @@ void vdo_unregister_allocating_thread(void)
 struct vmalloc_block_info {
 	void *ptr;
 	size_t size;
+	int node;
 	struct vmalloc_block_info *next;
 };
 
@@ -347,18 +350,32 @@ static inline bool use_kmalloc(size_t size)
 	return size <= PAGE_SIZE;
 }
 
+/*
+ * Allocate a large block of memory, on a particular node if one is given. kvmalloc_node() maps
+ * large allocations with huge pages where it can, but may also satisfy the request from kmalloc.
+ */
+static void *allocate_large_block(size_t size, gfp_t gfp_flags, int node)
+{
+	if (node == NUMA_NO_NODE)
+		return __vmalloc(size, gfp_flags);
+
+	return kvmalloc_node(size, gfp_flags, node);
+}
+
 /*
  * Allocate storage based on memory size and alignment, logging an error if the allocation fails.
  * The memory will be zeroed.
  *
  * @size: The size of an object
  * @align: The required alignment
+ * @node: The NUMA node to allocate from, or NUMA_NO_NODE
  * @what: What is being allocated (for error logging)
  * @ptr: A pointer to hold the allocated memory
  *
  * Return: VDO_SUCCESS or an error code
  */
-int vdo_allocate_memory(size_t size, size_t align, const char *what, void *ptr)
+int vdo_allocate_memory_on_node(size_t size, size_t align, int node, const char *what,
+				void *ptr)
 {
 	/*
 	 * The __GFP_RETRY_MAYFAIL flag means the VM implementation will retry memory reclaim
@@ -401,7 +418,7 @@ int vdo_allocate_memory(size_t size, size_t align, const char *what, void *ptr)
 
 	start_time = jiffies;
 	if (use_kmalloc(size) && (align < PAGE_SIZE)) {
-		p = kmalloc(size, gfp_flags | __GFP_NOWARN);
+		p = kmalloc_node(size, gfp_flags | __GFP_NOWARN, node);
 		if (p == NULL) {
 			/*
 			 * It is possible for kmalloc to fail to allocate memory because there is
@@ -409,7 +426,7 @@ int vdo_allocate_memory(size_t size, size_t align, const char *what, void *ptr)
 			 * free a page.
 			 */
 			fsleep(1000);
-			p = kmalloc(size, gfp_flags);
+			p = kmalloc_node(size, gfp_flags, node);
 		}
 
 		if (p != NULL)
@@ -433,13 +450,13 @@ int vdo_allocate_memory(size_t size, size_t align, const char *what, void *ptr)
 			 * the allocation fails. It is possible that more retries will succeed.
 			 */
 			for (;;) {
-				p = __vmalloc(size, gfp_flags | __GFP_NOWARN);
+				p = allocate_large_block(size, gfp_flags | __GFP_NOWARN, node);
 				if (p != NULL)
 					break;
 
 				if (jiffies_to_msecs(jiffies - start_time) > 1000) {
 					/* Try one more time, logging a failure for this call. */
-					p = __vmalloc(size, gfp_flags);
+					p = allocate_large_block(size, gfp_flags, node);
 					break;
 				}
 
@@ -448,9 +465,16 @@ int vdo_allocate_memory(size_t size, size_t align, const char *what, void *ptr)
 
 			if (p == NULL) {
 				vdo_free(block);
+			} else if (!is_vmalloc_addr(p)) {
+				vdo_free(block);
+				add_kmalloc_block(ksize(p));
+#if defined(TEST_INTERNAL) || defined(VDO_INTERNAL)
+				add_tracking_block(p, ksize(p), what);
+#endif /* TEST_INTERNAL or VDO_INTERNAL */
 			} else {
 				block->ptr = p;
 				block->size = PAGE_ALIGN(size);
+				block->node = node;
 				add_vmalloc_block(block);
 #if defined(TEST_INTERNAL) || defined(VDO_INTERNAL)
 				add_tracking_block(p, block->size, what);
@@ -472,6 +496,11 @@ int vdo_allocate_memory(size_t size, size_t align, const char *what, void *ptr)
 	return VDO_SUCCESS;
 }
 
+int vdo_allocate_memory(size_t size, size_t align, const char *what, void *ptr)
+{
+	return vdo_allocate_memory_on_node(size, align, NUMA_NO_NODE, what, ptr);
+}
+
 /*
  * Allocate storage based on memory size, failing immediately if the required memory is not
  * available. The memory will be zeroed.
@@ -603,6 +632,34 @@ void vdo_get_memory_stats(u64 *bytes_used, u64 *peak_bytes_used)
 	spin_unlock_irqrestore(&memory_stats.lock, flags);
 }
 
+/* Report the vmalloc blocks which were explicitly placed on each NUMA node. */
+static void report_node_memory_usage(void)
+{
+	int node;
+
+	for_each_online_node(node) {
+		struct vmalloc_block_info *block;
+		unsigned long flags;
+		u64 blocks = 0;
+		u64 bytes = 0;
+
+		spin_lock_irqsave(&memory_stats.lock, flags);
+		for (block = memory_stats.vmalloc_list; block != NULL; block = block->next) {
+			if (block->node == node) {
+				blocks++;
+				bytes += block->size;
+			}
+		}
+		spin_unlock_irqrestore(&memory_stats.lock, flags);
+
+		if (blocks > 0) {
+			vdo_log_info("  %llu bytes in %llu vmalloc blocks placed on node %d",
+				     (unsigned long long) bytes, (unsigned long long) blocks,
+				     node);
+		}
+	}
+}
+
 /*
  * Report stats on any allocated memory that we're tracking. Not all allocation types are
  * guaranteed to be tracked in bytes (e.g., bios).
@@ -634,4 +691,5 @@ void vdo_report_memory_usage(void)
 		     (unsigned long long) vmalloc_blocks);
 	vdo_log_info("  total %llu bytes, peak usage %llu bytes",
 		     (unsigned long long) total_bytes, (unsigned long long) peak_usage);
+	report_node_memory_usage();
 }
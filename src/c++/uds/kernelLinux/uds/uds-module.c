@@ -52,6 +52,7 @@ EXPORT_SYMBOL_GPL(uds_register_error_block);
 EXPORT_SYMBOL_GPL(uds_string_error);
 EXPORT_SYMBOL_GPL(uds_string_error_name);
 EXPORT_SYMBOL_GPL(vdo_allocate_memory);
+EXPORT_SYMBOL_GPL(vdo_allocate_memory_on_node);
 EXPORT_SYMBOL_GPL(vdo_allocate_memory_nowait);
 EXPORT_SYMBOL_GPL(vdo_append_to_buffer);
 EXPORT_SYMBOL_GPL(vdo_assertion_failed);
@@ -88,6 +89,8 @@ EXPORT_SYMBOL_GPL(begin_pending_search);
 EXPORT_SYMBOL_GPL(chapter_index_discard_count);
 EXPORT_SYMBOL_GPL(chapter_index_empty_count);
 EXPORT_SYMBOL_GPL(chapter_index_overflow_count);
+EXPORT_SYMBOL_GPL(chapter_index_writer_fills);
+EXPORT_SYMBOL_GPL(chapter_index_zone_fills);
 EXPORT_SYMBOL_GPL(chapters_replayed);
 EXPORT_SYMBOL_GPL(chapters_written);
 EXPORT_SYMBOL_GPL(discard_index_state_data);
@@ -119,11 +122,14 @@ EXPORT_SYMBOL_GPL(map_to_physical_page);
 EXPORT_SYMBOL_GPL(min_volume_index_delta_lists);
 EXPORT_SYMBOL_GPL(move_bits);
 EXPORT_SYMBOL_GPL(murmurhash3_128);
+EXPORT_SYMBOL_GPL(murmurhash3_128_lanes);
+EXPORT_SYMBOL_GPL(murmurhash3_128_striped);
 EXPORT_SYMBOL_GPL(put_page_in_cache);
 EXPORT_SYMBOL_GPL(saves_begun);
 EXPORT_SYMBOL_GPL(search_record_page);
 EXPORT_SYMBOL_GPL(select_victim_in_cache);
 EXPORT_SYMBOL_GPL(set_chapter_tester);
+EXPORT_SYMBOL_GPL(set_chapter_write_hook);
 EXPORT_SYMBOL_GPL(set_request_restarter);
 EXPORT_SYMBOL_GPL(swap_delta_index_page_endianness);
 EXPORT_SYMBOL_GPL(test_page_count);
@@ -155,6 +161,7 @@ EXPORT_SYMBOL_GPL(uds_free_index_layout);
 EXPORT_SYMBOL_GPL(uds_free_index_page_map);
 EXPORT_SYMBOL_GPL(uds_free_open_chapter);
 EXPORT_SYMBOL_GPL(uds_free_open_chapter_index);
+EXPORT_SYMBOL_GPL(uds_free_parallel_radix_sorter);
 EXPORT_SYMBOL_GPL(uds_free_radix_sorter);
 EXPORT_SYMBOL_GPL(uds_free_volume);
 EXPORT_SYMBOL_GPL(uds_free_volume_index);
@@ -185,8 +192,10 @@ EXPORT_SYMBOL_GPL(uds_make_index_geometry);
 EXPORT_SYMBOL_GPL(uds_make_index_layout);
 EXPORT_SYMBOL_GPL(uds_make_index_page_map);
 EXPORT_SYMBOL_GPL(uds_make_io_factory);
+EXPORT_SYMBOL_GPL(uds_make_name_radix_sorter);
 EXPORT_SYMBOL_GPL(uds_make_open_chapter);
 EXPORT_SYMBOL_GPL(uds_make_open_chapter_index);
+EXPORT_SYMBOL_GPL(uds_make_parallel_radix_sorter);
 EXPORT_SYMBOL_GPL(uds_make_radix_sorter);
 EXPORT_SYMBOL_GPL(uds_make_request_queue);
 EXPORT_SYMBOL_GPL(uds_make_volume);
@@ -194,12 +203,14 @@ EXPORT_SYMBOL_GPL(uds_make_volume_index);
 EXPORT_SYMBOL_GPL(uds_map_to_physical_chapter);
 EXPORT_SYMBOL_GPL(uds_next_delta_index_entry);
 EXPORT_SYMBOL_GPL(uds_pack_open_chapter_index_page);
+EXPORT_SYMBOL_GPL(uds_parallel_radix_sort);
 EXPORT_SYMBOL_GPL(uds_put_delta_index_entry);
 EXPORT_SYMBOL_GPL(uds_put_io_factory);
 EXPORT_SYMBOL_GPL(uds_put_open_chapter);
 EXPORT_SYMBOL_GPL(uds_put_open_chapter_index_record);
 EXPORT_SYMBOL_GPL(uds_put_volume_index_record);
 EXPORT_SYMBOL_GPL(uds_radix_sort);
+EXPORT_SYMBOL_GPL(uds_radix_sort_names);
 EXPORT_SYMBOL_GPL(uds_read_from_buffered_reader);
 EXPORT_SYMBOL_GPL(uds_read_index_page_map);
 EXPORT_SYMBOL_GPL(uds_remove_delta_index_entry);
@@ -39,15 +39,17 @@ static unsigned int generatePageNumber(struct index_geometry *g, unsigned int in
 
 /**********************************************************************/
 __attribute__((warn_unused_result)) static
-struct open_chapter_index *fillOpenChapter(struct uds_record_name *names,
-                                           struct index_geometry *g,
-                                           bool overflowFlag)
+struct open_chapter_index *fillZonedOpenChapter(struct uds_record_name *names,
+                                                struct index_geometry *g,
+                                                unsigned int zoneCount,
+                                                bool overflowFlag)
 {
   struct open_chapter_index *oci;
   int overflowCount = 0;
   struct delta_index_stats stats;
 
-  UDS_ASSERT_SUCCESS(uds_make_open_chapter_index(&oci, g, volumeNonce));
+  UDS_ASSERT_SUCCESS(uds_make_open_chapter_index(&oci, g, zoneCount,
+                                                 volumeNonce));
   uds_empty_open_chapter_index(oci, SAMPLE_CHAPTER_NUMBER);
   unsigned int i;
   for (i = 0; i < g->records_per_chapter; i++) {
@@ -66,6 +68,15 @@ struct open_chapter_index *fillOpenChapter(struct uds_record_name *names,
   return oci;
 }
 
+/**********************************************************************/
+__attribute__((warn_unused_result)) static
+struct open_chapter_index *fillOpenChapter(struct uds_record_name *names,
+                                           struct index_geometry *g,
+                                           bool overflowFlag)
+{
+  return fillZonedOpenChapter(names, g, 1, overflowFlag);
+}
+
 /**********************************************************************/
 __attribute__((warn_unused_result))
 static u8 *packOpenChapter(struct open_chapter_index *oci,
@@ -146,7 +157,7 @@ static void emptyChapterTest(void)
   // Create an open chapter index that is empty (no blocknames in it)
   struct open_chapter_index *oci;
   struct delta_index_stats stats;
-  UDS_ASSERT_SUCCESS(uds_make_open_chapter_index(&oci, g, volumeNonce));
+  UDS_ASSERT_SUCCESS(uds_make_open_chapter_index(&oci, g, 1, volumeNonce));
   uds_empty_open_chapter_index(oci, 0);
   uds_get_delta_index_stats(&oci->delta_index, &stats);
   CU_ASSERT_EQUAL(stats.record_count, 0);
@@ -286,6 +297,32 @@ static void bigEndianTest(void)
   uds_free_configuration(config);
 }
 
+/**********************************************************************/
+static void zonedChapterTest(void)
+{
+  struct uds_configuration *config = makeDenseConfiguration(1);
+  struct index_geometry *g = config->geometry;
+  struct uds_record_name *names = generateRandomBlockNames(g);
+
+  // An open chapter index divided into zones must pack into exactly the same
+  // pages as one with a single zone.
+  struct open_chapter_index *oci = fillOpenChapter(names, g, false);
+  u8 *indexPages = packOpenChapter(oci, g, g->index_pages_per_chapter, false);
+  struct open_chapter_index *zonedOCI = fillZonedOpenChapter(names, g, 4, false);
+  CU_ASSERT_EQUAL(zonedOCI->delta_index.zone_count, 4);
+  u8 *zonedPages
+    = packOpenChapter(zonedOCI, g, g->index_pages_per_chapter, false);
+  UDS_ASSERT_EQUAL_BYTES(indexPages, zonedPages,
+                         g->index_pages_per_chapter * g->bytes_per_page);
+
+  uds_free_open_chapter_index(oci);
+  uds_free_open_chapter_index(zonedOCI);
+  vdo_free(indexPages);
+  vdo_free(zonedPages);
+  vdo_free(names);
+  uds_free_configuration(config);
+}
+
 /**********************************************************************/
 
 static const CU_TestInfo chapterIndexTests[] = {
@@ -294,6 +331,7 @@ static const CU_TestInfo chapterIndexTests[] = {
   {"List overflow", listOverflowTest },
   {"Page overflow", pageOverflowTest },
   {"Big endian"   , bigEndianTest    },
+  {"Zoned chapter", zonedChapterTest },
   CU_TEST_INFO_NULL,
 };
 
@@ -104,6 +104,7 @@ static void fillOpenChapter(struct open_chapter_zone **openChapters,
   struct open_chapter_index *openChapterIndex;
   UDS_ASSERT_SUCCESS(uds_make_open_chapter_index(&openChapterIndex,
                                                  volume->geometry,
+                                                 zoneCount,
                                                  volume->nonce));
   uds_empty_open_chapter_index(openChapterIndex, 0);
 
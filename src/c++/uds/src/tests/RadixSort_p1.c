@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright 2023 Red Hat
+ */
+
+/**
+ * RadixSort_p1 compares the performance of the radix sort variants on
+ * random record names: the serial sort used to encode record pages, the
+ * least significant digit sort specialized for record names, and the
+ * parallel sort using one thread per cpu.
+ **/
+
+#include <linux/random.h>
+
+#include "albtest.h"
+#include "assertions.h"
+#include "memory-alloc.h"
+#include "radix-sort.h"
+#include "testPrototypes.h"
+#include "thread-utils.h"
+#include "time-utils.h"
+
+enum {
+  // The total number of keys sorted for each measurement
+  TOTAL_KEYS = 16 * 1024 * 1024,
+};
+
+static u8 *names;
+static const u8 **unsorted;
+static const u8 **keys;
+
+typedef int sortFunction(const u8 *keys[], unsigned int count);
+
+static struct radix_sorter *serialSorter;
+static struct parallel_radix_sorter *parallelSorter;
+
+/**********************************************************************/
+static int serialSort(const u8 *keys[], unsigned int count)
+{
+  return uds_radix_sort(serialSorter, keys, count, UDS_RECORD_NAME_SIZE);
+}
+
+/**********************************************************************/
+static int nameSort(const u8 *keys[], unsigned int count)
+{
+  return uds_radix_sort_names(serialSorter, keys, count);
+}
+
+/**********************************************************************/
+static int parallelSort(const u8 *keys[], unsigned int count)
+{
+  return uds_parallel_radix_sort(parallelSorter, keys, count,
+                                 UDS_RECORD_NAME_SIZE);
+}
+
+/**********************************************************************/
+static void timeSort(const char *label, sortFunction *sort, unsigned int count)
+{
+  unsigned int rounds = TOTAL_KEYS / count;
+  ktime_t elapsed = 0;
+  unsigned int round;
+  for (round = 0; round < rounds; round++) {
+    memcpy(keys, &unsorted[(round * count) % TOTAL_KEYS],
+           count * sizeof(keys[0]));
+    ktime_t start = current_time_ns(CLOCK_MONOTONIC);
+    UDS_ASSERT_SUCCESS(sort(keys, count));
+    elapsed += ktime_sub(current_time_ns(CLOCK_MONOTONIC), start);
+  }
+
+  unsigned int i;
+  for (i = 1; i < count; i++) {
+    CU_ASSERT_TRUE(memcmp(keys[i - 1], keys[i], UDS_RECORD_NAME_SIZE) <= 0);
+  }
+
+  char *total, *perKey;
+  UDS_ASSERT_SUCCESS(rel_time_to_string(&total, elapsed / rounds));
+  UDS_ASSERT_SUCCESS(rel_time_to_string(&perKey, elapsed / TOTAL_KEYS));
+  albPrint("    %-9s %8u keys: %s/sort, %s/key", label, count, total, perKey);
+  vdo_free(total);
+  vdo_free(perKey);
+}
+
+/**********************************************************************/
+static void timeSorts(unsigned int count)
+{
+  UDS_ASSERT_SUCCESS(uds_make_name_radix_sorter(count, &serialSorter));
+  UDS_ASSERT_SUCCESS(uds_make_parallel_radix_sorter(count, num_online_cpus(),
+                                                    &parallelSorter));
+  timeSort("serial", serialSort, count);
+  timeSort("names", nameSort, count);
+  timeSort("parallel", parallelSort, count);
+  uds_free_parallel_radix_sorter(parallelSorter);
+  uds_free_radix_sorter(serialSorter);
+}
+
+/**********************************************************************/
+static void sortTest(void)
+{
+  UDS_ASSERT_SUCCESS(vdo_allocate(TOTAL_KEYS * UDS_RECORD_NAME_SIZE, u8,
+                                  __func__, &names));
+  UDS_ASSERT_SUCCESS(vdo_allocate(TOTAL_KEYS, const u8 *, __func__,
+                                  &unsorted));
+  UDS_ASSERT_SUCCESS(vdo_allocate(TOTAL_KEYS, const u8 *, __func__, &keys));
+  get_random_bytes(names, TOTAL_KEYS * UDS_RECORD_NAME_SIZE);
+  unsigned int i;
+  for (i = 0; i < TOTAL_KEYS; i++) {
+    unsorted[i] = &names[i * UDS_RECORD_NAME_SIZE];
+  }
+
+  albPrint("    sorting with %u cpus", num_online_cpus());
+  // A record page holds 1024 records in the default geometry.
+  timeSorts(1024);
+  timeSorts(64 * 1024);
+  timeSorts(1024 * 1024);
+  timeSorts(TOTAL_KEYS);
+
+  vdo_free(names);
+  vdo_free(unsorted);
+  vdo_free(keys);
+}
+
+/**********************************************************************/
+static const CU_TestInfo tests[] = {
+  { "radix sort", sortTest },
+  CU_TEST_INFO_NULL,
+};
+
+static const CU_SuiteInfo suite = {
+  .name  = "RadixSort_p1",
+  .tests = tests
+};
+
+/**********************************************************************/
+const CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
@@ -295,6 +295,116 @@ static void testLittle(void)
   testSize(8);
 }
 
+/**********************************************************************/
+static void assertPermutation(const u8 *keys[], const u8 *data,
+                              unsigned int count, unsigned int length)
+{
+  bool *seen;
+  UDS_ASSERT_SUCCESS(vdo_allocate(count, bool, __func__, &seen));
+  unsigned int i;
+  for (i = 0; i < count; i++) {
+    unsigned int index = (keys[i] - data) / length;
+    CU_ASSERT_TRUE(index < count);
+    CU_ASSERT_FALSE(seen[index]);
+    seen[index] = true;
+  }
+  vdo_free(seen);
+}
+
+/**********************************************************************/
+static void testNamesSize(unsigned int count, unsigned int commonBytes)
+{
+  u8 *data;
+  UDS_ASSERT_SUCCESS(vdo_allocate(count * UDS_RECORD_NAME_SIZE, u8, __func__,
+                                  &data));
+  const u8 **keys = makeKeys(count);
+  struct radix_sorter *radixSorter;
+  UDS_ASSERT_SUCCESS(uds_make_name_radix_sorter(count, &radixSorter));
+  get_random_bytes(data, count * UDS_RECORD_NAME_SIZE);
+  unsigned int i;
+  for (i = 0; i < count; i++) {
+    keys[i] = &data[i * UDS_RECORD_NAME_SIZE];
+    // Give some bytes the same value in every name, and make some names
+    // identical.
+    memset(&data[i * UDS_RECORD_NAME_SIZE], 0x5A, commonBytes);
+    if ((i % 7) == 1) {
+      memcpy(&data[i * UDS_RECORD_NAME_SIZE],
+             &data[(i - 1) * UDS_RECORD_NAME_SIZE], UDS_RECORD_NAME_SIZE);
+    }
+  }
+  UDS_ASSERT_SUCCESS(uds_radix_sort_names(radixSorter, keys, count));
+  assertSorted(keys, count, UDS_RECORD_NAME_SIZE);
+  assertPermutation(keys, data, count, UDS_RECORD_NAME_SIZE);
+  // The name sort is stable, so sorting again must not move anything.
+  const u8 **sorted = makeKeys(count);
+  memcpy(sorted, keys, count * sizeof(keys[0]));
+  UDS_ASSERT_SUCCESS(uds_radix_sort_names(radixSorter, keys, count));
+  UDS_ASSERT_EQUAL_BYTES(sorted, keys, count * sizeof(keys[0]));
+  UDS_ASSERT_ERROR(UDS_INVALID_ARGUMENT,
+                   uds_radix_sort_names(radixSorter, keys, count + 100));
+  uds_free_radix_sorter(radixSorter);
+  vdo_free(data);
+  vdo_free(keys);
+  vdo_free(sorted);
+}
+
+/**********************************************************************/
+static void testNames(void)
+{
+  testNamesSize(1, 0);
+  testNamesSize(8, 0);
+  testNamesSize(1024, 0);
+  testNamesSize(1024, 3);
+  testNamesSize(0x10000, 0);
+
+  // A sorter not made for sorting names has no space to sort them.
+  const u8 *keys[1] = { (const u8 *) "" };
+  struct radix_sorter *radixSorter;
+  UDS_ASSERT_SUCCESS(uds_make_radix_sorter(1, &radixSorter));
+  UDS_ASSERT_ERROR(UDS_INVALID_ARGUMENT,
+                   uds_radix_sort_names(radixSorter, keys, 1));
+  uds_free_radix_sorter(radixSorter);
+}
+
+/**********************************************************************/
+static void testParallelSize(unsigned int count, unsigned int threads,
+                             unsigned int length)
+{
+  u8 *data;
+  UDS_ASSERT_SUCCESS(vdo_allocate(count * length, u8, __func__, &data));
+  const u8 **keys = makeKeys(count);
+  struct parallel_radix_sorter *radixSorter;
+  UDS_ASSERT_SUCCESS(uds_make_parallel_radix_sorter(count, threads,
+                                                    &radixSorter));
+  get_random_bytes(data, count * length);
+  unsigned int i;
+  for (i = 0; i < count; i++) {
+    keys[i] = &data[i * length];
+    // Crowd a third of the keys into one first byte pile.
+    if ((i % 3) == 0) {
+      data[i * length] = 0x42;
+    }
+  }
+  UDS_ASSERT_SUCCESS(uds_parallel_radix_sort(radixSorter, keys, count,
+                                             length));
+  assertSorted(keys, count, length);
+  assertPermutation(keys, data, count, length);
+  uds_free_parallel_radix_sorter(radixSorter);
+  vdo_free(data);
+  vdo_free(keys);
+}
+
+/**********************************************************************/
+static void testParallel(void)
+{
+  testParallelSize(1, 4, UDS_RECORD_NAME_SIZE);
+  testParallelSize(1000, 4, UDS_RECORD_NAME_SIZE);
+  testParallelSize(0x40000, 1, UDS_RECORD_NAME_SIZE);
+  testParallelSize(0x40000, 4, UDS_RECORD_NAME_SIZE);
+  testParallelSize(0x40000, 300, 2);
+  testParallelSize(0x40000, 3, 1);
+}
+
 /**********************************************************************/
 static const CU_TestInfo tests[] = {
   { "no keys",         testEmpty       },
@@ -307,6 +417,8 @@ static const CU_TestInfo tests[] = {
   { "big data",        testBig         },
   { "random data",     testRandom      },
   { "little data",     testLittle      },
+  { "record names",    testNames       },
+  { "parallel sort",   testParallel    },
   CU_TEST_INFO_NULL,
 };
 
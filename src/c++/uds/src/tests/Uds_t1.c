@@ -136,6 +136,8 @@ static void basicsTest(void)
   CU_ASSERT_EQUAL(indexStats.updates_found,       1);
   CU_ASSERT_EQUAL(indexStats.updates_not_found,   0);
   CU_ASSERT_EQUAL(indexStats.requests,            8);
+  CU_ASSERT_EQUAL(indexStats.chapter_close_stalls, 0);
+  CU_ASSERT_EQUAL(indexStats.chapter_close_stall_time, 0);
 
   vdo_free(request);
 }
@@ -109,6 +109,7 @@ static void testWriteChapter(void)
   struct open_chapter_index *openChapterIndex;
   UDS_ASSERT_SUCCESS(uds_make_open_chapter_index(&openChapterIndex,
                                                  volume->geometry,
+                                                 zoneCount,
                                                  volume->nonce));
   uds_empty_open_chapter_index(openChapterIndex, 0);
   UDS_ASSERT_SUCCESS(uds_close_open_chapter(chapters,
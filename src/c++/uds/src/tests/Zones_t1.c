@@ -9,6 +9,7 @@
 #include "index.h"
 #include "memory-alloc.h"
 #include "testPrototypes.h"
+#include "testRequests.h"
 
 static struct uds_configuration *config;
 static struct uds_index         *theIndex;
@@ -16,19 +17,44 @@ static struct uds_index         *theIndex;
 static struct cond_var callbackCond;
 static struct mutex    callbackMutex;
 static unsigned int    callbackCount = 0;
+// Whether callbacks should wait, holding their zone threads
+static bool            holdCallbacks = false;
+// Whether the chapter writer should wait before writing a chapter
+static bool            holdWrites = false;
+// The chapter the chapter writer is waiting to write, if any
+static u64             heldChapter = NO_CHAPTER;
 
 /**
- * A test callback that simply counts callbacks.
+ * A test callback that counts callbacks, and waits while callbacks are held.
  **/
 static void testCallback(struct uds_request *request)
 {
   mutex_lock(&callbackMutex);
   callbackCount++;
-  uds_signal_cond(&callbackCond);
+  uds_broadcast_cond(&callbackCond);
+  while (holdCallbacks) {
+    uds_wait_cond(&callbackCond, &callbackMutex);
+  }
   mutex_unlock(&callbackMutex);
   freeRequest(request);
 }
 
+/**
+ * A chapter write hook which keeps the chapter writer from writing a chapter
+ * while writes are held.
+ **/
+static void holdChapterWrite(u64 virtualChapter)
+{
+  mutex_lock(&callbackMutex);
+  heldChapter = virtualChapter;
+  uds_broadcast_cond(&callbackCond);
+  while (holdWrites) {
+    uds_wait_cond(&callbackCond, &callbackMutex);
+  }
+  heldChapter = NO_CHAPTER;
+  mutex_unlock(&callbackMutex);
+}
+
 /**
  * The suite initialization function.
  **/
@@ -43,6 +69,7 @@ static void zoneInitializeSuite(struct block_device *bdev)
   UDS_ASSERT_SUCCESS(uds_make_index(config, UDS_CREATE, NULL, &testCallback, &theIndex));
   uds_init_cond(&callbackCond);
   mutex_init(&callbackMutex);
+  initialize_test_requests();
 }
 
 /**
@@ -50,6 +77,7 @@ static void zoneInitializeSuite(struct block_device *bdev)
  **/
 static void zoneFinishSuite(void)
 {
+  uninitialize_test_requests();
   uds_free_index(theIndex);
   uds_free_configuration(config);
 #ifndef __KERNEL__
@@ -182,8 +210,136 @@ static void laggingZonesTest(void)
   CU_ASSERT_EQUAL(newestChapter, theIndex->newest_virtual_chapter);
 }
 
+/**
+ * Fill the open chapter of a zone, except for the given number of records,
+ * and wait for the records to be added.
+ **/
+static void fillZoneChapter(unsigned int zone, unsigned int unfilled)
+{
+  struct open_chapter_zone *chapter = theIndex->zones[zone]->open_chapter;
+  unsigned int count = chapter->capacity - chapter->size - unfilled;
+  addBlocksToZone(zone, count);
+  waitForCallbacks(count);
+}
+
+/**
+ * Wait for the chapter writer to be held before writing a chapter.
+ **/
+static void waitForHeldWrite(u64 virtualChapter)
+{
+  mutex_lock(&callbackMutex);
+  while (heldChapter != virtualChapter) {
+    uds_wait_cond(&callbackCond, &callbackMutex);
+  }
+  mutex_unlock(&callbackMutex);
+}
+
+/**
+ * Set whether callbacks or chapter writes are held.
+ **/
+static void setHolds(bool callbacks, bool writes)
+{
+  mutex_lock(&callbackMutex);
+  holdCallbacks = callbacks;
+  holdWrites = writes;
+  uds_broadcast_cond(&callbackCond);
+  mutex_unlock(&callbackMutex);
+}
+
+/**
+ * Test that zones may close a chapter while the one before it is still being
+ * written, that records in either unwritten chapter can be found, that zones
+ * stall rather than close a third chapter, and that both the zones and the
+ * chapter writer fill chapter indexes.
+ **/
+static void chapterClosePipelineTest(void)
+{
+  enum { ZONE_COUNT = 3 };
+  uds_free_index(theIndex);
+  config->zone_count = ZONE_COUNT;
+  UDS_ASSERT_SUCCESS(uds_make_index(config, UDS_CREATE, NULL, &testCallback,
+                                    &theIndex));
+  set_chapter_write_hook(holdChapterWrite);
+  setHolds(false, true);
+
+  struct uds_request request = {
+    .type = UDS_POST,
+  };
+  createRandomBlockNameInZone(theIndex, 0, &request.record_name);
+  createRandomMetadata(&request.new_metadata);
+  struct uds_record_data metadata = request.new_metadata;
+  verify_test_request(theIndex, &request, false, NULL);
+
+  // Close chapter 0, which the writer fills at least in part and then holds.
+  fillZoneChapter(0, 0);
+  flushZoneQueues(ZONE_COUNT);
+  waitForHeldWrite(0);
+  int zoneFills = atomic_read_acquire(&chapter_index_zone_fills);
+  int writerFills = atomic_read_acquire(&chapter_index_writer_fills);
+
+  // Close chapter 1 without waiting. Only the zones can fill its index.
+  fillZoneChapter(0, 0);
+  flushZoneQueues(ZONE_COUNT);
+  while (atomic_read_acquire(&chapter_index_zone_fills)
+         < zoneFills + ZONE_COUNT) {
+    sleep_for(ms_to_ktime(1));
+  }
+  CU_ASSERT_EQUAL(atomic_read_acquire(&chapter_index_writer_fills),
+                  writerFills);
+
+  // The record is in the oldest of the three chapters each zone is keeping.
+  CU_ASSERT_EQUAL(theIndex->zones[0]->newest_virtual_chapter, 2);
+  CU_ASSERT_EQUAL(theIndex->newest_virtual_chapter, 0);
+  request = (struct uds_request) {
+    .record_name = request.record_name,
+    .type        = UDS_QUERY_NO_UPDATE,
+  };
+  verify_test_request(theIndex, &request, true, &metadata);
+
+  /*
+   * Fill chapter 2 in every zone, so that each zone must wait for chapter 0
+   * to be written before closing it, and then holds its thread in the
+   * callback, leaving the chapter writer to fill the whole chapter index.
+   */
+  struct uds_index_stats before;
+  uds_get_index_stats(theIndex, &before);
+  zoneFills = atomic_read_acquire(&chapter_index_zone_fills);
+  writerFills = atomic_read_acquire(&chapter_index_writer_fills);
+  unsigned int z;
+  for (z = 0; z < ZONE_COUNT; z++) {
+    fillZoneChapter(z, 1);
+  }
+
+  setHolds(true, true);
+  for (z = 0; z < ZONE_COUNT; z++) {
+    addBlocksToZone(z, 1);
+  }
+
+  // Give the zones time to reach the stall before letting chapter 0 be written.
+  sleep_for(ms_to_ktime(100));
+  setHolds(true, false);
+  waitForCallbacks(ZONE_COUNT);
+  uds_wait_for_idle_index(theIndex);
+  CU_ASSERT_EQUAL(theIndex->newest_virtual_chapter, 3);
+  CU_ASSERT_EQUAL(atomic_read_acquire(&chapter_index_zone_fills), zoneFills);
+  CU_ASSERT_EQUAL(atomic_read_acquire(&chapter_index_writer_fills),
+                  writerFills + ZONE_COUNT);
+  setHolds(false, false);
+  set_chapter_write_hook(NULL);
+
+  struct uds_index_stats after;
+  uds_get_index_stats(theIndex, &after);
+  CU_ASSERT_TRUE(after.chapter_close_stalls > before.chapter_close_stalls);
+  CU_ASSERT_TRUE(after.chapter_close_stall_time
+                 > before.chapter_close_stall_time);
+
+  // The record has been written to the volume.
+  verify_test_request(theIndex, &request, true, &metadata);
+}
+
 static const CU_TestInfo zoneTests[] = {
-  { "Lagging Zones", laggingZonesTest },
+  { "Lagging Zones",         laggingZonesTest          },
+  { "Chapter Close Pipeline", chapterClosePipelineTest },
   CU_TEST_INFO_NULL,
 };
 
@@ -91,7 +91,7 @@ void writeTestVolumeChapter(struct volume *volume, struct index_geometry *geomet
   // Construct an empty delta chapter index for chapter zero. The chapter
   // write code doesn't really care if it's populated or not.
   struct open_chapter_index *chapterIndex;
-  UDS_ASSERT_SUCCESS(uds_make_open_chapter_index(&chapterIndex, geometry, volume->nonce));
+  UDS_ASSERT_SUCCESS(uds_make_open_chapter_index(&chapterIndex, geometry, 1, volume->nonce));
   CU_ASSERT_PTR_NOT_NULL(chapterIndex);
   uds_empty_open_chapter_index(chapterIndex, chapter);
 
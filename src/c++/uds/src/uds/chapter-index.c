@@ -19,8 +19,26 @@ u64 chapter_index_empty_count;
 u64 chapter_index_overflow_count;
 
 #endif /* TEST_INTERNAL */
+/*
+ * The delta lists of an open chapter index may be divided among several zones so that separate
+ * threads can fill them at the same time. Use as many zones as requested, provided that every zone
+ * gets at least one delta list.
+ */
+static unsigned int get_fill_zone_count(const struct index_geometry *geometry,
+					unsigned int zone_count)
+{
+	u32 list_count = geometry->delta_lists_per_chapter;
+
+	while ((zone_count > 1) &&
+	       ((zone_count - 1) * DIV_ROUND_UP(list_count, zone_count) >= list_count))
+		zone_count--;
+
+	return zone_count;
+}
+
 int uds_make_open_chapter_index(struct open_chapter_index **chapter_index,
-				const struct index_geometry *geometry, u64 volume_nonce)
+				const struct index_geometry *geometry,
+				unsigned int zone_count, u64 volume_nonce)
 {
 	int result;
 	size_t memory_size;
@@ -38,12 +56,14 @@ int uds_make_open_chapter_index(struct open_chapter_index **chapter_index,
 
 	/*
 	 * The delta index will rebalance delta lists when memory gets tight,
-	 * so give the chapter index one extra page.
+	 * so give the chapter index one extra page for each zone.
 	 */
-	memory_size = ((geometry->index_pages_per_chapter + 1) * geometry->bytes_per_page);
+	zone_count = get_fill_zone_count(geometry, max(zone_count, 1U));
+	memory_size = ((geometry->index_pages_per_chapter + zone_count) *
+		       geometry->bytes_per_page);
 	index->geometry = geometry;
 	index->volume_nonce = volume_nonce;
-	result = uds_initialize_delta_index(&index->delta_index, 1,
+	result = uds_initialize_delta_index(&index->delta_index, zone_count,
 					    geometry->delta_lists_per_chapter,
 					    geometry->chapter_mean_delta,
 					    geometry->chapter_payload_bits,
@@ -67,8 +87,8 @@ void uds_free_open_chapter_index(struct open_chapter_index *chapter_index)
 	struct delta_index_stats delta_index_stats;
 
 	uds_get_delta_index_stats(&chapter_index->delta_index, &delta_index_stats);
-	chapter_index_discard_count = delta_index_stats.discard_count;
-	chapter_index_overflow_count = delta_index_stats.overflow_count;
+	chapter_index_discard_count += delta_index_stats.discard_count;
+	chapter_index_overflow_count += delta_index_stats.overflow_count;
 
 #endif /* TEST_INTERNAL */
 	uds_uninitialize_delta_index(&chapter_index->delta_index);
@@ -40,7 +40,7 @@ extern u64 chapter_index_overflow_count;
 
 int __must_check uds_make_open_chapter_index(struct open_chapter_index **chapter_index,
 					     const struct index_geometry *geometry,
-					     u64 volume_nonce);
+					     unsigned int zone_count, u64 volume_nonce);
 
 void uds_free_open_chapter_index(struct open_chapter_index *chapter_index);
 
@@ -698,18 +698,31 @@ STATIC void move_bits(const u8 *from, u64 from_offset, u8 *to, u64 to_offset, u3
 		move_bits_up(from, from_offset, to, to_offset, size);
 }
 
+static inline const struct delta_zone *get_list_zone(const struct delta_index *delta_index,
+						     u32 list_number)
+{
+	return &delta_index->delta_zones[list_number / delta_index->lists_per_zone];
+}
+
+static inline const struct delta_list *get_mutable_list(const struct delta_index *delta_index,
+							u32 list_number)
+{
+	const struct delta_zone *delta_zone = get_list_zone(delta_index, list_number);
+
+	return &delta_zone->delta_lists[list_number - delta_zone->first_list + 1];
+}
+
 /*
  * Pack delta lists from a mutable delta index into an immutable delta index page. A range of delta
  * lists (starting with a specified list index) is copied from the mutable delta index into a
  * memory page used in the immutable index. The number of lists copied onto the page is returned in
- * list_count.
+ * list_count. The lists on a page may come from more than one zone of the mutable index.
  */
 int uds_pack_delta_index_page(const struct delta_index *delta_index, u64 header_nonce,
 			      u8 *memory, size_t memory_size, u64 virtual_chapter_number,
 			      u32 first_list, u32 *list_count)
 {
-	const struct delta_zone *delta_zone;
-	struct delta_list *delta_lists;
+	const struct delta_list *delta_list;
 	u32 max_lists;
 	u32 n_lists = 0;
 	u32 offset;
@@ -718,8 +731,6 @@ int uds_pack_delta_index_page(const struct delta_index *delta_index, u64 header_
 	int bits;
 	struct delta_page_header *header;
 
-	delta_zone = &delta_index->delta_zones[0];
-	delta_lists = &delta_zone->delta_lists[first_list + 1];
 	max_lists = delta_index->list_count - first_list;
 
 	/*
@@ -739,7 +750,8 @@ int uds_pack_delta_index_page(const struct delta_index *delta_index, u64 header_
 
 	while (n_lists < max_lists) {
 		/* Each list requires a delta list offset and the list data. */
-		bits = IMMUTABLE_HEADER_SIZE + delta_lists[n_lists].size;
+		delta_list = get_mutable_list(delta_index, first_list + n_lists);
+		bits = IMMUTABLE_HEADER_SIZE + delta_list->size;
 		if (bits > free_bits)
 			break;
 
@@ -760,14 +772,16 @@ int uds_pack_delta_index_page(const struct delta_index *delta_index, u64 header_
 	offset = get_immutable_header_offset(n_lists + 1);
 	set_immutable_start(memory, 0, offset);
 	for (i = 0; i < n_lists; i++) {
-		offset += delta_lists[i].size;
+		offset += get_mutable_list(delta_index, first_list + i)->size;
 		set_immutable_start(memory, i + 1, offset);
 	}
 
 	/* Copy the delta list data onto the memory page. */
 	for (i = 0; i < n_lists; i++) {
-		move_bits(delta_zone->memory, delta_lists[i].start, memory,
-			  get_immutable_start(memory, i), delta_lists[i].size);
+		delta_list = get_mutable_list(delta_index, first_list + i);
+		move_bits(get_list_zone(delta_index, first_list + i)->memory,
+			  delta_list->start, memory, get_immutable_start(memory, i),
+			  delta_list->size);
 	}
 
 	/* Set all the bits in the guard bytes. */
@@ -758,6 +758,8 @@ int uds_get_index_session_stats(struct uds_index_session *index_session,
 		stats->memory_used = 0;
 		stats->collisions = 0;
 		stats->entries_discarded = 0;
+		stats->chapter_close_stalls = 0;
+		stats->chapter_close_stall_time = 0;
 	}
 
 	return UDS_SUCCESS;
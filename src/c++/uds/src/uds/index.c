@@ -17,6 +17,16 @@ static const u64 NO_LAST_SAVE = U64_MAX;
 #ifdef TEST_INTERNAL
 atomic_t chapters_replayed;
 atomic_t chapters_written;
+atomic_t chapter_index_writer_fills;
+atomic_t chapter_index_zone_fills;
+
+/* This function pointer allows unit tests to hold the chapter writer before it writes a chapter. */
+static chapter_write_hook_fn chapter_write_hook;
+
+void set_chapter_write_hook(chapter_write_hook_fn hook)
+{
+	chapter_write_hook = hook;
+}
 #endif /* TEST_INTERNAL */
 
 /*
@@ -37,11 +47,20 @@ atomic_t chapters_written;
  * the chapter immediately, regardless of how full it is, in order to minimize skew between zones.
  * Once every zone has closed the chapter, the chapter writer will commit that chapter to storage.
  *
+ * Committing a chapter has two parts: building the chapter index and collated records from the
+ * zone chapters, and writing the resulting pages. The chapter index is divided into as many zones
+ * as the index has, and each index zone is asked to fill a part of it, so that the chapter is
+ * encoded in parallel. The writer thread fills any parts no zone has started, and then writes the
+ * chapter. Since the writer has two sets of buffers, the next chapter can be encoded while the
+ * previous one is being written.
+ *
  * The last zone to close the chapter also removes the oldest chapter from the volume index.
  * Although that chapter is invalid for zones that have moved on, the existence of the open chapter
  * means that those zones will never ask the volume index about it. No zone is allowed to get more
  * than one chapter ahead of any other. If a zone is so far ahead that it tries to close another
- * chapter before the previous one has been closed by all zones, it is forced to wait.
+ * chapter before the previous one has been closed by all zones, it is forced to wait. A zone must
+ * also wait to close a chapter if the chapter two before it has not been written yet. Each zone
+ * keeps its chapters in memory until they have been written, so that they can still be searched.
  *
  * The sparse cache relies on having the same set of chapter indexes available to all zones. When a
  * request wants to add a chapter to the sparse cache, it sends a barrier message to each zone
@@ -54,6 +73,24 @@ atomic_t chapters_written;
  * invoking the handler directly.
  */
 
+/* A chapter which has been closed by every zone, and which is being encoded or written */
+struct closed_chapter {
+	/* The virtual chapter number */
+	u64 virtual_chapter;
+	/* The number of chapter index zones which have been claimed for filling */
+	unsigned int fills_started;
+	/* The number of chapter index zones which have been filled */
+	unsigned int fills_finished;
+	/* The first error from filling the chapter index */
+	int result;
+	/* The open chapter index to fill */
+	struct open_chapter_index *open_chapter_index;
+	/* The collated records to write */
+	struct uds_volume_record *collated_records;
+	/* The chapters to collate (one per zone) */
+	struct open_chapter_zone *chapters[MAX_ZONES];
+};
+
 struct chapter_writer {
 	/* The index to which we belong */
 	struct uds_index *index;
@@ -69,14 +106,16 @@ struct chapter_writer {
 	int result;
 	/* The number of bytes allocated by the chapter writer */
 	size_t memory_size;
-	/* The number of zones which have submitted a chapter for writing */
+	/* The number of zones which have submitted the closing chapter for writing */
 	unsigned int zones_to_write;
-	/* Open chapter index used by uds_close_open_chapter() */
-	struct open_chapter_index *open_chapter_index;
-	/* Collated records used by uds_close_open_chapter() */
-	struct uds_volume_record *collated_records;
-	/* The chapters to write (one per zone) */
-	struct open_chapter_zone *chapters[];
+	/* The number of chapters closed by every zone but not yet written */
+	unsigned int chapters_to_write;
+	/* The number of times a zone has waited to close a chapter */
+	u64 stall_count;
+	/* The total time zones have spent waiting to close chapters */
+	ktime_t stall_time;
+	/* The chapters being encoded or written, indexed by virtual chapter number */
+	struct closed_chapter chapters[2];
 };
 
 static bool is_zone_chapter_sparse(const struct index_zone *zone, u64 virtual_chapter)
@@ -180,14 +219,41 @@ static void triage_request(struct uds_request *request)
 	uds_enqueue_request(request, STAGE_INDEX);
 }
 
+static struct closed_chapter *get_closed_chapter(struct chapter_writer *writer,
+						 u64 virtual_chapter)
+{
+	return &writer->chapters[virtual_chapter % ARRAY_SIZE(writer->chapters)];
+}
+
+/*
+ * A chapter may be closed once every zone has closed the chapter before it, and the chapter two
+ * before it has been written so that its buffers can be reused. This must be called with the
+ * chapter writer mutex held.
+ */
+static bool can_close_chapter(struct uds_index *index, u64 virtual_chapter)
+{
+	u64 written = index->newest_virtual_chapter;
+	u64 closing = written + index->chapter_writer->chapters_to_write;
+
+	return ((written + 1 >= virtual_chapter) && (closing >= virtual_chapter));
+}
+
 static int finish_previous_chapter(struct uds_index *index, u64 current_chapter_number)
 {
 	int result;
 	struct chapter_writer *writer = index->chapter_writer;
 
 	mutex_lock(&writer->mutex);
-	while (index->newest_virtual_chapter < current_chapter_number)
-		uds_wait_cond(&writer->cond, &writer->mutex);
+	if (!can_close_chapter(index, current_chapter_number)) {
+		ktime_t start = current_time_ns(CLOCK_MONOTONIC);
+
+		while (!can_close_chapter(index, current_chapter_number))
+			uds_wait_cond(&writer->cond, &writer->mutex);
+
+		writer->stall_count++;
+		writer->stall_time += ktime_sub(current_time_ns(CLOCK_MONOTONIC), start);
+	}
+
 	result = writer->result;
 	mutex_unlock(&writer->mutex);
 
@@ -206,30 +272,79 @@ static int swap_open_chapter(struct index_zone *zone)
 	if (result != UDS_SUCCESS)
 		return result;
 
-	swap(zone->open_chapter, zone->writing_chapter);
+	/* The oldest chapter has been written, so its buffer can be reused. */
+	swap(zone->open_chapter, zone->previous_chapter);
+	swap(zone->previous_chapter, zone->writing_chapter);
 	return UDS_SUCCESS;
 }
 
 /*
  * Inform the chapter writer that this zone is done with this chapter. The chapter won't start
- * writing until all zones have closed it.
+ * encoding until all zones have closed it.
  */
 static unsigned int start_closing_chapter(struct uds_index *index,
 					  unsigned int zone_number,
-					  struct open_chapter_zone *chapter)
+					  struct open_chapter_zone *chapter,
+					  u64 virtual_chapter)
 {
 	unsigned int finished_zones;
 	struct chapter_writer *writer = index->chapter_writer;
+	struct closed_chapter *closed = get_closed_chapter(writer, virtual_chapter);
 
 	mutex_lock(&writer->mutex);
 	finished_zones = ++writer->zones_to_write;
-	writer->chapters[zone_number] = chapter;
+	closed->chapters[zone_number] = chapter;
+	if (finished_zones == index->zone_count) {
+		closed->virtual_chapter = virtual_chapter;
+		closed->fills_started = 0;
+		closed->fills_finished = 0;
+		closed->result = UDS_SUCCESS;
+		uds_empty_open_chapter_index(closed->open_chapter_index, virtual_chapter);
+		writer->zones_to_write = 0;
+		writer->chapters_to_write++;
+	}
+
 	uds_broadcast_cond(&writer->cond);
 	mutex_unlock(&writer->mutex);
 
 	return finished_zones;
 }
 
+/*
+ * Fill parts of the chapter index of a closed chapter until no unclaimed parts remain, and return
+ * the number of parts filled.
+ */
+static unsigned int fill_closed_chapter(struct chapter_writer *writer, u64 virtual_chapter)
+{
+	struct uds_index *index = writer->index;
+	struct closed_chapter *closed = get_closed_chapter(writer, virtual_chapter);
+	unsigned int fill_zones = closed->open_chapter_index->delta_index.zone_count;
+	unsigned int filled = 0;
+
+	mutex_lock(&writer->mutex);
+	while ((closed->virtual_chapter == virtual_chapter) &&
+	       (closed->fills_started < fill_zones)) {
+		unsigned int fill_zone = closed->fills_started++;
+		int result;
+
+		mutex_unlock(&writer->mutex);
+		result = uds_fill_open_chapter_index_zone(closed->chapters, index->zone_count,
+							  closed->open_chapter_index,
+							  closed->collated_records,
+							  fill_zone);
+		mutex_lock(&writer->mutex);
+		if (closed->result == UDS_SUCCESS)
+			closed->result = result;
+
+		if (++closed->fills_finished == fill_zones)
+			uds_broadcast_cond(&writer->cond);
+		filled++;
+	}
+	mutex_unlock(&writer->mutex);
+
+	return filled;
+}
+
 static int announce_chapter_closed(struct index_zone *zone, u64 closed_chapter)
 {
 	int result;
@@ -251,6 +366,25 @@ static int announce_chapter_closed(struct index_zone *zone, u64 closed_chapter)
 	return UDS_SUCCESS;
 }
 
+/* Ask every zone to help fill the chapter index of a chapter which all zones have closed. */
+static int launch_fill_messages(struct index_zone *zone, u64 closed_chapter)
+{
+	int result;
+	unsigned int i;
+	struct uds_zone_message zone_message = {
+		.type = UDS_MESSAGE_FILL_CHAPTER_INDEX,
+		.virtual_chapter = closed_chapter,
+	};
+
+	for (i = 0; i < zone->index->zone_count; i++) {
+		result = launch_zone_message(zone_message, i, zone->index);
+		if (result != UDS_SUCCESS)
+			return result;
+	}
+
+	return UDS_SUCCESS;
+}
+
 static int open_next_chapter(struct index_zone *zone)
 {
 	int result;
@@ -274,13 +408,19 @@ static int open_next_chapter(struct index_zone *zone)
 	uds_reset_open_chapter(zone->open_chapter);
 
 	finished_zones = start_closing_chapter(zone->index, zone->id,
-					       zone->writing_chapter);
+					       zone->writing_chapter, closed_chapter);
 	if ((finished_zones == 1) && (zone->index->zone_count > 1)) {
 		result = announce_chapter_closed(zone, closed_chapter);
 		if (result != UDS_SUCCESS)
 			return result;
 	}
 
+	if (finished_zones == zone->index->zone_count) {
+		result = launch_fill_messages(zone, closed_chapter);
+		if (result != UDS_SUCCESS)
+			return result;
+	}
+
 	expiring = zone->oldest_virtual_chapter;
 	expire_chapters = uds_chapters_to_expire(zone->index->volume->geometry,
 						 zone->newest_virtual_chapter);
@@ -315,6 +455,16 @@ static int dispatch_index_zone_control_request(struct uds_request *request)
 	case UDS_MESSAGE_ANNOUNCE_CHAPTER_CLOSED:
 		return handle_chapter_closed(zone, message->virtual_chapter);
 
+	case UDS_MESSAGE_FILL_CHAPTER_INDEX:
+#ifdef TEST_INTERNAL
+		atomic_add(fill_closed_chapter(zone->index->chapter_writer,
+					       message->virtual_chapter),
+			   &chapter_index_zone_fills);
+#else
+		fill_closed_chapter(zone->index->chapter_writer, message->virtual_chapter);
+#endif /* TEST_INTERNAL */
+		return UDS_SUCCESS;
+
 	default:
 		vdo_log_error("invalid message type: %d", message->type);
 		return UDS_INVALID_ARGUMENT;
@@ -389,6 +539,15 @@ static int get_record_from_zone(struct index_zone *zone, struct uds_request *req
 		return UDS_SUCCESS;
 	}
 
+	/* The chapter before the writing chapter may not have been written yet either. */
+	if ((zone->newest_virtual_chapter > 1) &&
+	    (request->virtual_chapter == (zone->newest_virtual_chapter - 2)) &&
+	    (zone->previous_chapter->size > 0)) {
+		uds_search_open_chapter(zone->previous_chapter, &request->record_name,
+					&request->old_metadata, found);
+		return UDS_SUCCESS;
+	}
+
 	volume = zone->index->volume;
 	if (is_zone_chapter_sparse(zone, request->virtual_chapter) &&
 	    uds_sparse_cache_contains(volume->sparse_cache, request->virtual_chapter,
@@ -682,7 +841,11 @@ static void close_chapters(void *arg)
 	vdo_log_debug("chapter writer starting");
 	mutex_lock(&writer->mutex);
 	for (;;) {
-		while (writer->zones_to_write < index->zone_count) {
+		u64 virtual_chapter;
+		struct closed_chapter *closed;
+		unsigned int fill_zones;
+
+		while (writer->chapters_to_write == 0) {
 			if (writer->stop && (writer->zones_to_write == 0)) {
 				/*
 				 * We've been told to stop, and all of the zones are in the same
@@ -696,13 +859,34 @@ static void close_chapters(void *arg)
 		}
 
 		/*
-		 * Release the lock while closing a chapter. We probably don't need to do this, but
-		 * it seems safer in principle. It's OK to access the chapter and chapter_number
-		 * fields without the lock since those aren't allowed to change until we're done.
+		 * Release the lock while encoding and writing a chapter. The zones won't touch this
+		 * chapter's buffers again until it has been written, so it's OK to access them
+		 * without the lock.
 		 */
+		virtual_chapter = index->newest_virtual_chapter;
+		closed = get_closed_chapter(writer, virtual_chapter);
+		fill_zones = closed->open_chapter_index->delta_index.zone_count;
 		mutex_unlock(&writer->mutex);
 
-		if (index->has_saved_open_chapter) {
+		/* Fill whatever parts of the chapter index the zones haven't gotten to. */
+#ifdef TEST_INTERNAL
+		atomic_add(fill_closed_chapter(writer, virtual_chapter),
+			   &chapter_index_writer_fills);
+#else
+		fill_closed_chapter(writer, virtual_chapter);
+#endif /* TEST_INTERNAL */
+		mutex_lock(&writer->mutex);
+		while (closed->fills_finished < fill_zones)
+			uds_wait_cond(&writer->cond, &writer->mutex);
+		result = closed->result;
+		mutex_unlock(&writer->mutex);
+#ifdef TEST_INTERNAL
+
+		if (chapter_write_hook != NULL)
+			chapter_write_hook(virtual_chapter);
+#endif /* TEST_INTERNAL */
+
+		if ((result == UDS_SUCCESS) && index->has_saved_open_chapter) {
 			/*
 			 * Remove the saved open chapter the first time we close an open chapter
 			 * after loading from a clean shutdown, or after doing a clean save. The
@@ -715,11 +899,9 @@ static void close_chapters(void *arg)
 				vdo_log_debug("Discarding saved open chapter");
 		}
 
-		result = uds_close_open_chapter(writer->chapters, index->zone_count,
-						index->volume,
-						writer->open_chapter_index,
-						writer->collated_records,
-						index->newest_virtual_chapter);
+		if (result == UDS_SUCCESS)
+			result = uds_write_chapter(index->volume, closed->open_chapter_index,
+						   closed->collated_records);
 #ifdef TEST_INTERNAL
 
 		/*
@@ -736,7 +918,7 @@ static void close_chapters(void *arg)
 			uds_chapters_to_expire(index->volume->geometry,
 					       index->newest_virtual_chapter);
 		writer->result = result;
-		writer->zones_to_write = 0;
+		writer->chapters_to_write--;
 		uds_broadcast_cond(&writer->cond);
 	}
 }
@@ -760,6 +942,8 @@ static void stop_chapter_writer(struct chapter_writer *writer)
 
 static void free_chapter_writer(struct chapter_writer *writer)
 {
+	unsigned int i;
+
 	if (writer == NULL)
 		return;
 
@@ -768,22 +952,41 @@ static void free_chapter_writer(struct chapter_writer *writer)
 	mutex_destroy(&writer->mutex);
 	uds_destroy_cond(&writer->cond);
 #endif /* __KERNEL__ */
-	uds_free_open_chapter_index(writer->open_chapter_index);
-	vdo_free(writer->collated_records);
+	for (i = 0; i < ARRAY_SIZE(writer->chapters); i++) {
+		uds_free_open_chapter_index(writer->chapters[i].open_chapter_index);
+		vdo_free(writer->chapters[i].collated_records);
+	}
+
 	vdo_free(writer);
 }
 
+static int make_closed_chapter(struct uds_index *index, struct closed_chapter *closed)
+{
+	int result;
+	size_t collated_records_size =
+		(sizeof(struct uds_volume_record) * index->volume->geometry->records_per_chapter);
+
+	closed->virtual_chapter = NO_CHAPTER;
+	result = vdo_allocate_cache_aligned(collated_records_size, "collated records",
+					    &closed->collated_records);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	return uds_make_open_chapter_index(&closed->open_chapter_index,
+					   index->volume->geometry, index->zone_count,
+					   index->volume->nonce);
+}
+
 static int make_chapter_writer(struct uds_index *index,
 			       struct chapter_writer **writer_ptr)
 {
 	int result;
+	unsigned int i;
 	struct chapter_writer *writer;
 	size_t collated_records_size =
 		(sizeof(struct uds_volume_record) * index->volume->geometry->records_per_chapter);
 
-	result = vdo_allocate_extended(struct chapter_writer, index->zone_count,
-				       struct open_chapter_zone *, "Chapter Writer",
-				       &writer);
+	result = vdo_allocate(1, struct chapter_writer, "Chapter Writer", &writer);
 	if (result != VDO_SUCCESS)
 		return result;
 
@@ -791,26 +994,18 @@ static int make_chapter_writer(struct uds_index *index,
 	mutex_init(&writer->mutex);
 	uds_init_cond(&writer->cond);
 
-	result = vdo_allocate_cache_aligned(collated_records_size, "collated records",
-					    &writer->collated_records);
-	if (result != VDO_SUCCESS) {
-		free_chapter_writer(writer);
-		return result;
-	}
+	writer->memory_size = sizeof(struct chapter_writer);
+	for (i = 0; i < ARRAY_SIZE(writer->chapters); i++) {
+		result = make_closed_chapter(index, &writer->chapters[i]);
+		if (result != UDS_SUCCESS) {
+			free_chapter_writer(writer);
+			return result;
+		}
 
-	result = uds_make_open_chapter_index(&writer->open_chapter_index,
-					     index->volume->geometry,
-					     index->volume->nonce);
-	if (result != UDS_SUCCESS) {
-		free_chapter_writer(writer);
-		return result;
+		writer->memory_size += (collated_records_size +
+					writer->chapters[i].open_chapter_index->memory_size);
 	}
 
-	writer->memory_size = (sizeof(struct chapter_writer) +
-			       index->zone_count * sizeof(struct open_chapter_zone *) +
-			       collated_records_size +
-			       writer->open_chapter_index->memory_size);
-
 	result = vdo_create_thread(close_chapters, writer, "writer", &writer->thread);
 	if (result != VDO_SUCCESS) {
 		free_chapter_writer(writer);
@@ -1141,6 +1336,7 @@ static void free_index_zone(struct index_zone *zone)
 
 	uds_free_open_chapter(zone->open_chapter);
 	uds_free_open_chapter(zone->writing_chapter);
+	uds_free_open_chapter(zone->previous_chapter);
 	vdo_free(zone);
 }
 
@@ -1167,6 +1363,13 @@ static int make_index_zone(struct uds_index *index, unsigned int zone_number)
 		return result;
 	}
 
+	result = uds_make_open_chapter(index->volume->geometry, index->zone_count,
+				       &zone->previous_chapter);
+	if (result != UDS_SUCCESS) {
+		free_index_zone(zone);
+		return result;
+	}
+
 	zone->index = index;
 	zone->id = zone_number;
 	index->zones[zone_number] = zone;
@@ -1326,7 +1529,7 @@ void uds_wait_for_idle_index(struct uds_index *index)
 	struct chapter_writer *writer = index->chapter_writer;
 
 	mutex_lock(&writer->mutex);
-	while (writer->zones_to_write > 0)
+	while ((writer->zones_to_write > 0) || (writer->chapters_to_write > 0))
 		uds_wait_cond(&writer->cond, &writer->mutex);
 	mutex_unlock(&writer->mutex);
 }
@@ -1377,6 +1580,11 @@ void uds_get_index_stats(struct uds_index *index, struct uds_index_stats *counte
 	counters->memory_used = (index->volume_index->memory_size +
 				 index->volume->cache_size +
 				 index->chapter_writer->memory_size);
+
+	mutex_lock(&index->chapter_writer->mutex);
+	counters->chapter_close_stalls = index->chapter_writer->stall_count;
+	counters->chapter_close_stall_time = ktime_to_us(index->chapter_writer->stall_time);
+	mutex_unlock(&index->chapter_writer->mutex);
 }
 
 void uds_enqueue_request(struct uds_request *request, enum request_stage stage)
@@ -26,6 +26,12 @@
 
 extern atomic_t chapters_replayed;
 extern atomic_t chapters_written;
+extern atomic_t chapter_index_writer_fills;
+extern atomic_t chapter_index_zone_fills;
+
+typedef void (*chapter_write_hook_fn)(u64 virtual_chapter);
+
+void set_chapter_write_hook(chapter_write_hook_fn hook);
 #endif /* TEST_INTERNAL */
 
 typedef void (*index_callback_fn)(struct uds_request *request);
@@ -34,6 +40,7 @@ struct index_zone {
 	struct uds_index *index;
 	struct open_chapter_zone *open_chapter;
 	struct open_chapter_zone *writing_chapter;
+	struct open_chapter_zone *previous_chapter;
 	u64 oldest_virtual_chapter;
 	u64 newest_virtual_chapter;
 	unsigned int id;
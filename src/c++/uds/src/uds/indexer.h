@@ -208,6 +208,10 @@ struct uds_index_stats {
 	u64 queries_not_found;
 	/* The total number of requests processed */
 	u64 requests;
+	/* The number of times a zone waited for the chapter writer before closing a chapter */
+	u64 chapter_close_stalls;
+	/* The total time zones spent waiting for the chapter writer, in microseconds */
+	u64 chapter_close_stall_time;
 };
 
 enum uds_index_region {
@@ -235,6 +239,8 @@ enum uds_zone_message_type {
 	UDS_MESSAGE_SPARSE_CACHE_BARRIER,
 	/* Close a chapter to keep the zone from falling behind */
 	UDS_MESSAGE_ANNOUNCE_CHAPTER_CLOSED,
+	/* Fill part of the chapter index of a chapter closed by every zone */
+	UDS_MESSAGE_FILL_CHAPTER_INDEX,
 } __packed;
 
 struct uds_zone_message {
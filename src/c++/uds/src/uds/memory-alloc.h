@@ -22,6 +22,13 @@
 /* Custom memory allocation function that tracks memory usage */
 int __must_check vdo_allocate_memory(size_t size, size_t align, const char *what, void *ptr);
 
+/*
+ * Allocate zeroed memory from a particular NUMA node. Large allocations may be mapped with huge
+ * pages. A node of NUMA_NO_NODE behaves like vdo_allocate_memory().
+ */
+int __must_check vdo_allocate_memory_on_node(size_t size, size_t align, int node,
+					     const char *what, void *ptr);
+
 /*
  * Allocate storage based on element counts, sizes, and alignment.
  *
@@ -8,8 +8,11 @@
 
 #include "murmurhash3.h"
 
+#include <linux/string.h>
 #include <linux/unaligned.h>
 
+#include "cpu.h"
+
 static inline u64 rotl64(u64 x, s8 r)
 {
 	return (x << r) | (x >> (64 - r));
@@ -30,45 +33,17 @@ static __always_inline u64 fmix64(u64 k)
 	return k;
 }
 
-void murmurhash3_128(const void *key, const int len, const u32 seed, void *out)
+/* Mix in the bytes left over after the last full 16-byte block, then finalize. */
+static __always_inline void finish_128(const u8 *data, const int len, u64 h1, u64 h2,
+				       void *out)
 {
-	const u8 *data = key;
 	const int nblocks = len / 16;
 
-	u64 h1 = seed;
-	u64 h2 = seed;
-
 	const u64 c1 = 0x87c37b91114253d5LLU;
 	const u64 c2 = 0x4cf5ad432745937fLLU;
 
 	u64 *hash_out = out;
 
-	/* body */
-	int i;
-
-	for (i = 0; i < nblocks; i++) {
-		u64 k1 = get_unaligned_le64(&data[i * 16]);
-		u64 k2 = get_unaligned_le64(&data[i * 16 + 8]);
-
-		k1 *= c1;
-		k1 = ROTL64(k1, 31);
-		k1 *= c2;
-		h1 ^= k1;
-
-		h1 = ROTL64(h1, 27);
-		h1 += h2;
-		h1 = h1 * 5 + 0x52dce729;
-
-		k2 *= c2;
-		k2 = ROTL64(k2, 33);
-		k2 *= c1;
-		h2 ^= k2;
-
-		h2 = ROTL64(h2, 31);
-		h2 += h1;
-		h2 = h2 * 5 + 0x38495ab5;
-	}
-
 	/* tail */
 
 	{
@@ -153,3 +128,168 @@ void murmurhash3_128(const void *key, const int len, const u32 seed, void *out)
 	put_unaligned_le64(h1, &hash_out[0]);
 	put_unaligned_le64(h2, &hash_out[1]);
 }
+
+void murmurhash3_128(const void *key, const int len, const u32 seed, void *out)
+{
+	const u8 *data = key;
+	const int nblocks = len / 16;
+
+	u64 h1 = seed;
+	u64 h2 = seed;
+
+	const u64 c1 = 0x87c37b91114253d5LLU;
+	const u64 c2 = 0x4cf5ad432745937fLLU;
+
+	/* body */
+	int i;
+
+	for (i = 0; i < nblocks; i++) {
+		u64 k1 = get_unaligned_le64(&data[i * 16]);
+		u64 k2 = get_unaligned_le64(&data[i * 16 + 8]);
+
+		k1 *= c1;
+		k1 = ROTL64(k1, 31);
+		k1 *= c2;
+		h1 ^= k1;
+
+		h1 = ROTL64(h1, 27);
+		h1 += h2;
+		h1 = h1 * 5 + 0x52dce729;
+
+		k2 *= c2;
+		k2 = ROTL64(k2, 33);
+		k2 *= c1;
+		h2 ^= k2;
+
+		h2 = ROTL64(h2, 31);
+		h2 += h1;
+		h2 = h2 * 5 + 0x38495ab5;
+	}
+
+	finish_128(data, len, h1, h2, out);
+}
+
+/*
+ * Hash MURMURHASH3_LANES keys of the same length. The lanes are independent, so stepping them
+ * together lets the processor overlap their multiply chains rather than waiting on each one in
+ * turn. The results are identical to calling murmurhash3_128() on each key.
+ */
+void murmurhash3_128_lanes(const void * const keys[], const int len, const u32 seed,
+			   void * const outs[])
+{
+	const int nblocks = len / 16;
+
+	u64 h1[MURMURHASH3_LANES];
+	u64 h2[MURMURHASH3_LANES];
+
+	const u64 c1 = 0x87c37b91114253d5LLU;
+	const u64 c2 = 0x4cf5ad432745937fLLU;
+
+	int i;
+	int lane;
+
+	for (lane = 0; lane < MURMURHASH3_LANES; lane++) {
+		h1[lane] = seed;
+		h2[lane] = seed;
+	}
+
+	/* body */
+	for (i = 0; i < nblocks; i++) {
+		for (lane = 0; lane < MURMURHASH3_LANES; lane++) {
+			const u8 *data = keys[lane];
+			u64 k1 = get_unaligned_le64(&data[i * 16]);
+			u64 k2 = get_unaligned_le64(&data[i * 16 + 8]);
+
+			k1 *= c1;
+			k1 = ROTL64(k1, 31);
+			k1 *= c2;
+			h1[lane] ^= k1;
+
+			h1[lane] = ROTL64(h1[lane], 27);
+			h1[lane] += h2[lane];
+			h1[lane] = h1[lane] * 5 + 0x52dce729;
+
+			k2 *= c2;
+			k2 = ROTL64(k2, 33);
+			k2 *= c1;
+			h2[lane] ^= k2;
+
+			h2[lane] = ROTL64(h2[lane], 31);
+			h2[lane] += h1[lane];
+			h2[lane] = h2[lane] * 5 + 0x38495ab5;
+		}
+	}
+
+	for (lane = 0; lane < MURMURHASH3_LANES; lane++)
+		finish_128(keys[lane], len, h1[lane], h2[lane], outs[lane]);
+}
+
+/*
+ * Hash a key as MURMURHASH3_LANES interleaved stripes, where 16-byte block i of each 64-byte row
+ * goes to lane i, and then hash the lane results together with any bytes left after the last
+ * full row. This gives a single key the same overlapping of multiply chains that
+ * murmurhash3_128_lanes() gives a group of keys. It is a different function from
+ * murmurhash3_128(), so the two must never be mixed in one index.
+ */
+void murmurhash3_128_striped(const void *key, const int len, const u32 seed, void *out)
+{
+	const u8 *data = key;
+	const int row_size = 16 * MURMURHASH3_LANES;
+	const int nrows = len / row_size;
+	const int tail_len = len % row_size;
+	const int prefetch_distance = 16 * row_size;
+
+	u64 h1[MURMURHASH3_LANES];
+	u64 h2[MURMURHASH3_LANES];
+	u8 folded[2 * 16 * MURMURHASH3_LANES];
+
+	const u64 c1 = 0x87c37b91114253d5LLU;
+	const u64 c2 = 0x4cf5ad432745937fLLU;
+
+	int i;
+	int lane;
+
+	for (lane = 0; lane < MURMURHASH3_LANES; lane++) {
+		h1[lane] = seed;
+		h2[lane] = seed;
+	}
+
+	/* body */
+	for (i = 0; i < nrows; i++) {
+		/*
+		 * A single sequential stream has less memory parallelism than the separate keys
+		 * of murmurhash3_128_lanes(), so fetch well ahead of it.
+		 */
+		uds_prefetch_address(&data[(i * row_size) + prefetch_distance], false);
+		for (lane = 0; lane < MURMURHASH3_LANES; lane++) {
+			const u8 *block = &data[(i * row_size) + (lane * 16)];
+			u64 k1 = get_unaligned_le64(block);
+			u64 k2 = get_unaligned_le64(block + 8);
+
+			k1 *= c1;
+			k1 = ROTL64(k1, 31);
+			k1 *= c2;
+			h1[lane] ^= k1;
+
+			h1[lane] = ROTL64(h1[lane], 27);
+			h1[lane] += h2[lane];
+			h1[lane] = h1[lane] * 5 + 0x52dce729;
+
+			k2 *= c2;
+			k2 = ROTL64(k2, 33);
+			k2 *= c1;
+			h2[lane] ^= k2;
+
+			h2[lane] = ROTL64(h2[lane], 31);
+			h2[lane] += h1[lane];
+			h2[lane] = h2[lane] * 5 + 0x38495ab5;
+		}
+	}
+
+	/* Each lane saw a whole number of 16-byte blocks, so there is no per-lane tail. */
+	for (lane = 0; lane < MURMURHASH3_LANES; lane++)
+		finish_128(data, nrows * 16, h1[lane], h2[lane], &folded[lane * 16]);
+
+	memcpy(&folded[row_size], &data[nrows * row_size], tail_len);
+	murmurhash3_128(folded, row_size + tail_len, seed, out);
+}
@@ -10,6 +10,16 @@
 #include <linux/compiler.h>
 #include <linux/types.h>
 
+enum {
+	/* The number of keys hashed together by murmurhash3_128_lanes() */
+	MURMURHASH3_LANES = 4,
+};
+
 void murmurhash3_128(const void *key, int len, u32 seed, void *out);
 
+void murmurhash3_128_lanes(const void * const keys[], int len, u32 seed,
+			   void * const outs[]);
+
+void murmurhash3_128_striped(const void *key, int len, u32 seed, void *out);
+
 #endif /* _MURMURHASH3_H_ */
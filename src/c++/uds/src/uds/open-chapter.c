@@ -199,20 +199,28 @@ void uds_free_open_chapter(struct open_chapter_zone *open_chapter)
 	}
 }
 
-/* Map each record name to its record page number in the delta chapter index. */
-static int fill_delta_chapter_index(struct open_chapter_zone **chapter_zones,
-				    unsigned int zone_count,
-				    struct open_chapter_index *index,
-				    struct uds_volume_record *collated_records)
+/*
+ * Map each record name whose delta list belongs to one zone of the delta chapter index to its
+ * record page number, and collate that zone's share of the records. Since each zone of the chapter
+ * index is filled independently, the zones may be filled by different threads at the same time.
+ */
+int uds_fill_open_chapter_index_zone(struct open_chapter_zone **chapter_zones,
+				     unsigned int zone_count,
+				     struct open_chapter_index *index,
+				     struct uds_volume_record *collated_records,
+				     unsigned int delta_zone)
 {
 	int result;
 	unsigned int records_per_chapter;
 	unsigned int records_per_page;
 	unsigned int record_index;
 	unsigned int records = 0;
+	unsigned int first_record;
+	unsigned int last_record;
 	u32 page_number;
 	unsigned int z;
 	int overflow_count = 0;
+	const struct delta_index *delta_index = &index->delta_index;
 	struct uds_volume_record *fill_record = NULL;
 
 	/*
@@ -232,10 +240,13 @@ static int fill_delta_chapter_index(struct open_chapter_zone **chapter_zones,
 
 	records_per_chapter = index->geometry->records_per_chapter;
 	records_per_page = index->geometry->records_per_page;
+	first_record = ((u64) records_per_chapter * delta_zone) / delta_index->zone_count;
+	last_record = ((u64) records_per_chapter * (delta_zone + 1)) / delta_index->zone_count;
 
 	for (records = 0; records < records_per_chapter; records++) {
-		struct uds_volume_record *record = &collated_records[records];
+		struct uds_volume_record *record;
 		struct open_chapter_zone *open_chapter;
+		u32 list_number;
 
 		/* The record arrays in the zones are 1-based. */
 		record_index = 1 + (records / zone_count);
@@ -245,11 +256,19 @@ static int fill_delta_chapter_index(struct open_chapter_zone **chapter_zones,
 		/* Use the fill record in place of an unused record. */
 		if (record_index > open_chapter->size ||
 		    open_chapter->slots[record_index].deleted) {
-			*record = *fill_record;
+			if ((records >= first_record) && (records < last_record))
+				collated_records[records] = *fill_record;
 			continue;
 		}
 
-		*record = open_chapter->records[record_index];
+		record = &open_chapter->records[record_index];
+		if ((records >= first_record) && (records < last_record))
+			collated_records[records] = *record;
+
+		list_number = uds_hash_to_chapter_delta_list(&record->name, index->geometry);
+		if ((list_number / delta_index->lists_per_zone) != delta_zone)
+			continue;
+
 		result = uds_put_open_chapter_index_record(index, &record->name,
 							   page_number);
 		switch (result) {
@@ -272,6 +291,25 @@ static int fill_delta_chapter_index(struct open_chapter_zone **chapter_zones,
 	return UDS_SUCCESS;
 }
 
+/* Map each record name to its record page number in the delta chapter index. */
+static int fill_delta_chapter_index(struct open_chapter_zone **chapter_zones,
+				    unsigned int zone_count,
+				    struct open_chapter_index *index,
+				    struct uds_volume_record *collated_records)
+{
+	int result;
+	unsigned int z;
+
+	for (z = 0; z < index->delta_index.zone_count; z++) {
+		result = uds_fill_open_chapter_index_zone(chapter_zones, zone_count, index,
+							  collated_records, z);
+		if (result != UDS_SUCCESS)
+			return result;
+	}
+
+	return UDS_SUCCESS;
+}
+
 int uds_close_open_chapter(struct open_chapter_zone **chapter_zones,
 			   unsigned int zone_count, struct volume *volume,
 			   struct open_chapter_index *chapter_index,
@@ -62,6 +62,12 @@ void uds_remove_from_open_chapter(struct open_chapter_zone *open_chapter,
 
 void uds_free_open_chapter(struct open_chapter_zone *open_chapter);
 
+int __must_check uds_fill_open_chapter_index_zone(struct open_chapter_zone **chapter_zones,
+						  unsigned int zone_count,
+						  struct open_chapter_index *index,
+						  struct uds_volume_record *collated_records,
+						  unsigned int delta_zone);
+
 int __must_check uds_close_open_chapter(struct open_chapter_zone **chapter_zones,
 					unsigned int zone_count, struct volume *volume,
 					struct open_chapter_index *chapter_index,
@@ -10,6 +10,9 @@
 
 #include "memory-alloc.h"
 #include "string-utils.h"
+#include "thread-utils.h"
+
+#include "indexer.h"
 
 /*
  * This implementation allocates one large object to do the sorting, which can be reused as many
@@ -20,6 +23,9 @@
 /* Piles smaller than this are handled with a simple insertion sort. */
 #define INSERTION_SORT_THRESHOLD 12
 
+/* Sorts smaller than this are not worth the cost of starting threads. */
+#define PARALLEL_SORT_THRESHOLD 32768
+
 /* Sort keys are pointers to immutable fixed-length arrays of bytes. */
 typedef const u8 *sort_key_t;
 
@@ -53,15 +59,51 @@ struct task {
 	u16 length;
 };
 
+/* The state needed only by sorters which sort record names */
+struct name_sort_state {
+	/* The number of occurrences of each byte at each offset of a record name */
+	u32 bins[UDS_RECORD_NAME_SIZE][256];
+	/* Space for the keys while they are moved between piles */
+	sort_key_t scratch[];
+};
+
 struct radix_sorter {
 	unsigned int count;
 	struct histogram bins;
 	sort_key_t *pile[256];
+	/* The record name sort state, if this sorter was made to sort record names */
+	struct name_sort_state *names;
 	struct task *end_of_stack;
 	struct task insertion_list[256];
 	struct task stack[];
 };
 
+/* A range of first byte piles to be sorted by one thread of a parallel sort. */
+struct sort_share {
+	struct radix_sorter *sorter;
+	struct thread *thread;
+	/* The first key of the first pile in the share */
+	sort_key_t *first_key;
+	/* The sizes of all the piles of the sort */
+	const u32 *sizes;
+	/* The first pile in the share */
+	u16 first_bin;
+	/* The pile after the last pile in the share */
+	u16 end_bin;
+	/* The number of bytes remaining in the sort keys */
+	u16 length;
+	int result;
+};
+
+struct parallel_radix_sorter {
+	unsigned int count;
+	unsigned int share_count;
+	struct histogram bins;
+	u32 size[256];
+	sort_key_t *pile[256];
+	struct sort_share shares[];
+};
+
 /* Compare a segment of two fixed-length keys starting at an offset. */
 static inline int compare(sort_key_t key1, sort_key_t key2, u16 offset, u16 length)
 {
@@ -205,6 +247,44 @@ static inline int push_bins(struct task **stack, struct task *end_of_stack,
 	return UDS_SUCCESS;
 }
 
+/*
+ * Move each key of a task into its pile, given pointers to the end of each pile. This clears
+ * bins->size[] as it goes.
+ */
+static inline void distribute_keys(const struct task task, struct histogram *bins,
+				   sort_key_t *pile[])
+{
+	sort_key_t *fence;
+	sort_key_t *end;
+
+	/*
+	 * Don't bother processing the last pile: when piles 0..N-1 are all in place, then pile N
+	 * must also be in place.
+	 */
+	end = task.last_key - bins->size[bins->last];
+	bins->size[bins->last] = 0;
+
+	for (fence = task.first_key; fence <= end; ) {
+		u8 bin;
+		sort_key_t key = *fence;
+
+		/*
+		 * The radix byte of the key tells us which pile it belongs in. Swap it for an
+		 * unprocessed item just below that pile, and repeat.
+		 */
+		while (--pile[bin = key[task.offset]] > fence)
+			swap_keys(pile[bin], &key);
+
+		/*
+		 * The pile reached the fence. Put the key at the bottom of that pile, completing
+		 * it, and advance the fence to the next pile.
+		 */
+		*fence = key;
+		fence += bins->size[bin];
+		bins->size[bin] = 0;
+	}
+}
+
 int uds_make_radix_sorter(unsigned int count, struct radix_sorter **sorter)
 {
 	int result;
@@ -222,41 +302,49 @@ int uds_make_radix_sorter(unsigned int count, struct radix_sorter **sorter)
 	return UDS_SUCCESS;
 }
 
+/* Make a sorter which can also sort record names with uds_radix_sort_names(). */
+int uds_make_name_radix_sorter(unsigned int count, struct radix_sorter **sorter)
+{
+	int result;
+	struct radix_sorter *radix_sorter;
+
+	result = uds_make_radix_sorter(count, &radix_sorter);
+	if (result != UDS_SUCCESS)
+		return result;
+
+	result = vdo_allocate_extended(struct name_sort_state, count, sort_key_t, __func__,
+				       &radix_sorter->names);
+	if (result != VDO_SUCCESS) {
+		uds_free_radix_sorter(radix_sorter);
+		return result;
+	}
+
+	*sorter = radix_sorter;
+	return UDS_SUCCESS;
+}
+
 void uds_free_radix_sorter(struct radix_sorter *sorter)
 {
+	if (sorter == NULL)
+		return;
+
+	vdo_free(sorter->names);
 	vdo_free(sorter);
 }
 
-/*
- * Sort pointers to fixed-length keys (arrays of bytes) using a radix sort. The sort implementation
- * is unstable, so the relative ordering of equal keys is not preserved.
- */
-int uds_radix_sort(struct radix_sorter *sorter, const unsigned char *keys[],
-		   unsigned int count, unsigned short length)
+/* Sort the keys of a task, which must not be empty. */
+static int sort_task(struct radix_sorter *sorter, const struct task start)
 {
-	struct task start;
 	struct histogram *bins = &sorter->bins;
 	sort_key_t **pile = sorter->pile;
 	struct task *task_stack = sorter->stack;
 
-	/* All zero-length keys are identical and therefore already sorted. */
-	if ((count == 0) || (length == 0))
-		return UDS_SUCCESS;
-
-	/* The initial task is to sort the entire length of all the keys. */
-	start = (struct task) {
-		.first_key = keys,
-		.last_key = &keys[count - 1],
-		.offset = 0,
-		.length = length,
-	};
-
-	if (count <= INSERTION_SORT_THRESHOLD) {
+	if (start.last_key - start.first_key < INSERTION_SORT_THRESHOLD) {
 		insertion_sort(start);
 		return UDS_SUCCESS;
 	}
 
-	if (count > sorter->count)
+	if (start.last_key - start.first_key >= sorter->count)
 		return UDS_INVALID_ARGUMENT;
 
 	/*
@@ -269,8 +357,6 @@ int uds_radix_sort(struct radix_sorter *sorter, const unsigned char *keys[],
 		const struct task task = *task_stack;
 		struct task *insertion_task_list;
 		int result;
-		sort_key_t *fence;
-		sort_key_t *end;
 
 		measure_bins(task, bins);
 
@@ -289,32 +375,7 @@ int uds_radix_sort(struct radix_sorter *sorter, const unsigned char *keys[],
 
 		/* Now bins->used is zero again. */
 
-		/*
-		 * Don't bother processing the last pile: when piles 0..N-1 are all in place, then
-		 * pile N must also be in place.
-		 */
-		end = task.last_key - bins->size[bins->last];
-		bins->size[bins->last] = 0;
-
-		for (fence = task.first_key; fence <= end; ) {
-			u8 bin;
-			sort_key_t key = *fence;
-
-			/*
-			 * The radix byte of the key tells us which pile it belongs in. Swap it for
-			 * an unprocessed item just below that pile, and repeat.
-			 */
-			while (--pile[bin = key[task.offset]] > fence)
-				swap_keys(pile[bin], &key);
-
-			/*
-			 * The pile reached the fence. Put the key at the bottom of that pile,
-			 * completing it, and advance the fence to the next pile.
-			 */
-			*fence = key;
-			fence += bins->size[bin];
-			bins->size[bin] = 0;
-		}
+		distribute_keys(task, bins, pile);
 
 		/* Now bins->size[] is all zero again. */
 
@@ -328,3 +389,247 @@ int uds_radix_sort(struct radix_sorter *sorter, const unsigned char *keys[],
 
 	return UDS_SUCCESS;
 }
+
+/*
+ * Sort pointers to fixed-length keys (arrays of bytes) using a radix sort. The sort implementation
+ * is unstable, so the relative ordering of equal keys is not preserved.
+ */
+int uds_radix_sort(struct radix_sorter *sorter, const unsigned char *keys[],
+		   unsigned int count, unsigned short length)
+{
+	/* All zero-length keys are identical and therefore already sorted. */
+	if ((count == 0) || (length == 0))
+		return UDS_SUCCESS;
+
+	/* The initial task is to sort the entire length of all the keys. */
+	return sort_task(sorter, (struct task) {
+				.first_key = keys,
+				.last_key = &keys[count - 1],
+				.offset = 0,
+				.length = length,
+			 });
+}
+
+/*
+ * Sort pointers to record names using a least significant digit radix sort. Rather than
+ * recursing into ever smaller piles, this makes one counting pass over all the keys and then
+ * moves every key once for each byte of the name, skipping any byte which is the same in every
+ * key. The counting loop has a fixed trip count and no dependencies between the bytes of a name,
+ * so it unrolls well, and the moves are simple sequential scans. This sort is stable. The sorter
+ * must have been made by uds_make_name_radix_sorter().
+ */
+int uds_radix_sort_names(struct radix_sorter *sorter, const unsigned char *keys[],
+			 unsigned int count)
+{
+	struct name_sort_state *names = sorter->names;
+	sort_key_t *from = keys;
+	sort_key_t *to;
+	unsigned int i;
+	int offset;
+
+	if (names == NULL)
+		return UDS_INVALID_ARGUMENT;
+
+	if (count <= INSERTION_SORT_THRESHOLD)
+		return uds_radix_sort(sorter, keys, count, UDS_RECORD_NAME_SIZE);
+
+	if (count > sorter->count)
+		return UDS_INVALID_ARGUMENT;
+
+	to = names->scratch;
+	memset(names->bins, 0, sizeof(names->bins));
+	for (i = 0; i < count; i++) {
+		sort_key_t key = keys[i];
+		int j;
+
+		for (j = 0; j < UDS_RECORD_NAME_SIZE; j++)
+			names->bins[j][key[j]]++;
+	}
+
+	for (offset = UDS_RECORD_NAME_SIZE - 1; offset >= 0; offset--) {
+		u32 *next = names->bins[offset];
+		u32 start = 0;
+		sort_key_t *swap;
+		int bin;
+
+		/* The keys are already in order if they all have the same byte here. */
+		if (next[from[0][offset]] == count)
+			continue;
+
+		/* Convert the byte counts to the index of the first key of each pile. */
+		for (bin = 0; bin < 256; bin++) {
+			u32 size = next[bin];
+
+			next[bin] = start;
+			start += size;
+		}
+
+		for (i = 0; i < count; i++)
+			to[next[from[i][offset]]++] = from[i];
+
+		swap = from;
+		from = to;
+		to = swap;
+	}
+
+	if (from != keys)
+		memcpy(keys, from, count * sizeof(sort_key_t));
+
+	return UDS_SUCCESS;
+}
+
+int uds_make_parallel_radix_sorter(unsigned int count, unsigned int thread_count,
+				   struct parallel_radix_sorter **sorter)
+{
+	int result;
+	unsigned int i;
+	struct parallel_radix_sorter *parallel_sorter;
+
+	if (thread_count == 0)
+		return UDS_INVALID_ARGUMENT;
+
+	/* There is no work for more threads than there are first byte piles. */
+	if (thread_count > 256)
+		thread_count = 256;
+
+	result = vdo_allocate_extended(struct parallel_radix_sorter, thread_count,
+				       struct sort_share, __func__, &parallel_sorter);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	parallel_sorter->count = count;
+	parallel_sorter->share_count = thread_count;
+	for (i = 0; i < thread_count; i++) {
+		result = uds_make_radix_sorter(count, &parallel_sorter->shares[i].sorter);
+		if (result != UDS_SUCCESS) {
+			uds_free_parallel_radix_sorter(parallel_sorter);
+			return result;
+		}
+	}
+
+	*sorter = parallel_sorter;
+	return UDS_SUCCESS;
+}
+
+void uds_free_parallel_radix_sorter(struct parallel_radix_sorter *sorter)
+{
+	unsigned int i;
+
+	if (sorter == NULL)
+		return;
+
+	for (i = 0; i < sorter->share_count; i++)
+		uds_free_radix_sorter(sorter->shares[i].sorter);
+
+	vdo_free(sorter);
+}
+
+/* Sort each of the first byte piles in a share by the rest of the key. */
+static void sort_share(void *arg)
+{
+	struct sort_share *share = arg;
+	sort_key_t *first_key = share->first_key;
+	unsigned int bin;
+
+	for (bin = share->first_bin; bin < share->end_bin; bin++) {
+		u32 size = share->sizes[bin];
+
+		if (size > 1) {
+			share->result = sort_task(share->sorter, (struct task) {
+							.first_key = first_key,
+							.last_key = &first_key[size - 1],
+							.offset = 1,
+							.length = share->length,
+						  });
+			if (share->result != UDS_SUCCESS)
+				return;
+		}
+
+		first_key += size;
+	}
+}
+
+/*
+ * Sort pointers to fixed-length keys using several threads. The keys are first distributed into
+ * piles by their first byte, and then runs of adjacent piles with roughly equal numbers of keys
+ * are sorted concurrently. Sorts too small to benefit from the threads are done by the calling
+ * thread alone. Like uds_radix_sort(), this sort is unstable.
+ */
+int uds_parallel_radix_sort(struct parallel_radix_sorter *sorter, const unsigned char *keys[],
+			    unsigned int count, unsigned short length)
+{
+	struct task start;
+	struct histogram *bins = &sorter->bins;
+	sort_key_t *pile_start = keys;
+	unsigned int assigned = 0;
+	unsigned int bin = 0;
+	unsigned int i;
+	int result = UDS_SUCCESS;
+
+	if ((sorter->share_count == 1) || (count < PARALLEL_SORT_THRESHOLD) || (length < 2))
+		return uds_radix_sort(sorter->shares[0].sorter, keys, count, length);
+
+	if (count > sorter->count)
+		return UDS_INVALID_ARGUMENT;
+
+	start = (struct task) {
+		.first_key = keys,
+		.last_key = &keys[count - 1],
+		.offset = 0,
+		.length = length,
+	};
+
+	measure_bins(start, bins);
+	memcpy(sorter->size, bins->size, sizeof(sorter->size));
+	for (bin = 0; bin < 256; bin++) {
+		pile_start += bins->size[bin];
+		sorter->pile[bin] = pile_start;
+	}
+
+	bins->used = 0;
+	distribute_keys(start, bins, sorter->pile);
+
+	/* Divide the piles into shares of about the same number of keys. */
+	bin = 0;
+	for (i = 0; i < sorter->share_count; i++) {
+		struct sort_share *share = &sorter->shares[i];
+		unsigned int target = ((u64) count * (i + 1)) / sorter->share_count;
+
+		share->first_key = &keys[assigned];
+		share->sizes = sorter->size;
+		share->first_bin = bin;
+		share->length = length - 1;
+		share->result = UDS_SUCCESS;
+		share->thread = NULL;
+		while ((bin < 256) && (assigned < target))
+			assigned += sorter->size[bin++];
+
+		share->end_bin = bin;
+	}
+
+	/* Sort the first share on this thread, and do the rest of any share with no thread. */
+	for (i = 1; i < sorter->share_count; i++) {
+		struct sort_share *share = &sorter->shares[i];
+
+		if (share->first_bin == share->end_bin)
+			continue;
+
+		if (vdo_create_thread(sort_share, share, "radixsort", &share->thread) != VDO_SUCCESS)
+			share->thread = NULL;
+	}
+
+	sort_share(&sorter->shares[0]);
+	for (i = 0; i < sorter->share_count; i++) {
+		struct sort_share *share = &sorter->shares[i];
+
+		if (share->thread != NULL)
+			vdo_join_threads(share->thread);
+		else if ((i > 0) && (share->first_bin < share->end_bin))
+			sort_share(share);
+
+		if (result == UDS_SUCCESS)
+			result = share->result;
+	}
+
+	return result;
+}
@@ -19,12 +19,27 @@
  */
 
 struct radix_sorter;
+struct parallel_radix_sorter;
 
 int __must_check uds_make_radix_sorter(unsigned int count, struct radix_sorter **sorter);
 
+int __must_check uds_make_name_radix_sorter(unsigned int count, struct radix_sorter **sorter);
+
 void uds_free_radix_sorter(struct radix_sorter *sorter);
 
 int __must_check uds_radix_sort(struct radix_sorter *sorter, const unsigned char *keys[],
 				unsigned int count, unsigned short length);
 
+int __must_check uds_radix_sort_names(struct radix_sorter *sorter, const unsigned char *keys[],
+				      unsigned int count);
+
+int __must_check uds_make_parallel_radix_sorter(unsigned int count, unsigned int thread_count,
+						struct parallel_radix_sorter **sorter);
+
+void uds_free_parallel_radix_sorter(struct parallel_radix_sorter *sorter);
+
+int __must_check uds_parallel_radix_sort(struct parallel_radix_sorter *sorter,
+					 const unsigned char *keys[], unsigned int count,
+					 unsigned short length);
+
 #endif /* UDS_RADIX_SORT_H */
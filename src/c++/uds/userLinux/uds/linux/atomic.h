@@ -176,6 +176,17 @@ static inline void smp_mb__after_atomic(void)
 #endif
 }
 
+/**
+ * Read a value such that no later memory access is reordered before the read.
+ **/
+#define smp_load_acquire(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+
+/**
+ * Write a value such that no earlier memory access is reordered after the
+ * write.
+ **/
+#define smp_store_release(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
 /*****************************************************************************
  * Beginning of the methods for defeating compiler optimization.
  *****************************************************************************/
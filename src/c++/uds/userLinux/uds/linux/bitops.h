@@ -14,6 +14,7 @@
 #include <linux/bits.h> 
 #include <linux/compiler.h> 
 #include <linux/const.h>
+#include <linux/types.h>
 
 // From vdso/const.h
 #define UL(x)		(_UL(x))
@@ -64,6 +65,17 @@ static inline int test_bit(int nr, const volatile unsigned long *addr)
 	return 1UL & (addr[BIT_WORD(nr)] >> (nr & (BITS_PER_LONG-1)));
 }
 
+/**
+ * __ffs64 - find first set bit in a 64 bit word
+ * @word: The 64 bit word
+ *
+ * Undefined if no set bit exists, so code should check against 0 first.
+ **/
+static inline unsigned int __ffs64(u64 word)
+{
+	return __builtin_ctzll(word);
+}
+
 /**********************************************************************/
 unsigned long __must_check
 find_next_zero_bit(const unsigned long *addr,
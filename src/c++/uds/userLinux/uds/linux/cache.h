@@ -21,4 +21,6 @@
 #error "unknown cache line size"
 #endif
 
+#define ____cacheline_aligned __attribute__((__aligned__(L1_CACHE_BYTES)))
+
 #endif  /* __LINUX_CACHE_H */
@@ -67,6 +67,16 @@ int vdo_allocate_memory(size_t size, size_t align, const char *what, void *ptr)
 	return VDO_SUCCESS;
 }
 
+/**********************************************************************/
+int vdo_allocate_memory_on_node(size_t size,
+				size_t align,
+				int node __always_unused,
+				const char *what,
+				void *ptr)
+{
+	return vdo_allocate_memory(size, align, what, ptr);
+}
+
 /*
  * Allocate storage based on memory size, failing immediately if the required
  * memory is not available. The memory will be zeroed.
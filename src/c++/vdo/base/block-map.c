@@ -73,6 +73,8 @@ struct forest {
 	struct block_map *map;
 	size_t segments;
 	struct boundary *boundaries;
+	/* The number of logical zones; each segment has a separate page array for each zone */
+	zone_count_t zone_count;
 	struct tree_page **pages;
 	struct block_map_tree trees[];
 };
@@ -117,6 +119,16 @@ const struct block_map_entry UNMAPPED_BLOCK_MAP_ENTRY = {
 #define LOG_INTERVAL 4000
 #define DISPLAY_INTERVAL 100000
 
+/*
+ * Under the 2Q policy, the number of page gets after a page is loaded within which uses of it are
+ * assumed to be correlated with its loading. A sequential pass touches each leaf page once for
+ * each of its entries, with some interleaving from the next page.
+ */
+#define CORRELATED_GETS (2 * VDO_BLOCK_MAP_ENTRIES_PER_PAGE)
+
+/* The number of leaf pages a zone must fetch in order before it starts reading ahead. */
+#define READAHEAD_TRIGGER 2
+
 /*
  * For adjusting VDO page cache statistic fields which are only mutated on the logical zone thread.
  * Prevents any compiler shenanigans from affecting other threads reading those stats.
@@ -219,12 +231,14 @@ static int __must_check allocate_cache_components(struct vdo_page_cache *cache)
 	u64 size = cache->page_count * (u64) VDO_BLOCK_SIZE;
 	int result;
 
-	result = vdo_allocate(cache->page_count, struct page_info, "page infos",
-			      &cache->infos);
+	result = vdo_allocate_memory_on_node(cache->page_count * sizeof(struct page_info),
+					     __alignof__(struct page_info), cache->zone->node,
+					     "page infos", &cache->infos);
 	if (result != VDO_SUCCESS)
 		return result;
 
-	result = vdo_allocate_memory(size, VDO_BLOCK_SIZE, "cache pages", &cache->pages);
+	result = vdo_allocate_memory_on_node(size, VDO_BLOCK_SIZE, cache->zone->node,
+					     "cache pages", &cache->pages);
 	if (result != VDO_SUCCESS)
 		return result;
 
@@ -232,6 +246,24 @@ static int __must_check allocate_cache_components(struct vdo_page_cache *cache)
 	if (result != VDO_SUCCESS)
 		return result;
 
+	if (cache->use_2q) {
+		page_count_t i;
+
+		cache->probation_target = max_t(page_count_t, cache->page_count / 4, 1);
+		cache->ghost_capacity = max_t(page_count_t, cache->page_count / 2, 1);
+		result = vdo_allocate(cache->ghost_capacity, physical_block_number_t,
+				      "page cache ghosts", &cache->ghosts);
+		if (result != VDO_SUCCESS)
+			return result;
+
+		for (i = 0; i < cache->ghost_capacity; i++)
+			cache->ghosts[i] = NO_PAGE;
+
+		result = vdo_int_map_create(cache->ghost_capacity, &cache->ghost_map);
+		if (result != VDO_SUCCESS)
+			return result;
+	}
+
 	return initialize_info(cache);
 }
 
@@ -332,11 +364,88 @@ static void update_counter(struct page_info *info, s32 delta)
 	}
 }
 
-/** update_lru() - Update the lru information for an active page. */
+/** count_gets() - Get the (truncated) number of page gets the cache has handled. */
+static u32 count_gets(struct vdo_page_cache *cache)
+{
+	return cache->stats.read_count + cache->stats.write_count;
+}
+
+/**
+ * update_lru() - Update the lru information for an active page.
+ *
+ * Under the 2Q policy, probationary pages are kept in the order in which they were loaded. A
+ * probationary page is only promoted to the main list if it is used again well after it was
+ * loaded, since uses soon after loading are likely to be correlated (as when a scan touches every
+ * entry of a leaf page in turn).
+ */
 static void update_lru(struct page_info *info)
 {
-	if (info->cache->lru_list.prev != &info->lru_entry)
-		list_move_tail(&info->lru_entry, &info->cache->lru_list);
+	struct vdo_page_cache *cache = info->cache;
+
+	if (info->on_probation) {
+		if (list_empty(&info->lru_entry)) {
+			list_add_tail(&info->lru_entry, &cache->probation_list);
+			cache->probation_count++;
+			return;
+		}
+
+		if ((count_gets(cache) - info->load_stamp) <= CORRELATED_GETS)
+			return;
+
+		cache->probation_count--;
+		info->on_probation = false;
+	}
+
+	if (cache->lru_list.prev != &info->lru_entry)
+		list_move_tail(&info->lru_entry, &cache->lru_list);
+}
+
+/**
+ * remember_evicted_page() - Record the page number of a page evicted from probation in the ghost
+ *                           ring, forgetting the oldest entry if the ring is full.
+ */
+static void remember_evicted_page(struct vdo_page_cache *cache, physical_block_number_t pbn)
+{
+	physical_block_number_t *slot = &cache->ghosts[cache->next_ghost];
+
+	if ((*slot != NO_PAGE) && (vdo_int_map_get(cache->ghost_map, *slot) == slot))
+		vdo_int_map_remove(cache->ghost_map, *slot);
+
+	cache->next_ghost = (cache->next_ghost + 1) % cache->ghost_capacity;
+	*slot = pbn;
+	/* The map never holds more than its initial capacity, so this should not fail. */
+	if (vdo_int_map_put(cache->ghost_map, pbn, slot, true, NULL) != VDO_SUCCESS)
+		*slot = NO_PAGE;
+}
+
+/**
+ * was_recently_evicted() - Check whether a page being loaded was recently evicted from probation,
+ *                          and if so, forget that it was.
+ */
+static bool was_recently_evicted(struct vdo_page_cache *cache, physical_block_number_t pbn)
+{
+	physical_block_number_t *slot = vdo_int_map_remove(cache->ghost_map, pbn);
+
+	if (slot == NULL)
+		return false;
+
+	*slot = NO_PAGE;
+	ADD_ONCE(cache->stats.ghost_hits, 1);
+	return true;
+}
+
+/** remove_from_lru() - Remove a page from whichever replacement list it is on. */
+static void remove_from_lru(struct page_info *info)
+{
+	struct vdo_page_cache *cache = info->cache;
+
+	if (info->on_probation && !list_empty(&info->lru_entry)) {
+		cache->probation_count--;
+		remember_evicted_page(cache, info->pbn);
+	}
+
+	info->on_probation = false;
+	list_del_init(&info->lru_entry);
 }
 
 /**
@@ -408,9 +517,14 @@ static int reset_page_info(struct page_info *info)
 	if (result != VDO_SUCCESS)
 		return result;
 
+	if (info->readahead) {
+		info->readahead = false;
+		ADD_ONCE(info->cache->stats.readahead_wasted, 1);
+	}
+
+	remove_from_lru(info);
 	result = set_info_pbn(info, NO_PAGE);
 	set_info_state(info, PS_FREE);
-	list_del_init(&info->lru_entry);
 	return result;
 }
 
@@ -447,6 +561,18 @@ static struct page_info * __must_check find_page(struct vdo_page_cache *cache,
 	return cache->last_found;
 }
 
+/** select_first_evictable() - Find the first page on a replacement list which is evictable. */
+static struct page_info * __must_check select_first_evictable(struct list_head *list)
+{
+	struct page_info *info;
+
+	list_for_each_entry(info, list, lru_entry)
+		if ((info->busy == 0) && !is_in_flight(info))
+			return info;
+
+	return NULL;
+}
+
 /**
  * select_lru_page() - Determine which page is least recently used.
  *
@@ -454,6 +580,10 @@ static struct page_info * __must_check find_page(struct vdo_page_cache *cache,
  * list. Since whenever we mark a page busy we also put it to the end of the list it is unlikely
  * that the entries at the front are busy unless the queue is very short, but not impossible.
  *
+ * Under the 2Q policy, the oldest probationary page is chosen instead while the probation list is
+ * over its target size, so that pages which are only used once (as in a scan) can only displace
+ * each other.
+ *
  * Return: A pointer to the info structure for a relevant page, or NULL if no such page can be
  *         found. The page can be dirty or resident.
  */
@@ -461,11 +591,20 @@ static struct page_info * __must_check select_lru_page(struct vdo_page_cache *ca
 {
 	struct page_info *info;
 
-	list_for_each_entry(info, &cache->lru_list, lru_entry)
-		if ((info->busy == 0) && !is_in_flight(info))
+	if (!cache->use_2q)
+		return select_first_evictable(&cache->lru_list);
+
+	if (cache->probation_count > cache->probation_target) {
+		info = select_first_evictable(&cache->probation_list);
+		if (info != NULL)
 			return info;
+	}
 
-	return NULL;
+	info = select_first_evictable(&cache->lru_list);
+	if (info != NULL)
+		return info;
+
+	return select_first_evictable(&cache->probation_list);
 }
 
 /* ASYNCHRONOUS INTERFACE BEYOND THIS POINT */
@@ -625,6 +764,8 @@ static void check_for_drain_complete(struct block_map_zone *zone)
 	    (zone->active_lookups == 0) &&
 	    !vdo_waitq_has_waiters(&zone->flush_waiters) &&
 	    !is_vio_pool_busy(zone->vio_pool) &&
+	    ((zone->page_cache.tier_vio_pool == NULL) ||
+	     !is_vio_pool_busy(zone->page_cache.tier_vio_pool)) &&
 	    (zone->page_cache.outstanding_reads == 0) &&
 	    (zone->page_cache.outstanding_writes == 0)) {
 		vdo_finish_draining_with_result(&zone->state,
@@ -658,6 +799,8 @@ validate_completed_page_or_enter_read_only_mode(struct vdo_page_completion *comp
 	return false;
 }
 
+static void warm_up_pages(struct block_map_zone *zone);
+
 /**
  * handle_load_error() - Handle page load errors.
  * @completion: The page read vio.
@@ -672,6 +815,7 @@ static void handle_load_error(struct vdo_completion *completion)
 	vio_record_metadata_io_error(as_vio(completion));
 	vdo_enter_read_only_mode(cache->zone->block_map->vdo, result);
 	ADD_ONCE(cache->stats.failed_reads, 1);
+	cache->zone->warming_up = false;
 	set_info_state(info, PS_FAILED);
 	vdo_waitq_notify_all_waiters(&info->waiting, complete_waiter_with_error, &result);
 	reset_page_info(info);
@@ -684,6 +828,28 @@ static void handle_load_error(struct vdo_completion *completion)
 	check_for_drain_complete(cache->zone);
 }
 
+/**
+ * finish_page_load() - Make a page which has been loaded available to the completions waiting for
+ *                      it.
+ */
+static void finish_page_load(struct page_info *info)
+{
+	struct vdo_page_cache *cache = info->cache;
+
+	info->recovery_lock = 0;
+	set_info_state(info, PS_RESIDENT);
+	distribute_page_over_waitq(info, &info->waiting);
+
+	/*
+	 * Don't decrement until right before calling check_for_drain_complete() to
+	 * ensure that the above work can't cause the page cache to be freed out from under us.
+	 * Warming up will not start another read if the zone is draining.
+	 */
+	cache->outstanding_reads--;
+	warm_up_pages(cache->zone);
+	check_for_drain_complete(cache->zone);
+}
+
 /**
  * page_is_loaded() - Callback used when a page has been loaded.
  * @completion: The vio which has loaded the page. Its parent is the page_info.
@@ -714,16 +880,7 @@ static void page_is_loaded(struct vdo_completion *completion)
 	if (validity == VDO_BLOCK_MAP_PAGE_INVALID)
 		vdo_format_block_map_page(page, nonce, info->pbn, false);
 
-	info->recovery_lock = 0;
-	set_info_state(info, PS_RESIDENT);
-	distribute_page_over_waitq(info, &info->waiting);
-
-	/*
-	 * Don't decrement until right before calling check_for_drain_complete() to
-	 * ensure that the above work can't cause the page cache to be freed out from under us.
-	 */
-	cache->outstanding_reads--;
-	check_for_drain_complete(cache->zone);
+	finish_page_load(info);
 }
 
 /**
@@ -756,6 +913,261 @@ static void load_cache_page_endio(struct bio *bio)
 	continue_vio_after_io(vio, page_is_loaded, info->cache->zone->thread_id);
 }
 
+/** read_page_from_storage() - Read a page which is being loaded from the vdo's storage. */
+static void read_page_from_storage(struct page_info *info)
+{
+	vdo_action_fn callback = (info->cache->rebuilding ?
+				  handle_rebuild_read_error : handle_load_error);
+
+	vdo_submit_metadata_vio(info->vio, info->pbn, load_cache_page_endio,
+				callback, REQ_OP_READ | REQ_PRIO);
+}
+
+/*
+ * The block map cache device is an optional second level of the page cache on a separate fast
+ * device. Each zone owns an equal share of its blocks. A clean page which is evicted from the
+ * cache is copied to the block of the zone's share which was filled longest ago, and a page which
+ * is not in the cache is read from the cache device in preference to storage. A page is only held
+ * on the cache device while it is not in the cache, so it can not be modified while it is there,
+ * and it is dropped from the cache device when it is loaded. The location of each page is only
+ * kept in memory, so the cache device is empty each time the vdo is loaded. A page read from the
+ * cache device is served only if it is valid for its location and the vdo's nonce; otherwise, it
+ * is read from storage instead.
+ */
+
+/** release_tier_slot() - Forget the page, if any, held in a block of the cache device. */
+static void release_tier_slot(struct vdo_page_cache *cache, struct tier_slot *slot)
+{
+	if (slot->pbn != NO_PAGE)
+		vdo_int_map_remove(cache->tier_map, slot->pbn);
+
+	slot->pbn = NO_PAGE;
+	slot->valid = false;
+}
+
+static physical_block_number_t get_tier_block(struct vdo_page_cache *cache,
+					      struct tier_slot *slot)
+{
+	return cache->tier_origin + (slot - cache->tier_slots);
+}
+
+/** finish_tier_io() - Return a vio used for I/O to the cache device. */
+static void finish_tier_io(struct vdo_page_cache *cache, struct vio *vio)
+{
+	return_vio_to_pool(vio_as_pooled_vio(vio));
+	check_for_drain_complete(cache->zone);
+}
+
+/**
+ * page_is_read_from_tier() - Callback used when a page has been read from the cache device.
+ * @completion: The vio which read the page. Its parent is the tier slot which held the page.
+ */
+static void page_is_read_from_tier(struct vdo_completion *completion)
+{
+	struct vio *vio = as_vio(completion);
+	struct vdo_page_cache *cache = vio_as_pooled_vio(vio)->context;
+	struct tier_slot *slot = completion->parent;
+	struct page_info *info = find_page(cache, slot->pbn);
+	struct block_map_page *page = (struct block_map_page *) vio->data;
+	enum block_map_page_validity validity;
+
+	assert_on_cache_thread(cache, __func__);
+	slot->pbn = NO_PAGE;
+	slot->busy = false;
+
+	validity = vdo_validate_block_map_page(page, cache->zone->block_map->nonce, info->pbn);
+	if (validity != VDO_BLOCK_MAP_PAGE_VALID) {
+		ADD_ONCE(cache->stats.tier_pages_rejected, 1);
+		return_vio_to_pool(vio_as_pooled_vio(vio));
+		read_page_from_storage(info);
+		return;
+	}
+
+	memcpy(get_page_buffer(info), vio->data, VDO_BLOCK_SIZE);
+	ADD_ONCE(cache->stats.tier_pages_read, 1);
+	return_vio_to_pool(vio_as_pooled_vio(vio));
+	finish_page_load(info);
+}
+
+/**
+ * handle_tier_read_error() - Handle an error reading a page from the cache device by reading it
+ *                            from storage instead.
+ * @completion: The vio which read the page.
+ */
+static void handle_tier_read_error(struct vdo_completion *completion)
+{
+	struct vio *vio = as_vio(completion);
+	struct vdo_page_cache *cache = vio_as_pooled_vio(vio)->context;
+	struct tier_slot *slot = completion->parent;
+	struct page_info *info = find_page(cache, slot->pbn);
+
+	assert_on_cache_thread(cache, __func__);
+	vio_record_metadata_io_error(vio);
+	ADD_ONCE(cache->stats.tier_pages_rejected, 1);
+	slot->pbn = NO_PAGE;
+	slot->busy = false;
+	return_vio_to_pool(vio_as_pooled_vio(vio));
+	read_page_from_storage(info);
+}
+
+static void read_tier_page_endio(struct bio *bio)
+{
+	struct vio *vio = bio->bi_private;
+	struct vdo_page_cache *cache = vio_as_pooled_vio(vio)->context;
+
+	continue_vio_after_io(vio, page_is_read_from_tier, cache->zone->thread_id);
+}
+
+/**
+ * load_page_from_tier() - Start reading a page which is being loaded from the cache device, if the
+ *                         page is there.
+ *
+ * Return: true if the page is being read from the cache device.
+ */
+static bool load_page_from_tier(struct page_info *info)
+{
+	struct vdo_page_cache *cache = info->cache;
+	struct pooled_vio *pooled;
+	struct tier_slot *slot;
+
+	if (cache->tier_size == 0)
+		return false;
+
+	slot = vdo_int_map_get(cache->tier_map, info->pbn);
+	if (slot == NULL)
+		return false;
+
+	if (!slot->valid) {
+		/* The page is still being written, so drop it when the write finishes. */
+		release_tier_slot(cache, slot);
+		return false;
+	}
+
+	pooled = try_acquire_vio_from_pool(cache->tier_vio_pool);
+	if (pooled == NULL) {
+		release_tier_slot(cache, slot);
+		return false;
+	}
+
+	/* The slot keeps the page's pbn so that the read can find the page it is loading. */
+	vdo_int_map_remove(cache->tier_map, slot->pbn);
+	slot->valid = false;
+	slot->busy = true;
+	pooled->vio.completion.parent = slot;
+	vdo_submit_metadata_vio(&pooled->vio, get_tier_block(cache, slot), read_tier_page_endio,
+				handle_tier_read_error, REQ_OP_READ | REQ_PRIO);
+	return true;
+}
+
+/**
+ * page_is_written_to_tier() - Callback used when a page has been written to the cache device.
+ * @completion: The vio which wrote the page. Its parent is the tier slot holding the page.
+ */
+static void page_is_written_to_tier(struct vdo_completion *completion)
+{
+	struct vio *vio = as_vio(completion);
+	struct vdo_page_cache *cache = vio_as_pooled_vio(vio)->context;
+	struct tier_slot *slot = completion->parent;
+
+	assert_on_cache_thread(cache, __func__);
+	slot->busy = false;
+	/* The copy is useless if the page was loaded into the cache while it was being written. */
+	slot->valid = (slot->pbn != NO_PAGE);
+	finish_tier_io(cache, vio);
+}
+
+/**
+ * handle_tier_write_error() - Handle an error writing a page to the cache device.
+ * @completion: The vio which wrote the page.
+ */
+static void handle_tier_write_error(struct vdo_completion *completion)
+{
+	struct vio *vio = as_vio(completion);
+	struct vdo_page_cache *cache = vio_as_pooled_vio(vio)->context;
+	struct tier_slot *slot = completion->parent;
+
+	assert_on_cache_thread(cache, __func__);
+	vio_record_metadata_io_error(vio);
+	ADD_ONCE(cache->stats.tier_pages_rejected, 1);
+	slot->busy = false;
+	release_tier_slot(cache, slot);
+	finish_tier_io(cache, vio);
+}
+
+static void write_tier_page_endio(struct bio *bio)
+{
+	struct vio *vio = bio->bi_private;
+	struct vdo_page_cache *cache = vio_as_pooled_vio(vio)->context;
+
+	continue_vio_after_io(vio, page_is_written_to_tier, cache->zone->thread_id);
+}
+
+/**
+ * select_tier_slot() - Choose the block of the cache device to which to write an evicted page.
+ *
+ * Blocks are reused in the order in which they were filled, skipping those with I/O in progress.
+ *
+ * Return: The chosen slot, or NULL if every block has I/O in progress.
+ */
+static struct tier_slot *select_tier_slot(struct vdo_page_cache *cache)
+{
+	block_count_t i;
+
+	for (i = 0; i < cache->tier_size; i++) {
+		struct tier_slot *slot = &cache->tier_slots[cache->tier_hand];
+
+		cache->tier_hand = (cache->tier_hand + 1) % cache->tier_size;
+		if (!slot->busy)
+			return slot;
+	}
+
+	return NULL;
+}
+
+/**
+ * save_page_to_tier() - Copy a clean page which is about to be evicted to the cache device.
+ *
+ * The cache device is only a cache, so the page is simply not saved if no vio is available or the
+ * zone is not operating normally.
+ */
+static void save_page_to_tier(struct page_info *info)
+{
+	struct vdo_page_cache *cache = info->cache;
+	struct pooled_vio *pooled;
+	struct tier_slot *slot;
+	struct tier_slot *old_slot = NULL;
+	int result;
+
+	if ((cache->tier_size == 0) || (info->state != PS_RESIDENT) || cache->rebuilding ||
+	    !vdo_is_state_normal(&cache->zone->state) || vdo_is_read_only(cache->vdo))
+		return;
+
+	pooled = try_acquire_vio_from_pool(cache->tier_vio_pool);
+	if (pooled == NULL)
+		return;
+
+	slot = select_tier_slot(cache);
+	if (slot == NULL) {
+		return_vio_to_pool(pooled);
+		return;
+	}
+
+	release_tier_slot(cache, slot);
+	result = vdo_int_map_put(cache->tier_map, info->pbn, slot, false, (void **) &old_slot);
+	if ((result != VDO_SUCCESS) || (old_slot != NULL)) {
+		return_vio_to_pool(pooled);
+		return;
+	}
+
+	slot->pbn = info->pbn;
+	slot->busy = true;
+	memcpy(pooled->vio.data, get_page_buffer(info), VDO_BLOCK_SIZE);
+	ADD_ONCE(cache->stats.tier_pages_written, 1);
+	pooled->vio.completion.parent = slot;
+	vdo_submit_metadata_vio(&pooled->vio, get_tier_block(cache, slot), write_tier_page_endio,
+				handle_tier_write_error, REQ_OP_WRITE);
+}
+
 /**
  * launch_page_load() - Begin the process of loading a page.
  *
@@ -765,7 +1177,6 @@ static int __must_check launch_page_load(struct page_info *info,
 					 physical_block_number_t pbn)
 {
 	int result;
-	vdo_action_fn callback;
 	struct vdo_page_cache *cache = info->cache;
 
 	assert_io_allowed(cache);
@@ -778,12 +1189,15 @@ static int __must_check launch_page_load(struct page_info *info,
 	if (result != VDO_SUCCESS)
 		return result;
 
+	info->on_probation = (cache->use_2q && !was_recently_evicted(cache, pbn));
+
 	set_info_state(info, PS_INCOMING);
 	cache->outstanding_reads++;
 	ADD_ONCE(cache->stats.pages_loaded, 1);
-	callback = (cache->rebuilding ? handle_rebuild_read_error : handle_load_error);
-	vdo_submit_metadata_vio(info->vio, pbn, load_cache_page_endio,
-				callback, REQ_OP_READ | REQ_PRIO);
+	info->load_stamp = count_gets(cache);
+	if (!load_page_from_tier(info))
+		read_page_from_storage(info);
+
 	return VDO_SUCCESS;
 }
 
@@ -899,6 +1313,7 @@ static void allocate_free_page(struct page_info *info)
 		return;
 	}
 
+	save_page_to_tier(info);
 	result = reset_page_info(info);
 	if (result != VDO_SUCCESS) {
 		set_persistent_error(cache, "cannot reset page info", result);
@@ -996,18 +1411,11 @@ static bool write_has_finished(struct page_info *info)
 	return was_discard;
 }
 
-/**
- * handle_page_write_error() - Handler for page write errors.
- * @completion: The page write vio.
- */
-static void handle_page_write_error(struct vdo_completion *completion)
+/** fail_page_write() - Handle the failure of a write of a page. */
+static void fail_page_write(struct page_info *info, int result)
 {
-	int result = completion->result;
-	struct page_info *info = completion->parent;
 	struct vdo_page_cache *cache = info->cache;
 
-	vio_record_metadata_io_error(as_vio(completion));
-
 	/* If we're already read-only, write failures are to be expected. */
 	if (result != VDO_READ_ONLY) {
 #if __KERNEL__
@@ -1026,8 +1434,19 @@ static void handle_page_write_error(struct vdo_completion *completion)
 
 	if (!write_has_finished(info))
 		discard_page_if_needed(cache);
+}
 
-	check_for_drain_complete(cache->zone);
+/**
+ * handle_page_write_error() - Handler for page write errors.
+ * @completion: The page write vio.
+ */
+static void handle_page_write_error(struct vdo_completion *completion)
+{
+	struct page_info *info = completion->parent;
+
+	vio_record_metadata_io_error(as_vio(completion));
+	fail_page_write(info, completion->result);
+	check_for_drain_complete(info->cache->zone);
 }
 
 static void page_is_written_out(struct vdo_completion *completion);
@@ -1040,20 +1459,52 @@ static void write_cache_page_endio(struct bio *bio)
 	continue_vio_after_io(vio, page_is_written_out, info->cache->zone->thread_id);
 }
 
+/**
+ * complete_page_write() - Release a page's recovery journal lock once it has been written out, and
+ *                         make it available again.
+ */
+static void complete_page_write(struct page_info *info)
+{
+	bool was_discard, reclaimed;
+	u32 reclamations;
+	struct vdo_page_cache *cache = info->cache;
+
+	/* Handle journal updates and torn write protection. */
+	vdo_release_recovery_journal_block_reference(cache->zone->block_map->journal,
+						     info->recovery_lock,
+						     VDO_ZONE_TYPE_LOGICAL,
+						     cache->zone->zone_number);
+	info->recovery_lock = 0;
+	was_discard = write_has_finished(info);
+	reclaimed = (!was_discard || (info->busy > 0) || vdo_waitq_has_waiters(&info->waiting));
+
+	set_info_state(info, PS_RESIDENT);
+
+	reclamations = distribute_page_over_waitq(info, &info->waiting);
+	ADD_ONCE(cache->stats.reclaimed, reclamations);
+
+	if (was_discard)
+		cache->discard_count--;
+
+	if (reclaimed)
+		discard_page_if_needed(cache);
+	else
+		allocate_free_page(info);
+}
+
 /**
  * page_is_written_out() - Callback used when a page has been written out.
  * @completion: The vio which wrote the page. Its parent is a page_info.
  */
 static void page_is_written_out(struct vdo_completion *completion)
 {
-	bool was_discard, reclaimed;
-	u32 reclamations;
 	struct page_info *info = completion->parent;
 	struct vdo_page_cache *cache = info->cache;
 	struct block_map_page *page = (struct block_map_page *) get_page_buffer(info);
 
 	if (!page->header.initialized) {
 		page->header.initialized = true;
+		ADD_ONCE(cache->stats.writes_issued, 1);
 		vdo_submit_metadata_vio(info->vio, info->pbn,
 					write_cache_page_endio,
 					handle_page_write_error,
@@ -1061,29 +1512,206 @@ static void page_is_written_out(struct vdo_completion *completion)
 		return;
 	}
 
-	/* Handle journal updates and torn write protection. */
-	vdo_release_recovery_journal_block_reference(cache->zone->block_map->journal,
-						     info->recovery_lock,
-						     VDO_ZONE_TYPE_LOGICAL,
-						     cache->zone->zone_number);
-	info->recovery_lock = 0;
-	was_discard = write_has_finished(info);
-	reclaimed = (!was_discard || (info->busy > 0) || vdo_waitq_has_waiters(&info->waiting));
-
-	set_info_state(info, PS_RESIDENT);
+	complete_page_write(info);
+	check_for_drain_complete(cache->zone);
+}
+
+/**
+ * get_combinable_page() - Get the page with a given PBN if it is on the write list and may be
+ *                         written together with other pages.
+ *
+ * Pages which have never been initialized are excluded since they need to be written twice.
+ */
+static struct page_info *get_combinable_page(struct vdo_page_cache *cache,
+					     physical_block_number_t pbn)
+{
+	struct page_info *info = vdo_int_map_get(cache->page_map, pbn);
+
+	if ((info == NULL) || !info->on_write_list)
+		return NULL;
+
+	if (!((struct block_map_page *) get_page_buffer(info))->header.initialized)
+		return NULL;
+
+	return info;
+}
+
+/**
+ * find_page_run() - Find a run of pages on the write list with consecutive PBNs which includes a
+ *                   given page, if possible.
+ * @info: The page to start from.
+ * @infos: An array to hold the pages of the run, in PBN order.
+ *
+ * A run is at most BLOCK_MAP_MAX_PAGES_PER_WRITE pages long, so if a very long run includes the
+ * given page, the run found may start at an earlier page and not reach it.
+ *
+ * Return: The number of pages in the run.
+ */
+static page_count_t find_page_run(struct page_info *info, struct page_info **infos)
+{
+	struct vdo_page_cache *cache = info->cache;
+	struct page_info *previous;
+	page_count_t count;
+
+	infos[0] = info;
+	if (get_combinable_page(cache, info->pbn) == NULL)
+		return 1;
+
+	while ((previous = get_combinable_page(cache, infos[0]->pbn - 1)) != NULL)
+		infos[0] = previous;
+
+	for (count = 1; count < BLOCK_MAP_MAX_PAGES_PER_WRITE; count++) {
+		infos[count] = get_combinable_page(cache, infos[0]->pbn + count);
+		if (infos[count] == NULL)
+			break;
+	}
+
+	return count;
+}
+
+/** take_from_write_list() - Remove a page from the write list because it is being written. */
+static void take_from_write_list(struct page_info *info)
+{
+	info->on_write_list = false;
+	list_del_init(&info->state_entry);
+}
+
+/**
+ * get_page_run() - Get the pages written by a multi-page write from the page map.
+ * @vio: The vio which wrote the pages. Its parent is the first page.
+ * @infos: An array to hold the pages.
+ *
+ * Return: The number of pages written.
+ */
+static page_count_t get_page_run(struct vio *vio, struct page_info **infos)
+{
+	struct page_info *first = vio->completion.parent;
+	page_count_t count = vio->io_size / VDO_BLOCK_SIZE;
+	page_count_t i;
+
+	for (i = 0; i < count; i++)
+		infos[i] = vdo_int_map_get(first->cache->page_map, first->pbn + i);
+
+	return count;
+}
+
+static void write_listed_pages(struct vdo_page_cache *cache);
+
+/** finish_page_run_write() - Return a multi-page write vio and continue writing pages. */
+static void finish_page_run_write(struct vdo_page_cache *cache, struct vio *vio)
+{
+	return_vio_to_pool(vio_as_pooled_vio(vio));
+	write_listed_pages(cache);
+	check_for_drain_complete(cache->zone);
+}
+
+/**
+ * page_run_is_written_out() - Callback used when a run of pages has been written out.
+ * @completion: The vio which wrote the pages. Its parent is the first page_info of the run.
+ */
+static void page_run_is_written_out(struct vdo_completion *completion)
+{
+	struct page_info *infos[BLOCK_MAP_MAX_PAGES_PER_WRITE];
+	struct vio *vio = as_vio(completion);
+	struct vdo_page_cache *cache = ((struct page_info *) completion->parent)->cache;
+	page_count_t count = get_page_run(vio, infos);
+	page_count_t i;
+
+	for (i = 0; i < count; i++)
+		complete_page_write(infos[i]);
+
+	finish_page_run_write(cache, vio);
+}
+
+/**
+ * handle_page_run_write_error() - Handler for errors writing a run of pages.
+ * @completion: The vio which wrote the pages.
+ */
+static void handle_page_run_write_error(struct vdo_completion *completion)
+{
+	struct page_info *infos[BLOCK_MAP_MAX_PAGES_PER_WRITE];
+	int result = completion->result;
+	struct vio *vio = as_vio(completion);
+	struct vdo_page_cache *cache = ((struct page_info *) completion->parent)->cache;
+	page_count_t count = get_page_run(vio, infos);
+	page_count_t i;
+
+	vio_record_metadata_io_error(vio);
+	for (i = 0; i < count; i++)
+		fail_page_write(infos[i], result);
+
+	finish_page_run_write(cache, vio);
+}
+
+static void write_page_run_endio(struct bio *bio)
+{
+	struct vio *vio = bio->bi_private;
+	struct page_info *info = vio->completion.parent;
+
+	continue_vio_after_io(vio, page_run_is_written_out, info->cache->zone->thread_id);
+}
+
+/**
+ * write_page_run() - Copy the run of pages which includes the first page on the write list into a
+ *                    multi-block vio and write them out together.
+ *
+ * Implements waiter_callback_fn.
+ */
+static void write_page_run(struct vdo_waiter *waiter, void *context)
+{
+	struct page_info *infos[BLOCK_MAP_MAX_PAGES_PER_WRITE];
+	struct pooled_vio *pooled = context;
+	struct vdo_page_cache *cache = container_of(waiter, struct vdo_page_cache, write_waiter);
+	struct page_info *info = list_first_entry_or_null(&cache->write_list, struct page_info,
+							  state_entry);
+	page_count_t count;
+	page_count_t i;
+
+	if (info == NULL) {
+		return_vio_to_pool(pooled);
+		return;
+	}
+
+	count = find_page_run(info, infos);
+	for (i = 0; i < count; i++) {
+		memcpy(pooled->vio.data + (i * VDO_BLOCK_SIZE), get_page_buffer(infos[i]),
+		       VDO_BLOCK_SIZE);
+		take_from_write_list(infos[i]);
+	}
 
-	reclamations = distribute_page_over_waitq(info, &info->waiting);
-	ADD_ONCE(cache->stats.reclaimed, reclamations);
+	ADD_ONCE(cache->stats.pages_saved, count);
+	ADD_ONCE(cache->stats.writes_issued, 1);
+	pooled->vio.completion.parent = infos[0];
+	vdo_submit_metadata_vio_with_size(&pooled->vio, infos[0]->pbn, write_page_run_endio,
+					  handle_page_run_write_error, REQ_OP_WRITE | REQ_PRIO,
+					  count * VDO_BLOCK_SIZE);
+}
 
-	if (was_discard)
-		cache->discard_count--;
+/**
+ * write_listed_pages() - Write out the pages on the write list.
+ *
+ * Pages with consecutive PBNs are copied into a multi-block vio and written together. If no such
+ * vio is available, the rest of the list waits for one, so that runs are not broken up.
+ */
+static void write_listed_pages(struct vdo_page_cache *cache)
+{
+	while (!list_empty(&cache->write_list) &&
+	       !vdo_waiter_is_waiting(&cache->write_waiter)) {
+		struct page_info *infos[BLOCK_MAP_MAX_PAGES_PER_WRITE];
+		struct page_info *info = list_first_entry(&cache->write_list, struct page_info,
+							  state_entry);
 
-	if (reclaimed)
-		discard_page_if_needed(cache);
-	else
-		allocate_free_page(info);
+		if (find_page_run(info, infos) > 1) {
+			acquire_vio_from_pool(cache->write_vio_pool, &cache->write_waiter);
+			continue;
+		}
 
-	check_for_drain_complete(cache->zone);
+		take_from_write_list(info);
+		ADD_ONCE(cache->stats.pages_saved, 1);
+		ADD_ONCE(cache->stats.writes_issued, 1);
+		vdo_submit_metadata_vio(info->vio, info->pbn, write_cache_page_endio,
+					handle_page_write_error, REQ_OP_WRITE | REQ_PRIO);
+	}
 }
 
 /**
@@ -1104,6 +1732,7 @@ static void write_pages(struct vdo_completion *flush_completion)
 	 */
 	bool has_unflushed_pages = (cache->pages_to_flush > 0);
 	page_count_t pages_in_flush = cache->pages_in_flush;
+	page_count_t pages_listed = 0;
 
 	cache->pages_in_flush = 0;
 	while (pages_in_flush-- > 0) {
@@ -1121,11 +1750,16 @@ static void write_pages(struct vdo_completion *flush_completion)
 			vdo_fail_completion(completion, VDO_READ_ONLY);
 			continue;
 		}
-		ADD_ONCE(info->cache->stats.pages_saved, 1);
-		vdo_submit_metadata_vio(info->vio, info->pbn, write_cache_page_endio,
-					handle_page_write_error, REQ_OP_WRITE | REQ_PRIO);
+
+		info->on_write_list = true;
+		list_add_tail(&info->state_entry, &cache->write_list);
+		pages_listed++;
 	}
 
+	/* The listed pages are still outstanding writes, so the cache can't have been freed. */
+	if (pages_listed > 0)
+		write_listed_pages(cache);
+
 	if (has_unflushed_pages) {
 		/*
 		 * If there are unflushed pages, the cache can't have been freed, so this call is
@@ -1247,6 +1881,11 @@ void vdo_get_page(struct vdo_page_completion *page_completion,
 	info = find_page(cache, page_completion->pbn);
 	if (info != NULL) {
 		/* The page is in the cache already. */
+		if (info->readahead) {
+			info->readahead = false;
+			ADD_ONCE(cache->stats.readahead_used, 1);
+		}
+
 		if ((info->write_status == WRITE_STATUS_DEFERRED) ||
 		    is_incoming(info) ||
 		    (is_outgoing(info) && page_completion->writable)) {
@@ -1284,6 +1923,147 @@ void vdo_get_page(struct vdo_page_completion *page_completion,
 	discard_page_for_completion(page_completion);
 }
 
+/**
+ * read_ahead_page() - Start loading a page which is likely to be needed soon.
+ *
+ * Readahead is only speculative, so it will only use a free page or a clean page which could be
+ * evicted immediately, and will not compete with requests which are waiting for a free page.
+ */
+static void read_ahead_page(struct vdo_page_cache *cache, physical_block_number_t pbn)
+{
+	int result;
+	struct page_info *info;
+
+	assert_on_cache_thread(cache, __func__);
+
+	if ((cache->waiter_count > 0) || (find_page(cache, pbn) != NULL))
+		return;
+
+	info = find_free_page(cache);
+	if (info == NULL) {
+		info = select_lru_page(cache);
+		if ((info == NULL) || is_dirty(info))
+			return;
+
+		save_page_to_tier(info);
+		result = reset_page_info(info);
+		if (result != VDO_SUCCESS) {
+			set_persistent_error(cache, "cannot reset page info", result);
+			return;
+		}
+
+		list_del_init(&info->state_entry);
+	}
+
+	info->readahead = true;
+	ADD_ONCE(cache->stats.readahead_pages, 1);
+	result = launch_page_load(info, pbn);
+	if (result != VDO_SUCCESS)
+		set_persistent_error(cache, "cannot read ahead", result);
+}
+
+/**
+ * warm_up_pages() - Load the next pages of the block map's hot page list which belong to a zone.
+ *
+ * Like readahead, warming up only fills free pages, so it stops once the cache is full. It also
+ * limits the reads outstanding so that requests which need pages are not stuck behind it.
+ */
+static void warm_up_pages(struct block_map_zone *zone)
+{
+	struct vdo_page_cache *cache = &zone->page_cache;
+	const struct hot_page_list *list = &zone->block_map->hot_pages;
+	struct slab_depot *depot = zone->block_map->vdo->depot;
+
+	while (zone->warming_up && vdo_is_state_normal(&zone->state) &&
+	       (cache->outstanding_reads < BLOCK_MAP_WARMUP_READS)) {
+		const struct hot_page_run *run;
+		physical_block_number_t pbn;
+		struct page_info *info;
+		int result;
+
+		if (zone->warmup_run == list->run_count) {
+			zone->warming_up = false;
+			return;
+		}
+
+		run = &list->runs[zone->warmup_run];
+		if ((run->zone != zone->zone_number) || (zone->warmup_page == run->page_count)) {
+			zone->warmup_run++;
+			zone->warmup_page = 0;
+			continue;
+		}
+
+		pbn = run->pbn + zone->warmup_page++;
+		if ((pbn == VDO_ZERO_BLOCK) || !vdo_is_physical_data_block(depot, pbn) ||
+		    (find_page(cache, pbn) != NULL))
+			continue;
+
+		info = find_free_page(cache);
+		if (info == NULL) {
+			zone->warming_up = false;
+			return;
+		}
+
+		ADD_ONCE(cache->stats.warmup_pages, 1);
+		result = launch_page_load(info, pbn);
+		if (result != VDO_SUCCESS) {
+			zone->warming_up = false;
+			set_persistent_error(cache, "cannot warm up cache", result);
+			return;
+		}
+	}
+}
+
+/**
+ * record_hot_pages() - Record the runs of pages with consecutive PBNs in a zone's cache, so that
+ *                      the cache can be warmed up when the vdo is next loaded.
+ *
+ * Each run is found from its first page, and the runs are recorded in order of how recently that
+ * page was used, so that if there are more runs than the zone's share of the list, the coldest
+ * ones are dropped.
+ */
+static void record_hot_pages(struct block_map_zone *zone)
+{
+	struct vdo_page_cache *cache = &zone->page_cache;
+	struct list_head *lists[] = { &cache->lru_list, &cache->probation_list };
+	u16 capacity = VDO_MAX_HOT_PAGE_RUNS / zone->block_map->zone_count;
+	unsigned int i;
+
+	zone->hot_run_count = 0;
+	for (i = 0; i < ARRAY_SIZE(lists); i++) {
+		struct page_info *info;
+
+		list_for_each_entry_reverse(info, lists[i], lru_entry) {
+			struct page_info *neighbor;
+			page_count_t count = 1;
+
+			if (zone->hot_run_count == capacity)
+				return;
+
+			if (!is_valid(info))
+				continue;
+
+			neighbor = find_page(cache, info->pbn - 1);
+			if ((neighbor != NULL) && is_valid(neighbor))
+				continue;
+
+			while (count < U16_MAX) {
+				neighbor = find_page(cache, info->pbn + count);
+				if ((neighbor == NULL) || !is_valid(neighbor))
+					break;
+
+				count++;
+			}
+
+			zone->hot_runs[zone->hot_run_count++] = (struct hot_page_run) {
+				.pbn = info->pbn,
+				.page_count = count,
+				.zone = zone->zone_number,
+			};
+		}
+	}
+}
+
 /**
  * vdo_request_page_write() - Request that a VDO page be written out as soon as it is not busy.
  * @completion: The vdo_page_completion containing the page.
@@ -1332,20 +2112,34 @@ int vdo_get_cached_page(struct vdo_completion *completion,
 int vdo_invalidate_page_cache(struct vdo_page_cache *cache)
 {
 	struct page_info *info;
+	struct tier_slot *slot;
+	int result;
 
 	assert_on_cache_thread(cache, __func__);
 
 	/* Make sure we don't throw away any dirty pages. */
 	for (info = cache->infos; info < cache->infos + cache->page_count; info++) {
-		int result = VDO_ASSERT(!is_dirty(info), "cache must have no dirty pages");
-
+		result = VDO_ASSERT(!is_dirty(info), "cache must have no dirty pages");
 		if (result != VDO_SUCCESS)
 			return result;
 	}
 
 	/* Reset the page map by re-allocating it. */
 	vdo_int_map_free(vdo_forget(cache->page_map));
-	return vdo_int_map_create(cache->page_count, &cache->page_map);
+	result = vdo_int_map_create(cache->page_count, &cache->page_map);
+	if ((result != VDO_SUCCESS) || (cache->tier_size == 0))
+		return result;
+
+	/*
+	 * Forget the pages on the cache device as well; any which are still being written will be
+	 * dropped when the write finishes. Slots being read are not in the map.
+	 */
+	for (slot = cache->tier_slots; slot < cache->tier_slots + cache->tier_size; slot++) {
+		if ((slot->pbn != NO_PAGE) && (vdo_int_map_get(cache->tier_map, slot->pbn) == slot))
+			release_tier_slot(cache, slot);
+	}
+
+	return VDO_SUCCESS;
 }
 
 /**
@@ -2336,38 +3130,38 @@ void vdo_write_tree_page(struct tree_page *page, struct block_map_zone *zone)
 	enqueue_page(page, zone);
 }
 
-static int make_segment(struct forest *old_forest, block_count_t new_pages,
-			struct boundary *new_boundary, struct forest *forest)
+static int make_segment(struct forest *old_forest, struct boundary *new_boundary,
+			struct forest *forest)
 {
 	size_t index = (old_forest == NULL) ? 0 : old_forest->segments;
-	struct tree_page *page_ptr;
+	struct vdo *vdo = forest->map->vdo;
+	struct tree_page *page_ptrs[MAX_VDO_LOGICAL_ZONES];
+	struct tree_page **segment_pages;
 	page_count_t segment_sizes[VDO_BLOCK_MAP_TREE_HEIGHT];
+	page_count_t tree_pages = 0;
 	height_t height;
 	root_count_t root;
+	zone_count_t zone;
 	int result;
 
 	forest->segments = index + 1;
+	forest->zone_count = vdo->thread_config.logical_zone_count;
 
 	result = vdo_allocate(forest->segments, struct boundary,
 			      "forest boundary array", &forest->boundaries);
 	if (result != VDO_SUCCESS)
 		return result;
 
-	result = vdo_allocate(forest->segments, struct tree_page *,
+	result = vdo_allocate(forest->segments * forest->zone_count, struct tree_page *,
 			      "forest page pointers", &forest->pages);
 	if (result != VDO_SUCCESS)
 		return result;
 
-	result = vdo_allocate(new_pages, struct tree_page,
-			      "new forest pages", &forest->pages[index]);
-	if (result != VDO_SUCCESS)
-		return result;
-
 	if (index > 0) {
 		memcpy(forest->boundaries, old_forest->boundaries,
 		       index * sizeof(struct boundary));
 		memcpy(forest->pages, old_forest->pages,
-		       index * sizeof(struct tree_page *));
+		       index * forest->zone_count * sizeof(struct tree_page *));
 	}
 
 	memcpy(&(forest->boundaries[index]), new_boundary, sizeof(struct boundary));
@@ -2376,12 +3170,30 @@ static int make_segment(struct forest *old_forest, block_count_t new_pages,
 		segment_sizes[height] = new_boundary->levels[height];
 		if (index > 0)
 			segment_sizes[height] -= old_forest->boundaries[index - 1].levels[height];
+		tree_pages += segment_sizes[height];
+	}
+
+	/* The pages of each tree live on the node of the zone which owns that tree. */
+	segment_pages = &forest->pages[index * forest->zone_count];
+	for (zone = 0; zone < forest->zone_count; zone++) {
+		root_count_t zone_roots = ((forest->map->root_count - zone + forest->zone_count - 1) /
+					   forest->zone_count);
+
+		result = vdo_allocate_memory_on_node(((size_t) zone_roots * tree_pages *
+						      sizeof(struct tree_page)),
+						     __alignof__(struct tree_page),
+						     vdo->thread_config.logical_nodes[zone],
+						     "new forest pages", &segment_pages[zone]);
+		if (result != VDO_SUCCESS)
+			return result;
+
+		page_ptrs[zone] = segment_pages[zone];
 	}
 
-	page_ptr = forest->pages[index];
 	for (root = 0; root < forest->map->root_count; root++) {
 		struct block_map_tree_segment *segment;
 		struct block_map_tree *tree = &(forest->trees[root]);
+		struct tree_page **page_ptr = &page_ptrs[root % forest->zone_count];
 		height_t height;
 
 		int result = vdo_allocate(forest->segments,
@@ -2400,18 +3212,18 @@ static int make_segment(struct forest *old_forest, block_count_t new_pages,
 			if (segment_sizes[height] == 0)
 				continue;
 
-			segment->levels[height] = page_ptr;
+			segment->levels[height] = *page_ptr;
 			if (height == (VDO_BLOCK_MAP_TREE_HEIGHT - 1)) {
 				/* Record the root. */
 				struct block_map_page *page =
-					vdo_format_block_map_page(page_ptr->page_buffer,
+					vdo_format_block_map_page((*page_ptr)->page_buffer,
 								  forest->map->nonce,
 								  VDO_INVALID_PBN, true);
 				page->entries[0] =
 					vdo_pack_block_map_entry(forest->map->root_origin + root,
 								 VDO_MAPPING_STATE_UNCOMPRESSED);
 			}
-			page_ptr += segment_sizes[height];
+			*page_ptr += segment_sizes[height];
 		}
 	}
 
@@ -2425,7 +3237,9 @@ static void deforest(struct forest *forest, size_t first_page_segment)
 	if (forest->pages != NULL) {
 		size_t segment;
 
-		for (segment = first_page_segment; segment < forest->segments; segment++)
+		for (segment = first_page_segment * forest->zone_count;
+		     segment < forest->segments * forest->zone_count;
+		     segment++)
 			vdo_free(forest->pages[segment]);
 		vdo_free(forest->pages);
 	}
@@ -2468,7 +3282,7 @@ static int make_forest(struct block_map *map, block_count_t entries)
 		return result;
 
 	forest->map = map;
-	result = make_segment(old_forest, new_pages, &new_boundary, forest);
+	result = make_segment(old_forest, &new_boundary, forest);
 	if (result != VDO_SUCCESS) {
 		deforest(forest, forest->segments - 1);
 		return result;
@@ -2715,6 +3529,41 @@ void vdo_traverse_forest(struct block_map *map, vdo_entry_callback_fn callback,
  * @maximum_age: The number of journal blocks before a dirtied page is considered old and must be
  *               written out.
  */
+/**
+ * initialize_tier() - Set up a zone's share of the block map cache device, if the vdo has one.
+ *
+ * Return: VDO_SUCCESS or an error code.
+ */
+static int __must_check initialize_tier(struct vdo_page_cache *cache)
+{
+	struct block_map_zone *zone = cache->zone;
+	block_count_t i;
+	int result;
+
+	cache->tier_size = (cache->vdo->device_config->block_map_tier_blocks /
+			    zone->block_map->zone_count);
+	if (cache->tier_size == 0)
+		return VDO_SUCCESS;
+
+	cache->tier_origin = cache->tier_size * zone->zone_number;
+	result = vdo_allocate_memory_on_node(cache->tier_size * sizeof(struct tier_slot),
+					     __alignof__(struct tier_slot), zone->node,
+					     "block map tier slots", &cache->tier_slots);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	for (i = 0; i < cache->tier_size; i++)
+		cache->tier_slots[i].pbn = NO_PAGE;
+
+	result = vdo_int_map_create(cache->tier_size, &cache->tier_map);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	return make_vio_pool(cache->vdo, BLOCK_MAP_TIER_VIO_POOL_SIZE, 1, zone->thread_id,
+			     VIO_TYPE_BLOCK_MAP_TIER, VIO_PRIORITY_METADATA, cache,
+			     &cache->tier_vio_pool);
+}
+
 static int __must_check initialize_block_map_zone(struct block_map *map,
 						  zone_count_t zone_number,
 						  page_count_t cache_size,
@@ -2729,6 +3578,7 @@ static int __must_check initialize_block_map_zone(struct block_map *map,
 
 	zone->zone_number = zone_number;
 	zone->thread_id = vdo->thread_config.logical_threads[zone_number];
+	zone->node = vdo->thread_config.logical_nodes[zone_number];
 	zone->block_map = map;
 
 	result = vdo_allocate_extended(struct dirty_lists, maximum_age,
@@ -2762,14 +3612,37 @@ static int __must_check initialize_block_map_zone(struct block_map *map,
 	zone->page_cache.vdo = vdo;
 	zone->page_cache.page_count = cache_size / map->zone_count;
 	zone->page_cache.stats.free_pages = zone->page_cache.page_count;
+	zone->page_cache.use_2q = vdo->device_config->block_map_cache_2q;
+	zone->readahead = min_t(page_count_t, vdo->device_config->block_map_readahead,
+				zone->page_cache.page_count / 4);
+
+	result = vdo_allocate(VDO_MAX_HOT_PAGE_RUNS / map->zone_count, struct hot_page_run,
+			      __func__, &zone->hot_runs);
+	if (result != VDO_SUCCESS)
+		return result;
 
 	result = allocate_cache_components(&zone->page_cache);
 	if (result != VDO_SUCCESS)
 		return result;
 
+	result = make_vio_pool(vdo, BLOCK_MAP_WRITE_VIO_POOL_SIZE,
+			       BLOCK_MAP_MAX_PAGES_PER_WRITE, zone->thread_id,
+			       VIO_TYPE_BLOCK_MAP, VIO_PRIORITY_METADATA, NULL,
+			       &zone->page_cache.write_vio_pool);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	zone->page_cache.write_waiter.callback = write_page_run;
+
+	result = initialize_tier(&zone->page_cache);
+	if (result != VDO_SUCCESS)
+		return result;
+
 	/* initialize empty circular queues */
 	INIT_LIST_HEAD(&zone->page_cache.lru_list);
+	INIT_LIST_HEAD(&zone->page_cache.probation_list);
 	INIT_LIST_HEAD(&zone->page_cache.outgoing_list);
+	INIT_LIST_HEAD(&zone->page_cache.write_list);
 
 	return VDO_SUCCESS;
 }
@@ -2825,8 +3698,13 @@ static void uninitialize_block_map_zone(struct block_map_zone *zone)
 	struct vdo_page_cache *cache = &zone->page_cache;
 
 	vdo_free(vdo_forget(zone->dirty_lists));
+	vdo_free(vdo_forget(zone->hot_runs));
 	free_vio_pool(vdo_forget(zone->vio_pool));
 	vdo_int_map_free(vdo_forget(zone->loading_pages));
+	free_vio_pool(vdo_forget(cache->write_vio_pool));
+	free_vio_pool(vdo_forget(cache->tier_vio_pool));
+	vdo_int_map_free(vdo_forget(cache->tier_map));
+	vdo_free(vdo_forget(cache->tier_slots));
 	if (cache->infos != NULL) {
 		struct page_info *info;
 
@@ -2835,6 +3713,8 @@ static void uninitialize_block_map_zone(struct block_map_zone *zone)
 	}
 
 	vdo_int_map_free(vdo_forget(cache->page_map));
+	vdo_int_map_free(vdo_forget(cache->ghost_map));
+	vdo_free(vdo_forget(cache->ghosts));
 	vdo_free(vdo_forget(cache->infos));
 	vdo_free(vdo_forget(cache->pages));
 }
@@ -2976,6 +3856,10 @@ static void initiate_drain(struct admin_state *state)
 	VDO_ASSERT_LOG_ONLY((zone->active_lookups == 0),
 			    "%s() called with no active lookups", __func__);
 
+	zone->warming_up = false;
+	if (vdo_is_state_saving(state))
+		record_hot_pages(zone);
+
 	if (!vdo_is_state_suspending(state)) {
 		while (zone->dirty_lists->oldest_period < zone->dirty_lists->next_period)
 			expire_oldest_list(zone->dirty_lists);
@@ -2997,11 +3881,39 @@ static void drain_zone(void *context, zone_count_t zone_number,
 			   parent, initiate_drain);
 }
 
+/*
+ * Collect the runs of pages each zone recorded when it was saved, to be written out with the super
+ * block.
+ *
+ * Implements vdo_action_conclusion_fn.
+ */
+static int gather_hot_pages(void *context)
+{
+	struct block_map *map = context;
+	struct hot_page_list *list = &map->hot_pages;
+	zone_count_t z;
+
+	if (vdo_get_current_manager_operation(map->action_manager) != VDO_ADMIN_STATE_SAVING)
+		return VDO_SUCCESS;
+
+	list->zone_count = map->zone_count;
+	list->run_count = 0;
+	for (z = 0; z < map->zone_count; z++) {
+		struct block_map_zone *zone = &map->zones[z];
+
+		memcpy(&list->runs[list->run_count], zone->hot_runs,
+		       zone->hot_run_count * sizeof(struct hot_page_run));
+		list->run_count += zone->hot_run_count;
+	}
+
+	return VDO_SUCCESS;
+}
+
 void vdo_drain_block_map(struct block_map *map, const struct admin_state_code *operation,
 			 struct vdo_completion *parent)
 {
-	vdo_schedule_operation(map->action_manager, operation, NULL, drain_zone, NULL,
-			       parent);
+	vdo_schedule_operation(map->action_manager, operation, NULL, drain_zone,
+			       gather_hot_pages, parent);
 }
 
 /* Implements vdo_zone_action_fn. */
@@ -3020,6 +3932,61 @@ void vdo_resume_block_map(struct block_map *map, struct vdo_completion *parent)
 			       NULL, resume_block_map_zone, NULL, parent);
 }
 
+/* Implements vdo_zone_action_fn. */
+static void start_zone_warmup(void *context, zone_count_t zone_number,
+			      struct vdo_completion *parent)
+{
+	struct block_map *map = context;
+	struct block_map_zone *zone = &map->zones[zone_number];
+
+	zone->warming_up = true;
+	zone->warmup_run = 0;
+	zone->warmup_page = 0;
+	warm_up_pages(zone);
+	vdo_finish_completion(parent);
+}
+
+/* Implements vdo_zone_action_fn. */
+static void cancel_zone_warmup(void *context, zone_count_t zone_number,
+			       struct vdo_completion *parent)
+{
+	struct block_map *map = context;
+
+	map->zones[zone_number].warming_up = false;
+	vdo_finish_completion(parent);
+}
+
+/**
+ * vdo_warm_up_block_map() - Start or cancel loading the pages of the hot page list into the cache.
+ * @map: The block map.
+ * @start: Whether to start warming up the cache rather than cancel a warm-up in progress.
+ * @parent: The completion to notify once each zone has started or stopped; may be NULL.
+ *
+ * Must be called on the journal thread. Each zone warms up asynchronously until it has loaded its
+ * pages from the list, its cache is full, or it is drained.
+ */
+void vdo_warm_up_block_map(struct block_map *map, bool start, struct vdo_completion *parent)
+{
+	struct hot_page_list *list = &map->hot_pages;
+
+	if (start && (list->zone_count != map->zone_count)) {
+		if (list->run_count > 0) {
+			vdo_log_info("not warming up block map cache: pages were recorded with %u logical zones, not %u",
+				     list->zone_count, map->zone_count);
+		}
+
+		if (parent != NULL)
+			vdo_continue_completion(parent, VDO_SUCCESS);
+		return;
+	}
+
+	if (start && (list->run_count > 0))
+		vdo_log_info("warming up block map cache from %u runs of pages", list->run_count);
+
+	vdo_schedule_action(map->action_manager, NULL,
+			    (start ? start_zone_warmup : cancel_zone_warmup), NULL, parent);
+}
+
 /* Allocate an expanded collection of trees, for a future growth. */
 int vdo_prepare_to_grow_block_map(struct block_map *map,
 				  block_count_t new_logical_blocks)
@@ -3077,11 +4044,108 @@ static void handle_page_error(struct vdo_completion *completion)
 	finish_processing_page(completion, completion->result);
 }
 
+/**
+ * find_loaded_leaf_pbn() - Find the PBN of a leaf block map page from its parent tree page.
+ *
+ * Return: The PBN of the page, or VDO_ZERO_BLOCK if the parent tree page has not been loaded or
+ *         the leaf page has not been allocated.
+ */
+static physical_block_number_t find_loaded_leaf_pbn(struct block_map *map,
+						    page_number_t page_number)
+{
+	struct data_location mapping;
+	struct tree_page *tree_page;
+	struct block_map_page *page;
+	root_count_t root_index = page_number % map->root_count;
+	page_number_t page_index = page_number / map->root_count;
+	slot_number_t slot = page_index % VDO_BLOCK_MAP_ENTRIES_PER_PAGE;
+
+	tree_page = get_tree_page_by_index(map->forest, root_index, 1,
+					   page_index / VDO_BLOCK_MAP_ENTRIES_PER_PAGE);
+	if (tree_page == NULL)
+		return VDO_ZERO_BLOCK;
+
+	page = (struct block_map_page *) tree_page->page_buffer;
+	if (vdo_get_block_map_page_pbn(page) == VDO_ZERO_BLOCK)
+		return VDO_ZERO_BLOCK;
+
+	mapping = vdo_unpack_block_map_entry(&page->entries[slot]);
+	if (is_invalid_tree_entry(map->vdo, &mapping, 1) || !vdo_is_mapped_location(&mapping))
+		return VDO_ZERO_BLOCK;
+
+	return mapping.pbn;
+}
+
+/**
+ * next_zone_page() - Find the next leaf page after a given one which belongs to a zone.
+ *
+ * Return: The page number, or 0 if there are no more leaf pages in the zone.
+ */
+static page_number_t next_zone_page(struct block_map_zone *zone, page_number_t page_number)
+{
+	struct block_map *map = zone->block_map;
+	page_count_t leaf_pages = DIV_ROUND_UP(map->entry_count, VDO_BLOCK_MAP_ENTRIES_PER_PAGE);
+
+	for (page_number++; page_number < leaf_pages; page_number++) {
+		if (((page_number % map->root_count) % map->zone_count) == zone->zone_number)
+			return page_number;
+	}
+
+	return 0;
+}
+
+/**
+ * read_ahead() - Note that a data_vio is fetching a leaf page, and if the zone has been fetching
+ *                its leaf pages in order, load the next few before they are needed.
+ *
+ * Fetches from data_vios which are just behind the head of the stream are ignored, since requests
+ * for consecutive logical blocks are not guaranteed to arrive in order. Leaf pages whose parent
+ * tree pages have not been loaded yet are skipped.
+ */
+static void read_ahead(struct block_map_zone *zone, page_number_t page_number)
+{
+	if ((zone->readahead == 0) || (page_number == zone->last_leaf_page))
+		return;
+
+	if ((page_number < zone->last_leaf_page) &&
+	    (page_number + zone->block_map->root_count > zone->last_leaf_page))
+		return;
+
+	if (page_number == next_zone_page(zone, zone->last_leaf_page)) {
+		zone->sequential_pages++;
+		if (zone->pages_ahead > 0)
+			zone->pages_ahead--;
+	} else {
+		zone->sequential_pages = 0;
+		zone->pages_ahead = 0;
+		zone->readahead_limit = page_number;
+	}
+
+	zone->last_leaf_page = page_number;
+	if (zone->sequential_pages < READAHEAD_TRIGGER)
+		return;
+
+	while (zone->pages_ahead < zone->readahead) {
+		physical_block_number_t pbn;
+		page_number_t next = next_zone_page(zone, zone->readahead_limit);
+
+		if (next == 0)
+			return;
+
+		zone->readahead_limit = next;
+		zone->pages_ahead++;
+		pbn = find_loaded_leaf_pbn(zone->block_map, next);
+		if (pbn != VDO_ZERO_BLOCK)
+			read_ahead_page(&zone->page_cache, pbn);
+	}
+}
+
 /* Fetch the mapping page for a block map update, and call the provided handler when fetched. */
 static void fetch_mapping_page(struct data_vio *data_vio, bool modifiable,
 			       vdo_action_fn action)
 {
 	struct block_map_zone *zone = data_vio->logical.zone->block_map_zone;
+	page_number_t page_number = data_vio->tree_lock.tree_slots[0].page_index;
 
 	if (vdo_is_state_draining(&zone->state)) {
 		continue_data_vio_with_error(data_vio, VDO_SHUTTING_DOWN);
@@ -3092,6 +4156,7 @@ static void fetch_mapping_page(struct data_vio *data_vio, bool modifiable,
 		     data_vio->tree_lock.tree_slots[0].block_map_slot.pbn,
 		     modifiable, &data_vio->vio.completion,
 		     action, handle_page_error, false);
+	read_ahead(zone, page_number);
 }
 
 /**
@@ -3311,6 +4376,15 @@ struct block_map_statistics vdo_get_block_map_statistics(struct block_map *map)
 		totals.discard_required += READ_ONCE(stats->discard_required);
 		totals.wait_for_page += READ_ONCE(stats->wait_for_page);
 		totals.fetch_required += READ_ONCE(stats->fetch_required);
+		totals.ghost_hits += READ_ONCE(stats->ghost_hits);
+		totals.readahead_pages += READ_ONCE(stats->readahead_pages);
+		totals.readahead_used += READ_ONCE(stats->readahead_used);
+		totals.readahead_wasted += READ_ONCE(stats->readahead_wasted);
+		totals.writes_issued += READ_ONCE(stats->writes_issued);
+		totals.warmup_pages += READ_ONCE(stats->warmup_pages);
+		totals.tier_pages_read += READ_ONCE(stats->tier_pages_read);
+		totals.tier_pages_written += READ_ONCE(stats->tier_pages_written);
+		totals.tier_pages_rejected += READ_ONCE(stats->tier_pages_rejected);
 		totals.pages_loaded += READ_ONCE(stats->pages_loaded);
 		totals.pages_saved += READ_ONCE(stats->pages_saved);
 		totals.flush_count += READ_ONCE(stats->flush_count);
@@ -39,6 +39,16 @@
 
 enum {
 	BLOCK_MAP_VIO_POOL_SIZE = 64,
+	/* The most leaf pages which may be read ahead of a sequential stream in each zone */
+	VDO_MAX_BLOCK_MAP_READAHEAD = 64,
+	/* The most leaf pages with consecutive PBNs which will be written out together */
+	BLOCK_MAP_MAX_PAGES_PER_WRITE = 16,
+	/* The number of vios each zone has for writing out several leaf pages together */
+	BLOCK_MAP_WRITE_VIO_POOL_SIZE = 8,
+	/* The most page reads each zone may have outstanding while warming up its cache */
+	BLOCK_MAP_WARMUP_READS = 16,
+	/* The number of vios each zone has for I/O to the block map cache device */
+	BLOCK_MAP_TIER_VIO_POOL_SIZE = 16,
 };
 
 /*
@@ -48,6 +58,16 @@ typedef u32 vdo_page_generation;
 
 extern const struct block_map_entry UNMAPPED_BLOCK_MAP_ENTRY;
 
+/* A block of the block map cache device. */
+struct tier_slot {
+	/* the page held in (or being read from or written to) the block, or NO_PAGE */
+	physical_block_number_t pbn;
+	/* whether the block is being read or written */
+	bool busy;
+	/* whether the block holds a complete copy of its page */
+	bool valid;
+};
+
 /* The VDO Page Cache abstraction. */
 struct vdo_page_cache {
 	/* the VDO which owns this cache */
@@ -58,6 +78,8 @@ struct vdo_page_cache {
 	page_count_t pages_in_batch;
 	/* Whether the VDO is doing a read-only rebuild */
 	bool rebuilding;
+	/* Whether to use the 2Q replacement policy rather than plain LRU */
+	bool use_2q;
 
 	/* array of page information entries */
 	struct page_info *infos;
@@ -67,12 +89,44 @@ struct vdo_page_cache {
 	struct page_info *last_found;
 	/* map of page number to info */
 	struct int_map *page_map;
-	/* main LRU list (all infos) */
+	/* main LRU list (all infos not on probation) */
 	struct list_head lru_list;
+	/* 2Q: pages loaded once, in the order they were loaded */
+	struct list_head probation_list;
+	/* 2Q: number of pages on the probation list */
+	page_count_t probation_count;
+	/* 2Q: number of probationary pages above which they are evicted first */
+	page_count_t probation_target;
+	/* 2Q: ring of the page numbers most recently evicted from probation */
+	physical_block_number_t *ghosts;
+	/* 2Q: size of the ghost ring */
+	page_count_t ghost_capacity;
+	/* 2Q: next slot to use in the ghost ring */
+	page_count_t next_ghost;
+	/* 2Q: map of page number to ghost ring slot */
+	struct int_map *ghost_map;
 	/* free page list (oldest first) */
 	struct list_head free_list;
 	/* outgoing page list */
 	struct list_head outgoing_list;
+	/* pages covered by a completed flush which are waiting to be written (oldest first) */
+	struct list_head write_list;
+	/* vios for writing out several pages with consecutive PBNs together */
+	struct vio_pool *write_vio_pool;
+	/* the waiter for a vio from the write_vio_pool */
+	struct vdo_waiter write_waiter;
+	/* number of blocks in this zone's share of the block map cache device (0 if none) */
+	block_count_t tier_size;
+	/* the first block of this zone's share of the block map cache device */
+	physical_block_number_t tier_origin;
+	/* the state of each block in this zone's share of the block map cache device */
+	struct tier_slot *tier_slots;
+	/* map of page number to the tier slot holding the page */
+	struct int_map *tier_map;
+	/* the next tier slot to consider for reuse */
+	block_count_t tier_hand;
+	/* vios for reading and writing the block map cache device */
+	struct vio_pool *tier_vio_pool;
 	/* number of read I/O operations pending */
 	page_count_t outstanding_reads;
 	/* number of write I/O operations pending */
@@ -146,6 +200,14 @@ struct page_info {
 	enum vdo_page_write_status write_status;
 	/* page state */
 	enum vdo_page_buffer_state state;
+	/* whether the page is (or will be) on the 2Q probation list */
+	bool on_probation;
+	/* 2Q: the (truncated) count of page gets when this page was loaded */
+	u32 load_stamp;
+	/* whether this page was loaded by readahead and has not been used since */
+	bool readahead;
+	/* whether this page is on the write list of its cache */
+	bool on_write_list;
 	/* queue of completions awaiting this item */
 	struct vdo_wait_queue waiting;
 	/* state linked list entry */
@@ -236,12 +298,32 @@ struct dirty_lists {
 struct block_map_zone {
 	zone_count_t zone_number;
 	thread_id_t thread_id;
+	/* The NUMA node of the zone's thread, or NUMA_NO_NODE */
+	int node;
 	struct admin_state state;
 	struct block_map *block_map;
 	/* Dirty pages, by era*/
 	struct dirty_lists *dirty_lists;
 	struct vdo_page_cache page_cache;
 	data_vio_count_t active_lookups;
+	/* The number of leaf pages to read ahead of a sequential stream (0 for none) */
+	page_count_t readahead;
+	/* The leaf page most recently fetched for a data_vio */
+	page_number_t last_leaf_page;
+	/* The number of leaf pages of this zone which have been fetched in order */
+	page_count_t sequential_pages;
+	/* The last leaf page considered for readahead */
+	page_number_t readahead_limit;
+	/* The number of leaf pages considered for readahead beyond the last one fetched */
+	page_count_t pages_ahead;
+	/* The runs of cached leaf pages recorded when this zone was last saved */
+	struct hot_page_run *hot_runs;
+	u16 hot_run_count;
+	/* Whether this zone is loading the pages of the block map's hot page list */
+	bool warming_up;
+	/* The run of the hot page list being loaded, and the next page of that run */
+	u16 warmup_run;
+	page_count_t warmup_page;
 	struct int_map *loading_pages;
 	struct vio_pool *vio_pool;
 	/* The tree page which has issued or will be issuing a flush */
@@ -278,6 +360,9 @@ struct block_map {
 	/* The number of entries after growth */
 	block_count_t next_entry_count;
 
+	/* The leaf pages to load to warm up the cache, from the super block or the last save */
+	struct hot_page_list hot_pages;
+
 	zone_count_t zone_count;
 	struct block_map_zone zones[];
 };
@@ -344,6 +429,8 @@ void vdo_drain_block_map(struct block_map *map, const struct admin_state_code *o
 
 void vdo_resume_block_map(struct block_map *map, struct vdo_completion *parent);
 
+void vdo_warm_up_block_map(struct block_map *map, bool start, struct vdo_completion *parent);
+
 int __must_check vdo_prepare_to_grow_block_map(struct block_map *map,
 					       block_count_t new_logical_blocks);
 
@@ -0,0 +1,337 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright 2023 Red Hat
+ */
+
+#include "compression.h"
+
+#include <linux/limits.h>
+#include <linux/log2.h>
+#include <linux/lz4.h>
+#include <linux/minmax.h>
+#include <linux/string.h>
+#include <linux/zlib.h>
+
+#include "numeric.h"
+
+#include "constants.h"
+#include "status-codes.h"
+
+/*
+ * Deflate is always applied to a single block, so a window the size of a block is sufficient, and
+ * a small hash table keeps the per-block initialization cheap. Both values are fixed since the
+ * decoder must use the same window size as the encoder.
+ */
+#define VDO_DEFLATE_WINDOW_BITS 12
+#define VDO_DEFLATE_MEM_LEVEL 6
+
+enum {
+	/* The number of bytes in each sample examined by the fast-reject check */
+	FAST_REJECT_SAMPLE_SIZE = sizeof(u64),
+	/* The distance between the starts of consecutive samples */
+	FAST_REJECT_SAMPLE_STRIDE = 64,
+	FAST_REJECT_SAMPLES = VDO_BLOCK_SIZE / FAST_REJECT_SAMPLE_STRIDE,
+	FAST_REJECT_SAMPLED_BYTES = FAST_REJECT_SAMPLES * FAST_REJECT_SAMPLE_SIZE,
+	/* The number of hash table slots used to find repeated samples */
+	FAST_REJECT_REPEAT_SLOTS = 2 * FAST_REJECT_SAMPLES,
+	/* The number of interleaved byte histograms used by the fast-reject check */
+	FAST_REJECT_HISTOGRAMS = 4,
+	/* A sample with fewer distinct byte values than this is always worth compressing */
+	FAST_REJECT_MINIMUM_DISTINCT_BYTES = 64,
+	/* The sampled byte collision entropy, in bits per byte, at or above which a block is rejected */
+	FAST_REJECT_ENTROPY_BITS = 7,
+};
+
+struct vdo_codec {
+	const char *name;
+	int default_level;
+	int minimum_level;
+	int maximum_level;
+	/*
+	 * Compress a block, returning the size of the compressed fragment, or 0 if it would not fit
+	 * in fragment_size bytes.
+	 */
+	int (*compress)(const char *block, char *fragment, int fragment_size, int level,
+			void *workspace);
+	/* Decompress a fragment, returning the number of bytes produced or a negative error. */
+	int (*decompress)(const char *fragment, int fragment_size, char *block, void *workspace);
+};
+
+static int lz4_compress(const char *block, char *fragment, int fragment_size, int level,
+			void *workspace)
+{
+	return LZ4_compress_fast(block, fragment, VDO_BLOCK_SIZE, fragment_size, level, workspace);
+}
+
+static int lz4_decompress(const char *fragment, int fragment_size, char *block,
+			  void *workspace __always_unused)
+{
+	return LZ4_decompress_safe(fragment, block, fragment_size, VDO_BLOCK_SIZE);
+}
+
+/* Prepare a zlib stream to work in a caller supplied workspace. */
+static inline void prepare_zlib_stream(struct z_stream_s *stream, void *workspace)
+{
+	memset(stream, 0, sizeof(*stream));
+#ifdef __KERNEL__
+	stream->workspace = workspace;
+#else
+	/* The user space zlib allocates its own memory, leaving this field to the allocator. */
+	stream->opaque = workspace;
+#endif /* __KERNEL__ */
+}
+
+static int deflate_compress(const char *block, char *fragment, int fragment_size, int level,
+			    void *workspace)
+{
+	int result;
+	struct z_stream_s stream;
+
+	prepare_zlib_stream(&stream, workspace);
+	/* A negative window size produces a raw deflate stream, without a zlib header. */
+	result = zlib_deflateInit2(&stream, level, Z_DEFLATED, -VDO_DEFLATE_WINDOW_BITS,
+				   VDO_DEFLATE_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+	if (result != Z_OK)
+		return 0;
+
+	stream.next_in = (const u8 *) block;
+	stream.avail_in = VDO_BLOCK_SIZE;
+	stream.next_out = (u8 *) fragment;
+	stream.avail_out = fragment_size;
+	result = zlib_deflate(&stream, Z_FINISH);
+	zlib_deflateEnd(&stream);
+	return ((result == Z_STREAM_END) ? stream.total_out : 0);
+}
+
+static int deflate_decompress(const char *fragment, int fragment_size, char *block,
+			      void *workspace)
+{
+	int result;
+	struct z_stream_s stream;
+
+	prepare_zlib_stream(&stream, workspace);
+	result = zlib_inflateInit2(&stream, -VDO_DEFLATE_WINDOW_BITS);
+	if (result != Z_OK)
+		return -1;
+
+	stream.next_in = (const u8 *) fragment;
+	stream.avail_in = fragment_size;
+	stream.next_out = (u8 *) block;
+	stream.avail_out = VDO_BLOCK_SIZE;
+	result = zlib_inflate(&stream, Z_FINISH);
+	zlib_inflateEnd(&stream);
+	return ((result == Z_STREAM_END) ? (int) stream.total_out : -1);
+}
+
+static const struct vdo_codec CODECS[] = {
+	[VDO_CODEC_LZ4] = {
+		.name = VDO_COMPRESS_LZ4,
+		.default_level = LZ4_ACCELERATION_DEFAULT,
+		.minimum_level = INT_MIN,
+		.maximum_level = INT_MAX,
+		.compress = lz4_compress,
+		.decompress = lz4_decompress,
+	},
+	[VDO_CODEC_DEFLATE] = {
+		.name = VDO_COMPRESS_DEFLATE,
+		/* Favor throughput; the data is only a single block. */
+		.default_level = Z_BEST_SPEED,
+		.minimum_level = Z_BEST_SPEED,
+		.maximum_level = Z_BEST_COMPRESSION,
+		.compress = deflate_compress,
+		.decompress = deflate_decompress,
+	},
+};
+
+/**
+ * vdo_parse_compression_codec() - Look up a codec by name.
+ * @name: The name, which need not be null terminated.
+ * @length: The length of the name.
+ * @codec_ptr: A pointer to hold the codec.
+ *
+ * Return: VDO_SUCCESS or VDO_BAD_CONFIGURATION if the name is unknown.
+ */
+int vdo_parse_compression_codec(const char *name, size_t length,
+				enum vdo_compression_codec *codec_ptr)
+{
+	enum vdo_compression_codec codec;
+
+	for (codec = 0; codec < VDO_CODEC_COUNT; codec++) {
+		if ((strlen(CODECS[codec].name) == length) &&
+		    (strncmp(name, CODECS[codec].name, length) == 0)) {
+			*codec_ptr = codec;
+			return VDO_SUCCESS;
+		}
+	}
+
+	return VDO_BAD_CONFIGURATION;
+}
+
+/**
+ * vdo_get_compression_codec_name() - Get the name of a codec as used in the table line.
+ * @codec: The codec.
+ */
+const char *vdo_get_compression_codec_name(enum vdo_compression_codec codec)
+{
+	return ((codec < VDO_CODEC_COUNT) ? CODECS[codec].name : "unknown");
+}
+
+/**
+ * vdo_get_default_compression_level() - Get the level a codec uses if none is configured.
+ * @codec: The codec.
+ */
+int vdo_get_default_compression_level(enum vdo_compression_codec codec)
+{
+	return CODECS[codec].default_level;
+}
+
+/**
+ * vdo_validate_compression_level() - Check whether a level is meaningful for a codec.
+ * @codec: The codec.
+ * @level: The configured level.
+ *
+ * Return: VDO_SUCCESS or VDO_BAD_CONFIGURATION.
+ */
+int vdo_validate_compression_level(enum vdo_compression_codec codec, int level)
+{
+	if ((level < CODECS[codec].minimum_level) || (level > CODECS[codec].maximum_level))
+		return VDO_BAD_CONFIGURATION;
+
+	return VDO_SUCCESS;
+}
+
+/**
+ * vdo_get_compression_workspace_size() - Get the size of the per-thread workspace needed to
+ *                                        compress or decompress with any codec.
+ *
+ * Since any codec may have to decode blocks written while a different one was configured, each
+ * CPU thread has a single workspace large enough for all of them. A thread only compresses or
+ * decompresses one block at a time, so the same workspace serves for both.
+ */
+size_t vdo_get_compression_workspace_size(void)
+{
+	size_t size = LZ4_MEM_COMPRESS;
+
+	size = max_t(size_t, size,
+		     zlib_deflate_workspacesize(-VDO_DEFLATE_WINDOW_BITS, VDO_DEFLATE_MEM_LEVEL));
+	return max_t(size_t, size, zlib_inflate_workspacesize());
+}
+
+/**
+ * vdo_compress_block() - Compress a block.
+ * @codec: The codec to use.
+ * @level: The codec specific compression level.
+ * @block: The block to compress.
+ * @fragment: The buffer to hold the compressed data.
+ * @fragment_size: The size of the fragment buffer.
+ * @workspace: The workspace of the current CPU thread.
+ *
+ * Return: The size of the compressed fragment, or 0 if the block could not be compressed into
+ *         fragment_size bytes.
+ */
+int vdo_compress_block(enum vdo_compression_codec codec, int level, const char *block,
+		       char *fragment, int fragment_size, void *workspace)
+{
+	return CODECS[codec].compress(block, fragment, fragment_size, level, workspace);
+}
+
+/**
+ * vdo_decompress_fragment() - Decompress a fragment into a full block.
+ * @codec: The codec which compressed the fragment.
+ * @fragment: The compressed data.
+ * @fragment_size: The size of the compressed data.
+ * @block: The buffer to hold the decompressed block.
+ * @workspace: The workspace of the current CPU thread.
+ *
+ * Return: VDO_SUCCESS or VDO_INVALID_FRAGMENT if the fragment does not decode to a whole block.
+ */
+int vdo_decompress_fragment(enum vdo_compression_codec codec, const char *fragment,
+			    int fragment_size, char *block, void *workspace)
+{
+	int size;
+
+	if (codec >= VDO_CODEC_COUNT)
+		return VDO_INVALID_FRAGMENT;
+
+	size = CODECS[codec].decompress(fragment, fragment_size, block, workspace);
+	return ((size == VDO_BLOCK_SIZE) ? VDO_SUCCESS : VDO_INVALID_FRAGMENT);
+}
+
+/**
+ * has_repeated_sample() - Check whether any two samples of a block are identical.
+ * @block: The block to examine.
+ *
+ * Repeated samples indicate runs or repeated strings, which any codec will find even if the
+ * byte distribution looks random.
+ */
+static bool has_repeated_sample(const char *block)
+{
+	u8 slots[FAST_REJECT_REPEAT_SLOTS] = { 0 };
+	unsigned int i;
+
+	for (i = 0; i < FAST_REJECT_SAMPLES; i++) {
+		u64 sample = get_unaligned_le64(&block[i * FAST_REJECT_SAMPLE_STRIDE]);
+		unsigned int slot = ((sample * 0x9e3779b97f4a7c15ULL) >>
+				     (64 - ilog2(FAST_REJECT_REPEAT_SLOTS)));
+
+		/* Slots hold the sample number plus one so that zero means empty. */
+		if ((slots[slot] != 0) &&
+		    (get_unaligned_le64(&block[(slots[slot] - 1) * FAST_REJECT_SAMPLE_STRIDE]) ==
+		     sample))
+			return true;
+
+		slots[slot] = i + 1;
+	}
+
+	return false;
+}
+
+/**
+ * vdo_is_probably_incompressible() - Cheaply estimate whether compressing a block is hopeless.
+ * @block: The block to examine.
+ *
+ * One eighth of the block is sampled, eight bytes at a time, evenly through the block. The block
+ * is judged incompressible if the samples use most byte values with a near uniform distribution
+ * and no sample repeats another. This is several times faster than even LZ4 failing to compress
+ * a block, and errs on the side of compressing: data with repeats which the samples miss will
+ * be rejected, but anything with runs, a skewed byte distribution, or a small alphabet will not.
+ *
+ * Return: true if the block should not be compressed.
+ */
+bool vdo_is_probably_incompressible(const char *block)
+{
+	/* Interleaving the counts keeps runs of one byte value from serializing the updates. */
+	u8 counts[FAST_REJECT_HISTOGRAMS][256] = { { 0 } };
+	unsigned int distinct = 0;
+	unsigned int sum_of_squares = 0;
+	unsigned int i, j;
+
+	BUILD_BUG_ON(FAST_REJECT_SAMPLES * FAST_REJECT_SAMPLE_SIZE / FAST_REJECT_HISTOGRAMS > U8_MAX);
+	for (i = 0; i < FAST_REJECT_SAMPLES; i++) {
+		u64 sample = get_unaligned_le64(&block[i * FAST_REJECT_SAMPLE_STRIDE]);
+
+		for (j = 0; j < FAST_REJECT_SAMPLE_SIZE; j++)
+			counts[j % FAST_REJECT_HISTOGRAMS][(sample >> (8 * j)) & 0xff]++;
+	}
+
+	/*
+	 * The collision entropy of the samples, H2 = -log2(sum(c^2) / N^2), needs no logarithms to
+	 * compare against a threshold, and is never more than the Shannon entropy.
+	 */
+	for (i = 0; i < 256; i++) {
+		unsigned int count = 0;
+
+		for (j = 0; j < FAST_REJECT_HISTOGRAMS; j++)
+			count += counts[j][i];
+
+		distinct += (count > 0);
+		sum_of_squares += count * count;
+	}
+
+	if ((distinct < FAST_REJECT_MINIMUM_DISTINCT_BYTES) ||
+	    ((sum_of_squares << FAST_REJECT_ENTROPY_BITS) >
+	     (FAST_REJECT_SAMPLED_BYTES * FAST_REJECT_SAMPLED_BYTES)))
+		return false;
+
+	return !has_repeated_sample(block);
+}
@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright 2023 Red Hat
+ */
+
+#ifndef VDO_COMPRESSION_H
+#define VDO_COMPRESSION_H
+
+#include "types.h"
+
+int __must_check vdo_parse_compression_codec(const char *name, size_t length,
+					     enum vdo_compression_codec *codec_ptr);
+
+const char * __must_check vdo_get_compression_codec_name(enum vdo_compression_codec codec);
+
+int __must_check vdo_get_default_compression_level(enum vdo_compression_codec codec);
+
+int __must_check vdo_validate_compression_level(enum vdo_compression_codec codec, int level);
+
+size_t __must_check vdo_get_compression_workspace_size(void);
+
+int __must_check vdo_compress_block(enum vdo_compression_codec codec, int level,
+				    const char *block, char *fragment, int fragment_size,
+				    void *workspace);
+
+int __must_check vdo_decompress_fragment(enum vdo_compression_codec codec,
+					 const char *fragment, int fragment_size, char *block,
+					 void *workspace);
+
+bool __must_check vdo_is_probably_incompressible(const char *block);
+
+#endif /* VDO_COMPRESSION_H */
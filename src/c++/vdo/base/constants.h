@@ -89,6 +89,12 @@ enum {
 	VDO_SECTORS_PER_BLOCK = 8,
 #endif /* __KERNEL__ */
 
+	/* The number of u64 words examined per step when comparing or zero-checking a block */
+	VDO_BLOCK_COMPARE_WORDS = 8,
+
+	/* The number of bytes examined per step when comparing or zero-checking a block */
+	VDO_BLOCK_COMPARE_STRIDE = (VDO_BLOCK_COMPARE_WORDS * sizeof(u64)),
+
 	/* The size of a sector that will not be torn */
 	VDO_SECTOR_SIZE = 512,
 
@@ -98,5 +104,6 @@ enum {
 
 /* Supported compression algorithms */
 #define VDO_COMPRESS_LZ4 "lz4"
+#define VDO_COMPRESS_DEFLATE "deflate"
 
 #endif /* VDO_CONSTANTS_H */
@@ -13,7 +13,6 @@
 #include <linux/jiffies.h>
 #include <linux/kernel.h>
 #include <linux/list.h>
-#include <linux/lz4.h>
 #include <linux/minmax.h>
 #include <linux/sched.h>
 #include <linux/spinlock.h>
@@ -26,8 +25,10 @@
 #include "memory-alloc.h"
 #include "murmurhash3.h"
 #include "permassert.h"
+#include "time-utils.h"
 
 #include "block-map.h"
+#include "compression.h"
 #include "dump.h"
 #include "encodings.h"
 #include "int-map.h"
@@ -119,6 +120,29 @@ static blk_opf_t PASSTHROUGH_FLAGS = (REQ_PRIO | REQ_META | REQ_SYNC | REQ_RAHEA
 
 #define DATA_VIO_RELEASE_BATCH_SIZE 128
 
+/**
+ * DOC: Hash batching.
+ *
+ * Rather than enqueueing each data_vio on a cpu queue to be hashed individually, data_vios which
+ * need their record names computed are added to the funnel queue of one of the pool's
+ * hash_batchers. As with releases, the first data_vio added to an idle batcher causes the
+ * batcher's completion to be enqueued on a cpu queue. When that completion runs, it takes up to
+ * DATA_VIO_HASH_BATCH_SIZE data_vios from its queue, hashes them MURMURHASH3_LANES at a time,
+ * and sends each on to its hash zone. There is one batcher per cpu thread so that hashing can
+ * still proceed on all of the cpu threads at once. New data_vios are added to the same batcher
+ * until it has accumulated a full batch, and then to the next one.
+ */
+#define DATA_VIO_HASH_BATCH_SIZE 16
+
+/*
+ * One in this many blocks which fast-reject judges incompressible is compressed anyway, so that
+ * the statistics show how often the judgment is wrong.
+ */
+#define FAST_REJECT_CHECK_INTERVAL 64
+
+/* The seed used to compute record names from data blocks */
+#define VDO_RECORD_NAME_SEED 0x62ea60be
+
 static const unsigned int VDO_SECTORS_PER_BLOCK_MASK = VDO_SECTORS_PER_BLOCK - 1;
 static const u32 COMPRESSION_STATUS_MASK = 0xff;
 static const u32 MAY_NOT_COMPRESS_MASK = 0x80000000;
@@ -154,6 +178,18 @@ struct limiter {
 	u64 arrival;
 };
 
+/* A queue of data_vios which are waiting to be hashed together. */
+struct hash_batcher {
+	/* Completion for scheduling a batch of hashing */
+	struct vdo_completion completion;
+	/* The queue of data_vios waiting to be hashed */
+	struct funnel_queue *queue;
+	/* The number of data_vios which have ever been added to the queue */
+	atomic_t enqueued;
+	/* Whether the batcher is processing, or scheduled to process, its queue */
+	atomic_t processing;
+};
+
 /*
  * A data_vio_pool is a collection of preallocated data_vios which may be acquired from any thread,
  * and are released in batches.
@@ -177,6 +213,12 @@ struct data_vio_pool {
 	struct funnel_queue *queue;
 	/* Whether the pool is processing, or scheduled to process releases */
 	atomic_t processing;
+	/* The batchers which hash data_vios on the cpu threads */
+	struct hash_batcher *hashers;
+	/* The number of hash batchers */
+	unsigned int hasher_count;
+	/* The number of times the batcher receiving new data_vios has changed */
+	atomic_t hash_rotor;
 	/* The data vios in the pool */
 	struct data_vio data_vios[];
 };
@@ -185,6 +227,7 @@ static const char * const ASYNC_OPERATION_NAMES[] = {
 	"launch",
 	"acknowledge_write",
 	"acquire_hash_lock",
+	"allocate_data_block",
 	"attempt_logical_block_lock",
 	"lock_duplicate_pbn",
 	"check_for_duplication",
@@ -221,6 +264,13 @@ as_data_vio_pool(struct vdo_completion *completion)
 	return container_of(completion, struct data_vio_pool, completion);
 }
 
+static inline struct hash_batcher * __must_check
+as_hash_batcher(struct vdo_completion *completion)
+{
+	vdo_assert_completion_type(completion, VDO_HASH_BATCH_COMPLETION);
+	return container_of(completion, struct hash_batcher, completion);
+}
+
 static inline u64 get_arrival_time(struct bio *bio)
 {
 	return (u64) bio->bi_private;
@@ -267,7 +317,7 @@ static void launch_locked_request(struct data_vio *data_vio)
 		}
 	}
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_FIND_BLOCK_MAP_SLOT;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_FIND_BLOCK_MAP_SLOT);
 	vdo_find_block_map_slot(data_vio);
 }
 
@@ -496,7 +546,7 @@ static void attempt_logical_block_lock(struct vdo_completion *completion)
 		return;
 	}
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_ATTEMPT_LOGICAL_BLOCK_LOCK;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_ATTEMPT_LOGICAL_BLOCK_LOCK);
 	vdo_waitq_enqueue_waiter(&lock_holder->logical.waiters, &data_vio->waiter);
 
 	/*
@@ -540,18 +590,29 @@ static void launch_data_vio(struct data_vio *data_vio, logical_block_number_t lb
 	vdo_enqueue_completion(completion, VDO_DEFAULT_Q_MAP_BIO_PRIORITY);
 }
 
+/*
+ * Zero detection runs on every incoming write, so it examines a cache line's worth of words per
+ * branch. The words are OR'ed into a single accumulator so the loads are independent of each
+ * other; the compiler is free to turn this into vector operations where they are available.
+ */
 STATIC bool is_zero_block(char *block)
 {
-	int i;
+	const u64 *words = (const u64 *) block;
+	unsigned int i;
 
 #ifdef INTERNAL
-	BUILD_BUG_ON(VDO_BLOCK_SIZE % sizeof(u64) != 0);
+	BUILD_BUG_ON(VDO_BLOCK_SIZE % VDO_BLOCK_COMPARE_STRIDE != 0);
 	VDO_ASSERT_LOG_ONLY((uintptr_t) block % sizeof(u64) == 0,
 			    "Data blocks are expected to be aligned");
 
 #endif	/* INTERNAL */
-	for (i = 0; i < VDO_BLOCK_SIZE; i += sizeof(u64)) {
-		if (*((u64 *) &block[i]))
+	/* Most non-zero blocks are non-zero in their first word. */
+	if (words[0] != 0)
+		return false;
+
+	for (i = 0; i < VDO_BLOCK_SIZE / sizeof(u64); i += VDO_BLOCK_COMPARE_WORDS) {
+		if ((words[i] | words[i + 1] | words[i + 2] | words[i + 3] |
+		     words[i + 4] | words[i + 5] | words[i + 6] | words[i + 7]) != 0)
 			return false;
 	}
 
@@ -625,6 +686,9 @@ static void launch_bio(struct vdo *vdo, struct data_vio *data_vio, struct bio *b
 	if (data_vio->user_bio->bi_opf & REQ_FUA)
 		data_vio->fua = true;
 
+	if (data_vio->write)
+		data_vio->stage_start = current_time_ns(CLOCK_MONOTONIC);
+
 	lbn = (bio->bi_iter.bi_sector - vdo->starting_sector_offset) / VDO_SECTORS_PER_BLOCK;
 	launch_data_vio(data_vio, lbn);
 }
@@ -895,6 +959,53 @@ static void destroy_data_vio(struct data_vio *data_vio)
 	vdo_free(vdo_forget(data_vio->scratch_block));
 }
 
+static void hash_batch_callback(struct vdo_completion *completion);
+
+static int make_hash_batchers(struct vdo *vdo, struct data_vio_pool *pool)
+{
+	unsigned int i;
+	int result;
+
+	result = vdo_allocate(vdo->device_config->thread_counts.cpu_threads,
+			      struct hash_batcher, "hash batchers", &pool->hashers);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	for (i = 0; i < vdo->device_config->thread_counts.cpu_threads; i++) {
+		struct hash_batcher *batcher = &pool->hashers[i];
+
+		vdo_initialize_completion(&batcher->completion, vdo,
+					  VDO_HASH_BATCH_COMPLETION);
+		vdo_prepare_completion(&batcher->completion, hash_batch_callback,
+				       hash_batch_callback, vdo->thread_config.cpu_thread,
+				       NULL);
+		result = vdo_make_funnel_queue(&batcher->queue);
+		if (result != VDO_SUCCESS)
+			return result;
+
+		pool->hasher_count++;
+	}
+
+	return VDO_SUCCESS;
+}
+
+static void free_hash_batchers(struct data_vio_pool *pool)
+{
+	unsigned int i;
+
+	if (pool->hashers == NULL)
+		return;
+
+	for (i = 0; i < pool->hasher_count; i++) {
+		struct hash_batcher *batcher = &pool->hashers[i];
+
+		BUG_ON(atomic_read(&batcher->processing));
+		vdo_free_funnel_queue(vdo_forget(batcher->queue));
+	}
+
+	vdo_free(vdo_forget(pool->hashers));
+}
+
 /**
  * make_data_vio_pool() - Initialize a data_vio pool.
  * @vdo: The vdo to which the pool will belong.
@@ -935,6 +1046,12 @@ int make_data_vio_pool(struct vdo *vdo, data_vio_count_t pool_size,
 		return result;
 	}
 
+	result = make_hash_batchers(vdo, pool);
+	if (result != VDO_SUCCESS) {
+		free_data_vio_pool(vdo_forget(pool));
+		return result;
+	}
+
 	for (i = 0; i < pool_size; i++) {
 		struct data_vio *data_vio = &pool->data_vios[i];
 
@@ -988,6 +1105,7 @@ void free_data_vio_pool(struct data_vio_pool *pool)
 		destroy_data_vio(data_vio);
 	}
 
+	free_hash_batchers(pool);
 	vdo_free_funnel_queue(vdo_forget(pool->queue));
 	vdo_free(pool);
 }
@@ -1411,7 +1529,7 @@ void complete_data_vio(struct vdo_completion *completion)
 	struct data_vio *data_vio = as_data_vio(completion);
 
 	completion->error_handler = NULL;
-	data_vio->last_async_operation = VIO_ASYNC_OP_CLEANUP;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_CLEANUP);
 	perform_cleanup_stage(data_vio,
 			      (data_vio->write ? VIO_CLEANUP_START : VIO_RELEASE_LOGICAL));
 }
@@ -1461,6 +1579,76 @@ const char *get_data_vio_operation_name(struct data_vio *data_vio)
 		"unknown async operation");
 }
 
+/**
+ * get_write_stage() - Get the write stage whose latency is tracked for an async operation.
+ *
+ * Return: The stage, or VDO_WRITE_STAGE_COUNT if the operation's time is not tracked.
+ */
+static enum vdo_write_stage get_write_stage(enum async_operation_number operation)
+{
+	switch (operation) {
+	case VIO_ASYNC_OP_LAUNCH:
+		return VDO_WRITE_STAGE_LAUNCH;
+	case VIO_ASYNC_OP_HASH_DATA_VIO:
+		return VDO_WRITE_STAGE_HASH;
+	case VIO_ASYNC_OP_ACQUIRE_VDO_HASH_LOCK:
+		return VDO_WRITE_STAGE_HASH_LOCK;
+	case VIO_ASYNC_OP_CHECK_FOR_DUPLICATION:
+		return VDO_WRITE_STAGE_DEDUPE_QUERY;
+	case VIO_ASYNC_OP_ALLOCATE_DATA_BLOCK:
+		return VDO_WRITE_STAGE_ALLOCATION;
+	case VIO_ASYNC_OP_WRITE_DATA_VIO:
+		return VDO_WRITE_STAGE_DATA_WRITE;
+	case VIO_ASYNC_OP_JOURNAL_REMAPPING:
+		return VDO_WRITE_STAGE_JOURNAL;
+	case VIO_ASYNC_OP_PUT_MAPPED_BLOCK:
+		return VDO_WRITE_STAGE_BLOCK_MAP;
+	case VIO_ASYNC_OP_ACKNOWLEDGE_WRITE:
+		return VDO_WRITE_STAGE_ACKNOWLEDGE;
+	default:
+		return VDO_WRITE_STAGE_COUNT;
+	}
+}
+
+/**
+ * set_data_vio_async_operation() - Record the asynchronous operation a data_vio is starting.
+ * @data_vio: The data_vio.
+ * @operation: The operation.
+ *
+ * For writes, this also ends the timing of the stage for the previous operation. The clock is
+ * only read when the previous or the new operation is a timed stage.
+ */
+void set_data_vio_async_operation(struct data_vio *data_vio,
+				  enum async_operation_number operation)
+{
+	enum vdo_write_stage stage;
+	enum vdo_write_stage next_stage;
+	u64 now;
+
+	if (!data_vio->write || (operation == data_vio->last_async_operation)) {
+		data_vio->last_async_operation = operation;
+		return;
+	}
+
+	stage = get_write_stage(data_vio->last_async_operation);
+	next_stage = get_write_stage(operation);
+	data_vio->last_async_operation = operation;
+	if ((stage == VDO_WRITE_STAGE_COUNT) && (next_stage == VDO_WRITE_STAGE_COUNT))
+		return;
+
+	now = current_time_ns(CLOCK_MONOTONIC);
+	if (stage != VDO_WRITE_STAGE_COUNT) {
+		struct atomic_stage_latency *latency =
+			&vdo_from_data_vio(data_vio)->stats.write_stages[stage];
+		u64 microseconds = (now - data_vio->stage_start) / NSEC_PER_USEC;
+
+		atomic64_add(microseconds, &latency->total_microseconds);
+		atomic64_inc(&latency->buckets[vdo_get_latency_bucket(microseconds)]);
+	}
+
+	data_vio->stage_start = now;
+}
+
 /**
  * data_vio_allocate_data_block() - Allocate a data block.
  *
@@ -1478,10 +1666,12 @@ void data_vio_allocate_data_block(struct data_vio *data_vio,
 	VDO_ASSERT_LOG_ONLY((allocation->pbn == VDO_ZERO_BLOCK),
 			    "data_vio does not have an allocation");
 	allocation->write_lock_type = write_lock_type;
-	allocation->zone = vdo_get_next_allocation_zone(data_vio->logical.zone);
+	allocation->zone = vdo_get_next_allocation_zone(data_vio->logical.zone,
+							data_vio->logical.lbn);
 	allocation->first_allocation_zone = allocation->zone->zone_number;
 
 	data_vio->vio.completion.error_handler = error_handler;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_ALLOCATE_DATA_BLOCK);
 	launch_data_vio_allocated_zone_callback(data_vio, callback);
 }
 
@@ -1509,11 +1699,12 @@ void release_data_vio_allocation_lock(struct data_vio *data_vio, bool reset)
  * uncompress_data_vio() - Uncompress the data a data_vio has just read.
  * @mapping_state: The mapping state indicating which fragment to decompress.
  * @buffer: The buffer to receive the uncompressed data.
+ *
+ * This must be called on a CPU thread since it uses that thread's compression workspace.
  */
 int uncompress_data_vio(struct data_vio *data_vio,
 			enum block_mapping_state mapping_state, char *buffer)
 {
-	int size;
 	u16 fragment_offset, fragment_size;
 	struct compressed_block *block = data_vio->compression.block;
 	int result = vdo_get_compressed_block_fragment(mapping_state, block,
@@ -1524,11 +1715,13 @@ int uncompress_data_vio(struct data_vio *data_vio,
 		return result;
 	}
 
-	size = LZ4_decompress_safe((block->data + fragment_offset), buffer,
-				   fragment_size, VDO_BLOCK_SIZE);
-	if (size != VDO_BLOCK_SIZE) {
-		vdo_log_debug("%s: lz4 error", __func__);
-		return VDO_INVALID_FRAGMENT;
+	result = vdo_decompress_fragment(vdo_get_compressed_block_codec(block),
+					 (block->data + fragment_offset), fragment_size, buffer,
+					 vdo_get_work_queue_private_data());
+	if (result != VDO_SUCCESS) {
+		vdo_log_debug("%s: %s error", __func__,
+			      vdo_get_compression_codec_name(vdo_get_compressed_block_codec(block)));
+		return result;
 	}
 
 	return VDO_SUCCESS;
@@ -1642,7 +1835,7 @@ static void read_block(struct vdo_completion *completion)
 		return;
 	}
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_READ_DATA_VIO;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_READ_DATA_VIO);
 	if (vdo_is_state_compressed(data_vio->mapped.state)) {
 		result = vio_reset_bio(vio, (char *) data_vio->compression.block,
 				       read_endio, REQ_OP_READ, data_vio->mapped.pbn);
@@ -1712,7 +1905,7 @@ static void update_block_map(struct vdo_completion *completion)
 	else
 		completion->callback = complete_data_vio;
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_PUT_MAPPED_BLOCK;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_PUT_MAPPED_BLOCK);
 	vdo_put_mapped_block(data_vio);
 }
 
@@ -1777,7 +1970,7 @@ static void journal_remapping(struct vdo_completion *completion)
 					    data_vio->mapped.zone->thread_id);
 	}
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_JOURNAL_REMAPPING;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_JOURNAL_REMAPPING);
 	vdo_add_recovery_journal_entry(completion->vdo->recovery_journal, data_vio);
 }
 
@@ -1793,7 +1986,7 @@ static void read_old_block_mapping(struct vdo_completion *completion)
 
 	assert_data_vio_in_logical_zone(data_vio);
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_GET_MAPPED_BLOCK_FOR_WRITE;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_GET_MAPPED_BLOCK_FOR_WRITE);
 	set_data_vio_journal_callback(data_vio, journal_remapping);
 	vdo_get_mapped_block(data_vio);
 }
@@ -1827,7 +2020,7 @@ static void pack_compressed_data(struct vdo_completion *completion)
 		return;
 	}
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_ATTEMPT_PACKING;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_ATTEMPT_PACKING);
 	vdo_attempt_packing(data_vio);
 }
 
@@ -1840,25 +2033,48 @@ static void compress_data_vio(struct vdo_completion *completion)
 {
 	struct data_vio *data_vio = as_data_vio(completion);
 	struct vdo *vdo = vdo_from_data_vio(data_vio);
+	const struct device_config *config = vdo->device_config;
+	bool checking = false;
 	int size;
 
 	assert_data_vio_on_cpu_thread(data_vio);
 
+	if (config->compression_fast_reject &&
+	    vdo_is_probably_incompressible(data_vio->vio.data)) {
+		u64 predictions = atomic64_inc_return(&vdo->stats.fast_reject_predictions);
+
+		if ((predictions % FAST_REJECT_CHECK_INTERVAL) != 0) {
+			write_data_vio(data_vio);
+			return;
+		}
+
+		checking = true;
+		atomic64_inc(&vdo->stats.fast_reject_checks);
+	} else {
+		atomic64_inc(&vdo->stats.compression_attempts);
+	}
+
 	/*
 	 * By putting the compressed data at the start of the compressed block data field, we won't
 	 * need to copy it if this data_vio becomes a compressed write agent.
 	 */
-	size = LZ4_compress_fast(data_vio->vio.data,
-				 data_vio->compression.block->data, VDO_BLOCK_SIZE,
-				 VDO_MAX_COMPRESSED_FRAGMENT_SIZE,
-				 vdo->device_config->compression_level,
-				 (char *) vdo_get_work_queue_private_data());
+	data_vio->compression.codec = config->compression_codec;
+	size = vdo_compress_block(config->compression_codec, config->compression_level,
+				  data_vio->vio.data, data_vio->compression.block->data,
+				  VDO_MAX_COMPRESSED_FRAGMENT_SIZE,
+				  vdo_get_work_queue_private_data());
 	if ((size > 0) && (size < VDO_COMPRESSED_BLOCK_DATA_SIZE)) {
+		if (checking)
+			atomic64_inc(&vdo->stats.fast_reject_mispredictions);
+
 		data_vio->compression.size = size;
 		launch_data_vio_packer_callback(data_vio, pack_compressed_data);
 		return;
 	}
 
+	if (!checking)
+		atomic64_inc(&vdo->stats.compression_failures);
+
 	write_data_vio(data_vio);
 }
 
@@ -1898,36 +2114,121 @@ void launch_compress_data_vio(struct data_vio *data_vio)
 		return;
 	}
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_COMPRESS_DATA_VIO;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_COMPRESS_DATA_VIO);
 	launch_data_vio_cpu_callback(data_vio, compress_data_vio,
 				     CPU_Q_COMPRESS_BLOCK_PRIORITY);
 }
 
 /**
- * hash_data_vio() - Hash the data in a data_vio and set the hash zone (which also flags the record
- *		     name as set).
+ * hash_data_vios() - Compute the record names of a batch of data_vios.
+ * @algorithm: The record name hash algorithm recorded in the volume geometry.
+ *
+ * For murmur3, full groups of MURMURHASH3_LANES data_vios are hashed together and any left over
+ * are hashed individually. The striped hash already interleaves lanes within each block.
+ */
+static void hash_data_vios(struct data_vio *batch[], unsigned int count,
+			   enum vdo_hash_algorithm algorithm)
+{
+	unsigned int i = 0;
+
+	if (algorithm == VDO_HASH_MURMUR3_STRIPED) {
+		for (; i < count; i++) {
+			murmurhash3_128_striped(batch[i]->vio.data, VDO_BLOCK_SIZE,
+						VDO_RECORD_NAME_SEED, &batch[i]->record_name);
+		}
+
+		return;
+	}
+
+	for (; i + MURMURHASH3_LANES <= count; i += MURMURHASH3_LANES) {
+		const void *data[MURMURHASH3_LANES];
+		void *names[MURMURHASH3_LANES];
+		unsigned int lane;
+
+		for (lane = 0; lane < MURMURHASH3_LANES; lane++) {
+			data[lane] = batch[i + lane]->vio.data;
+			names[lane] = &batch[i + lane]->record_name;
+		}
+
+		murmurhash3_128_lanes(data, VDO_BLOCK_SIZE, VDO_RECORD_NAME_SEED, names);
+	}
 
- * This callback is registered in prepare_for_dedupe().
+	for (; i < count; i++) {
+		murmurhash3_128(batch[i]->vio.data, VDO_BLOCK_SIZE, VDO_RECORD_NAME_SEED,
+				&batch[i]->record_name);
+	}
+}
+
+/**
+ * schedule_hashing() - Ensure that a hash batcher is scheduled to process its queue.
+ *
+ * If this call switches the state to processing, enqueue. Otherwise, some other thread has already
+ * done so.
  */
-static void hash_data_vio(struct vdo_completion *completion)
+static void schedule_hashing(struct hash_batcher *batcher)
 {
-	struct data_vio *data_vio = as_data_vio(completion);
+	/* Pairs with the barrier in hash_batch_callback(). */
+	smp_mb__before_atomic();
+	if (atomic_cmpxchg(&batcher->processing, false, true))
+		return;
 
-	assert_data_vio_on_cpu_thread(data_vio);
-	VDO_ASSERT_LOG_ONLY(!data_vio->is_zero, "zero blocks should not be hashed");
+	batcher->completion.requeue = true;
+	vdo_launch_completion_with_priority(&batcher->completion,
+					    CPU_Q_HASH_BLOCK_PRIORITY);
+}
+
+/**
+ * hash_batch_callback() - Hash a batch of data_vios and set their hash zones (which also flags
+ *			   their record names as set).
+ * @completion: The hash_batcher with data_vios to hash.
+ *
+ * This callback is registered in make_hash_batchers().
+ */
+static void hash_batch_callback(struct vdo_completion *completion)
+{
+	struct hash_batcher *batcher = as_hash_batcher(completion);
+	struct hash_zones *zones = completion->vdo->hash_zones;
+	struct data_vio *batch[DATA_VIO_HASH_BATCH_SIZE];
+	unsigned int count;
+	unsigned int i;
+
+	for (count = 0; count < DATA_VIO_HASH_BATCH_SIZE; count++) {
+		struct funnel_queue_entry *entry = vdo_funnel_queue_poll(batcher->queue);
+		struct data_vio *data_vio;
+
+		if (entry == NULL)
+			break;
+
+		data_vio = as_data_vio(container_of(entry, struct vdo_completion,
+						    work_queue_entry_link));
+		assert_data_vio_on_cpu_thread(data_vio);
+		VDO_ASSERT_LOG_ONLY(!data_vio->is_zero, "zero blocks should not be hashed");
+		batch[count] = data_vio;
+	}
 
-	murmurhash3_128(data_vio->vio.data, VDO_BLOCK_SIZE, 0x62ea60be,
-			&data_vio->record_name);
+	hash_data_vios(batch, count, completion->vdo->geometry.hash_algorithm);
+	for (i = 0; i < count; i++) {
+		struct data_vio *data_vio = batch[i];
+
+		data_vio->hash_zone = vdo_select_hash_zone(zones, &data_vio->record_name);
+		set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_ACQUIRE_VDO_HASH_LOCK);
+		launch_data_vio_hash_zone_callback(data_vio, vdo_acquire_hash_lock);
+	}
 
-	data_vio->hash_zone = vdo_select_hash_zone(vdo_from_data_vio(data_vio)->hash_zones,
-						   &data_vio->record_name);
-	data_vio->last_async_operation = VIO_ASYNC_OP_ACQUIRE_VDO_HASH_LOCK;
-	launch_data_vio_hash_zone_callback(data_vio, vdo_acquire_hash_lock);
+	atomic_set(&batcher->processing, false);
+	/* Pairs with the barrier in schedule_hashing(). */
+	smp_mb();
+	if (!vdo_is_funnel_queue_empty(batcher->queue))
+		schedule_hashing(batcher);
 }
 
 /** prepare_for_dedupe() - Prepare for the dedupe path after attempting to get an allocation. */
 static void prepare_for_dedupe(struct data_vio *data_vio)
 {
+	struct data_vio_pool *pool = vdo_from_data_vio(data_vio)->data_vio_pool;
+	unsigned int rotor = atomic_read(&pool->hash_rotor);
+	struct hash_batcher *batcher = &pool->hashers[rotor % pool->hasher_count];
+
 	/* We don't care what thread we are on. */
 	VDO_ASSERT_LOG_ONLY(!data_vio->is_zero, "must not prepare to dedupe zero blocks");
 
@@ -1935,8 +2236,14 @@ static void prepare_for_dedupe(struct data_vio *data_vio)
 	 * Before we can dedupe, we need to know the record name, so the first
 	 * step is to hash the block data.
 	 */
-	data_vio->last_async_operation = VIO_ASYNC_OP_HASH_DATA_VIO;
-	launch_data_vio_cpu_callback(data_vio, hash_data_vio, CPU_Q_HASH_BLOCK_PRIORITY);
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_HASH_DATA_VIO);
+	vdo_funnel_queue_put(batcher->queue, &data_vio->vio.completion.work_queue_entry_link);
+
+	/* Once this batcher has a full batch, send subsequent data_vios to the next one. */
+	if ((atomic_inc_return(&batcher->enqueued) % DATA_VIO_HASH_BATCH_SIZE) == 0)
+		atomic_cmpxchg(&pool->hash_rotor, rotor, rotor + 1);
+
+	schedule_hashing(batcher);
 }
 
 /**
@@ -1988,7 +2295,7 @@ void write_data_vio(struct data_vio *data_vio)
 		return;
 	}
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_WRITE_DATA_VIO;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_WRITE_DATA_VIO);
 	vdo_submit_data_vio(data_vio);
 }
 
@@ -2045,7 +2352,7 @@ static void allocate_block(struct vdo_completion *completion)
 		return;
 	}
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_ACKNOWLEDGE_WRITE;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_ACKNOWLEDGE_WRITE);
 	launch_data_vio_on_bio_ack_queue(data_vio, acknowledge_write_callback);
 }
 
@@ -2090,7 +2397,7 @@ void continue_data_vio_with_block_map_slot(struct vdo_completion *completion)
 	assert_data_vio_in_logical_zone(data_vio);
 	if (data_vio->read) {
 		set_data_vio_logical_callback(data_vio, read_block);
-		data_vio->last_async_operation = VIO_ASYNC_OP_GET_MAPPED_BLOCK_FOR_READ;
+		set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_GET_MAPPED_BLOCK_FOR_READ);
 		vdo_get_mapped_block(data_vio);
 		return;
 	}
@@ -2131,6 +2438,6 @@ void continue_data_vio_with_block_map_slot(struct vdo_completion *completion)
 		return;
 	}
 
-	data_vio->last_async_operation = VIO_ASYNC_OP_ACKNOWLEDGE_WRITE;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_ACKNOWLEDGE_WRITE);
 	launch_data_vio_on_bio_ack_queue(data_vio, acknowledge_write_callback);
 }
@@ -32,6 +32,7 @@ enum async_operation_number {
 	VIO_ASYNC_OP_LAUNCH = MIN_VIO_ASYNC_OPERATION_NUMBER,
 	VIO_ASYNC_OP_ACKNOWLEDGE_WRITE,
 	VIO_ASYNC_OP_ACQUIRE_VDO_HASH_LOCK,
+	VIO_ASYNC_OP_ALLOCATE_DATA_BLOCK,
 	VIO_ASYNC_OP_ATTEMPT_LOGICAL_BLOCK_LOCK,
 	VIO_ASYNC_OP_LOCK_DUPLICATE_PBN,
 	VIO_ASYNC_OP_CHECK_FOR_DUPLICATION,
@@ -121,6 +122,9 @@ struct compression_state {
 	/* The compressed size of this block */
 	u16 size;
 
+	/* The codec which compressed this block */
+	enum vdo_compression_codec codec;
+
 	/* The packer input or output bin slot which holds the enclosing data_vio */
 	slot_number_t slot;
 
@@ -192,6 +196,9 @@ struct data_vio {
 	/* Used for logging and debugging */
 	enum async_operation_number last_async_operation;
 
+	/* The time, in nanoseconds, at which a write entered its current timed stage */
+	u64 stage_start;
+
 	/* The operations to record in the recovery and slab journals */
 	struct reference_updater increment_updater;
 	struct reference_updater decrement_updater;
@@ -381,6 +388,9 @@ static inline void continue_data_vio_with_error(struct data_vio *data_vio, int r
 
 const char * __must_check get_data_vio_operation_name(struct data_vio *data_vio);
 
+void set_data_vio_async_operation(struct data_vio *data_vio,
+				  enum async_operation_number operation);
+
 static inline void assert_data_vio_in_hash_zone(struct data_vio *data_vio)
 {
 	thread_id_t expected = data_vio->hash_zone->thread_id;
@@ -816,7 +816,7 @@ static void start_updating(struct hash_lock *lock, struct data_vio *agent)
 	VDO_ASSERT_LOG_ONLY(lock->verified, "new advice should have been verified");
 	VDO_ASSERT_LOG_ONLY(lock->update_advice, "should only update advice if needed");
 
-	agent->last_async_operation = VIO_ASYNC_OP_UPDATE_DEDUPE_INDEX;
+	set_data_vio_async_operation(agent, VIO_ASYNC_OP_UPDATE_DEDUPE_INDEX);
 	set_data_vio_hash_zone_callback(agent, finish_updating);
 	query_index(agent, UDS_UPDATE);
 }
@@ -1140,20 +1140,30 @@ static void finish_verifying(struct vdo_completion *completion)
 	}
 }
 
-static bool blocks_equal(char *block1, char *block2)
+/*
+ * Compare a cache line's worth of words per branch, accumulating the differences so that the loads
+ * do not depend on each other. Verification nearly always succeeds, so the whole block is almost
+ * always examined and the early exit matters much less than the loop overhead.
+ */
+STATIC bool blocks_equal(char *block1, char *block2)
 {
-	int i;
+	const u64 *words1 = (const u64 *) block1;
+	const u64 *words2 = (const u64 *) block2;
+	unsigned int i;
 
 #ifdef INTERNAL
-	BUILD_BUG_ON(VDO_BLOCK_SIZE % sizeof(u64) != 0);
+	BUILD_BUG_ON(VDO_BLOCK_SIZE % VDO_BLOCK_COMPARE_STRIDE != 0);
 	VDO_ASSERT_LOG_ONLY((uintptr_t) block1 % sizeof(u64) == 0,
 			    "Data blocks are expected to be aligned");
 	VDO_ASSERT_LOG_ONLY((uintptr_t) block2 % sizeof(u64) == 0,
 			    "Data blocks are expected to be aligned");
 
 #endif  /* INTERNAL */
-	for (i = 0; i < VDO_BLOCK_SIZE; i += sizeof(u64)) {
-		if (*((u64 *) &block1[i]) != *((u64 *) &block2[i]))
+	for (i = 0; i < VDO_BLOCK_SIZE / sizeof(u64); i += VDO_BLOCK_COMPARE_WORDS) {
+		if (((words1[i] ^ words2[i]) | (words1[i + 1] ^ words2[i + 1]) |
+		     (words1[i + 2] ^ words2[i + 2]) | (words1[i + 3] ^ words2[i + 3]) |
+		     (words1[i + 4] ^ words2[i + 4]) | (words1[i + 5] ^ words2[i + 5]) |
+		     (words1[i + 6] ^ words2[i + 6]) | (words1[i + 7] ^ words2[i + 7])) != 0)
 			return false;
 	}
 
@@ -1228,7 +1238,7 @@ static void start_verifying(struct hash_lock *lock, struct data_vio *agent)
 	lock->state = VDO_HASH_LOCK_VERIFYING;
 	VDO_ASSERT_LOG_ONLY(!lock->verified, "hash lock only verifies advice once");
 
-	agent->last_async_operation = VIO_ASYNC_OP_VERIFY_DUPLICATION;
+	set_data_vio_async_operation(agent, VIO_ASYNC_OP_VERIFY_DUPLICATION);
 	result = vio_reset_bio(vio, buffer, verify_endio, REQ_OP_READ,
 			       agent->duplicate.pbn);
 	if (result != VDO_SUCCESS) {
@@ -1450,7 +1460,7 @@ static void start_locking(struct hash_lock *lock, struct data_vio *agent)
 	 * accepting the advice, and don't explicitly change lock states (or use an agent-local
 	 * state, or an atomic), we can avoid a thread transition here.
 	 */
-	agent->last_async_operation = VIO_ASYNC_OP_LOCK_DUPLICATE_PBN;
+	set_data_vio_async_operation(agent, VIO_ASYNC_OP_LOCK_DUPLICATE_PBN);
 	launch_data_vio_duplicate_zone_callback(agent, lock_duplicate_pbn);
 }
 
@@ -1741,7 +1751,7 @@ static void start_querying(struct hash_lock *lock, struct data_vio *data_vio)
 {
 	lock->agent = data_vio;
 	lock->state = VDO_HASH_LOCK_QUERYING;
-	data_vio->last_async_operation = VIO_ASYNC_OP_CHECK_FOR_DUPLICATION;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_CHECK_FOR_DUPLICATION);
 	set_data_vio_hash_zone_callback(data_vio, finish_querying);
 	query_index(data_vio,
 		    (data_vio_has_allocation(data_vio) ? UDS_POST : UDS_QUERY));
@@ -1883,6 +1893,7 @@ void vdo_acquire_hash_lock(struct vdo_completion *completion)
 		return;
 	}
 
+	increment_stat(&data_vio->hash_zone->statistics.lock_requests);
 	result = acquire_lock(data_vio->hash_zone, &data_vio->record_name, NULL, &lock);
 	if (result != VDO_SUCCESS) {
 		continue_data_vio_with_error(data_vio, result);
@@ -2743,12 +2754,16 @@ static void get_hash_zone_statistics(const struct hash_zone *zone,
 				     struct hash_lock_statistics *tally)
 {
 	const struct hash_lock_statistics *stats = &zone->statistics;
+	u64 lock_requests = READ_ONCE(stats->lock_requests);
 
 	tally->dedupe_advice_valid += READ_ONCE(stats->dedupe_advice_valid);
 	tally->dedupe_advice_stale += READ_ONCE(stats->dedupe_advice_stale);
 	tally->concurrent_data_matches += READ_ONCE(stats->concurrent_data_matches);
 	tally->concurrent_hash_collisions += READ_ONCE(stats->concurrent_hash_collisions);
 	tally->curr_dedupe_queries += READ_ONCE(zone->active);
+	tally->lock_requests += lock_requests;
+	tally->max_zone_lock_requests = max(tally->max_zone_lock_requests, lock_requests);
+	tally->min_zone_lock_requests = min(tally->min_zone_lock_requests, lock_requests);
 }
 
 static void get_index_statistics(struct hash_zones *zones,
@@ -2794,6 +2809,8 @@ void vdo_get_dedupe_statistics(struct hash_zones *zones, struct vdo_statistics *
 {
 	zone_count_t zone;
 
+	/* Start the minimum high so that the first zone sets it. */
+	stats->hash_lock.min_zone_lock_requests = U64_MAX;
 	for (zone = 0; zone < zones->zone_count; zone++)
 		get_hash_zone_statistics(&zones->zones[zone], &stats->hash_lock);
 
@@ -2818,19 +2835,24 @@ struct hash_zone *vdo_select_hash_zone(struct hash_zones *zones,
 				       const struct uds_record_name *name)
 {
 	/*
-	 * Use a fragment of the record name as a hash code. Eight bits of hash should suffice
-	 * since the number of hash zones is small.
-	 * TODO: Verify that the first byte is independent enough.
+	 * Fold the whole record name into a 32-bit hash code. A single byte of the name only
+	 * gives 256 buckets, which can't be split evenly among many zones; with 100 zones, some
+	 * zones would get half again as many names as others. The multiply by 2^64/phi spreads
+	 * every bit of the folded name into the high half, which is the part the scaling below
+	 * depends on, so no one field of the name which the index uses for its own purposes
+	 * decides the zone.
 	 */
-	u32 hash = name->name[0];
+	u64 folded = (get_unaligned_le64(&name->name[0]) ^
+		      get_unaligned_le64(&name->name[8]));
+	u32 hash = (folded * 0x9e3779b97f4a7c15ULL) >> 32;
 
 	/*
-	 * Scale the 8-bit hash fragment to a zone index by treating it as a binary fraction and
+	 * Scale the 32-bit hash to a zone index by treating it as a binary fraction and
 	 * multiplying that by the zone count. If the hash is uniformly distributed over [0 ..
-	 * 2^8-1], then (hash * count / 2^8) should be uniformly distributed over [0 .. count-1].
-	 * The multiply and shift is much faster than a divide (modulus) on X86 CPUs.
+	 * 2^32-1], then (hash * count / 2^32) should be uniformly distributed over [0 ..
+	 * count-1]. The multiply and shift is much faster than a divide (modulus) on X86 CPUs.
 	 */
-	hash = (hash * zones->zone_count) >> 8;
+	hash = ((u64) hash * zones->zone_count) >> 32;
 	return &zones->zones[hash];
 }
 
@@ -2891,8 +2913,9 @@ static void dump_hash_zone(const struct hash_zone *zone)
 		return;
 	}
 
-	vdo_log_info("struct hash_zone %u: mapSize=%zu",
-		     zone->zone_number, vdo_int_map_size(zone->hash_lock_map));
+	vdo_log_info("struct hash_zone %u: mapSize=%zu lockRequests=%llu",
+		     zone->zone_number, vdo_int_map_size(zone->hash_lock_map),
+		     (unsigned long long) READ_ONCE(zone->statistics.lock_requests));
 	for (i = 0; i < LOCK_POOL_CAPACITY; i++)
 		dump_hash_lock(&zone->lock_array[i]);
 }
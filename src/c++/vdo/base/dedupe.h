@@ -122,6 +122,8 @@ void vdo_set_dedupe_index_timeout_interval(unsigned int value);
 void vdo_set_dedupe_index_min_timer_interval(unsigned int value);
 
 #ifdef INTERNAL
+bool blocks_equal(char *block1, char *block2);
+
 typedef int (*uds_request_hook_fn)(struct uds_request *request);
 extern uds_request_hook_fn uds_launch_request_hook;
 #endif /* INTERNAL */
@@ -9,9 +9,9 @@
 #include <linux/delay.h>
 #include <linux/device-mapper.h>
 #include <linux/err.h>
-#include <linux/lz4.h>
 #include <linux/module.h>
 #include <linux/mutex.h>
+#include <linux/nodemask.h>
 #include <linux/spinlock.h>
 #ifdef INTERNAL
 #include "linux/blkdev.h"
@@ -26,6 +26,7 @@
 #include "admin-state.h"
 #include "block-map.h"
 #include "completion.h"
+#include "compression.h"
 #include "constants.h"
 #include "data-vio.h"
 #include "dedupe.h"
@@ -254,7 +255,11 @@ static void free_device_config(struct device_config *config)
 	if (config->owned_device != NULL)
 		dm_put_device(config->owning_target, config->owned_device);
 
+	if (config->block_map_tier_device != NULL)
+		dm_put_device(config->owning_target, config->block_map_tier_device);
+
 	vdo_free(config->parent_device_name);
+	vdo_free(config->block_map_tier_name);
 	vdo_free(config->original_string);
 
 	/* Reduce the chance a use-after-free (as in BZ 1669960) happens to work. */
@@ -454,6 +459,8 @@ static inline int __must_check parse_bool(const char *bool_str, const char *true
  * @string: The string value describing compression options.
  * @config: The configuration data structure to update.
  *
+ * The string names a codec, optionally followed by ':' and a codec specific level.
+ *
  * Return: VDO_SUCCESS or an error.
  */
 static int __must_check parse_compression(const char *string,
@@ -462,25 +469,35 @@ static int __must_check parse_compression(const char *string,
 	char *delimiter = strchrnul(string, ':');
 	char *option_string = *delimiter ? delimiter + 1 : NULL;
 	int key_length = delimiter - string;
+	int level;
 	int result;
 
-	if (strncmp(string, VDO_COMPRESS_LZ4, key_length) == 0 &&
-	    key_length == strlen(VDO_COMPRESS_LZ4)) {
-		if (!option_string)
-			return VDO_SUCCESS;
-
-		result = kstrtoint(option_string, 10, &config->compression_level);
-		if (result || strlen(option_string) == 0) {
-			vdo_log_error("optional config string error: integer needed, found \"%s\"",
-				      option_string);
-			return VDO_BAD_CONFIGURATION;
-		}
-	} else {
+	result = vdo_parse_compression_codec(string, key_length, &config->compression_codec);
+	if (result != VDO_SUCCESS) {
 		vdo_log_error("optional config string error: unknown compression type \"%s\"",
 			      string);
 		return VDO_BAD_CONFIGURATION;
 	}
 
+	config->compression_level = vdo_get_default_compression_level(config->compression_codec);
+	if (!option_string)
+		return VDO_SUCCESS;
+
+	result = kstrtoint(option_string, 10, &level);
+	if (result || strlen(option_string) == 0) {
+		vdo_log_error("optional config string error: integer needed, found \"%s\"",
+			      option_string);
+		return VDO_BAD_CONFIGURATION;
+	}
+
+	result = vdo_validate_compression_level(config->compression_codec, level);
+	if (result != VDO_SUCCESS) {
+		vdo_log_error("optional config string error: invalid %s level %d",
+			      vdo_get_compression_codec_name(config->compression_codec), level);
+		return result;
+	}
+
+	config->compression_level = level;
 	return VDO_SUCCESS;
 }
 
@@ -531,6 +548,15 @@ static int process_one_thread_config_spec(const char *thread_param_type,
 		config->physical_zones = count;
 		return VDO_SUCCESS;
 	}
+	if (strcmp(thread_param_type, "numaNodes") == 0) {
+		if (count > num_online_nodes()) {
+			vdo_log_error("thread config string error: at most %u 'numaNodes' are online",
+				      num_online_nodes());
+			return -EINVAL;
+		}
+		config->numa_nodes = count;
+		return VDO_SUCCESS;
+	}
 	/* Handle other thread count parameters */
 	if (count > MAXIMUM_VDO_THREADS) {
 		vdo_log_error("thread config string error: at most %d '%s' threads are allowed",
@@ -616,7 +642,7 @@ static int parse_one_thread_config_spec(const char *spec,
  *
  * The configuration string should contain one or more comma-separated specs of the form
  * "typename=number"; the supported type names are "cpu", "ack", "bio", "bioRotationInterval",
- * "logical", "physical", and "hash".
+ * "logical", "physical", "hash", and "numaNodes".
  *
  * If an error occurs during parsing of a single key/value pair, we deem it serious enough to stop
  * further parsing.
@@ -680,6 +706,32 @@ static int process_one_key_value_pair(const char *key, unsigned int value,
 		config->max_discard_blocks = value;
 		return VDO_SUCCESS;
 	}
+
+	if (strcmp(key, "packerMaxAge") == 0) {
+		config->packer_max_age = value;
+		return VDO_SUCCESS;
+	}
+
+	if (strcmp(key, "journalCommitDelay") == 0) {
+		if (value > VDO_MAX_JOURNAL_COMMIT_DELAY) {
+			vdo_log_error("optional parameter error: at most %d microseconds of journal commit delay are allowed",
+				      VDO_MAX_JOURNAL_COMMIT_DELAY);
+			return -EINVAL;
+		}
+		config->journal_commit_delay = value;
+		return VDO_SUCCESS;
+	}
+
+	if (strcmp(key, "blockMapReadahead") == 0) {
+		if (value > VDO_MAX_BLOCK_MAP_READAHEAD) {
+			vdo_log_error("optional parameter error: at most %d block map readahead pages are allowed",
+				      VDO_MAX_BLOCK_MAP_READAHEAD);
+			return -EINVAL;
+		}
+		config->block_map_readahead = value;
+		return VDO_SUCCESS;
+	}
+
 	/* Handles unknown key names */
 	return process_one_thread_config_spec(key, value, &config->thread_counts);
 }
@@ -708,6 +760,36 @@ static int parse_one_key_value_pair(const char *key, const char *value,
 	if (strcmp(key, "compressionType") == 0)
 		return parse_compression(value, config);
 
+	if (strcmp(key, "compressionFastReject") == 0)
+		return parse_bool(value, "on", "off", &config->compression_fast_reject);
+
+	if (strcmp(key, "packerMode") == 0)
+		return parse_bool(value, "bucketed", "sorted", &config->packer_bucketed);
+
+	if (strcmp(key, "blockMapCachePolicy") == 0)
+		return parse_bool(value, "2q", "lru", &config->block_map_cache_2q);
+
+	if (strcmp(key, "blockMapWarmup") == 0)
+		return parse_bool(value, "on", "off", &config->block_map_warmup);
+
+	if (strcmp(key, "allocationLocality") == 0)
+		return parse_bool(value, "on", "off", &config->allocation_locality);
+
+	if (strcmp(key, "lazyRefCounts") == 0)
+		return parse_bool(value, "on", "off", &config->lazy_ref_counts);
+
+	if (strcmp(key, "streamingRebuild") == 0)
+		return parse_bool(value, "on", "off", &config->streaming_rebuild);
+
+	if (strcmp(key, "journalGroupCommit") == 0)
+		return parse_bool(value, "on", "off", &config->journal_group_commit);
+
+	if (strcmp(key, "blockMapCacheDevice") == 0) {
+		vdo_free(config->block_map_tier_name);
+		return vdo_duplicate_string(value, "block map cache device name",
+					    &config->block_map_tier_name);
+	}
+
 	/* The remaining arguments must have non-negative integral values. */
 	result = kstrtouint(value, 10, &count);
 	if (result) {
@@ -863,11 +945,24 @@ static int parse_device_config(int argc, char **argv, struct dm_target *ti,
 		.logical_zones = 0,
 		.physical_zones = 0,
 		.hash_zones = 0,
+		.numa_nodes = 0,
 	};
 	config->max_discard_blocks = 1;
 	config->deduplication = true;
 	config->compression = false;
-	config->compression_level = LZ4_ACCELERATION_DEFAULT;
+	config->compression_codec = VDO_CODEC_LZ4;
+	config->compression_level = vdo_get_default_compression_level(VDO_CODEC_LZ4);
+	config->compression_fast_reject = false;
+	config->packer_bucketed = false;
+	config->packer_max_age = 0;
+	config->block_map_cache_2q = false;
+	config->block_map_readahead = 0;
+	config->block_map_warmup = true;
+	config->allocation_locality = false;
+	config->lazy_ref_counts = false;
+	config->streaming_rebuild = false;
+	config->journal_group_commit = false;
+	config->journal_commit_delay = 0;
 
 	arg_set.argc = argc;
 	arg_set.argv = argv;
@@ -989,6 +1084,28 @@ static int parse_device_config(int argc, char **argv, struct dm_target *ti,
 		return VDO_BAD_CONFIGURATION;
 	}
 
+	if (config->block_map_tier_name != NULL) {
+		result = dm_get_device(ti, config->block_map_tier_name,
+				       dm_table_get_mode(ti->table),
+				       &config->block_map_tier_device);
+		if (result != 0) {
+			vdo_log_error("couldn't open device \"%s\": error %d",
+				      config->block_map_tier_name, result);
+			handle_parse_error(config, error_ptr,
+					   "Unable to open block map cache device");
+			return VDO_BAD_CONFIGURATION;
+		}
+
+		config->block_map_tier_blocks =
+			bdev_nr_bytes(config->block_map_tier_device->bdev) / VDO_BLOCK_SIZE;
+		if (config->block_map_tier_blocks <
+		    max_t(unsigned int, config->thread_counts.logical_zones, 1)) {
+			handle_parse_error(config, error_ptr,
+					   "Block map cache device is too small");
+			return VDO_BAD_CONFIGURATION;
+		}
+	}
+
 	if (config->version == 0) {
 		u64 device_size = bdev_nr_bytes(config->owned_device->bdev);
 
@@ -1189,7 +1306,8 @@ static void vdo_status(struct dm_target *ti, status_type_t status_type,
 		       vdo_get_backing_device(vdo), stats->mode,
 		       stats->in_recovery_mode ? "recovering" : "-",
 		       vdo_get_dedupe_index_state_name(vdo->hash_zones),
-		       VDO_COMPRESS_LZ4, device_config->compression_level,
+		       vdo_get_compression_codec_name(device_config->compression_codec),
+		       device_config->compression_level,
 		       vdo_get_compressing(vdo) ? "on" : "off",
 		       stats->data_blocks_used + stats->overhead_blocks_used,
 		       stats->physical_blocks);
@@ -1233,6 +1351,17 @@ static int __must_check process_vdo_message_locked(struct vdo *vdo, unsigned int
 		return -EINVAL;
 	}
 
+	if ((argc == 2) && (strcasecmp(argv[0], "warmup") == 0)) {
+		if (strcasecmp(argv[1], "start") == 0)
+			return vdo_warm_up_block_map_cache(vdo, true);
+
+		if (strcasecmp(argv[1], "cancel") == 0)
+			return vdo_warm_up_block_map_cache(vdo, false);
+
+		vdo_log_warning("invalid argument '%s' to dmsetup warmup message", argv[1]);
+		return -EINVAL;
+	}
+
 	vdo_log_warning("unrecognized dmsetup message '%s' received", argv[0]);
 	return -EINVAL;
 }
@@ -1581,6 +1710,11 @@ static int __must_check decode_vdo(struct vdo *vdo)
 	if (result != VDO_SUCCESS)
 		return result;
 
+	/* The list of pages to warm up the cache with is only advisory. */
+	if (vdo_decode_hot_page_list(vdo->super_block.buffer,
+				     &vdo->block_map->hot_pages) != VDO_SUCCESS)
+		vdo_log_debug("no block map cache warm-up list");
+
 	result = vdo_make_physical_zones(vdo, &vdo->physical_zones);
 	if (result != VDO_SUCCESS)
 		return result;
@@ -1966,6 +2100,15 @@ static int prepare_to_grow_physical(struct vdo *vdo, block_count_t new_physical_
 	return VDO_SUCCESS;
 }
 
+/* Check whether two optional devices are the same device. */
+static bool is_same_device(struct dm_dev *a, struct dm_dev *b)
+{
+	if ((a == NULL) || (b == NULL))
+		return (a == b);
+
+	return (a->bdev->bd_dev == b->bdev->bd_dev);
+}
+
 /**
  * validate_new_device_config() - Check whether a new device config represents a valid modification
  *				  to an existing config.
@@ -2006,6 +2149,48 @@ static int validate_new_device_config(struct device_config *to_validate,
 		return VDO_PARAMETER_MISMATCH;
 	}
 
+	if (to_validate->block_map_cache_2q != config->block_map_cache_2q) {
+		*error_ptr = "Block map cache policy cannot change";
+		return VDO_PARAMETER_MISMATCH;
+	}
+
+	if (to_validate->block_map_readahead != config->block_map_readahead) {
+		*error_ptr = "Block map readahead cannot change";
+		return VDO_PARAMETER_MISMATCH;
+	}
+
+	if (!is_same_device(to_validate->block_map_tier_device,
+			    config->block_map_tier_device) ||
+	    (to_validate->block_map_tier_blocks != config->block_map_tier_blocks)) {
+		*error_ptr = "Block map cache device cannot change";
+		return VDO_PARAMETER_MISMATCH;
+	}
+
+	if (to_validate->allocation_locality != config->allocation_locality) {
+		*error_ptr = "Allocation locality cannot change";
+		return VDO_PARAMETER_MISMATCH;
+	}
+
+	if (to_validate->packer_bucketed != config->packer_bucketed) {
+		*error_ptr = "Packer mode cannot change";
+		return VDO_PARAMETER_MISMATCH;
+	}
+
+	if (to_validate->packer_max_age != config->packer_max_age) {
+		*error_ptr = "Packer maximum age cannot change";
+		return VDO_PARAMETER_MISMATCH;
+	}
+
+	if (to_validate->journal_group_commit != config->journal_group_commit) {
+		*error_ptr = "Journal group commit cannot change";
+		return VDO_PARAMETER_MISMATCH;
+	}
+
+	if (to_validate->journal_commit_delay != config->journal_commit_delay) {
+		*error_ptr = "Journal commit delay cannot change";
+		return VDO_PARAMETER_MISMATCH;
+	}
+
 	if (memcmp(&to_validate->thread_counts, &config->thread_counts,
 		   sizeof(struct thread_count_config)) != 0) {
 		*error_ptr = "Thread configuration cannot change";
@@ -2526,6 +2711,9 @@ static void load_callback(struct vdo_completion *completion)
 			vdo_start_dedupe_index(vdo->hash_zones, was_new(vdo));
 		}
 
+		if (vdo->device_config->block_map_warmup)
+			vdo_warm_up_block_map(vdo->block_map, true, NULL);
+
 		vdo->allocations_allowed = false;
 		fallthrough;
 
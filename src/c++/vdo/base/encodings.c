@@ -29,6 +29,19 @@ struct geometry_block {
 	u32 checksum;
 } __packed;
 
+static const struct header GEOMETRY_BLOCK_HEADER_6_0 = {
+	.id = VDO_GEOMETRY_BLOCK,
+	.version = {
+		.major_version = 6,
+		.minor_version = 0,
+	},
+	/*
+	 * Note: this size isn't just the payload size following the header, like it is everywhere
+	 * else in VDO.
+	 */
+	.size = sizeof(struct geometry_block) + sizeof(struct volume_geometry),
+};
+
 static const struct header GEOMETRY_BLOCK_HEADER_5_0 = {
 	.id = VDO_GEOMETRY_BLOCK,
 	.version = {
@@ -39,7 +52,7 @@ static const struct header GEOMETRY_BLOCK_HEADER_5_0 = {
 	 * Note: this size isn't just the payload size following the header, like it is everywhere
 	 * else in VDO.
 	 */
-	.size = sizeof(struct geometry_block) + sizeof(struct volume_geometry),
+	.size = sizeof(struct geometry_block) + sizeof(struct volume_geometry_5_0),
 };
 
 static const struct header GEOMETRY_BLOCK_HEADER_4_0 = {
@@ -57,6 +70,11 @@ static const struct header GEOMETRY_BLOCK_HEADER_4_0 = {
 
 const u8 VDO_GEOMETRY_MAGIC_NUMBER[VDO_GEOMETRY_MAGIC_NUMBER_SIZE + 1] = "dmvdo001";
 
+static const char *HASH_ALGORITHM_NAMES[] = {
+	[VDO_HASH_MURMUR3] = "murmur3",
+	[VDO_HASH_MURMUR3_STRIPED] = "murmur3-striped",
+};
+
 #define PAGE_HEADER_4_1_SIZE (8 + 8 + 8 + 1 + 1 + 1 + 1)
 
 static const struct version_number BLOCK_MAP_4_1 = {
@@ -132,6 +150,17 @@ static const struct header SUPER_BLOCK_HEADER_12_0 = {
 	.size = VDO_SUPER_BLOCK_FIXED_SIZE - VDO_ENCODED_HEADER_SIZE,
 };
 
+static const struct header HOT_PAGE_LIST_HEADER_1_0 = {
+	.id = VDO_HOT_PAGE_LIST,
+	.version = {
+			.major_version = 1,
+			.minor_version = 0,
+		},
+
+	/* This is the size of an empty list. */
+	.size = sizeof(u8) + sizeof(__le16),
+};
+
 /**
  * validate_version() - Check whether a version matches an expected version.
  * @expected_version: The expected version.
@@ -291,6 +320,34 @@ static void decode_volume_geometry(u8 *buffer, size_t *offset,
 		.mem = mem,
 		.sparse = sparse,
 	};
+
+	geometry->hash_algorithm = ((version > 5) ? buffer[(*offset)++] : VDO_HASH_MURMUR3);
+}
+
+/**
+ * get_geometry_block_header() - Get the header for a given geometry block version.
+ * @version: The major version of the geometry block.
+ */
+static const struct header *get_geometry_block_header(u32 version)
+{
+	if (version <= 4)
+		return &GEOMETRY_BLOCK_HEADER_4_0;
+
+	return ((version == 5) ? &GEOMETRY_BLOCK_HEADER_5_0 : &GEOMETRY_BLOCK_HEADER_6_0);
+}
+
+/**
+ * vdo_get_hash_algorithm_name() - Get the name of a record name hash algorithm.
+ * @algorithm: The algorithm.
+ *
+ * Return: The name of the algorithm, or "unknown" if it is not valid.
+ */
+const char *vdo_get_hash_algorithm_name(enum vdo_hash_algorithm algorithm)
+{
+	if (algorithm >= VDO_HASH_ALGORITHM_COUNT)
+		return "unknown";
+
+	return HASH_ALGORITHM_NAMES[algorithm];
 }
 
 #if (defined(VDO_USER) || defined(INTERNAL))
@@ -308,8 +365,15 @@ int encode_volume_geometry(u8 *buffer, size_t *offset,
 {
 	enum volume_region_id id;
 	const struct header *header;
+	int result;
+
+	result = VDO_ASSERT((version > 5) || (geometry->hash_algorithm == VDO_HASH_MURMUR3),
+			    "geometry version %u cannot record hash algorithm %s", version,
+			    vdo_get_hash_algorithm_name(geometry->hash_algorithm));
+	if (result != VDO_SUCCESS)
+		return result;
 
-	header = ((version <= 4) ? &GEOMETRY_BLOCK_HEADER_4_0 : &GEOMETRY_BLOCK_HEADER_5_0);
+	header = get_geometry_block_header(version);
 	vdo_encode_header(buffer, offset, header);
 
 	/* This is for backwards compatibility */
@@ -334,6 +398,9 @@ int encode_volume_geometry(u8 *buffer, size_t *offset,
 	else
 		buffer[(*offset)++] = 0;
 
+	if (version > 5)
+		buffer[(*offset)++] = geometry->hash_algorithm;
+
 	return VDO_ASSERT(header->size == (*offset + sizeof(u32)),
 		          "should have included up to the geometry checksum");
 }
@@ -356,13 +423,8 @@ int __must_check vdo_parse_geometry_block(u8 *block, struct volume_geometry *geo
 	offset += VDO_GEOMETRY_MAGIC_NUMBER_SIZE;
 
 	vdo_decode_header(block, &offset, &header);
-	if (header.version.major_version <= 4) {
-		result = vdo_validate_header(&GEOMETRY_BLOCK_HEADER_4_0, &header,
-					     true, __func__);
-	} else {
-		result = vdo_validate_header(&GEOMETRY_BLOCK_HEADER_5_0, &header,
-					     true, __func__);
-	}
+	result = vdo_validate_header(get_geometry_block_header(header.version.major_version),
+				     &header, true, __func__);
 	if (result != VDO_SUCCESS)
 		return result;
 
@@ -376,8 +438,16 @@ int __must_check vdo_parse_geometry_block(u8 *block, struct volume_geometry *geo
 	/* Decode and verify the checksum. */
 	checksum = vdo_crc32(block, offset);
 	decode_u32_le(block, &offset, &saved_checksum);
+	if (checksum != saved_checksum)
+		return VDO_CHECKSUM_MISMATCH;
+
+	if (geometry->hash_algorithm >= VDO_HASH_ALGORITHM_COUNT) {
+		return vdo_log_error_strerror(VDO_UNSUPPORTED_VERSION,
+					      "unknown record name hash algorithm %u",
+					      geometry->hash_algorithm);
+	}
 
-	return ((checksum == saved_checksum) ? VDO_SUCCESS : VDO_CHECKSUM_MISMATCH);
+	return VDO_SUCCESS;
 }
 
 struct block_map_page *vdo_format_block_map_page(void *buffer, nonce_t nonce,
@@ -1545,3 +1615,95 @@ int vdo_decode_super_block(u8 *buffer)
 
 	return ((checksum != saved_checksum) ? VDO_CHECKSUM_MISMATCH : VDO_SUCCESS);
 }
+
+/**
+ * vdo_encode_hot_page_list() - Encode the list of cached block map pages into the unused sectors
+ *                              of a super block buffer.
+ * @buffer: The super block buffer.
+ * @list: The list to encode.
+ */
+void vdo_encode_hot_page_list(u8 *buffer, const struct hot_page_list *list)
+{
+	u32 checksum;
+	u16 i;
+	struct header header = HOT_PAGE_LIST_HEADER_1_0;
+	size_t offset = VDO_HOT_PAGE_LIST_OFFSET;
+
+	header.size += list->run_count * VDO_HOT_PAGE_RUN_ENCODED_SIZE;
+	vdo_encode_header(buffer, &offset, &header);
+	buffer[offset++] = list->zone_count;
+	encode_u16_le(buffer, &offset, list->run_count);
+	for (i = 0; i < list->run_count; i++) {
+		const struct hot_page_run *run = &list->runs[i];
+
+		encode_u64_le(buffer, &offset, run->pbn);
+		encode_u16_le(buffer, &offset, run->page_count);
+		buffer[offset++] = run->zone;
+	}
+
+	checksum = vdo_crc32(buffer + VDO_HOT_PAGE_LIST_OFFSET,
+			     offset - VDO_HOT_PAGE_LIST_OFFSET);
+	encode_u32_le(buffer, &offset, checksum);
+
+	VDO_ASSERT_LOG_ONLY(offset <= VDO_BLOCK_SIZE, "hot page list must fit in the super block");
+}
+
+/**
+ * vdo_decode_hot_page_list() - Decode the list of cached block map pages from a super block
+ *                              buffer.
+ * @buffer: The super block buffer.
+ * @list: The list to decode into; it will be empty if the buffer does not hold a valid list.
+ *
+ * Return: VDO_SUCCESS or an error if there is no valid list.
+ */
+int vdo_decode_hot_page_list(u8 *buffer, struct hot_page_list *list)
+{
+	struct header header;
+	u32 checksum, saved_checksum;
+	u16 run_count, i;
+	size_t offset = VDO_HOT_PAGE_LIST_OFFSET;
+
+	list->zone_count = 0;
+	list->run_count = 0;
+
+	/*
+	 * Volumes saved before the list existed may have anything in these sectors, so don't log
+	 * validation failures.
+	 */
+	vdo_decode_header(buffer, &offset, &header);
+	if (header.id != VDO_HOT_PAGE_LIST)
+		return VDO_INCORRECT_COMPONENT;
+
+	if (!vdo_are_same_version(HOT_PAGE_LIST_HEADER_1_0.version, header.version) ||
+	    (header.size < HOT_PAGE_LIST_HEADER_1_0.size) ||
+	    (header.size > (HOT_PAGE_LIST_HEADER_1_0.size +
+			    (VDO_MAX_HOT_PAGE_RUNS * VDO_HOT_PAGE_RUN_ENCODED_SIZE))))
+		return VDO_UNSUPPORTED_VERSION;
+
+	checksum = vdo_crc32(buffer + VDO_HOT_PAGE_LIST_OFFSET,
+			     VDO_ENCODED_HEADER_SIZE + header.size);
+	offset += header.size;
+	decode_u32_le(buffer, &offset, &saved_checksum);
+	if (checksum != saved_checksum)
+		return VDO_CHECKSUM_MISMATCH;
+
+	offset = VDO_HOT_PAGE_LIST_OFFSET + VDO_ENCODED_HEADER_SIZE;
+	list->zone_count = buffer[offset++];
+	decode_u16_le(buffer, &offset, &run_count);
+	if (header.size != (HOT_PAGE_LIST_HEADER_1_0.size +
+			    (run_count * VDO_HOT_PAGE_RUN_ENCODED_SIZE))) {
+		list->zone_count = 0;
+		return VDO_UNSUPPORTED_VERSION;
+	}
+
+	for (i = 0; i < run_count; i++) {
+		struct hot_page_run *run = &list->runs[i];
+
+		decode_u64_le(buffer, &offset, &run->pbn);
+		decode_u16_le(buffer, &offset, &run->page_count);
+		run->zone = buffer[offset++];
+	}
+
+	list->run_count = run_count;
+	return VDO_SUCCESS;
+}
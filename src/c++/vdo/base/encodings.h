@@ -57,6 +57,7 @@ struct packed_version_number {
 #define VDO_SLAB_DEPOT 3
 #define VDO_BLOCK_MAP 4
 #define VDO_GEOMETRY_BLOCK 5
+#define VDO_HOT_PAGE_LIST 6
 
 /* The header for versioned data stored on disk. */
 struct header {
@@ -76,8 +77,19 @@ enum {
 	VDO_GEOMETRY_BLOCK_LOCATION = 0,
 	VDO_GEOMETRY_MAGIC_NUMBER_SIZE = 8,
 	VDO_DEFAULT_GEOMETRY_BLOCK_VERSION = 5,
+	/* The first geometry block version which records the record name hash algorithm */
+	VDO_HASH_ALGORITHM_GEOMETRY_BLOCK_VERSION = 6,
 };
 
+/* The functions which may be used to compute the record name of a data block. */
+enum vdo_hash_algorithm {
+	/* MurmurHash3 x64-128 of the whole block; the only choice before geometry version 6 */
+	VDO_HASH_MURMUR3 = 0,
+	/* MurmurHash3 x64-128 over four interleaved stripes of the block, then folded */
+	VDO_HASH_MURMUR3_STRIPED = 1,
+	VDO_HASH_ALGORITHM_COUNT,
+} __packed;
+
 struct index_config {
 	u32 mem;
 	u32 unused;
@@ -113,6 +125,24 @@ struct volume_geometry {
 	struct volume_region regions[VDO_VOLUME_REGION_COUNT];
 	/* The index config */
 	struct index_config index_config;
+	/* The function used to compute record names for deduplication */
+	enum vdo_hash_algorithm hash_algorithm;
+} __packed;
+
+/* This volume geometry struct is used for sizing only */
+struct volume_geometry_5_0 {
+	/* For backwards compatibility */
+	u32 unused;
+	/* The nonce of this volume */
+	nonce_t nonce;
+	/* The uuid of this volume */
+	uuid_t uuid;
+	/* The block offset to be applied to bios */
+	block_count_t bio_offset;
+	/* The regions in ID order */
+	struct volume_region regions[VDO_VOLUME_REGION_COUNT];
+	/* The index config */
+	struct index_config index_config;
 } __packed;
 
 /* This volume geometry struct is used for sizing only */
@@ -694,6 +724,33 @@ enum {
 				   BLOCK_MAP_COMPONENT_ENCODED_SIZE),
 };
 
+/*
+ * The list of cached block map pages is stored in the otherwise unused sectors of the super block,
+ * following the component data. It is only advisory, so a torn write merely loses the list.
+ */
+enum {
+	VDO_HOT_PAGE_LIST_OFFSET = VDO_SECTOR_SIZE,
+	VDO_HOT_PAGE_RUN_ENCODED_SIZE = sizeof(__le64) + sizeof(__le16) + sizeof(u8),
+	VDO_MAX_HOT_PAGE_RUNS = ((VDO_BLOCK_SIZE - VDO_HOT_PAGE_LIST_OFFSET -
+				  VDO_ENCODED_HEADER_SIZE - sizeof(u8) - sizeof(__le16) -
+				  sizeof(__le32)) / VDO_HOT_PAGE_RUN_ENCODED_SIZE),
+};
+
+/* A run of block map leaf pages with consecutive PBNs which were cached by one logical zone. */
+struct hot_page_run {
+	physical_block_number_t pbn;
+	u16 page_count;
+	u8 zone;
+};
+
+/* The block map leaf pages which were cached when the vdo was last saved. */
+struct hot_page_list {
+	/* The number of logical zones when the list was recorded */
+	zone_count_t zone_count;
+	u16 run_count;
+	struct hot_page_run runs[VDO_MAX_HOT_PAGE_RUNS];
+};
+
 /* The entirety of the component data encoded in the VDO super block. */
 struct vdo_component_states {
 	/* For backwards compatibility */
@@ -850,6 +907,25 @@ vdo_get_index_region_size(struct volume_geometry geometry)
 int __must_check vdo_parse_geometry_block(unsigned char *block,
 					  struct volume_geometry *geometry);
 
+/**
+ * vdo_get_geometry_block_version() - Get the oldest geometry block version which can record a
+ *                                    geometry.
+ * @geometry: The geometry to be recorded.
+ *
+ * Volumes which use the default record name hash keep the older format so that older releases
+ * can still load them.
+ *
+ * Return: The geometry block version to write.
+ */
+static inline u32 __must_check
+vdo_get_geometry_block_version(const struct volume_geometry *geometry)
+{
+	return ((geometry->hash_algorithm == VDO_HASH_MURMUR3) ?
+		VDO_DEFAULT_GEOMETRY_BLOCK_VERSION : VDO_HASH_ALGORITHM_GEOMETRY_BLOCK_VERSION);
+}
+
+const char * __must_check vdo_get_hash_algorithm_name(enum vdo_hash_algorithm algorithm);
+
 #if (defined(VDO_USER) || defined(INTERNAL))
 int __must_check encode_volume_geometry(u8 *buffer, size_t *offset,
 					const struct volume_geometry *geometry,
@@ -1340,6 +1416,9 @@ int __must_check vdo_validate_component_states(struct vdo_component_states *stat
 void vdo_encode_super_block(u8 *buffer, struct vdo_component_states *states);
 int __must_check vdo_decode_super_block(u8 *buffer);
 
+void vdo_encode_hot_page_list(u8 *buffer, const struct hot_page_list *list);
+int __must_check vdo_decode_hot_page_list(u8 *buffer, struct hot_page_list *list);
+
 /* We start with 0L and postcondition with ~0L to match our historical usage in userspace. */
 static inline u32 vdo_crc32(const void *buf, unsigned long len)
 {
@@ -10,7 +10,11 @@
 #include <linux/completion.h>
 #include <linux/err.h>
 #include <linux/kthread.h>
+#include <linux/ktime.h>
+#include <linux/numa.h>
 #include <linux/percpu.h>
+#include <linux/spinlock.h>
+#include <linux/topology.h>
 #ifndef VDO_UPSTREAM
 #include <linux/version.h>
 #endif /* VDO_UPSTREAM */
@@ -27,6 +31,14 @@
 
 static DEFINE_PER_CPU(unsigned int, service_queue_rotor);
 
+enum {
+	/* The most completions a worker will run before checking whether to yield the CPU */
+	VDO_WORK_QUEUE_BATCH_SIZE = 16,
+};
+
+/* The longest a worker thread will spin waiting for work before sleeping, in microseconds */
+unsigned int vdo_work_queue_max_spin_interval = 10;
+
 /**
  * DOC: Work queue definition.
  *
@@ -34,6 +46,12 @@ static DEFINE_PER_CPU(unsigned int, service_queue_rotor);
  * a group of the former to do the work, and assigns work to them in round-robin fashion (roughly).
  * Externally, both are represented via the same common sub-structure, though there's actually not
  * a great deal of overlap between the two types internally.
+ *
+ * If the queue type allows stealing, a thread of a round-robin queue which runs out of work will
+ * take completions from the funnel queues of its siblings before going to sleep, so that one long
+ * job doesn't leave the completions queued behind it waiting while other threads are idle. Since
+ * funnel queues only support a single consumer, each simple queue of such a group then guards its
+ * polling with a spin lock; a thief only ever tries that lock, and moves on if it is held.
  */
 struct vdo_work_queue {
 	/* Name of just the work queue (e.g., "cpuQ12") */
@@ -48,6 +66,10 @@ struct simple_work_queue {
 	struct vdo_work_queue common;
 	struct funnel_queue *priority_lists[VDO_WORK_Q_MAX_PRIORITY + 1];
 	void *private;
+	/* The round-robin queue to steal from, set once all its threads have started */
+	struct round_robin_work_queue *group;
+	/* The index of this queue in its group */
+	unsigned int index;
 
 	/*
 	 * The fields above are unchanged after setup but often read, and are good candidates for
@@ -60,6 +82,21 @@ struct simple_work_queue {
 	wait_queue_head_t waiting_worker_threads ____cacheline_aligned;
 	/* Hack to reduce wakeup calls if the worker thread is running */
 	atomic_t idle;
+	/* Serializes polling if other threads of the group may steal from this queue */
+	spinlock_t poll_lock;
+	/*
+	 * A moving average of the time from the worker running out of work to new work arriving,
+	 * in nanoseconds
+	 */
+	u64 average_idle_ns;
+	/* The time at which an enqueuer last took responsibility for waking the idle worker */
+	u64 wake_request_ns;
+	/* Counters, written only by the worker thread */
+	u64 wakeups;
+	u64 spins;
+	u64 spin_hits;
+	u64 batches;
+	u64 completions;
 
 	/* These are infrequently used so in terms of performance we don't care where they land. */
 	struct task_struct *thread;
@@ -96,7 +133,7 @@ static inline struct round_robin_work_queue *as_round_robin_work_queue(struct vd
  * we'll grab the latter (but we'll catch the high-priority item on the next call). If strict
  * enforcement of priorities becomes necessary, this function will need fixing.
  */
-static struct vdo_completion *poll_for_completion(struct simple_work_queue *queue)
+static struct vdo_completion *poll_priority_lists(struct simple_work_queue *queue)
 {
 	int i;
 
@@ -110,7 +147,78 @@ static struct vdo_completion *poll_for_completion(struct simple_work_queue *queu
 	return NULL;
 }
 
-static void enqueue_work_queue_completion(struct simple_work_queue *queue,
+static struct vdo_completion *poll_for_completion(struct simple_work_queue *queue)
+{
+	struct vdo_completion *completion;
+
+	if (!queue->common.type->allow_stealing)
+		return poll_priority_lists(queue);
+
+	spin_lock(&queue->poll_lock);
+	completion = poll_priority_lists(queue);
+	spin_unlock(&queue->poll_lock);
+	return completion;
+}
+
+/*
+ * Take a waiting completion from one of the other threads of this queue's group, if stealing is
+ * allowed. Siblings which are busy polling their own queues are skipped rather than waited for.
+ */
+static struct vdo_completion *steal_completion(struct simple_work_queue *queue)
+{
+	struct round_robin_work_queue *group = smp_load_acquire(&queue->group);
+	unsigned int i;
+
+	if (group == NULL)
+		return NULL;
+
+	for (i = 1; i < group->num_service_queues; i++) {
+		struct simple_work_queue *victim =
+			group->service_queues[(queue->index + i) % group->num_service_queues];
+		struct vdo_completion *completion;
+
+		if (!spin_trylock(&victim->poll_lock))
+			continue;
+
+		completion = poll_priority_lists(victim);
+		spin_unlock(&victim->poll_lock);
+		if (completion == NULL)
+			continue;
+
+		VDO_ASSERT_LOG_ONLY(completion->my_queue == &victim->common,
+				    "stolen completion %px marked as being in queue %px",
+				    completion, &victim->common);
+		completion->my_queue = &queue->common;
+		return completion;
+	}
+
+	return NULL;
+}
+
+static struct vdo_completion *find_completion(struct simple_work_queue *queue)
+{
+	struct vdo_completion *completion = poll_for_completion(queue);
+
+	return ((completion != NULL) ? completion : steal_completion(queue));
+}
+
+/*
+ * Wake the worker thread if it is idle. Returns true if this call took responsibility for waking
+ * it.
+ */
+static bool wake_worker_if_idle(struct simple_work_queue *queue)
+{
+	if ((atomic_read(&queue->idle) != 1) || (atomic_cmpxchg(&queue->idle, 1, 0) != 1))
+		return false;
+
+	WRITE_ONCE(queue->wake_request_ns, ktime_get_ns());
+	/* There's a maximum of one thread in this list. */
+	wake_up(&queue->waiting_worker_threads);
+	return true;
+}
+
+/* Returns true if the worker thread of the queue was woken to process the completion. */
+static bool enqueue_work_queue_completion(struct simple_work_queue *queue,
 					  struct vdo_completion *completion)
 {
 	VDO_ASSERT_LOG_ONLY(completion->my_queue == NULL,
@@ -146,11 +254,7 @@ static void enqueue_work_queue_completion(struct simple_work_queue *queue,
 	 * first is any better or worse for other platforms, even other x86 configurations.
 	 */
 	smp_mb();
-	if ((atomic_read(&queue->idle) != 1) || (atomic_cmpxchg(&queue->idle, 1, 0) != 1))
-		return;
-
-	/* There's a maximum of one thread in this list. */
-	wake_up(&queue->waiting_worker_threads);
+	return wake_worker_if_idle(queue);
 }
 
 static void run_start_hook(struct simple_work_queue *queue)
@@ -165,6 +269,68 @@ static void run_finish_hook(struct simple_work_queue *queue)
 		queue->common.type->finish(queue->private);
 }
 
+static inline void increment_counter(u64 *counter)
+{
+	WRITE_ONCE(*counter, *counter + 1);
+}
+
+/*
+ * Choose how long to spin before sleeping. If work has recently been arriving within the maximum
+ * spin interval of the worker running out of it, spin for up to twice the average wait, on the
+ * expectation that more work will arrive before a sleep and wakeup could complete. Otherwise,
+ * don't spin at all.
+ */
+STATIC u64 compute_spin_window(u64 average_idle_ns, unsigned int max_spin_us)
+{
+	u64 max_spin_ns = (u64) max_spin_us * NSEC_PER_USEC;
+
+	if ((average_idle_ns == 0) || (average_idle_ns > max_spin_ns))
+		return 0;
+
+	return min(2 * average_idle_ns, max_spin_ns);
+}
+
+static struct vdo_completion *spin_for_completion(struct simple_work_queue *queue, u64 start)
+{
+	u64 window = compute_spin_window(queue->average_idle_ns,
+					 READ_ONCE(vdo_work_queue_max_spin_interval));
+	struct vdo_completion *completion;
+
+	if (window == 0)
+		return NULL;
+
+	increment_counter(&queue->spins);
+	do {
+		cpu_relax();
+		completion = find_completion(queue);
+		if (completion != NULL) {
+			increment_counter(&queue->spin_hits);
+			return completion;
+		}
+	} while (!need_resched() && !kthread_should_stop() &&
+		 ((ktime_get_ns() - start) < window));
+
+	return NULL;
+}
+
+/* Add a sample to a moving average of idle times, weighting the new sample 1/8. */
+STATIC u64 update_average_idle_time(u64 average_idle_ns, u64 idle_ns)
+{
+	return average_idle_ns - (average_idle_ns / 8) + (idle_ns / 8);
+}
+
+/*
+ * Update the moving average of the time the worker waits for work to arrive. The sample ends when
+ * the work arrived, not when the worker got to it, so that the time taken to sleep and wake up
+ * does not count; otherwise a few long sleeps would keep the average above the spin interval and
+ * the worker would never spin again.
+ */
+static void record_idle_time(struct simple_work_queue *queue, u64 start, u64 arrival)
+{
+	queue->average_idle_ns = update_average_idle_time(queue->average_idle_ns,
+							  arrival - start);
+}
+
 /*
  * Wait for the next completion to process, or until kthread_should_stop indicates that it's time
  * for us to shut down.
@@ -176,9 +342,16 @@ static void run_finish_hook(struct simple_work_queue *queue)
  */
 static struct vdo_completion *wait_for_next_completion(struct simple_work_queue *queue)
 {
+	u64 start = ktime_get_ns();
 	struct vdo_completion *completion;
 	DEFINE_WAIT(wait);
 
+	completion = spin_for_completion(queue, start);
+	if (completion != NULL) {
+		record_idle_time(queue, start, ktime_get_ns());
+		return completion;
+	}
+
 	while (true) {
 		prepare_to_wait(&queue->waiting_worker_threads, &wait,
 				TASK_INTERRUPTIBLE);
@@ -193,7 +366,7 @@ static struct vdo_completion *wait_for_next_completion(struct simple_work_queue
 		atomic_set(&queue->idle, 1);
 		smp_mb(); /* store-load barrier between "idle" and funnel queue */
 
-		completion = poll_for_completion(queue);
+		completion = find_completion(queue);
 		if (completion != NULL)
 			break;
 
@@ -206,18 +379,29 @@ static struct vdo_completion *wait_for_next_completion(struct simple_work_queue
 			break;
 
 		schedule();
+		increment_counter(&queue->wakeups);
 
 		/*
 		 * Most of the time when we wake, it should be because there's work to do. If it
 		 * was a spurious wakeup, continue looping.
 		 */
-		completion = poll_for_completion(queue);
+		completion = find_completion(queue);
 		if (completion != NULL)
 			break;
 	}
 
 	finish_wait(&queue->waiting_worker_threads, &wait);
 	atomic_set(&queue->idle, 0);
+	if (completion != NULL) {
+		/*
+		 * If an enqueuer woke this thread, the work arrived when it did. Otherwise, the
+		 * work was found before sleeping.
+		 */
+		u64 wake_request = READ_ONCE(queue->wake_request_ns);
+
+		record_idle_time(queue, start,
+				 ((wake_request > start) ? wake_request : ktime_get_ns()));
+	}
 
 	return completion;
 }
@@ -239,6 +423,7 @@ static void service_work_queue(struct simple_work_queue *queue)
 
 	while (true) {
 		struct vdo_completion *completion = poll_for_completion(queue);
+		unsigned int batch_size = 0;
 
 		if (completion == NULL)
 			completion = wait_for_next_completion(queue);
@@ -248,7 +433,14 @@ static void service_work_queue(struct simple_work_queue *queue)
 			break;
 		}
 
-		process_completion(queue, completion);
+		/* Drain a batch of completions without going back through the scheduler checks. */
+		do {
+			process_completion(queue, completion);
+		} while ((++batch_size < VDO_WORK_QUEUE_BATCH_SIZE) &&
+			 ((completion = poll_for_completion(queue)) != NULL));
+
+		increment_counter(&queue->batches);
+		WRITE_ONCE(queue->completions, queue->completions + batch_size);
 
 		/*
 		 * Be friendly to a CPU that has other work to do, if the kernel has told us to.
@@ -313,7 +505,7 @@ void vdo_free_work_queue(struct vdo_work_queue *queue)
 
 static int make_simple_work_queue(const char *thread_name_prefix, const char *name,
 				  struct vdo_thread *owner, void *private,
-				  const struct vdo_work_queue_type *type,
+				  const struct vdo_work_queue_type *type, int node,
 				  struct simple_work_queue **queue_ptr)
 {
 	DECLARE_COMPLETION_ONSTACK(started);
@@ -335,6 +527,7 @@ static int make_simple_work_queue(const char *thread_name_prefix, const char *na
 	queue->common.type = type;
 	queue->common.owner = owner;
 	init_waitqueue_head(&queue->waiting_worker_threads);
+	spin_lock_init(&queue->poll_lock);
 
 	result = vdo_duplicate_string(name, "queue name", &queue->common.name);
 	if (result != VDO_SUCCESS) {
@@ -350,14 +543,19 @@ static int make_simple_work_queue(const char *thread_name_prefix, const char *na
 		}
 	}
 
-	thread = kthread_run(work_queue_runner, queue, "%s:%s", thread_name_prefix,
-			     queue->common.name);
+	thread = kthread_create_on_node(work_queue_runner, queue, node, "%s:%s",
+					thread_name_prefix, queue->common.name);
 	if (IS_ERR(thread)) {
 		free_simple_work_queue(queue);
 		return (int) PTR_ERR(thread);
 	}
 
+	/* Keep the thread next to the memory of the zone it serves. */
+	if (node != NUMA_NO_NODE)
+		set_cpus_allowed_ptr(thread, cpumask_of_node(node));
+
 	queue->thread = thread;
+	wake_up_process(thread);
 
 	/*
 	 * If we don't wait to ensure the thread is running VDO code, a quick kthread_stop (due to
@@ -383,7 +581,7 @@ static int make_simple_work_queue(const char *thread_name_prefix, const char *na
  */
 int vdo_make_work_queue(const char *thread_name_prefix, const char *name,
 			struct vdo_thread *owner, const struct vdo_work_queue_type *type,
-			unsigned int thread_count, void *thread_privates[],
+			int node, unsigned int thread_count, void *thread_privates[],
 			struct vdo_work_queue **queue_ptr)
 {
 	struct round_robin_work_queue *queue;
@@ -396,7 +594,7 @@ int vdo_make_work_queue(const char *thread_name_prefix, const char *name,
 		void *context = ((thread_privates != NULL) ? thread_privates[0] : NULL);
 
 		result = make_simple_work_queue(thread_name_prefix, name, owner, context,
-						type, &simple_queue);
+						type, node, &simple_queue);
 		if (result == VDO_SUCCESS)
 			*queue_ptr = &simple_queue->common;
 		return result;
@@ -416,6 +614,7 @@ int vdo_make_work_queue(const char *thread_name_prefix, const char *name,
 
 	queue->num_service_queues = thread_count;
 	queue->common.round_robin_mode = true;
+	queue->common.type = type;
 	queue->common.owner = owner;
 
 	result = vdo_duplicate_string(name, "queue name", &queue->common.name);
@@ -432,7 +631,8 @@ int vdo_make_work_queue(const char *thread_name_prefix, const char *name,
 
 		snprintf(thread_name, sizeof(thread_name), "%s%u", name, i);
 		result = make_simple_work_queue(thread_name_prefix, thread_name, owner,
-						context, type, &queue->service_queues[i]);
+						context, type, node,
+						&queue->service_queues[i]);
 		if (result != VDO_SUCCESS) {
 			queue->num_service_queues = i;
 			/* Destroy previously created subordinates. */
@@ -441,6 +641,13 @@ int vdo_make_work_queue(const char *thread_name_prefix, const char *name,
 		}
 	}
 
+	if (type->allow_stealing) {
+		for (i = 0; i < thread_count; i++) {
+			queue->service_queues[i]->index = i;
+			smp_store_release(&queue->service_queues[i]->group, queue);
+		}
+	}
+
 	return VDO_SUCCESS;
 }
 
@@ -488,8 +695,11 @@ static void dump_simple_work_queue(struct simple_work_queue *queue)
 		thread_status = atomic_read(&queue->idle) ? "idle" : "running";
 	}
 
-	vdo_log_info("workQ %px (%s) %s (%c)", &queue->common, queue->common.name,
-		     thread_status, task_state_report);
+	vdo_log_info("workQ %px (%s) %s (%c) wakeups %llu spins %llu/%llu batches %llu completions %llu",
+		     &queue->common, queue->common.name, thread_status, task_state_report,
+		     READ_ONCE(queue->wakeups), READ_ONCE(queue->spin_hits),
+		     READ_ONCE(queue->spins), READ_ONCE(queue->batches),
+		     READ_ONCE(queue->completions));
 
 	/* ->waiting_worker_threads wait queue status? anyone waiting? */
 }
@@ -512,6 +722,40 @@ void vdo_dump_work_queue(struct vdo_work_queue *queue)
 	}
 }
 
+static void add_simple_work_queue_statistics(struct simple_work_queue *queue,
+					     struct vdo_work_queue_statistics *stats)
+{
+	stats->wakeups += READ_ONCE(queue->wakeups);
+	stats->spins += READ_ONCE(queue->spins);
+	stats->spin_hits += READ_ONCE(queue->spin_hits);
+	stats->batches += READ_ONCE(queue->batches);
+	stats->completions += READ_ONCE(queue->completions);
+}
+
+/*
+ * Add the counters of a work queue, summed over all its threads, to the given statistics. The
+ * counters are read without synchronization, so they may be slightly stale.
+ */
+void vdo_add_work_queue_statistics(struct vdo_work_queue *queue,
+				   struct vdo_work_queue_statistics *stats)
+{
+	if (queue->round_robin_mode) {
+		struct round_robin_work_queue *round_robin = as_round_robin_work_queue(queue);
+		unsigned int i;
+
+		for (i = 0; i < round_robin->num_service_queues; i++)
+			add_simple_work_queue_statistics(round_robin->service_queues[i], stats);
+	} else {
+		add_simple_work_queue_statistics(as_simple_work_queue(queue), stats);
+	}
+}
+
+void vdo_set_work_queue_max_spin_interval(unsigned int value)
+{
+	/* Arbitrary maximum value is one millisecond */
+	WRITE_ONCE(vdo_work_queue_max_spin_interval, min(value, 1000U));
+}
+
 static void get_function_name(void *pointer, char *buffer, size_t buffer_length)
 {
 	if (pointer == NULL) {
@@ -579,8 +823,25 @@ void vdo_enqueue_work_queue(struct vdo_work_queue *queue,
 		 */
 		unsigned int rotor = this_cpu_inc_return(service_queue_rotor);
 		unsigned int index = rotor % round_robin->num_service_queues;
+		unsigned int i;
 
 		simple_queue = round_robin->service_queues[index];
+		if (enqueue_work_queue_completion(simple_queue, completion) ||
+		    !queue->type->allow_stealing)
+			return;
+
+		/*
+		 * The chosen thread is busy, so wake an idle sibling, if there is one, to steal
+		 * the completion should it still be waiting by then.
+		 */
+		for (i = 1; i < round_robin->num_service_queues; i++) {
+			unsigned int sibling = (index + i) % round_robin->num_service_queues;
+
+			if (wake_worker_if_idle(round_robin->service_queues[sibling]))
+				return;
+		}
+
+		return;
 	}
 
 	enqueue_work_queue_completion(simple_queue, completion);
@@ -19,15 +19,33 @@ struct vdo_work_queue_type {
 	void (*finish)(void *context);
 	enum vdo_completion_priority max_priority;
 	enum vdo_completion_priority default_priority;
+	/* Whether idle threads of a round-robin queue may take work queued for their siblings */
+	bool allow_stealing;
+};
+
+/* Counters describing how the threads of a work queue have waited for and processed work */
+struct vdo_work_queue_statistics {
+	/* Times a worker thread was woken after sleeping */
+	u64 wakeups;
+	/* Times a worker thread spun waiting for work before sleeping */
+	u64 spins;
+	/* Spins which found work */
+	u64 spin_hits;
+	/* Batches of completions processed between checks for rescheduling */
+	u64 batches;
+	/* Completions processed */
+	u64 completions;
 };
 
 struct vdo_completion;
 struct vdo_thread;
 struct vdo_work_queue;
 
+extern unsigned int vdo_work_queue_max_spin_interval;
+
 int vdo_make_work_queue(const char *thread_name_prefix, const char *name,
 			struct vdo_thread *owner, const struct vdo_work_queue_type *type,
-			unsigned int thread_count, void *thread_privates[],
+			int node, unsigned int thread_count, void *thread_privates[],
 			struct vdo_work_queue **queue_ptr);
 
 void vdo_enqueue_work_queue(struct vdo_work_queue *queue, struct vdo_completion *completion);
@@ -38,6 +56,11 @@ void vdo_free_work_queue(struct vdo_work_queue *queue);
 
 void vdo_dump_work_queue(struct vdo_work_queue *queue);
 
+void vdo_add_work_queue_statistics(struct vdo_work_queue *queue,
+				   struct vdo_work_queue_statistics *stats);
+
+void vdo_set_work_queue_max_spin_interval(unsigned int value);
+
 void vdo_dump_completion_to_buffer(struct vdo_completion *completion, char *buffer,
 				   size_t length);
 
@@ -48,4 +71,9 @@ struct vdo_thread *vdo_get_work_queue_owner(struct vdo_work_queue *queue);
 bool __must_check vdo_work_queue_type_is(struct vdo_work_queue *queue,
 					 const struct vdo_work_queue_type *type);
 
+#ifdef INTERNAL
+u64 compute_spin_window(u64 average_idle_ns, unsigned int max_spin_us);
+u64 update_average_idle_time(u64 average_idle_ns, u64 idle_ns);
+#endif /* INTERNAL */
+
 #endif /* VDO_WORK_QUEUE_H */
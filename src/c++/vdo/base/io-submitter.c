@@ -129,7 +129,9 @@ static void send_bio_to_device(struct vio *vio, struct bio *bio)
 			       jiffies - vio->bio_submission_jiffies);
 	vio->bio_submission_jiffies = jiffies;
 #endif
-	bio_set_dev(bio, vdo_get_backing_device(vdo));
+	bio_set_dev(bio, ((vio->type == VIO_TYPE_BLOCK_MAP_TIER) ?
+			  vdo_get_block_map_tier_device(vdo) :
+			  vdo_get_backing_device(vdo)));
 	submit_bio_noacct(bio);
 }
 
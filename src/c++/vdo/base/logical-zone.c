@@ -73,6 +73,7 @@ static int initialize_zone(struct logical_zones *zones, zone_count_t zone_number
 
 	allocation_zone_number = zone->thread_id % vdo->thread_config.physical_zone_count;
 	zone->allocation_zone = &vdo->physical_zones->zones[allocation_zone_number];
+	zone->allocation_locality = vdo->device_config->allocation_locality;
 
 	return vdo_make_default_thread(vdo, zone->thread_id);
 }
@@ -343,8 +344,26 @@ void vdo_release_flush_generation_lock(struct data_vio *data_vio)
 	attempt_generation_complete_notification(&zone->completion);
 }
 
-struct physical_zone *vdo_get_next_allocation_zone(struct logical_zone *zone)
+/**
+ * vdo_get_next_allocation_zone() - Get the physical zone from which to allocate a block.
+ * @zone: The logical zone of the block being written.
+ * @lbn: The logical block being written.
+ *
+ * Allocations normally rotate through the physical zones. When allocation locality is enabled,
+ * each aligned group of logical blocks is always allocated from the same physical zone instead, so
+ * that a sequential write is not scattered across zones.
+ *
+ * Return: The physical zone.
+ */
+struct physical_zone *vdo_get_next_allocation_zone(struct logical_zone *zone,
+						   logical_block_number_t lbn)
 {
+	if (zone->allocation_locality) {
+		struct physical_zones *zones = zone->zones->vdo->physical_zones;
+
+		return &zones->zones[(lbn / ALLOCATIONS_PER_ZONE) % zones->zone_count];
+	}
+
 	if (zone->allocation_count == ALLOCATIONS_PER_ZONE) {
 		zone->allocation_count = 0;
 		zone->allocation_zone = zone->allocation_zone->next;
@@ -48,6 +48,8 @@ struct logical_zone {
 	struct physical_zone *allocation_zone;
 	/* The number of allocations done from the current allocation_zone */
 	block_count_t allocation_count;
+	/* Whether to choose the allocation zone by logical block number */
+	bool allocation_locality;
 	/* The next zone */
 	struct logical_zone *next;
 };
@@ -82,7 +84,8 @@ void vdo_acquire_flush_generation_lock(struct data_vio *data_vio);
 
 void vdo_release_flush_generation_lock(struct data_vio *data_vio);
 
-struct physical_zone * __must_check vdo_get_next_allocation_zone(struct logical_zone *zone);
+struct physical_zone * __must_check vdo_get_next_allocation_zone(struct logical_zone *zone,
+								 logical_block_number_t lbn);
 
 void vdo_dump_logical_zone(const struct logical_zone *zone);
 
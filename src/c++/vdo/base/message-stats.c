@@ -90,6 +90,20 @@ static void write_block_allocator_statistics(char *prefix,
 	write_u64("slabsOpened : ", stats->slabs_opened, ", ", buf, maxlen);
 	/* The number of times since loading that a slab has been re-opened */
 	write_u64("slabsReopened : ", stats->slabs_reopened, ", ", buf, maxlen);
+	/* The number of sequential allocations which were physically contiguous */
+	write_u64("contiguousAllocations : ", stats->contiguous_allocations, ", ", buf, maxlen);
+	/* The number of sequential allocations which were not physically contiguous */
+	write_u64("fragmentedAllocations : ", stats->fragmented_allocations, ", ", buf, maxlen);
+	/* The number of slabs which have yet to be scrubbed since loading */
+	write_u64("slabsToScrub : ", stats->slabs_to_scrub, ", ", buf, maxlen);
+	/* The number of slabs which have been scrubbed since loading */
+	write_u64("slabsScrubbed : ", stats->slabs_scrubbed, ", ", buf, maxlen);
+	/* The estimated number of seconds until all slabs are scrubbed */
+	write_u64("scrubSecondsRemaining : ", stats->scrub_seconds_remaining, ", ", buf, maxlen);
+	/* The number of clean slabs whose reference counts were deferred when loading */
+	write_u64("lazySlabs : ", stats->lazy_slabs, ", ", buf, maxlen);
+	/* The number of deferred slabs whose reference counts have since been loaded */
+	write_u64("lazySlabsLoaded : ", stats->lazy_slabs_loaded, ", ", buf, maxlen);
 	write_string(NULL, "}", suffix, buf, maxlen);
 }
 
@@ -106,6 +120,50 @@ static void write_commit_statistics(char *prefix, struct commit_statistics *stat
 	write_string(NULL, "}", suffix, buf, maxlen);
 }
 
+static void write_stage_latency_statistics(char *prefix,
+					   struct stage_latency_statistics *stats,
+					   char *suffix, char **buf, unsigned int *maxlen)
+{
+	write_string(prefix, "{ ", NULL, buf, maxlen);
+	/* Number of times a write has completed this stage */
+	write_u64("count : ", stats->count, ", ", buf, maxlen);
+	/* Total time spent in this stage, in microseconds */
+	write_u64("totalMicroseconds : ", stats->total_microseconds, ", ", buf, maxlen);
+	/* Number of times the stage took less than 10 microseconds */
+	write_u64("under10us : ", stats->under_10us, ", ", buf, maxlen);
+	/* Number of times the stage took 10 to 100 microseconds */
+	write_u64("under100us : ", stats->under_100us, ", ", buf, maxlen);
+	/* Number of times the stage took 100 microseconds to 1 millisecond */
+	write_u64("under1ms : ", stats->under_1ms, ", ", buf, maxlen);
+	/* Number of times the stage took 1 to 10 milliseconds */
+	write_u64("under10ms : ", stats->under_10ms, ", ", buf, maxlen);
+	/* Number of times the stage took 10 to 100 milliseconds */
+	write_u64("under100ms : ", stats->under_100ms, ", ", buf, maxlen);
+	/* Number of times the stage took 100 milliseconds to 1 second */
+	write_u64("under1s : ", stats->under_1s, ", ", buf, maxlen);
+	/* Number of times the stage took 1 second or more */
+	write_u64("over1s : ", stats->over_1s, ", ", buf, maxlen);
+	write_string(NULL, "}", suffix, buf, maxlen);
+}
+
+static void write_commit_size_statistics(char *prefix,
+					 struct commit_size_statistics *stats,
+					 char *suffix, char **buf, unsigned int *maxlen)
+{
+	write_string(prefix, "{ ", NULL, buf, maxlen);
+	/* Number of commits of a single entry */
+	write_u64("oneEntry : ", stats->one_entry, ", ", buf, maxlen);
+	/* Number of commits of 2 to 15 entries */
+	write_u64("under16 : ", stats->under_16, ", ", buf, maxlen);
+	/* Number of commits of 16 to 63 entries */
+	write_u64("under64 : ", stats->under_64, ", ", buf, maxlen);
+	/* Number of commits of 64 entries up to a full block */
+	write_u64("oneBlock : ", stats->one_block, ", ", buf, maxlen);
+	/* Number of commits of more than a full block of entries */
+	write_u64("multipleBlocks : ", stats->multiple_blocks, ", ", buf, maxlen);
+	write_string(NULL, "}", suffix, buf, maxlen);
+}
+
 static void write_recovery_journal_statistics(char *prefix,
 					      struct recovery_journal_statistics *stats,
 					      char *suffix, char **buf,
@@ -121,6 +179,15 @@ static void write_recovery_journal_statistics(char *prefix,
 	write_commit_statistics("entries : ", &stats->entries, ", ", buf, maxlen);
 	/* Write/Commit totals for journal blocks */
 	write_commit_statistics("blocks : ", &stats->blocks, ", ", buf, maxlen);
+	/* Number of commits which wrote several adjacent blocks at once */
+	write_u64("multiBlockWrites : ", stats->multi_block_writes, ", ", buf, maxlen);
+	/* Number of commits which waited for more entries */
+	write_u64("delayedCommits : ", stats->delayed_commits, ", ", buf, maxlen);
+	/* The number of new entries in each commit */
+	write_commit_size_statistics("commitSize : ", &stats->commit_size, ", ", buf, maxlen);
+	/* The time from issuing each commit until it completes */
+	write_stage_latency_statistics("commitLatency : ", &stats->commit_latency, ", ", buf,
+				       maxlen);
 	write_string(NULL, "}", suffix, buf, maxlen);
 }
 
@@ -140,6 +207,23 @@ static void write_packer_statistics(char *prefix, struct packer_statistics *stat
 	write_string(NULL, "}", suffix, buf, maxlen);
 }
 
+static void write_compression_statistics(char *prefix, struct compression_statistics *stats,
+					 char *suffix, char **buf, unsigned int *maxlen)
+{
+	write_string(prefix, "{ ", NULL, buf, maxlen);
+	/* Number of blocks given to the compression codec to compress */
+	write_u64("attempts : ", stats->attempts, ", ", buf, maxlen);
+	/* Number of compression attempts which did not produce a fragment */
+	write_u64("failures : ", stats->failures, ", ", buf, maxlen);
+	/* Number of blocks not compressed because fast-reject judged them incompressible */
+	write_u64("fastRejectSkips : ", stats->fast_reject_skips, ", ", buf, maxlen);
+	/* Number of blocks judged incompressible which were compressed anyway to check fast-reject */
+	write_u64("fastRejectChecks : ", stats->fast_reject_checks, ", ", buf, maxlen);
+	/* Number of fast-reject checks which produced a fragment */
+	write_u64("fastRejectMispredictions : ", stats->fast_reject_mispredictions, ", ", buf, maxlen);
+	write_string(NULL, "}", suffix, buf, maxlen);
+}
+
 static void write_slab_journal_statistics(char *prefix,
 					  struct slab_journal_statistics *stats,
 					  char *suffix, char **buf, unsigned int *maxlen)
@@ -221,6 +305,24 @@ static void write_block_map_statistics(char *prefix, struct block_map_statistics
 	write_u64("pagesSaved : ", stats->pages_saved, ", ", buf, maxlen);
 	/* the number of flushes issued */
 	write_u64("flushCount : ", stats->flush_count, ", ", buf, maxlen);
+	/* number of fetched pages which were recently evicted from probation */
+	write_u64("ghostHits : ", stats->ghost_hits, ", ", buf, maxlen);
+	/* number of pages loaded speculatively by readahead */
+	write_u64("readaheadPages : ", stats->readahead_pages, ", ", buf, maxlen);
+	/* number of readahead pages which were used before being evicted */
+	write_u64("readaheadUsed : ", stats->readahead_used, ", ", buf, maxlen);
+	/* number of readahead pages evicted without being used */
+	write_u64("readaheadWasted : ", stats->readahead_wasted, ", ", buf, maxlen);
+	/* number of writes issued to save pages */
+	write_u64("writesIssued : ", stats->writes_issued, ", ", buf, maxlen);
+	/* number of pages loaded to warm up the cache */
+	write_u64("warmupPages : ", stats->warmup_pages, ", ", buf, maxlen);
+	/* number of pages read from the cache device */
+	write_u64("tierPagesRead : ", stats->tier_pages_read, ", ", buf, maxlen);
+	/* number of evicted pages written to the cache device */
+	write_u64("tierPagesWritten : ", stats->tier_pages_written, ", ", buf, maxlen);
+	/* number of cache device pages which were invalid or could not be read or written */
+	write_u64("tierPagesRejected : ", stats->tier_pages_rejected, ", ", buf, maxlen);
 	write_string(NULL, "}", suffix, buf, maxlen);
 }
 
@@ -240,6 +342,12 @@ static void write_hash_lock_statistics(char *prefix, struct hash_lock_statistics
 		  stats->concurrent_hash_collisions, ", ", buf, maxlen);
 	/* Current number of dedupe queries that are in flight */
 	write_u32("currDedupeQueries : ", stats->curr_dedupe_queries, ", ", buf, maxlen);
+	/* Number of writes which requested a hash lock, summed over all hash zones */
+	write_u64("lockRequests : ", stats->lock_requests, ", ", buf, maxlen);
+	/* Number of hash lock requests handled by the busiest hash zone */
+	write_u64("maxZoneLockRequests : ", stats->max_zone_lock_requests, ", ", buf, maxlen);
+	/* Number of hash lock requests handled by the least busy hash zone */
+	write_u64("minZoneLockRequests : ", stats->min_zone_lock_requests, ", ", buf, maxlen);
 	write_string(NULL, "}", suffix, buf, maxlen);
 }
 
@@ -278,6 +386,32 @@ static void write_bio_stats(char *prefix, struct bio_stats *stats, char *suffix,
 	write_string(NULL, "}", suffix, buf, maxlen);
 }
 
+static void write_write_latency_statistics(char *prefix,
+					   struct write_latency_statistics *stats,
+					   char *suffix, char **buf, unsigned int *maxlen)
+{
+	write_string(prefix, "{ ", NULL, buf, maxlen);
+	/* From accepting the bio until the block map lookup starts */
+	write_stage_latency_statistics("launch : ", &stats->launch, ", ", buf, maxlen);
+	/* Waiting for and computing the record name */
+	write_stage_latency_statistics("hash : ", &stats->hash, ", ", buf, maxlen);
+	/* Waiting for a hash lock */
+	write_stage_latency_statistics("hashLock : ", &stats->hash_lock, ", ", buf, maxlen);
+	/* Querying the dedupe index */
+	write_stage_latency_statistics("dedupeQuery : ", &stats->dedupe_query, ", ", buf, maxlen);
+	/* Allocating a physical block */
+	write_stage_latency_statistics("allocation : ", &stats->allocation, ", ", buf, maxlen);
+	/* Writing the data to storage */
+	write_stage_latency_statistics("dataWrite : ", &stats->data_write, ", ", buf, maxlen);
+	/* Making the recovery journal entry */
+	write_stage_latency_statistics("journal : ", &stats->journal, ", ", buf, maxlen);
+	/* Updating the block map */
+	write_stage_latency_statistics("blockMap : ", &stats->block_map, ", ", buf, maxlen);
+	/* Acknowledging the bio */
+	write_stage_latency_statistics("acknowledge : ", &stats->acknowledge, ", ", buf, maxlen);
+	write_string(NULL, "}", suffix, buf, maxlen);
+}
+
 static void write_memory_usage(char *prefix, struct memory_usage *stats, char *suffix,
 			       char **buf, unsigned int *maxlen)
 {
@@ -349,6 +483,8 @@ static void write_vdo_statistics(char *prefix, struct vdo_statistics *stats, cha
 	write_u8("recoveryPercentage : ", stats->recovery_percentage, ", ", buf, maxlen);
 	/* The statistics for the compressed block packer */
 	write_packer_statistics("packer : ", &stats->packer, ", ", buf, maxlen);
+	/* The statistics for compressing data blocks */
+	write_compression_statistics("compression : ", &stats->compression, ", ", buf, maxlen);
 	/* Counters for events in the block allocator */
 	write_block_allocator_statistics("allocator : ", &stats->allocator,
 					 ", ", buf, maxlen);
@@ -408,6 +544,9 @@ static void write_vdo_statistics(char *prefix, struct vdo_statistics *stats, cha
 	/* Current number of bios in progress */
 	write_bio_stats("biosInProgress : ", &stats->bios_in_progress, ", ",
 			buf, maxlen);
+	/* Time spent in each stage of the write path */
+	write_write_latency_statistics("writeLatency : ", &stats->write_latency, ", ",
+				       buf, maxlen);
 	/* Memory usage stats. */
 	write_memory_usage("memoryUsage : ", &stats->memory_usage, ", ", buf, maxlen);
 	/* The statistics for the UDS index */
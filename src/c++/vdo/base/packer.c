@@ -6,7 +6,11 @@
 #include "packer.h"
 
 #include <linux/atomic.h>
+#include <linux/bitops.h>
 #include <linux/blkdev.h>
+#include <linux/jiffies.h>
+#include <linux/minmax.h>
+#include <linux/timer.h>
 
 #include "logger.h"
 #include "memory-alloc.h"
@@ -25,9 +29,19 @@
 #include "vdo.h"
 #include "vio.h"
 
+/*
+ * The minor version of a compressed block identifies the codec which compressed all of the
+ * fragments in it, so 1.0 blocks, which predate the choice of codecs, are all LZ4.
+ */
 static const struct version_number COMPRESSED_BLOCK_1_0 = {
 	.major_version = 1,
-	.minor_version = 0,
+	.minor_version = VDO_CODEC_LZ4,
+};
+
+enum packer_timer_state {
+	PACKER_TIMER_IDLE,
+	PACKER_TIMER_RUNNING,
+	PACKER_TIMER_FIRED,
 };
 
 #define COMPRESSED_BLOCK_1_0_SIZE (4 + 4 + (2 * VDO_MAX_COMPRESSION_SLOTS))
@@ -57,7 +71,8 @@ int vdo_get_compressed_block_fragment(enum block_mapping_state mapping_state,
 		return VDO_INVALID_FRAGMENT;
 
 	version = vdo_unpack_version_number(block->header.version);
-	if (!vdo_are_same_version(version, COMPRESSED_BLOCK_1_0))
+	if ((version.major_version != COMPRESSED_BLOCK_1_0.major_version) ||
+	    (version.minor_version >= VDO_CODEC_COUNT))
 		return VDO_INVALID_FRAGMENT;
 
 	slot = mapping_state - VDO_MAPPING_STATE_COMPRESSED_BASE;
@@ -79,6 +94,16 @@ int vdo_get_compressed_block_fragment(enum block_mapping_state mapping_state,
 	return VDO_SUCCESS;
 }
 
+/**
+ * vdo_get_compressed_block_codec() - Get the codec which compressed the fragments in a compressed
+ *                                    block.
+ * @block: A compressed block which vdo_get_compressed_block_fragment() has accepted.
+ */
+enum vdo_compression_codec vdo_get_compressed_block_codec(const struct compressed_block *block)
+{
+	return vdo_unpack_version_number(block->header.version).minor_version;
+}
+
 /**
  * assert_on_packer_thread() - Check that we are on the packer thread.
  * @packer: The packer.
@@ -111,6 +136,41 @@ static void insert_in_sorted_list(struct packer *packer, struct packer_bin *bin)
 	list_move_tail(&bin->list, &packer->bins);
 }
 
+/**
+ * place_in_bucket() - Move a bin to the bucket for its current free space.
+ * @packer: The packer.
+ * @bin: The bin whose free space may have changed.
+ *
+ * This does nothing unless the packer is bucketed.
+ */
+static void place_in_bucket(struct packer *packer, struct packer_bin *bin)
+{
+	unsigned int bucket = bin->free_space >> PACKER_BUCKET_SHIFT;
+
+	if (!packer->bucketed || (bucket == bin->bucket))
+		return;
+
+	list_move_tail(&bin->bucket_entry, &packer->buckets[bucket]);
+	if (list_empty(&packer->buckets[bin->bucket]))
+		packer->occupied_buckets &= ~(1ULL << bin->bucket);
+
+	packer->occupied_buckets |= (1ULL << bucket);
+	bin->bucket = bucket;
+}
+
+/**
+ * restore_bin_order() - Update the packer's index of bins after the free space in a bin changes.
+ * @packer: The packer.
+ * @bin: The bin whose free space has changed.
+ */
+static void restore_bin_order(struct packer *packer, struct packer_bin *bin)
+{
+	if (packer->bucketed)
+		place_in_bucket(packer, bin);
+	else
+		insert_in_sorted_list(packer, bin);
+}
+
 /**
  * make_bin() - Allocate a bin and put it into the packer's list.
  * @packer: The packer.
@@ -128,9 +188,15 @@ static int __must_check make_bin(struct packer *packer)
 	bin->free_space = VDO_COMPRESSED_BLOCK_DATA_SIZE;
 	INIT_LIST_HEAD(&bin->list);
 	list_add_tail(&bin->list, &packer->bins);
+	bin->bucket = PACKER_BUCKETS - 1;
+	list_add_tail(&bin->bucket_entry, &packer->buckets[bin->bucket]);
+	packer->occupied_buckets |= (1ULL << bin->bucket);
 	return VDO_SUCCESS;
 }
 
+static void write_aged_bins(struct vdo_completion *completion);
+static void expire_bins(struct timer_list *timer);
+
 /**
  * vdo_make_packer() - Make a new block packer.
  *
@@ -153,8 +219,34 @@ int vdo_make_packer(struct vdo *vdo, block_count_t bin_count, struct packer **pa
 	packer->thread_id = vdo->thread_config.packer_thread;
 	packer->size = bin_count;
 	INIT_LIST_HEAD(&packer->bins);
+	/* The occupied_buckets bitmap has one bit for each bucket. */
+	BUILD_BUG_ON(PACKER_BUCKETS > 64);
+	for (i = 0; i < PACKER_BUCKETS; i++)
+		INIT_LIST_HEAD(&packer->buckets[i]);
+
+	packer->bucketed = vdo->device_config->packer_bucketed;
+	if (packer->bucketed) {
+		result = vdo_allocate(bin_count * VDO_MAX_COMPRESSION_SLOTS,
+				      struct fill_candidate, __func__,
+				      &packer->fill_candidates);
+		if (result != VDO_SUCCESS) {
+			vdo_free(packer);
+			return result;
+		}
+	}
+
 	vdo_set_admin_state_code(&packer->state, VDO_ADMIN_STATE_NORMAL_OPERATION);
 
+	if (vdo->device_config->packer_max_age > 0) {
+		packer->max_age = max_t(unsigned long,
+					msecs_to_jiffies(vdo->device_config->packer_max_age), 1);
+	}
+
+	atomic_set(&packer->timer_state, PACKER_TIMER_IDLE);
+	timer_setup(&packer->timer, expire_bins, 0);
+	vdo_initialize_completion(&packer->completion, vdo, VDO_PACKER_COMPLETION);
+	vdo_set_completion_callback(&packer->completion, write_aged_bins, packer->thread_id);
+
 	for (i = 0; i < bin_count; i++) {
 		result = make_bin(packer);
 		if (result != VDO_SUCCESS) {
@@ -202,6 +294,7 @@ void vdo_free_packer(struct packer *packer)
 	}
 
 	vdo_free(vdo_forget(packer->canceled_bin));
+	vdo_free(vdo_forget(packer->fill_candidates));
 	vdo_free(packer);
 }
 
@@ -323,11 +416,39 @@ static void handle_compressed_write_error(struct vdo_completion *completion)
  */
 static void add_to_bin(struct packer_bin *bin, struct data_vio *data_vio)
 {
+	if (bin->slots_used == 0)
+		bin->arrival = jiffies;
+
 	data_vio->compression.bin = bin;
 	data_vio->compression.slot = bin->slots_used;
 	bin->incoming[bin->slots_used++] = data_vio;
 }
 
+/**
+ * take_from_bin() - Remove the data_vio in a given slot from a bin.
+ * @bin: The bin from which to remove the data_vio.
+ * @slot: The slot of the data_vio to remove.
+ *
+ * The last data_vio in the bin is moved into the vacated slot. The bin's free space is not
+ * adjusted.
+ *
+ * Return: The removed data_vio.
+ */
+static struct data_vio *take_from_bin(struct packer_bin *bin, slot_number_t slot)
+{
+	struct data_vio *data_vio = bin->incoming[slot];
+
+	bin->slots_used--;
+	if (slot < bin->slots_used) {
+		bin->incoming[slot] = bin->incoming[bin->slots_used];
+		bin->incoming[slot]->compression.slot = slot;
+	}
+
+	data_vio->compression.bin = NULL;
+	data_vio->compression.slot = 0;
+	return data_vio;
+}
+
 /**
  * remove_from_bin() - Get the next data_vio whose compression has not been canceled from a bin.
  * @packer: The packer.
@@ -351,28 +472,179 @@ static struct data_vio *remove_from_bin(struct packer *packer, struct packer_bin
 
 	/* The bin is now empty. */
 	bin->free_space = VDO_COMPRESSED_BLOCK_DATA_SIZE;
+	place_in_bucket(packer, bin);
 	return NULL;
 }
 
+/* The state of a search for the fragments which best fill a bin */
+struct fill_search {
+	/* The fragments which could be moved, largest first */
+	struct fill_candidate *candidates;
+	unsigned int candidate_count;
+	/* The free space and free slots of the bin being filled */
+	size_t space;
+	slot_number_t slots;
+	/* The number of sets of fragments which may still be examined */
+	unsigned int budget;
+	/* The candidates in the set being examined */
+	unsigned int chosen[VDO_MAX_COMPRESSION_SLOTS];
+	/* The best set found so far */
+	unsigned int best[VDO_MAX_COMPRESSION_SLOTS];
+	slot_number_t best_count;
+	size_t best_size;
+};
+
+/**
+ * gather_fill_candidates() - Collect the fragments in other bins which fit in a bin.
+ * @packer: The packer.
+ * @bin: The bin to fill.
+ *
+ * Return: The number of candidates, which are sorted largest first.
+ */
+static unsigned int gather_fill_candidates(struct packer *packer, struct packer_bin *bin)
+{
+	struct fill_candidate *candidates = packer->fill_candidates;
+	unsigned int count = 0;
+	struct packer_bin *donor;
+	slot_number_t slot;
+	size_t remaining = 0;
+	unsigned int i;
+
+	list_for_each_entry(donor, &packer->bins, list) {
+		if (donor == bin)
+			continue;
+
+		for (slot = 0; slot < donor->slots_used; slot++) {
+			struct data_vio *data_vio = donor->incoming[slot];
+			block_size_t size = data_vio->compression.size;
+
+			if (size > bin->free_space)
+				continue;
+
+			/* An insertion sort is fine for the few fragments the bins can hold. */
+			for (i = count; (i > 0) && (candidates[i - 1].size < size); i--)
+				candidates[i] = candidates[i - 1];
+
+			candidates[i] = (struct fill_candidate) {
+				.data_vio = data_vio,
+				.size = size,
+			};
+			count++;
+		}
+	}
+
+	for (i = count; i > 0; i--) {
+		remaining += candidates[i - 1].size;
+		candidates[i - 1].remaining = remaining;
+	}
+
+	return count;
+}
+
+/**
+ * search_fill() - Search for the set of candidates which fills the most of a bin.
+ * @search: The search state.
+ * @start: The first candidate which may be added to the current set.
+ * @depth: The number of candidates in the current set.
+ * @size: The total size of the current set.
+ *
+ * The candidates are tried largest first, so the first set examined is the one found by
+ * repeatedly taking the largest fragment which fits. The search stops once a set exactly fills
+ * the bin, or when its budget runs out.
+ */
+static void search_fill(struct fill_search *search, unsigned int start, slot_number_t depth,
+			size_t size)
+{
+	unsigned int i;
+
+	if (size > search->best_size) {
+		search->best_size = size;
+		search->best_count = depth;
+		memcpy(search->best, search->chosen, depth * sizeof(search->chosen[0]));
+	}
+
+	for (i = start; i < search->candidate_count; i++) {
+		struct fill_candidate *candidate = &search->candidates[i];
+
+		if ((search->best_size == search->space) || (depth == search->slots) ||
+		    (search->budget == 0))
+			return;
+
+		/* Even all of the remaining candidates would not improve on the best set. */
+		if ((size + candidate->remaining) <= search->best_size)
+			return;
+
+		if ((size + candidate->size) > search->space)
+			continue;
+
+		search->budget--;
+		search->chosen[depth] = i;
+		search_fill(search, i + 1, depth + 1, size + candidate->size);
+	}
+}
+
+/**
+ * fill_bin() - Move fragments from other bins into a bin which is about to be written.
+ * @packer: The packer.
+ * @bin: The bin to fill.
+ *
+ * This looks for a set of fragments which exactly fills the remaining space, and otherwise moves
+ * the set which fills the most of it that was found. This also frees space in the other bins for
+ * fragments which arrive later.
+ */
+static void fill_bin(struct packer *packer, struct packer_bin *bin)
+{
+	struct fill_search search = {
+		.candidates = packer->fill_candidates,
+		.space = bin->free_space,
+		.slots = VDO_MAX_COMPRESSION_SLOTS - bin->slots_used,
+		.budget = PACKER_FILL_SEARCH_LIMIT,
+	};
+	slot_number_t i;
+
+	if ((search.space == 0) || (search.slots == 0))
+		return;
+
+	search.candidate_count = gather_fill_candidates(packer, bin);
+	search_fill(&search, 0, 0, 0);
+
+	for (i = 0; i < search.best_count; i++) {
+		struct data_vio *data_vio = search.candidates[search.best[i]].data_vio;
+		struct packer_bin *donor = data_vio->compression.bin;
+		block_size_t size = data_vio->compression.size;
+
+		take_from_bin(donor, data_vio->compression.slot);
+		donor->free_space += size;
+		place_in_bucket(packer, donor);
+		add_to_bin(bin, data_vio);
+		bin->free_space -= size;
+	}
+}
+
 /**
  * initialize_compressed_block() - Initialize a compressed block.
  * @block: The compressed block to initialize.
  * @size: The size of the agent's fragment.
+ * @codec: The codec which compressed the fragments to be packed in the block.
  *
  * This method initializes the compressed block in the compressed write agent. Because the
  * compressor already put the agent's compressed fragment at the start of the compressed block's
  * data field, it needn't be copied. So all we need do is initialize the header and set the size of
  * the agent's fragment.
  */
-STATIC void initialize_compressed_block(struct compressed_block *block, u16 size)
+STATIC void initialize_compressed_block(struct compressed_block *block, u16 size,
+					enum vdo_compression_codec codec)
 {
+	struct version_number version = COMPRESSED_BLOCK_1_0;
+
 	/*
 	 * Make sure the block layout isn't accidentally changed by changing the length of the
 	 * block header.
 	 */
 	BUILD_BUG_ON(sizeof(struct compressed_block_header) != COMPRESSED_BLOCK_1_0_SIZE);
 
-	block->header.version = vdo_pack_version_number(COMPRESSED_BLOCK_1_0);
+	version.minor_version = codec;
+	block->header.version = vdo_pack_version_number(version);
 	block->header.sizes[0] = __cpu_to_le16(size);
 }
 
@@ -427,17 +699,21 @@ static void write_bin(struct packer *packer, struct packer_bin *bin)
 	slot_number_t slot = 1;
 	struct compression_state *compression;
 	struct compressed_block *block;
-	struct data_vio *agent = remove_from_bin(packer, bin);
+	struct data_vio *agent;
 	struct data_vio *client;
 	struct packer_statistics *stats;
 
+	if (packer->bucketed && (bin->slots_used > 0))
+		fill_bin(packer, bin);
+
+	agent = remove_from_bin(packer, bin);
 	if (agent == NULL)
 		return;
 
 	compression = &agent->compression;
 	compression->slot = 0;
 	block = compression->block;
-	initialize_compressed_block(block, compression->size);
+	initialize_compressed_block(block, compression->size, compression->codec);
 	offset = compression->size;
 
 	while ((client = remove_from_bin(packer, bin)) != NULL)
@@ -486,6 +762,22 @@ static void write_bin(struct packer *packer, struct packer_bin *bin)
 	vdo_submit_data_vio(agent);
 }
 
+/**
+ * start_age_timer() - Start the timer for writing a bin which has reached the maximum age, unless
+ *                     the timer is already running for an older bin.
+ * @packer: The packer.
+ * @bin: The bin which has just received its first data_vio.
+ */
+static void start_age_timer(struct packer *packer, struct packer_bin *bin)
+{
+	if ((packer->max_age == 0) ||
+	    (atomic_cmpxchg(&packer->timer_state, PACKER_TIMER_IDLE,
+			    PACKER_TIMER_RUNNING) != PACKER_TIMER_IDLE))
+		return;
+
+	mod_timer(&packer->timer, bin->arrival + packer->max_age);
+}
+
 /**
  * add_data_vio_to_packer_bin() - Add a data_vio to a bin's incoming queue
  * @packer: The packer.
@@ -511,7 +803,69 @@ static void add_data_vio_to_packer_bin(struct packer *packer, struct packer_bin
 		write_bin(packer, bin);
 
 	/* Now that we've finished changing the free space, restore the sort order. */
-	insert_in_sorted_list(packer, bin);
+	restore_bin_order(packer, bin);
+
+	if (bin->slots_used == 1)
+		start_age_timer(packer, bin);
+}
+
+/**
+ * get_tightest_bin() - Find the bin in a bucket with the least free space which is at least a
+ *                      given size.
+ * @packer: The packer.
+ * @bucket: The bucket to search.
+ * @size: The minimum amount of free space.
+ *
+ * Return: The selected bin, or NULL if no bin in the bucket has enough free space.
+ */
+static struct packer_bin *get_tightest_bin(struct packer *packer, unsigned int bucket,
+					   size_t size)
+{
+	struct packer_bin *bin, *tightest = NULL;
+
+	list_for_each_entry(bin, &packer->buckets[bucket], bucket_entry) {
+		if ((bin->free_space >= size) &&
+		    ((tightest == NULL) || (bin->free_space < tightest->free_space)))
+			tightest = bin;
+	}
+
+	return tightest;
+}
+
+/**
+ * select_bucketed_bin() - Select the bin for a data_vio in a bucketed packer.
+ * @packer: The packer.
+ * @data_vio: The data_vio.
+ *
+ * This makes the same choices as select_bin(), except that among bins whose free space falls in
+ * the same larger bucket, the first one found is used rather than the tightest.
+ */
+static struct packer_bin * __must_check select_bucketed_bin(struct packer *packer,
+							    struct data_vio *data_vio)
+{
+	size_t size = data_vio->compression.size;
+	unsigned int bucket = size >> PACKER_BUCKET_SHIFT;
+	/* Shifting in two steps avoids an undefined shift when the bucket is the last one. */
+	u64 larger = packer->occupied_buckets & ~((2ULL << bucket) - 1);
+	struct packer_bin *bin = get_tightest_bin(packer, bucket, size);
+
+	if (bin != NULL)
+		return bin;
+
+	/* Every bin in a larger bucket has room. */
+	if (larger != 0)
+		return list_first_entry(&packer->buckets[__ffs64(larger)], struct packer_bin,
+					bucket_entry);
+
+	/*
+	 * As in select_bin(), overflow the fullest bin only if that wastes less space than giving
+	 * up on compressing the data_vio.
+	 */
+	bin = get_tightest_bin(packer, __ffs64(packer->occupied_buckets), 0);
+	if (size >= (VDO_COMPRESSED_BLOCK_DATA_SIZE - bin->free_space))
+		return NULL;
+
+	return bin;
 }
 
 /**
@@ -529,6 +883,9 @@ static struct packer_bin * __must_check select_bin(struct packer *packer,
 	 */
 	struct packer_bin *bin, *fullest_bin;
 
+	if (packer->bucketed)
+		return select_bucketed_bin(packer, data_vio);
+
 	list_for_each_entry(bin, &packer->bins, list) {
 		if (bin->free_space >= data_vio->compression.size)
 			return bin;
@@ -616,8 +973,73 @@ void vdo_attempt_packing(struct data_vio *data_vio)
  */
 static void check_for_drain_complete(struct packer *packer)
 {
-	if (vdo_is_state_draining(&packer->state) && (packer->canceled_bin->slots_used == 0))
-		vdo_finish_draining(&packer->state);
+	if (!vdo_is_state_draining(&packer->state) || (packer->canceled_bin->slots_used > 0))
+		return;
+
+	if ((atomic_read(&packer->timer_state) == PACKER_TIMER_IDLE) ||
+	    (atomic_cmpxchg(&packer->timer_state, PACKER_TIMER_RUNNING,
+			    PACKER_TIMER_IDLE) == PACKER_TIMER_RUNNING)) {
+		del_timer_sync(&packer->timer);
+	} else {
+		/* The timer has fired, and its completion must run before the drain can finish. */
+		return;
+	}
+
+	vdo_finish_draining(&packer->state);
+}
+
+/**
+ * write_aged_bins() - Write every bin which has reached the maximum age, and restart the timer for
+ *                     the oldest remaining bin.
+ * @completion: The packer's completion.
+ *
+ * This callback is registered in vdo_make_packer() and launched by expire_bins().
+ */
+static void write_aged_bins(struct vdo_completion *completion)
+{
+	struct packer *packer = container_of(completion, struct packer, completion);
+	unsigned long cutoff = jiffies - packer->max_age;
+	struct packer_bin *bin, *tmp, *oldest = NULL;
+	LIST_HEAD(written);
+
+	assert_on_packer_thread(packer, __func__);
+	atomic_set(&packer->timer_state, PACKER_TIMER_IDLE);
+	if (vdo_is_state_normal(&packer->state)) {
+		list_for_each_entry_safe(bin, tmp, &packer->bins, list) {
+			if (bin->slots_used == 0)
+				continue;
+
+			if (time_after(bin->arrival, cutoff)) {
+				if ((oldest == NULL) || time_before(bin->arrival, oldest->arrival))
+					oldest = bin;
+				continue;
+			}
+
+			write_bin(packer, bin);
+			list_move_tail(&bin->list, &written);
+		}
+
+		/* The written bins are empty, so they belong at the end of a sorted list. */
+		list_splice_tail(&written, &packer->bins);
+		if (oldest != NULL)
+			start_age_timer(packer, oldest);
+	}
+
+	check_for_drain_complete(packer);
+}
+
+/**
+ * expire_bins() - Launch the packer's completion to write the bins which have reached the maximum
+ *                 age.
+ * @timer: The packer's timer.
+ */
+static void expire_bins(struct timer_list *timer)
+{
+	struct packer *packer = from_timer(packer, timer, timer);
+
+	if (atomic_cmpxchg(&packer->timer_state, PACKER_TIMER_RUNNING,
+			   PACKER_TIMER_FIRED) == PACKER_TIMER_RUNNING)
+		vdo_launch_completion(&packer->completion);
 }
 
 /**
@@ -664,7 +1086,6 @@ void vdo_remove_lock_holder_from_packer(struct vdo_completion *completion)
 	struct packer *packer = get_packer_from_data_vio(data_vio);
 	struct data_vio *lock_holder;
 	struct packer_bin *bin;
-	slot_number_t slot;
 
 	assert_data_vio_in_packer_zone(data_vio);
 
@@ -672,19 +1093,10 @@ void vdo_remove_lock_holder_from_packer(struct vdo_completion *completion)
 	bin = lock_holder->compression.bin;
 	VDO_ASSERT_LOG_ONLY((bin != NULL), "data_vio in packer has a bin");
 
-	slot = lock_holder->compression.slot;
-	bin->slots_used--;
-	if (slot < bin->slots_used) {
-		bin->incoming[slot] = bin->incoming[bin->slots_used];
-		bin->incoming[slot]->compression.slot = slot;
-	}
-
-	lock_holder->compression.bin = NULL;
-	lock_holder->compression.slot = 0;
-
+	take_from_bin(bin, lock_holder->compression.slot);
 	if (bin != packer->canceled_bin) {
 		bin->free_space += lock_holder->compression.size;
-		insert_in_sorted_list(packer, bin);
+		restore_bin_order(packer, bin);
 	}
 
 	abort_packing(lock_holder);
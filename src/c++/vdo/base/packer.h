@@ -6,7 +6,9 @@
 #ifndef VDO_PACKER_H
 #define VDO_PACKER_H
 
+#include <linux/atomic.h>
 #include <linux/list.h>
+#include <linux/timer.h>
 
 #include "admin-state.h"
 #include "constants.h"
@@ -38,6 +40,14 @@ enum {
 	VDO_MAX_COMPRESSED_FRAGMENT_SIZE = VDO_COMPRESSED_BLOCK_DATA_SIZE - 1,
 };
 
+enum {
+	/* The log of the number of bytes of free space covered by each of the packer's buckets */
+	PACKER_BUCKET_SHIFT = 6,
+	PACKER_BUCKETS = (VDO_COMPRESSED_BLOCK_DATA_SIZE >> PACKER_BUCKET_SHIFT) + 1,
+	/* The most sets of fragments examined when filling a bin before it is written */
+	PACKER_FILL_SEARCH_LIMIT = 1024,
+};
+
 /* * The compressed block overlay. */
 struct compressed_block {
 	struct compressed_block_header header;
@@ -56,6 +66,13 @@ struct compressed_block {
  * successful, the agent shares its pbn lock which each of the other data_vios in its compressed
  * block and sends each on its way. Finally the agent itself continues on the write path as before.
  *
+ * In bucketed mode, the list of bins is not kept sorted. Instead, each bin is also on the list of
+ * one of the packer's buckets, selected by the bin's free space. Every bin in a bucket has room
+ * for any fragment smaller than the bucket's range, so a bin for a new fragment can be found by
+ * examining only the fragment's own bucket and the first non-empty larger one. Before a bin is
+ * written, fragments from other bins are moved into it to fill as much of its remaining space as
+ * possible, preferring a set of fragments which fills it exactly.
+ *
  * There is one special bin which is used to hold data_vios which have been canceled and removed
  * from their bin by the packer. These data_vios need to wait for the canceller to rendezvous with
  * them and so they sit in this special bin.
@@ -63,21 +80,43 @@ struct compressed_block {
 struct packer_bin {
 	/* List links for packer.packer_bins */
 	struct list_head list;
+	/* List links for the packer bucket holding this bin, in bucketed mode */
+	struct list_head bucket_entry;
+	/* The index of the bucket holding this bin */
+	unsigned int bucket;
 	/* The number of items in the bin */
 	slot_number_t slots_used;
 	/* The number of compressed block bytes remaining in the current batch */
 	size_t free_space;
+	/* The time, in jiffies, at which the first item in the current batch arrived */
+	unsigned long arrival;
 	/* The current partial batch of data_vios, waiting for more */
 	struct data_vio *incoming[];
 };
 
+/* A fragment in another bin which could be moved into a bin about to be written */
+struct fill_candidate {
+	struct data_vio *data_vio;
+	block_size_t size;
+	/* The total size of this candidate and all the smaller ones after it */
+	size_t remaining;
+};
+
 struct packer {
 	/* The ID of the packer's callback thread */
 	thread_id_t thread_id;
 	/* The number of bins */
 	block_count_t size;
-	/* A list of all packer_bins, kept sorted by free_space */
+	/* A list of all packer_bins, kept sorted by free_space unless the packer is bucketed */
 	struct list_head bins;
+	/* Whether bins are found through the buckets rather than the sorted list */
+	bool bucketed;
+	/* Lists of the bins whose free space falls in each bucket, in bucketed mode */
+	struct list_head buckets[PACKER_BUCKETS];
+	/* A bit for each bucket which holds any bins */
+	u64 occupied_buckets;
+	/* Space to sort the fragments of all the bins when filling one, in bucketed mode */
+	struct fill_candidate *fill_candidates;
 	/*
 	 * A bin to hold data_vios which were canceled out of the packer and are waiting to
 	 * rendezvous with the canceling data_vio.
@@ -90,6 +129,15 @@ struct packer {
 	/* The administrative state of the packer */
 	struct admin_state state;
 
+	/* The age, in jiffies, at which a partial bin is written, or 0 if bins may wait forever */
+	unsigned long max_age;
+	/* The timer for writing bins which have reached the maximum age */
+	struct timer_list timer;
+	/* The state of the timer, a packer_timer_state */
+	atomic_t timer_state;
+	/* The completion for writing aged bins on the packer thread when the timer fires */
+	struct vdo_completion completion;
+
 	/* Statistics are only updated on the packer thread, but are accessed from other threads */
 	struct packer_statistics statistics;
 };
@@ -98,6 +146,9 @@ int vdo_get_compressed_block_fragment(enum block_mapping_state mapping_state,
 				      struct compressed_block *block,
 				      u16 *fragment_offset, u16 *fragment_size);
 
+enum vdo_compression_codec __must_check
+vdo_get_compressed_block_codec(const struct compressed_block *block);
+
 int __must_check vdo_make_packer(struct vdo *vdo, block_count_t bin_count,
 				 struct packer **packer_ptr);
 
@@ -120,7 +171,8 @@ void vdo_resume_packer(struct packer *packer, struct vdo_completion *parent);
 void vdo_dump_packer(const struct packer *packer);
 
 #ifdef INTERNAL
-void initialize_compressed_block(struct compressed_block *block, u16 size);
+void initialize_compressed_block(struct compressed_block *block, u16 size,
+				 enum vdo_compression_codec codec);
 
 struct compression_state;
 block_size_t __must_check pack_fragment(struct compression_state *compression,
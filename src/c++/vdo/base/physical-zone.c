@@ -477,21 +477,29 @@ int vdo_attempt_physical_zone_pbn_lock(struct physical_zone *zone,
 
 /**
  * allocate_and_lock_block() - Attempt to allocate a block from this zone.
- * @allocation: The struct allocation of the data_vio attempting to allocate.
+ * @data_vio: The data_vio attempting to allocate.
  *
- * If a block is allocated, the recipient will also hold a lock on it.
+ * If a block is allocated, the recipient will also hold a lock on it. Blocks for uncompressed data
+ * are allocated with regard to the logical block being written, so that sequential writes may be
+ * kept physically together.
  *
  * Return: VDO_SUCCESS if a block was allocated, or an error code.
  */
-static int allocate_and_lock_block(struct allocation *allocation)
+static int allocate_and_lock_block(struct data_vio *data_vio)
 {
 	int result;
 	struct pbn_lock *lock;
+	struct allocation *allocation = &data_vio->allocation;
+	struct block_allocator *allocator = allocation->zone->allocator;
 
 	VDO_ASSERT_LOG_ONLY(allocation->lock == NULL,
 			    "must not allocate a block while already holding a lock on one");
 
-	result = vdo_allocate_block(allocation->zone->allocator, &allocation->pbn);
+	if (allocation->write_lock_type == VIO_WRITE_LOCK)
+		result = vdo_allocate_block_for_lbn(allocator, data_vio->logical.lbn,
+						    &allocation->pbn);
+	else
+		result = vdo_allocate_block(allocator, &allocation->pbn);
 	if (result != VDO_SUCCESS)
 		return result;
 
@@ -590,7 +598,7 @@ static bool continue_allocating(struct data_vio *data_vio)
  */
 bool vdo_allocate_block_in_zone(struct data_vio *data_vio)
 {
-	int result = allocate_and_lock_block(&data_vio->allocation);
+	int result = allocate_and_lock_block(data_vio);
 
 	if (result == VDO_SUCCESS)
 		return true;
@@ -276,6 +276,86 @@ static struct pool_stats_attribute pool_stats_attr_packer_compressed_fragments_i
 	.print = pool_stats_print_packer_compressed_fragments_in_packer,
 };
 
+/* Number of blocks given to the compression codec to compress */
+static ssize_t pool_stats_print_compression_attempts(struct vdo_statistics *stats,
+						     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->compression.attempts);
+	#else
+	return sprintf(buf, "%lu\n", stats->compression.attempts);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_compression_attempts = {
+	.attr = { .name = "compression_attempts", .mode = 0444, },
+	.print = pool_stats_print_compression_attempts,
+};
+
+/* Number of compression attempts which did not produce a fragment */
+static ssize_t pool_stats_print_compression_failures(struct vdo_statistics *stats,
+						     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->compression.failures);
+	#else
+	return sprintf(buf, "%lu\n", stats->compression.failures);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_compression_failures = {
+	.attr = { .name = "compression_failures", .mode = 0444, },
+	.print = pool_stats_print_compression_failures,
+};
+
+/* Number of blocks not compressed because fast-reject judged them incompressible */
+static ssize_t pool_stats_print_compression_fast_reject_skips(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->compression.fast_reject_skips);
+	#else
+	return sprintf(buf, "%lu\n", stats->compression.fast_reject_skips);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_compression_fast_reject_skips = {
+	.attr = { .name = "compression_fast_reject_skips", .mode = 0444, },
+	.print = pool_stats_print_compression_fast_reject_skips,
+};
+
+/* Number of blocks judged incompressible which were compressed anyway to check fast-reject */
+static ssize_t pool_stats_print_compression_fast_reject_checks(struct vdo_statistics *stats,
+							       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->compression.fast_reject_checks);
+	#else
+	return sprintf(buf, "%lu\n", stats->compression.fast_reject_checks);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_compression_fast_reject_checks = {
+	.attr = { .name = "compression_fast_reject_checks", .mode = 0444, },
+	.print = pool_stats_print_compression_fast_reject_checks,
+};
+
+/* Number of fast-reject checks which produced a fragment */
+static ssize_t pool_stats_print_compression_fast_reject_mispredictions(struct vdo_statistics *stats,
+								       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->compression.fast_reject_mispredictions);
+	#else
+	return sprintf(buf, "%lu\n", stats->compression.fast_reject_mispredictions);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_compression_fast_reject_mispredictions = {
+	.attr = { .name = "compression_fast_reject_mispredictions", .mode = 0444, },
+	.print = pool_stats_print_compression_fast_reject_mispredictions,
+};
+
 /* The total number of slabs from which blocks may be allocated */
 static ssize_t pool_stats_print_allocator_slab_count(struct vdo_statistics *stats,
 						     char *buf)
@@ -324,6 +404,118 @@ static struct pool_stats_attribute pool_stats_attr_allocator_slabs_reopened = {
 	.print = pool_stats_print_allocator_slabs_reopened,
 };
 
+/* The number of sequential allocations which were physically contiguous */
+static ssize_t pool_stats_print_allocator_contiguous_allocations(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->allocator.contiguous_allocations);
+	#else
+	return sprintf(buf, "%lu\n", stats->allocator.contiguous_allocations);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_allocator_contiguous_allocations = {
+	.attr = { .name = "allocator_contiguous_allocations", .mode = 0444, },
+	.print = pool_stats_print_allocator_contiguous_allocations,
+};
+
+/* The number of sequential allocations which were not physically contiguous */
+static ssize_t pool_stats_print_allocator_fragmented_allocations(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->allocator.fragmented_allocations);
+	#else
+	return sprintf(buf, "%lu\n", stats->allocator.fragmented_allocations);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_allocator_fragmented_allocations = {
+	.attr = { .name = "allocator_fragmented_allocations", .mode = 0444, },
+	.print = pool_stats_print_allocator_fragmented_allocations,
+};
+
+/* The number of slabs which have yet to be scrubbed since loading */
+static ssize_t pool_stats_print_allocator_slabs_to_scrub(struct vdo_statistics *stats,
+							 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->allocator.slabs_to_scrub);
+	#else
+	return sprintf(buf, "%lu\n", stats->allocator.slabs_to_scrub);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_allocator_slabs_to_scrub = {
+	.attr = { .name = "allocator_slabs_to_scrub", .mode = 0444, },
+	.print = pool_stats_print_allocator_slabs_to_scrub,
+};
+
+/* The number of slabs which have been scrubbed since loading */
+static ssize_t pool_stats_print_allocator_slabs_scrubbed(struct vdo_statistics *stats,
+							 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->allocator.slabs_scrubbed);
+	#else
+	return sprintf(buf, "%lu\n", stats->allocator.slabs_scrubbed);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_allocator_slabs_scrubbed = {
+	.attr = { .name = "allocator_slabs_scrubbed", .mode = 0444, },
+	.print = pool_stats_print_allocator_slabs_scrubbed,
+};
+
+/* The estimated number of seconds until all slabs are scrubbed */
+static ssize_t pool_stats_print_allocator_scrub_seconds_remaining(struct vdo_statistics *stats,
+								  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->allocator.scrub_seconds_remaining);
+	#else
+	return sprintf(buf, "%lu\n", stats->allocator.scrub_seconds_remaining);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_allocator_scrub_seconds_remaining = {
+	.attr = { .name = "allocator_scrub_seconds_remaining", .mode = 0444, },
+	.print = pool_stats_print_allocator_scrub_seconds_remaining,
+};
+
+/* The number of clean slabs whose reference counts were deferred when loading */
+static ssize_t pool_stats_print_allocator_lazy_slabs(struct vdo_statistics *stats,
+						     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->allocator.lazy_slabs);
+	#else
+	return sprintf(buf, "%lu\n", stats->allocator.lazy_slabs);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_allocator_lazy_slabs = {
+	.attr = { .name = "allocator_lazy_slabs", .mode = 0444, },
+	.print = pool_stats_print_allocator_lazy_slabs,
+};
+
+/* The number of deferred slabs whose reference counts have since been loaded */
+static ssize_t pool_stats_print_allocator_lazy_slabs_loaded(struct vdo_statistics *stats,
+							    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->allocator.lazy_slabs_loaded);
+	#else
+	return sprintf(buf, "%lu\n", stats->allocator.lazy_slabs_loaded);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_allocator_lazy_slabs_loaded = {
+	.attr = { .name = "allocator_lazy_slabs_loaded", .mode = 0444, },
+	.print = pool_stats_print_allocator_lazy_slabs_loaded,
+};
+
 /* Number of times the on-disk journal was full */
 static ssize_t pool_stats_print_journal_disk_full(struct vdo_statistics *stats,
 						  char *buf)
@@ -452,6 +644,260 @@ static struct pool_stats_attribute pool_stats_attr_journal_blocks_committed = {
 	.print = pool_stats_print_journal_blocks_committed,
 };
 
+/* Number of commits which wrote several adjacent blocks at once */
+static ssize_t pool_stats_print_journal_multi_block_writes(struct vdo_statistics *stats, char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.multi_block_writes);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.multi_block_writes);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_multi_block_writes = {
+	.attr = { .name = "journal_multi_block_writes", .mode = 0444, },
+	.print = pool_stats_print_journal_multi_block_writes,
+};
+
+/* Number of commits which waited for more entries */
+static ssize_t pool_stats_print_journal_delayed_commits(struct vdo_statistics *stats, char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.delayed_commits);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.delayed_commits);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_delayed_commits = {
+	.attr = { .name = "journal_delayed_commits", .mode = 0444, },
+	.print = pool_stats_print_journal_delayed_commits,
+};
+
+/* Number of commits of a single entry */
+static ssize_t pool_stats_print_journal_commit_size_one_entry(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_size.one_entry);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_size.one_entry);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_size_one_entry = {
+	.attr = { .name = "journal_commit_size_one_entry", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_size_one_entry,
+};
+
+/* Number of commits of 2 to 15 entries */
+static ssize_t pool_stats_print_journal_commit_size_under_16(struct vdo_statistics *stats,
+							     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_size.under_16);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_size.under_16);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_size_under_16 = {
+	.attr = { .name = "journal_commit_size_under_16", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_size_under_16,
+};
+
+/* Number of commits of 16 to 63 entries */
+static ssize_t pool_stats_print_journal_commit_size_under_64(struct vdo_statistics *stats,
+							     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_size.under_64);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_size.under_64);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_size_under_64 = {
+	.attr = { .name = "journal_commit_size_under_64", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_size_under_64,
+};
+
+/* Number of commits of 64 entries up to a full block */
+static ssize_t pool_stats_print_journal_commit_size_one_block(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_size.one_block);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_size.one_block);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_size_one_block = {
+	.attr = { .name = "journal_commit_size_one_block", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_size_one_block,
+};
+
+/* Number of commits of more than a full block of entries */
+static ssize_t pool_stats_print_journal_commit_size_multiple_blocks(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_size.multiple_blocks);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_size.multiple_blocks);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_size_multiple_blocks = {
+	.attr = { .name = "journal_commit_size_multiple_blocks", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_size_multiple_blocks,
+};
+
+/* Number of times a write has completed this stage */
+static ssize_t pool_stats_print_journal_commit_latency_count(struct vdo_statistics *stats,
+							     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_latency.count);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_latency.count);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_latency_count = {
+	.attr = { .name = "journal_commit_latency_count", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_latency_count,
+};
+
+/* Total time spent in this stage, in microseconds */
+static ssize_t pool_stats_print_journal_commit_latency_total_microseconds(struct vdo_statistics *stats,
+									  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_latency.total_microseconds);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_latency.total_microseconds);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_latency_total_microseconds = {
+	.attr = { .name = "journal_commit_latency_total_microseconds", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_latency_total_microseconds,
+};
+
+/* Number of times the stage took less than 10 microseconds */
+static ssize_t pool_stats_print_journal_commit_latency_under_10us(struct vdo_statistics *stats,
+								  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_latency.under_10us);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_latency.under_10us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_latency_under_10us = {
+	.attr = { .name = "journal_commit_latency_under_10us", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_latency_under_10us,
+};
+
+/* Number of times the stage took 10 to 100 microseconds */
+static ssize_t pool_stats_print_journal_commit_latency_under_100us(struct vdo_statistics *stats,
+								   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_latency.under_100us);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_latency.under_100us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_latency_under_100us = {
+	.attr = { .name = "journal_commit_latency_under_100us", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_latency_under_100us,
+};
+
+/* Number of times the stage took 100 microseconds to 1 millisecond */
+static ssize_t pool_stats_print_journal_commit_latency_under_1ms(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_latency.under_1ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_latency.under_1ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_latency_under_1ms = {
+	.attr = { .name = "journal_commit_latency_under_1ms", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_latency_under_1ms,
+};
+
+/* Number of times the stage took 1 to 10 milliseconds */
+static ssize_t pool_stats_print_journal_commit_latency_under_10ms(struct vdo_statistics *stats,
+								  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_latency.under_10ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_latency.under_10ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_latency_under_10ms = {
+	.attr = { .name = "journal_commit_latency_under_10ms", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_latency_under_10ms,
+};
+
+/* Number of times the stage took 10 to 100 milliseconds */
+static ssize_t pool_stats_print_journal_commit_latency_under_100ms(struct vdo_statistics *stats,
+								   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_latency.under_100ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_latency.under_100ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_latency_under_100ms = {
+	.attr = { .name = "journal_commit_latency_under_100ms", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_latency_under_100ms,
+};
+
+/* Number of times the stage took 100 milliseconds to 1 second */
+static ssize_t pool_stats_print_journal_commit_latency_under_1s(struct vdo_statistics *stats,
+								char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_latency.under_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_latency.under_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_latency_under_1s = {
+	.attr = { .name = "journal_commit_latency_under_1s", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_latency_under_1s,
+};
+
+/* Number of times the stage took 1 second or more */
+static ssize_t pool_stats_print_journal_commit_latency_over_1s(struct vdo_statistics *stats,
+							       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->journal.commit_latency.over_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->journal.commit_latency.over_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_journal_commit_latency_over_1s = {
+	.attr = { .name = "journal_commit_latency_over_1s", .mode = 0444, },
+	.print = pool_stats_print_journal_commit_latency_over_1s,
+};
+
 /* Number of times the on-disk journal was full */
 static ssize_t pool_stats_print_slab_journal_disk_full_count(struct vdo_statistics *stats,
 							     char *buf)
@@ -884,18 +1330,162 @@ static struct pool_stats_attribute pool_stats_attr_block_map_flush_count = {
 	.print = pool_stats_print_block_map_flush_count,
 };
 
-/* Number of times the UDS advice proved correct */
-static ssize_t pool_stats_print_hash_lock_dedupe_advice_valid(struct vdo_statistics *stats,
-							      char *buf)
+/* number of fetched pages which were recently evicted from probation */
+static ssize_t pool_stats_print_block_map_ghost_hits(struct vdo_statistics *stats,
+						     char *buf)
 {
 	#ifdef __KERNEL__
-	return sprintf(buf, "%llu\n", stats->hash_lock.dedupe_advice_valid);
+	return sprintf(buf, "%llu\n", stats->block_map.ghost_hits);
 	#else
-	return sprintf(buf, "%lu\n", stats->hash_lock.dedupe_advice_valid);
+	return sprintf(buf, "%lu\n", stats->block_map.ghost_hits);
 	#endif // __KERNEL__
 }
 
-static struct pool_stats_attribute pool_stats_attr_hash_lock_dedupe_advice_valid = {
+static struct pool_stats_attribute pool_stats_attr_block_map_ghost_hits = {
+	.attr = { .name = "block_map_ghost_hits", .mode = 0444, },
+	.print = pool_stats_print_block_map_ghost_hits,
+};
+
+/* number of pages loaded speculatively by readahead */
+static ssize_t pool_stats_print_block_map_readahead_pages(struct vdo_statistics *stats,
+							  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->block_map.readahead_pages);
+	#else
+	return sprintf(buf, "%lu\n", stats->block_map.readahead_pages);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_block_map_readahead_pages = {
+	.attr = { .name = "block_map_readahead_pages", .mode = 0444, },
+	.print = pool_stats_print_block_map_readahead_pages,
+};
+
+/* number of readahead pages which were used before being evicted */
+static ssize_t pool_stats_print_block_map_readahead_used(struct vdo_statistics *stats,
+							 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->block_map.readahead_used);
+	#else
+	return sprintf(buf, "%lu\n", stats->block_map.readahead_used);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_block_map_readahead_used = {
+	.attr = { .name = "block_map_readahead_used", .mode = 0444, },
+	.print = pool_stats_print_block_map_readahead_used,
+};
+
+/* number of readahead pages evicted without being used */
+static ssize_t pool_stats_print_block_map_readahead_wasted(struct vdo_statistics *stats,
+							   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->block_map.readahead_wasted);
+	#else
+	return sprintf(buf, "%lu\n", stats->block_map.readahead_wasted);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_block_map_readahead_wasted = {
+	.attr = { .name = "block_map_readahead_wasted", .mode = 0444, },
+	.print = pool_stats_print_block_map_readahead_wasted,
+};
+
+/* number of writes issued to save pages */
+static ssize_t pool_stats_print_block_map_writes_issued(struct vdo_statistics *stats,
+							char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->block_map.writes_issued);
+	#else
+	return sprintf(buf, "%lu\n", stats->block_map.writes_issued);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_block_map_writes_issued = {
+	.attr = { .name = "block_map_writes_issued", .mode = 0444, },
+	.print = pool_stats_print_block_map_writes_issued,
+};
+
+/* number of pages loaded to warm up the cache */
+static ssize_t pool_stats_print_block_map_warmup_pages(struct vdo_statistics *stats,
+						       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->block_map.warmup_pages);
+	#else
+	return sprintf(buf, "%lu\n", stats->block_map.warmup_pages);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_block_map_warmup_pages = {
+	.attr = { .name = "block_map_warmup_pages", .mode = 0444, },
+	.print = pool_stats_print_block_map_warmup_pages,
+};
+
+/* number of pages read from the cache device */
+static ssize_t pool_stats_print_block_map_tier_pages_read(struct vdo_statistics *stats,
+							  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->block_map.tier_pages_read);
+	#else
+	return sprintf(buf, "%lu\n", stats->block_map.tier_pages_read);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_block_map_tier_pages_read = {
+	.attr = { .name = "block_map_tier_pages_read", .mode = 0444, },
+	.print = pool_stats_print_block_map_tier_pages_read,
+};
+
+/* number of evicted pages written to the cache device */
+static ssize_t pool_stats_print_block_map_tier_pages_written(struct vdo_statistics *stats,
+							     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->block_map.tier_pages_written);
+	#else
+	return sprintf(buf, "%lu\n", stats->block_map.tier_pages_written);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_block_map_tier_pages_written = {
+	.attr = { .name = "block_map_tier_pages_written", .mode = 0444, },
+	.print = pool_stats_print_block_map_tier_pages_written,
+};
+
+/* number of cache device pages which were invalid or could not be read or written */
+static ssize_t pool_stats_print_block_map_tier_pages_rejected(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->block_map.tier_pages_rejected);
+	#else
+	return sprintf(buf, "%lu\n", stats->block_map.tier_pages_rejected);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_block_map_tier_pages_rejected = {
+	.attr = { .name = "block_map_tier_pages_rejected", .mode = 0444, },
+	.print = pool_stats_print_block_map_tier_pages_rejected,
+};
+
+/* Number of times the UDS advice proved correct */
+static ssize_t pool_stats_print_hash_lock_dedupe_advice_valid(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->hash_lock.dedupe_advice_valid);
+	#else
+	return sprintf(buf, "%lu\n", stats->hash_lock.dedupe_advice_valid);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_hash_lock_dedupe_advice_valid = {
 	.attr = { .name = "hash_lock_dedupe_advice_valid", .mode = 0444, },
 	.print = pool_stats_print_hash_lock_dedupe_advice_valid,
 };
@@ -964,6 +1554,54 @@ static struct pool_stats_attribute pool_stats_attr_hash_lock_curr_dedupe_queries
 	.print = pool_stats_print_hash_lock_curr_dedupe_queries,
 };
 
+/* Number of writes which requested a hash lock, summed over all hash zones */
+static ssize_t pool_stats_print_hash_lock_lock_requests(struct vdo_statistics *stats,
+							char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->hash_lock.lock_requests);
+	#else
+	return sprintf(buf, "%lu\n", stats->hash_lock.lock_requests);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_hash_lock_lock_requests = {
+	.attr = { .name = "hash_lock_lock_requests", .mode = 0444, },
+	.print = pool_stats_print_hash_lock_lock_requests,
+};
+
+/* Number of hash lock requests handled by the busiest hash zone */
+static ssize_t pool_stats_print_hash_lock_max_zone_lock_requests(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->hash_lock.max_zone_lock_requests);
+	#else
+	return sprintf(buf, "%lu\n", stats->hash_lock.max_zone_lock_requests);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_hash_lock_max_zone_lock_requests = {
+	.attr = { .name = "hash_lock_max_zone_lock_requests", .mode = 0444, },
+	.print = pool_stats_print_hash_lock_max_zone_lock_requests,
+};
+
+/* Number of hash lock requests handled by the least busy hash zone */
+static ssize_t pool_stats_print_hash_lock_min_zone_lock_requests(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->hash_lock.min_zone_lock_requests);
+	#else
+	return sprintf(buf, "%lu\n", stats->hash_lock.min_zone_lock_requests);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_hash_lock_min_zone_lock_requests = {
+	.attr = { .name = "hash_lock_min_zone_lock_requests", .mode = 0444, },
+	.print = pool_stats_print_hash_lock_min_zone_lock_requests,
+};
+
 /* number of times VDO got an invalid dedupe advice PBN from UDS */
 static ssize_t pool_stats_print_errors_invalid_advice_pbn_count(struct vdo_statistics *stats,
 								char *buf)
@@ -2338,6 +2976,1297 @@ static struct pool_stats_attribute pool_stats_attr_bios_in_progress_fua = {
 	.print = pool_stats_print_bios_in_progress_fua,
 };
 
+/* Number of times a write has completed this stage */
+static ssize_t pool_stats_print_write_latency_launch_count(struct vdo_statistics *stats, char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.launch.count);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.launch.count);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_launch_count = {
+	.attr = { .name = "write_latency_launch_count", .mode = 0444, },
+	.print = pool_stats_print_write_latency_launch_count,
+};
+
+/* Total time spent in this stage, in microseconds */
+static ssize_t pool_stats_print_write_latency_launch_total_microseconds(struct vdo_statistics *stats,
+									char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.launch.total_microseconds);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.launch.total_microseconds);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_launch_total_microseconds = {
+	.attr = { .name = "write_latency_launch_total_microseconds", .mode = 0444, },
+	.print = pool_stats_print_write_latency_launch_total_microseconds,
+};
+
+/* Number of times the stage took less than 10 microseconds */
+static ssize_t pool_stats_print_write_latency_launch_under_10us(struct vdo_statistics *stats,
+								char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.launch.under_10us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.launch.under_10us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_launch_under_10us = {
+	.attr = { .name = "write_latency_launch_under_10us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_launch_under_10us,
+};
+
+/* Number of times the stage took 10 to 100 microseconds */
+static ssize_t pool_stats_print_write_latency_launch_under_100us(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.launch.under_100us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.launch.under_100us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_launch_under_100us = {
+	.attr = { .name = "write_latency_launch_under_100us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_launch_under_100us,
+};
+
+/* Number of times the stage took 100 microseconds to 1 millisecond */
+static ssize_t pool_stats_print_write_latency_launch_under_1ms(struct vdo_statistics *stats,
+							       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.launch.under_1ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.launch.under_1ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_launch_under_1ms = {
+	.attr = { .name = "write_latency_launch_under_1ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_launch_under_1ms,
+};
+
+/* Number of times the stage took 1 to 10 milliseconds */
+static ssize_t pool_stats_print_write_latency_launch_under_10ms(struct vdo_statistics *stats,
+								char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.launch.under_10ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.launch.under_10ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_launch_under_10ms = {
+	.attr = { .name = "write_latency_launch_under_10ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_launch_under_10ms,
+};
+
+/* Number of times the stage took 10 to 100 milliseconds */
+static ssize_t pool_stats_print_write_latency_launch_under_100ms(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.launch.under_100ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.launch.under_100ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_launch_under_100ms = {
+	.attr = { .name = "write_latency_launch_under_100ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_launch_under_100ms,
+};
+
+/* Number of times the stage took 100 milliseconds to 1 second */
+static ssize_t pool_stats_print_write_latency_launch_under_1s(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.launch.under_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.launch.under_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_launch_under_1s = {
+	.attr = { .name = "write_latency_launch_under_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_launch_under_1s,
+};
+
+/* Number of times the stage took 1 second or more */
+static ssize_t pool_stats_print_write_latency_launch_over_1s(struct vdo_statistics *stats,
+							     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.launch.over_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.launch.over_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_launch_over_1s = {
+	.attr = { .name = "write_latency_launch_over_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_launch_over_1s,
+};
+
+/* Number of times a write has completed this stage */
+static ssize_t pool_stats_print_write_latency_hash_count(struct vdo_statistics *stats, char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash.count);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash.count);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_count = {
+	.attr = { .name = "write_latency_hash_count", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_count,
+};
+
+/* Total time spent in this stage, in microseconds */
+static ssize_t pool_stats_print_write_latency_hash_total_microseconds(struct vdo_statistics *stats,
+								      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash.total_microseconds);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash.total_microseconds);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_total_microseconds = {
+	.attr = { .name = "write_latency_hash_total_microseconds", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_total_microseconds,
+};
+
+/* Number of times the stage took less than 10 microseconds */
+static ssize_t pool_stats_print_write_latency_hash_under_10us(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash.under_10us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash.under_10us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_under_10us = {
+	.attr = { .name = "write_latency_hash_under_10us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_under_10us,
+};
+
+/* Number of times the stage took 10 to 100 microseconds */
+static ssize_t pool_stats_print_write_latency_hash_under_100us(struct vdo_statistics *stats,
+							       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash.under_100us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash.under_100us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_under_100us = {
+	.attr = { .name = "write_latency_hash_under_100us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_under_100us,
+};
+
+/* Number of times the stage took 100 microseconds to 1 millisecond */
+static ssize_t pool_stats_print_write_latency_hash_under_1ms(struct vdo_statistics *stats,
+							     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash.under_1ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash.under_1ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_under_1ms = {
+	.attr = { .name = "write_latency_hash_under_1ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_under_1ms,
+};
+
+/* Number of times the stage took 1 to 10 milliseconds */
+static ssize_t pool_stats_print_write_latency_hash_under_10ms(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash.under_10ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash.under_10ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_under_10ms = {
+	.attr = { .name = "write_latency_hash_under_10ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_under_10ms,
+};
+
+/* Number of times the stage took 10 to 100 milliseconds */
+static ssize_t pool_stats_print_write_latency_hash_under_100ms(struct vdo_statistics *stats,
+							       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash.under_100ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash.under_100ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_under_100ms = {
+	.attr = { .name = "write_latency_hash_under_100ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_under_100ms,
+};
+
+/* Number of times the stage took 100 milliseconds to 1 second */
+static ssize_t pool_stats_print_write_latency_hash_under_1s(struct vdo_statistics *stats, char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash.under_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash.under_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_under_1s = {
+	.attr = { .name = "write_latency_hash_under_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_under_1s,
+};
+
+/* Number of times the stage took 1 second or more */
+static ssize_t pool_stats_print_write_latency_hash_over_1s(struct vdo_statistics *stats, char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash.over_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash.over_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_over_1s = {
+	.attr = { .name = "write_latency_hash_over_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_over_1s,
+};
+
+/* Number of times a write has completed this stage */
+static ssize_t pool_stats_print_write_latency_hash_lock_count(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash_lock.count);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash_lock.count);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_lock_count = {
+	.attr = { .name = "write_latency_hash_lock_count", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_lock_count,
+};
+
+/* Total time spent in this stage, in microseconds */
+static ssize_t pool_stats_print_write_latency_hash_lock_total_microseconds(struct vdo_statistics *stats,
+									   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash_lock.total_microseconds);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash_lock.total_microseconds);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_lock_total_microseconds = {
+	.attr = { .name = "write_latency_hash_lock_total_microseconds", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_lock_total_microseconds,
+};
+
+/* Number of times the stage took less than 10 microseconds */
+static ssize_t pool_stats_print_write_latency_hash_lock_under_10us(struct vdo_statistics *stats,
+								   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash_lock.under_10us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash_lock.under_10us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_lock_under_10us = {
+	.attr = { .name = "write_latency_hash_lock_under_10us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_lock_under_10us,
+};
+
+/* Number of times the stage took 10 to 100 microseconds */
+static ssize_t pool_stats_print_write_latency_hash_lock_under_100us(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash_lock.under_100us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash_lock.under_100us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_lock_under_100us = {
+	.attr = { .name = "write_latency_hash_lock_under_100us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_lock_under_100us,
+};
+
+/* Number of times the stage took 100 microseconds to 1 millisecond */
+static ssize_t pool_stats_print_write_latency_hash_lock_under_1ms(struct vdo_statistics *stats,
+								  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash_lock.under_1ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash_lock.under_1ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_lock_under_1ms = {
+	.attr = { .name = "write_latency_hash_lock_under_1ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_lock_under_1ms,
+};
+
+/* Number of times the stage took 1 to 10 milliseconds */
+static ssize_t pool_stats_print_write_latency_hash_lock_under_10ms(struct vdo_statistics *stats,
+								   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash_lock.under_10ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash_lock.under_10ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_lock_under_10ms = {
+	.attr = { .name = "write_latency_hash_lock_under_10ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_lock_under_10ms,
+};
+
+/* Number of times the stage took 10 to 100 milliseconds */
+static ssize_t pool_stats_print_write_latency_hash_lock_under_100ms(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash_lock.under_100ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash_lock.under_100ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_lock_under_100ms = {
+	.attr = { .name = "write_latency_hash_lock_under_100ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_lock_under_100ms,
+};
+
+/* Number of times the stage took 100 milliseconds to 1 second */
+static ssize_t pool_stats_print_write_latency_hash_lock_under_1s(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash_lock.under_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash_lock.under_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_lock_under_1s = {
+	.attr = { .name = "write_latency_hash_lock_under_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_lock_under_1s,
+};
+
+/* Number of times the stage took 1 second or more */
+static ssize_t pool_stats_print_write_latency_hash_lock_over_1s(struct vdo_statistics *stats,
+								char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.hash_lock.over_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.hash_lock.over_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_hash_lock_over_1s = {
+	.attr = { .name = "write_latency_hash_lock_over_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_hash_lock_over_1s,
+};
+
+/* Number of times a write has completed this stage */
+static ssize_t pool_stats_print_write_latency_dedupe_query_count(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.dedupe_query.count);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.dedupe_query.count);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_dedupe_query_count = {
+	.attr = { .name = "write_latency_dedupe_query_count", .mode = 0444, },
+	.print = pool_stats_print_write_latency_dedupe_query_count,
+};
+
+/* Total time spent in this stage, in microseconds */
+static ssize_t pool_stats_print_write_latency_dedupe_query_total_microseconds(struct vdo_statistics *stats,
+									      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.dedupe_query.total_microseconds);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.dedupe_query.total_microseconds);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_dedupe_query_total_microseconds = {
+	.attr = { .name = "write_latency_dedupe_query_total_microseconds", .mode = 0444, },
+	.print = pool_stats_print_write_latency_dedupe_query_total_microseconds,
+};
+
+/* Number of times the stage took less than 10 microseconds */
+static ssize_t pool_stats_print_write_latency_dedupe_query_under_10us(struct vdo_statistics *stats,
+								      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.dedupe_query.under_10us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.dedupe_query.under_10us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_dedupe_query_under_10us = {
+	.attr = { .name = "write_latency_dedupe_query_under_10us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_dedupe_query_under_10us,
+};
+
+/* Number of times the stage took 10 to 100 microseconds */
+static ssize_t pool_stats_print_write_latency_dedupe_query_under_100us(struct vdo_statistics *stats,
+								       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.dedupe_query.under_100us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.dedupe_query.under_100us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_dedupe_query_under_100us = {
+	.attr = { .name = "write_latency_dedupe_query_under_100us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_dedupe_query_under_100us,
+};
+
+/* Number of times the stage took 100 microseconds to 1 millisecond */
+static ssize_t pool_stats_print_write_latency_dedupe_query_under_1ms(struct vdo_statistics *stats,
+								     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.dedupe_query.under_1ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.dedupe_query.under_1ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_dedupe_query_under_1ms = {
+	.attr = { .name = "write_latency_dedupe_query_under_1ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_dedupe_query_under_1ms,
+};
+
+/* Number of times the stage took 1 to 10 milliseconds */
+static ssize_t pool_stats_print_write_latency_dedupe_query_under_10ms(struct vdo_statistics *stats,
+								      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.dedupe_query.under_10ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.dedupe_query.under_10ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_dedupe_query_under_10ms = {
+	.attr = { .name = "write_latency_dedupe_query_under_10ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_dedupe_query_under_10ms,
+};
+
+/* Number of times the stage took 10 to 100 milliseconds */
+static ssize_t pool_stats_print_write_latency_dedupe_query_under_100ms(struct vdo_statistics *stats,
+								       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.dedupe_query.under_100ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.dedupe_query.under_100ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_dedupe_query_under_100ms = {
+	.attr = { .name = "write_latency_dedupe_query_under_100ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_dedupe_query_under_100ms,
+};
+
+/* Number of times the stage took 100 milliseconds to 1 second */
+static ssize_t pool_stats_print_write_latency_dedupe_query_under_1s(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.dedupe_query.under_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.dedupe_query.under_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_dedupe_query_under_1s = {
+	.attr = { .name = "write_latency_dedupe_query_under_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_dedupe_query_under_1s,
+};
+
+/* Number of times the stage took 1 second or more */
+static ssize_t pool_stats_print_write_latency_dedupe_query_over_1s(struct vdo_statistics *stats,
+								   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.dedupe_query.over_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.dedupe_query.over_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_dedupe_query_over_1s = {
+	.attr = { .name = "write_latency_dedupe_query_over_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_dedupe_query_over_1s,
+};
+
+/* Number of times a write has completed this stage */
+static ssize_t pool_stats_print_write_latency_allocation_count(struct vdo_statistics *stats,
+							       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.allocation.count);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.allocation.count);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_allocation_count = {
+	.attr = { .name = "write_latency_allocation_count", .mode = 0444, },
+	.print = pool_stats_print_write_latency_allocation_count,
+};
+
+/* Total time spent in this stage, in microseconds */
+static ssize_t pool_stats_print_write_latency_allocation_total_microseconds(struct vdo_statistics *stats,
+									    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.allocation.total_microseconds);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.allocation.total_microseconds);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_allocation_total_microseconds = {
+	.attr = { .name = "write_latency_allocation_total_microseconds", .mode = 0444, },
+	.print = pool_stats_print_write_latency_allocation_total_microseconds,
+};
+
+/* Number of times the stage took less than 10 microseconds */
+static ssize_t pool_stats_print_write_latency_allocation_under_10us(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.allocation.under_10us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.allocation.under_10us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_allocation_under_10us = {
+	.attr = { .name = "write_latency_allocation_under_10us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_allocation_under_10us,
+};
+
+/* Number of times the stage took 10 to 100 microseconds */
+static ssize_t pool_stats_print_write_latency_allocation_under_100us(struct vdo_statistics *stats,
+								     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.allocation.under_100us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.allocation.under_100us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_allocation_under_100us = {
+	.attr = { .name = "write_latency_allocation_under_100us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_allocation_under_100us,
+};
+
+/* Number of times the stage took 100 microseconds to 1 millisecond */
+static ssize_t pool_stats_print_write_latency_allocation_under_1ms(struct vdo_statistics *stats,
+								   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.allocation.under_1ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.allocation.under_1ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_allocation_under_1ms = {
+	.attr = { .name = "write_latency_allocation_under_1ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_allocation_under_1ms,
+};
+
+/* Number of times the stage took 1 to 10 milliseconds */
+static ssize_t pool_stats_print_write_latency_allocation_under_10ms(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.allocation.under_10ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.allocation.under_10ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_allocation_under_10ms = {
+	.attr = { .name = "write_latency_allocation_under_10ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_allocation_under_10ms,
+};
+
+/* Number of times the stage took 10 to 100 milliseconds */
+static ssize_t pool_stats_print_write_latency_allocation_under_100ms(struct vdo_statistics *stats,
+								     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.allocation.under_100ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.allocation.under_100ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_allocation_under_100ms = {
+	.attr = { .name = "write_latency_allocation_under_100ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_allocation_under_100ms,
+};
+
+/* Number of times the stage took 100 milliseconds to 1 second */
+static ssize_t pool_stats_print_write_latency_allocation_under_1s(struct vdo_statistics *stats,
+								  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.allocation.under_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.allocation.under_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_allocation_under_1s = {
+	.attr = { .name = "write_latency_allocation_under_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_allocation_under_1s,
+};
+
+/* Number of times the stage took 1 second or more */
+static ssize_t pool_stats_print_write_latency_allocation_over_1s(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.allocation.over_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.allocation.over_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_allocation_over_1s = {
+	.attr = { .name = "write_latency_allocation_over_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_allocation_over_1s,
+};
+
+/* Number of times a write has completed this stage */
+static ssize_t pool_stats_print_write_latency_data_write_count(struct vdo_statistics *stats,
+							       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.data_write.count);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.data_write.count);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_data_write_count = {
+	.attr = { .name = "write_latency_data_write_count", .mode = 0444, },
+	.print = pool_stats_print_write_latency_data_write_count,
+};
+
+/* Total time spent in this stage, in microseconds */
+static ssize_t pool_stats_print_write_latency_data_write_total_microseconds(struct vdo_statistics *stats,
+									    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.data_write.total_microseconds);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.data_write.total_microseconds);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_data_write_total_microseconds = {
+	.attr = { .name = "write_latency_data_write_total_microseconds", .mode = 0444, },
+	.print = pool_stats_print_write_latency_data_write_total_microseconds,
+};
+
+/* Number of times the stage took less than 10 microseconds */
+static ssize_t pool_stats_print_write_latency_data_write_under_10us(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.data_write.under_10us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.data_write.under_10us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_data_write_under_10us = {
+	.attr = { .name = "write_latency_data_write_under_10us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_data_write_under_10us,
+};
+
+/* Number of times the stage took 10 to 100 microseconds */
+static ssize_t pool_stats_print_write_latency_data_write_under_100us(struct vdo_statistics *stats,
+								     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.data_write.under_100us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.data_write.under_100us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_data_write_under_100us = {
+	.attr = { .name = "write_latency_data_write_under_100us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_data_write_under_100us,
+};
+
+/* Number of times the stage took 100 microseconds to 1 millisecond */
+static ssize_t pool_stats_print_write_latency_data_write_under_1ms(struct vdo_statistics *stats,
+								   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.data_write.under_1ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.data_write.under_1ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_data_write_under_1ms = {
+	.attr = { .name = "write_latency_data_write_under_1ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_data_write_under_1ms,
+};
+
+/* Number of times the stage took 1 to 10 milliseconds */
+static ssize_t pool_stats_print_write_latency_data_write_under_10ms(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.data_write.under_10ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.data_write.under_10ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_data_write_under_10ms = {
+	.attr = { .name = "write_latency_data_write_under_10ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_data_write_under_10ms,
+};
+
+/* Number of times the stage took 10 to 100 milliseconds */
+static ssize_t pool_stats_print_write_latency_data_write_under_100ms(struct vdo_statistics *stats,
+								     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.data_write.under_100ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.data_write.under_100ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_data_write_under_100ms = {
+	.attr = { .name = "write_latency_data_write_under_100ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_data_write_under_100ms,
+};
+
+/* Number of times the stage took 100 milliseconds to 1 second */
+static ssize_t pool_stats_print_write_latency_data_write_under_1s(struct vdo_statistics *stats,
+								  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.data_write.under_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.data_write.under_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_data_write_under_1s = {
+	.attr = { .name = "write_latency_data_write_under_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_data_write_under_1s,
+};
+
+/* Number of times the stage took 1 second or more */
+static ssize_t pool_stats_print_write_latency_data_write_over_1s(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.data_write.over_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.data_write.over_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_data_write_over_1s = {
+	.attr = { .name = "write_latency_data_write_over_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_data_write_over_1s,
+};
+
+/* Number of times a write has completed this stage */
+static ssize_t pool_stats_print_write_latency_journal_count(struct vdo_statistics *stats, char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.journal.count);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.journal.count);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_journal_count = {
+	.attr = { .name = "write_latency_journal_count", .mode = 0444, },
+	.print = pool_stats_print_write_latency_journal_count,
+};
+
+/* Total time spent in this stage, in microseconds */
+static ssize_t pool_stats_print_write_latency_journal_total_microseconds(struct vdo_statistics *stats,
+									 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.journal.total_microseconds);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.journal.total_microseconds);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_journal_total_microseconds = {
+	.attr = { .name = "write_latency_journal_total_microseconds", .mode = 0444, },
+	.print = pool_stats_print_write_latency_journal_total_microseconds,
+};
+
+/* Number of times the stage took less than 10 microseconds */
+static ssize_t pool_stats_print_write_latency_journal_under_10us(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.journal.under_10us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.journal.under_10us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_journal_under_10us = {
+	.attr = { .name = "write_latency_journal_under_10us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_journal_under_10us,
+};
+
+/* Number of times the stage took 10 to 100 microseconds */
+static ssize_t pool_stats_print_write_latency_journal_under_100us(struct vdo_statistics *stats,
+								  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.journal.under_100us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.journal.under_100us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_journal_under_100us = {
+	.attr = { .name = "write_latency_journal_under_100us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_journal_under_100us,
+};
+
+/* Number of times the stage took 100 microseconds to 1 millisecond */
+static ssize_t pool_stats_print_write_latency_journal_under_1ms(struct vdo_statistics *stats,
+								char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.journal.under_1ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.journal.under_1ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_journal_under_1ms = {
+	.attr = { .name = "write_latency_journal_under_1ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_journal_under_1ms,
+};
+
+/* Number of times the stage took 1 to 10 milliseconds */
+static ssize_t pool_stats_print_write_latency_journal_under_10ms(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.journal.under_10ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.journal.under_10ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_journal_under_10ms = {
+	.attr = { .name = "write_latency_journal_under_10ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_journal_under_10ms,
+};
+
+/* Number of times the stage took 10 to 100 milliseconds */
+static ssize_t pool_stats_print_write_latency_journal_under_100ms(struct vdo_statistics *stats,
+								  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.journal.under_100ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.journal.under_100ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_journal_under_100ms = {
+	.attr = { .name = "write_latency_journal_under_100ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_journal_under_100ms,
+};
+
+/* Number of times the stage took 100 milliseconds to 1 second */
+static ssize_t pool_stats_print_write_latency_journal_under_1s(struct vdo_statistics *stats,
+							       char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.journal.under_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.journal.under_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_journal_under_1s = {
+	.attr = { .name = "write_latency_journal_under_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_journal_under_1s,
+};
+
+/* Number of times the stage took 1 second or more */
+static ssize_t pool_stats_print_write_latency_journal_over_1s(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.journal.over_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.journal.over_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_journal_over_1s = {
+	.attr = { .name = "write_latency_journal_over_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_journal_over_1s,
+};
+
+/* Number of times a write has completed this stage */
+static ssize_t pool_stats_print_write_latency_block_map_count(struct vdo_statistics *stats,
+							      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.block_map.count);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.block_map.count);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_block_map_count = {
+	.attr = { .name = "write_latency_block_map_count", .mode = 0444, },
+	.print = pool_stats_print_write_latency_block_map_count,
+};
+
+/* Total time spent in this stage, in microseconds */
+static ssize_t pool_stats_print_write_latency_block_map_total_microseconds(struct vdo_statistics *stats,
+									   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.block_map.total_microseconds);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.block_map.total_microseconds);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_block_map_total_microseconds = {
+	.attr = { .name = "write_latency_block_map_total_microseconds", .mode = 0444, },
+	.print = pool_stats_print_write_latency_block_map_total_microseconds,
+};
+
+/* Number of times the stage took less than 10 microseconds */
+static ssize_t pool_stats_print_write_latency_block_map_under_10us(struct vdo_statistics *stats,
+								   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.block_map.under_10us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.block_map.under_10us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_block_map_under_10us = {
+	.attr = { .name = "write_latency_block_map_under_10us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_block_map_under_10us,
+};
+
+/* Number of times the stage took 10 to 100 microseconds */
+static ssize_t pool_stats_print_write_latency_block_map_under_100us(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.block_map.under_100us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.block_map.under_100us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_block_map_under_100us = {
+	.attr = { .name = "write_latency_block_map_under_100us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_block_map_under_100us,
+};
+
+/* Number of times the stage took 100 microseconds to 1 millisecond */
+static ssize_t pool_stats_print_write_latency_block_map_under_1ms(struct vdo_statistics *stats,
+								  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.block_map.under_1ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.block_map.under_1ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_block_map_under_1ms = {
+	.attr = { .name = "write_latency_block_map_under_1ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_block_map_under_1ms,
+};
+
+/* Number of times the stage took 1 to 10 milliseconds */
+static ssize_t pool_stats_print_write_latency_block_map_under_10ms(struct vdo_statistics *stats,
+								   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.block_map.under_10ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.block_map.under_10ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_block_map_under_10ms = {
+	.attr = { .name = "write_latency_block_map_under_10ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_block_map_under_10ms,
+};
+
+/* Number of times the stage took 10 to 100 milliseconds */
+static ssize_t pool_stats_print_write_latency_block_map_under_100ms(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.block_map.under_100ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.block_map.under_100ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_block_map_under_100ms = {
+	.attr = { .name = "write_latency_block_map_under_100ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_block_map_under_100ms,
+};
+
+/* Number of times the stage took 100 milliseconds to 1 second */
+static ssize_t pool_stats_print_write_latency_block_map_under_1s(struct vdo_statistics *stats,
+								 char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.block_map.under_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.block_map.under_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_block_map_under_1s = {
+	.attr = { .name = "write_latency_block_map_under_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_block_map_under_1s,
+};
+
+/* Number of times the stage took 1 second or more */
+static ssize_t pool_stats_print_write_latency_block_map_over_1s(struct vdo_statistics *stats,
+								char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.block_map.over_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.block_map.over_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_block_map_over_1s = {
+	.attr = { .name = "write_latency_block_map_over_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_block_map_over_1s,
+};
+
+/* Number of times a write has completed this stage */
+static ssize_t pool_stats_print_write_latency_acknowledge_count(struct vdo_statistics *stats,
+								char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.acknowledge.count);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.acknowledge.count);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_acknowledge_count = {
+	.attr = { .name = "write_latency_acknowledge_count", .mode = 0444, },
+	.print = pool_stats_print_write_latency_acknowledge_count,
+};
+
+/* Total time spent in this stage, in microseconds */
+static ssize_t pool_stats_print_write_latency_acknowledge_total_microseconds(struct vdo_statistics *stats,
+									     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.acknowledge.total_microseconds);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.acknowledge.total_microseconds);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_acknowledge_total_microseconds = {
+	.attr = { .name = "write_latency_acknowledge_total_microseconds", .mode = 0444, },
+	.print = pool_stats_print_write_latency_acknowledge_total_microseconds,
+};
+
+/* Number of times the stage took less than 10 microseconds */
+static ssize_t pool_stats_print_write_latency_acknowledge_under_10us(struct vdo_statistics *stats,
+								     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.acknowledge.under_10us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.acknowledge.under_10us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_acknowledge_under_10us = {
+	.attr = { .name = "write_latency_acknowledge_under_10us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_acknowledge_under_10us,
+};
+
+/* Number of times the stage took 10 to 100 microseconds */
+static ssize_t pool_stats_print_write_latency_acknowledge_under_100us(struct vdo_statistics *stats,
+								      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.acknowledge.under_100us);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.acknowledge.under_100us);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_acknowledge_under_100us = {
+	.attr = { .name = "write_latency_acknowledge_under_100us", .mode = 0444, },
+	.print = pool_stats_print_write_latency_acknowledge_under_100us,
+};
+
+/* Number of times the stage took 100 microseconds to 1 millisecond */
+static ssize_t pool_stats_print_write_latency_acknowledge_under_1ms(struct vdo_statistics *stats,
+								    char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.acknowledge.under_1ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.acknowledge.under_1ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_acknowledge_under_1ms = {
+	.attr = { .name = "write_latency_acknowledge_under_1ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_acknowledge_under_1ms,
+};
+
+/* Number of times the stage took 1 to 10 milliseconds */
+static ssize_t pool_stats_print_write_latency_acknowledge_under_10ms(struct vdo_statistics *stats,
+								     char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.acknowledge.under_10ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.acknowledge.under_10ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_acknowledge_under_10ms = {
+	.attr = { .name = "write_latency_acknowledge_under_10ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_acknowledge_under_10ms,
+};
+
+/* Number of times the stage took 10 to 100 milliseconds */
+static ssize_t pool_stats_print_write_latency_acknowledge_under_100ms(struct vdo_statistics *stats,
+								      char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.acknowledge.under_100ms);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.acknowledge.under_100ms);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_acknowledge_under_100ms = {
+	.attr = { .name = "write_latency_acknowledge_under_100ms", .mode = 0444, },
+	.print = pool_stats_print_write_latency_acknowledge_under_100ms,
+};
+
+/* Number of times the stage took 100 milliseconds to 1 second */
+static ssize_t pool_stats_print_write_latency_acknowledge_under_1s(struct vdo_statistics *stats,
+								   char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.acknowledge.under_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.acknowledge.under_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_acknowledge_under_1s = {
+	.attr = { .name = "write_latency_acknowledge_under_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_acknowledge_under_1s,
+};
+
+/* Number of times the stage took 1 second or more */
+static ssize_t pool_stats_print_write_latency_acknowledge_over_1s(struct vdo_statistics *stats,
+								  char *buf)
+{
+	#ifdef __KERNEL__
+	return sprintf(buf, "%llu\n", stats->write_latency.acknowledge.over_1s);
+	#else
+	return sprintf(buf, "%lu\n", stats->write_latency.acknowledge.over_1s);
+	#endif // __KERNEL__
+}
+
+static struct pool_stats_attribute pool_stats_attr_write_latency_acknowledge_over_1s = {
+	.attr = { .name = "write_latency_acknowledge_over_1s", .mode = 0444, },
+	.print = pool_stats_print_write_latency_acknowledge_over_1s,
+};
+
 /* Tracked bytes currently allocated. */
 static ssize_t pool_stats_print_memory_usage_bytes_used(struct vdo_statistics *stats,
 							char *buf)
@@ -2514,9 +4443,21 @@ struct attribute *vdo_pool_stats_attrs[] = {
 	&pool_stats_attr_packer_compressed_fragments_written.attr,
 	&pool_stats_attr_packer_compressed_blocks_written.attr,
 	&pool_stats_attr_packer_compressed_fragments_in_packer.attr,
+	&pool_stats_attr_compression_attempts.attr,
+	&pool_stats_attr_compression_failures.attr,
+	&pool_stats_attr_compression_fast_reject_skips.attr,
+	&pool_stats_attr_compression_fast_reject_checks.attr,
+	&pool_stats_attr_compression_fast_reject_mispredictions.attr,
 	&pool_stats_attr_allocator_slab_count.attr,
 	&pool_stats_attr_allocator_slabs_opened.attr,
 	&pool_stats_attr_allocator_slabs_reopened.attr,
+	&pool_stats_attr_allocator_contiguous_allocations.attr,
+	&pool_stats_attr_allocator_fragmented_allocations.attr,
+	&pool_stats_attr_allocator_slabs_to_scrub.attr,
+	&pool_stats_attr_allocator_slabs_scrubbed.attr,
+	&pool_stats_attr_allocator_scrub_seconds_remaining.attr,
+	&pool_stats_attr_allocator_lazy_slabs.attr,
+	&pool_stats_attr_allocator_lazy_slabs_loaded.attr,
 	&pool_stats_attr_journal_disk_full.attr,
 	&pool_stats_attr_journal_slab_journal_commits_requested.attr,
 	&pool_stats_attr_journal_entries_started.attr,
@@ -2525,6 +4466,22 @@ struct attribute *vdo_pool_stats_attrs[] = {
 	&pool_stats_attr_journal_blocks_started.attr,
 	&pool_stats_attr_journal_blocks_written.attr,
 	&pool_stats_attr_journal_blocks_committed.attr,
+	&pool_stats_attr_journal_multi_block_writes.attr,
+	&pool_stats_attr_journal_delayed_commits.attr,
+	&pool_stats_attr_journal_commit_size_one_entry.attr,
+	&pool_stats_attr_journal_commit_size_under_16.attr,
+	&pool_stats_attr_journal_commit_size_under_64.attr,
+	&pool_stats_attr_journal_commit_size_one_block.attr,
+	&pool_stats_attr_journal_commit_size_multiple_blocks.attr,
+	&pool_stats_attr_journal_commit_latency_count.attr,
+	&pool_stats_attr_journal_commit_latency_total_microseconds.attr,
+	&pool_stats_attr_journal_commit_latency_under_10us.attr,
+	&pool_stats_attr_journal_commit_latency_under_100us.attr,
+	&pool_stats_attr_journal_commit_latency_under_1ms.attr,
+	&pool_stats_attr_journal_commit_latency_under_10ms.attr,
+	&pool_stats_attr_journal_commit_latency_under_100ms.attr,
+	&pool_stats_attr_journal_commit_latency_under_1s.attr,
+	&pool_stats_attr_journal_commit_latency_over_1s.attr,
 	&pool_stats_attr_slab_journal_disk_full_count.attr,
 	&pool_stats_attr_slab_journal_flush_count.attr,
 	&pool_stats_attr_slab_journal_blocked_count.attr,
@@ -2552,11 +4509,23 @@ struct attribute *vdo_pool_stats_attrs[] = {
 	&pool_stats_attr_block_map_pages_loaded.attr,
 	&pool_stats_attr_block_map_pages_saved.attr,
 	&pool_stats_attr_block_map_flush_count.attr,
+	&pool_stats_attr_block_map_ghost_hits.attr,
+	&pool_stats_attr_block_map_readahead_pages.attr,
+	&pool_stats_attr_block_map_readahead_used.attr,
+	&pool_stats_attr_block_map_readahead_wasted.attr,
+	&pool_stats_attr_block_map_writes_issued.attr,
+	&pool_stats_attr_block_map_warmup_pages.attr,
+	&pool_stats_attr_block_map_tier_pages_read.attr,
+	&pool_stats_attr_block_map_tier_pages_written.attr,
+	&pool_stats_attr_block_map_tier_pages_rejected.attr,
 	&pool_stats_attr_hash_lock_dedupe_advice_valid.attr,
 	&pool_stats_attr_hash_lock_dedupe_advice_stale.attr,
 	&pool_stats_attr_hash_lock_concurrent_data_matches.attr,
 	&pool_stats_attr_hash_lock_concurrent_hash_collisions.attr,
 	&pool_stats_attr_hash_lock_curr_dedupe_queries.attr,
+	&pool_stats_attr_hash_lock_lock_requests.attr,
+	&pool_stats_attr_hash_lock_max_zone_lock_requests.attr,
+	&pool_stats_attr_hash_lock_min_zone_lock_requests.attr,
 	&pool_stats_attr_errors_invalid_advice_pbn_count.attr,
 	&pool_stats_attr_errors_no_space_error_count.attr,
 	&pool_stats_attr_errors_read_only_error_count.attr,
@@ -2644,6 +4613,87 @@ struct attribute *vdo_pool_stats_attrs[] = {
 	&pool_stats_attr_bios_in_progress_discard.attr,
 	&pool_stats_attr_bios_in_progress_flush.attr,
 	&pool_stats_attr_bios_in_progress_fua.attr,
+	&pool_stats_attr_write_latency_launch_count.attr,
+	&pool_stats_attr_write_latency_launch_total_microseconds.attr,
+	&pool_stats_attr_write_latency_launch_under_10us.attr,
+	&pool_stats_attr_write_latency_launch_under_100us.attr,
+	&pool_stats_attr_write_latency_launch_under_1ms.attr,
+	&pool_stats_attr_write_latency_launch_under_10ms.attr,
+	&pool_stats_attr_write_latency_launch_under_100ms.attr,
+	&pool_stats_attr_write_latency_launch_under_1s.attr,
+	&pool_stats_attr_write_latency_launch_over_1s.attr,
+	&pool_stats_attr_write_latency_hash_count.attr,
+	&pool_stats_attr_write_latency_hash_total_microseconds.attr,
+	&pool_stats_attr_write_latency_hash_under_10us.attr,
+	&pool_stats_attr_write_latency_hash_under_100us.attr,
+	&pool_stats_attr_write_latency_hash_under_1ms.attr,
+	&pool_stats_attr_write_latency_hash_under_10ms.attr,
+	&pool_stats_attr_write_latency_hash_under_100ms.attr,
+	&pool_stats_attr_write_latency_hash_under_1s.attr,
+	&pool_stats_attr_write_latency_hash_over_1s.attr,
+	&pool_stats_attr_write_latency_hash_lock_count.attr,
+	&pool_stats_attr_write_latency_hash_lock_total_microseconds.attr,
+	&pool_stats_attr_write_latency_hash_lock_under_10us.attr,
+	&pool_stats_attr_write_latency_hash_lock_under_100us.attr,
+	&pool_stats_attr_write_latency_hash_lock_under_1ms.attr,
+	&pool_stats_attr_write_latency_hash_lock_under_10ms.attr,
+	&pool_stats_attr_write_latency_hash_lock_under_100ms.attr,
+	&pool_stats_attr_write_latency_hash_lock_under_1s.attr,
+	&pool_stats_attr_write_latency_hash_lock_over_1s.attr,
+	&pool_stats_attr_write_latency_dedupe_query_count.attr,
+	&pool_stats_attr_write_latency_dedupe_query_total_microseconds.attr,
+	&pool_stats_attr_write_latency_dedupe_query_under_10us.attr,
+	&pool_stats_attr_write_latency_dedupe_query_under_100us.attr,
+	&pool_stats_attr_write_latency_dedupe_query_under_1ms.attr,
+	&pool_stats_attr_write_latency_dedupe_query_under_10ms.attr,
+	&pool_stats_attr_write_latency_dedupe_query_under_100ms.attr,
+	&pool_stats_attr_write_latency_dedupe_query_under_1s.attr,
+	&pool_stats_attr_write_latency_dedupe_query_over_1s.attr,
+	&pool_stats_attr_write_latency_allocation_count.attr,
+	&pool_stats_attr_write_latency_allocation_total_microseconds.attr,
+	&pool_stats_attr_write_latency_allocation_under_10us.attr,
+	&pool_stats_attr_write_latency_allocation_under_100us.attr,
+	&pool_stats_attr_write_latency_allocation_under_1ms.attr,
+	&pool_stats_attr_write_latency_allocation_under_10ms.attr,
+	&pool_stats_attr_write_latency_allocation_under_100ms.attr,
+	&pool_stats_attr_write_latency_allocation_under_1s.attr,
+	&pool_stats_attr_write_latency_allocation_over_1s.attr,
+	&pool_stats_attr_write_latency_data_write_count.attr,
+	&pool_stats_attr_write_latency_data_write_total_microseconds.attr,
+	&pool_stats_attr_write_latency_data_write_under_10us.attr,
+	&pool_stats_attr_write_latency_data_write_under_100us.attr,
+	&pool_stats_attr_write_latency_data_write_under_1ms.attr,
+	&pool_stats_attr_write_latency_data_write_under_10ms.attr,
+	&pool_stats_attr_write_latency_data_write_under_100ms.attr,
+	&pool_stats_attr_write_latency_data_write_under_1s.attr,
+	&pool_stats_attr_write_latency_data_write_over_1s.attr,
+	&pool_stats_attr_write_latency_journal_count.attr,
+	&pool_stats_attr_write_latency_journal_total_microseconds.attr,
+	&pool_stats_attr_write_latency_journal_under_10us.attr,
+	&pool_stats_attr_write_latency_journal_under_100us.attr,
+	&pool_stats_attr_write_latency_journal_under_1ms.attr,
+	&pool_stats_attr_write_latency_journal_under_10ms.attr,
+	&pool_stats_attr_write_latency_journal_under_100ms.attr,
+	&pool_stats_attr_write_latency_journal_under_1s.attr,
+	&pool_stats_attr_write_latency_journal_over_1s.attr,
+	&pool_stats_attr_write_latency_block_map_count.attr,
+	&pool_stats_attr_write_latency_block_map_total_microseconds.attr,
+	&pool_stats_attr_write_latency_block_map_under_10us.attr,
+	&pool_stats_attr_write_latency_block_map_under_100us.attr,
+	&pool_stats_attr_write_latency_block_map_under_1ms.attr,
+	&pool_stats_attr_write_latency_block_map_under_10ms.attr,
+	&pool_stats_attr_write_latency_block_map_under_100ms.attr,
+	&pool_stats_attr_write_latency_block_map_under_1s.attr,
+	&pool_stats_attr_write_latency_block_map_over_1s.attr,
+	&pool_stats_attr_write_latency_acknowledge_count.attr,
+	&pool_stats_attr_write_latency_acknowledge_total_microseconds.attr,
+	&pool_stats_attr_write_latency_acknowledge_under_10us.attr,
+	&pool_stats_attr_write_latency_acknowledge_under_100us.attr,
+	&pool_stats_attr_write_latency_acknowledge_under_1ms.attr,
+	&pool_stats_attr_write_latency_acknowledge_under_10ms.attr,
+	&pool_stats_attr_write_latency_acknowledge_under_100ms.attr,
+	&pool_stats_attr_write_latency_acknowledge_under_1s.attr,
+	&pool_stats_attr_write_latency_acknowledge_over_1s.attr,
 	&pool_stats_attr_memory_usage_bytes_used.attr,
 	&pool_stats_attr_memory_usage_peak_bytes_used.attr,
 	&pool_stats_attr_index_entries_indexed.attr,
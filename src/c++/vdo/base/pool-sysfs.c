@@ -12,6 +12,7 @@
 
 #include "data-vio.h"
 #include "dedupe.h"
+#include "funnel-workqueue.h"
 #include "vdo.h"
 
 struct pool_attribute {
@@ -91,6 +92,18 @@ static ssize_t pool_instance_show(struct vdo *vdo, char *buf)
 	return sprintf(buf, "%u\n", vdo->instance);
 }
 
+static ssize_t pool_rebuild_pages_done_show(struct vdo *vdo, char *buf)
+{
+	return sprintf(buf, "%llu\n",
+		       (unsigned long long) atomic64_read(&vdo->stats.rebuild_pages_done));
+}
+
+static ssize_t pool_rebuild_pages_total_show(struct vdo *vdo, char *buf)
+{
+	return sprintf(buf, "%llu\n",
+		       (unsigned long long) atomic64_read(&vdo->stats.rebuild_pages_total));
+}
+
 static ssize_t pool_requests_active_show(struct vdo *vdo, char *buf)
 {
 	return sprintf(buf, "%u\n",
@@ -108,6 +121,49 @@ static ssize_t pool_requests_maximum_show(struct vdo *vdo, char *buf)
 		       get_data_vio_pool_maximum_requests(vdo->data_vio_pool));
 }
 
+static struct vdo_work_queue_statistics get_work_queue_statistics(struct vdo *vdo)
+{
+	struct vdo_work_queue_statistics stats = { 0 };
+	thread_id_t id;
+
+	for (id = 0; id < vdo->thread_config.thread_count; id++) {
+		if (vdo->threads[id].queue != NULL)
+			vdo_add_work_queue_statistics(vdo->threads[id].queue, &stats);
+	}
+
+	return stats;
+}
+
+static ssize_t pool_work_queue_batches_show(struct vdo *vdo, char *buf)
+{
+	return sprintf(buf, "%llu\n",
+		       (unsigned long long) get_work_queue_statistics(vdo).batches);
+}
+
+static ssize_t pool_work_queue_completions_show(struct vdo *vdo, char *buf)
+{
+	return sprintf(buf, "%llu\n",
+		       (unsigned long long) get_work_queue_statistics(vdo).completions);
+}
+
+static ssize_t pool_work_queue_spin_hits_show(struct vdo *vdo, char *buf)
+{
+	return sprintf(buf, "%llu\n",
+		       (unsigned long long) get_work_queue_statistics(vdo).spin_hits);
+}
+
+static ssize_t pool_work_queue_spins_show(struct vdo *vdo, char *buf)
+{
+	return sprintf(buf, "%llu\n",
+		       (unsigned long long) get_work_queue_statistics(vdo).spins);
+}
+
+static ssize_t pool_work_queue_wakeups_show(struct vdo *vdo, char *buf)
+{
+	return sprintf(buf, "%llu\n",
+		       (unsigned long long) get_work_queue_statistics(vdo).wakeups);
+}
+
 static void vdo_pool_release(struct kobject *directory)
 {
 	vdo_free(container_of(directory, struct vdo, vdo_directory));
@@ -154,6 +210,22 @@ static struct pool_attribute vdo_pool_instance_attr = {
 	.show = pool_instance_show,
 };
 
+static struct pool_attribute vdo_pool_rebuild_pages_done_attr = {
+	.attr = {
+			.name = "rebuild_pages_done",
+			.mode = 0444,
+		},
+	.show = pool_rebuild_pages_done_show,
+};
+
+static struct pool_attribute vdo_pool_rebuild_pages_total_attr = {
+	.attr = {
+			.name = "rebuild_pages_total",
+			.mode = 0444,
+		},
+	.show = pool_rebuild_pages_total_show,
+};
+
 static struct pool_attribute vdo_pool_requests_active_attr = {
 	.attr = {
 			.name = "requests_active",
@@ -178,15 +250,62 @@ static struct pool_attribute vdo_pool_requests_maximum_attr = {
 	.show = pool_requests_maximum_show,
 };
 
+static struct pool_attribute vdo_pool_work_queue_batches_attr = {
+	.attr = {
+			.name = "work_queue_batches",
+			.mode = 0444,
+		},
+	.show = pool_work_queue_batches_show,
+};
+
+static struct pool_attribute vdo_pool_work_queue_completions_attr = {
+	.attr = {
+			.name = "work_queue_completions",
+			.mode = 0444,
+		},
+	.show = pool_work_queue_completions_show,
+};
+
+static struct pool_attribute vdo_pool_work_queue_spin_hits_attr = {
+	.attr = {
+			.name = "work_queue_spin_hits",
+			.mode = 0444,
+		},
+	.show = pool_work_queue_spin_hits_show,
+};
+
+static struct pool_attribute vdo_pool_work_queue_spins_attr = {
+	.attr = {
+			.name = "work_queue_spins",
+			.mode = 0444,
+		},
+	.show = pool_work_queue_spins_show,
+};
+
+static struct pool_attribute vdo_pool_work_queue_wakeups_attr = {
+	.attr = {
+			.name = "work_queue_wakeups",
+			.mode = 0444,
+		},
+	.show = pool_work_queue_wakeups_show,
+};
+
 static struct attribute *pool_attrs[] = {
 	&vdo_pool_compressing_attr.attr,
 	&vdo_pool_discards_active_attr.attr,
 	&vdo_pool_discards_limit_attr.attr,
 	&vdo_pool_discards_maximum_attr.attr,
 	&vdo_pool_instance_attr.attr,
+	&vdo_pool_rebuild_pages_done_attr.attr,
+	&vdo_pool_rebuild_pages_total_attr.attr,
 	&vdo_pool_requests_active_attr.attr,
 	&vdo_pool_requests_limit_attr.attr,
 	&vdo_pool_requests_maximum_attr.attr,
+	&vdo_pool_work_queue_batches_attr.attr,
+	&vdo_pool_work_queue_completions_attr.attr,
+	&vdo_pool_work_queue_spin_hits_attr.attr,
+	&vdo_pool_work_queue_spins_attr.attr,
+	&vdo_pool_work_queue_wakeups_attr.attr,
 	NULL,
 };
 ATTRIBUTE_GROUPS(pool);
@@ -7,10 +7,14 @@
 
 #include <linux/atomic.h>
 #include <linux/bio.h>
+#include <linux/jiffies.h>
+#include <linux/minmax.h>
+#include <linux/timer.h>
 
 #include "logger.h"
 #include "memory-alloc.h"
 #include "permassert.h"
+#include "time-utils.h"
 
 #include "block-map.h"
 #include "completion.h"
@@ -34,6 +38,12 @@ static const u64 RECOVERY_COUNT_MASK = 0xff;
 #define RECOVERY_JOURNAL_RESERVED_BLOCKS				\
 	((MAXIMUM_VDO_USER_VIOS / RECOVERY_JOURNAL_ENTRIES_PER_BLOCK) + 2)
 
+enum commit_timer_state {
+	COMMIT_TIMER_IDLE,
+	COMMIT_TIMER_RUNNING,
+	COMMIT_TIMER_FIRED,
+};
+
 /**
  * DOC: Lock Counters.
  *
@@ -347,8 +357,19 @@ static void check_for_drain_complete(struct recovery_journal *journal)
 	if (!vdo_is_state_draining(&journal->state) ||
 	    journal->reaping ||
 	    has_block_waiters(journal) ||
-	    vdo_waitq_has_waiters(&journal->entry_waiters) ||
-	    !suspend_lock_counter(&journal->lock_counter))
+	    vdo_waitq_has_waiters(&journal->entry_waiters))
+		return;
+
+	if ((atomic_read(&journal->commit_timer_state) == COMMIT_TIMER_IDLE) ||
+	    (atomic_cmpxchg(&journal->commit_timer_state, COMMIT_TIMER_RUNNING,
+			    COMMIT_TIMER_IDLE) == COMMIT_TIMER_RUNNING)) {
+		del_timer_sync(&journal->commit_timer);
+	} else {
+		/* The timer has fired, and its completion must run before the drain can finish. */
+		return;
+	}
+
+	if (!suspend_lock_counter(&journal->lock_counter))
 		return;
 
 	if (vdo_is_state_saving(&journal->state)) {
@@ -452,6 +473,9 @@ static void check_slab_journal_commit_threshold(struct recovery_journal *journal
 
 static void reap_recovery_journal(struct recovery_journal *journal);
 static void assign_entries(struct recovery_journal *journal);
+static void write_blocks(struct recovery_journal *journal);
+static void write_delayed_commit(struct vdo_completion *completion);
+static void expire_commit_delay(struct timer_list *timer);
 
 /**
  * finish_reaping() - Finish reaping the journal.
@@ -686,6 +710,36 @@ static int initialize_recovery_block(struct vdo *vdo, struct recovery_journal *j
 	return VDO_SUCCESS;
 }
 
+/**
+ * make_group_vio() - Make the vio for writing several adjacent journal blocks at once.
+ * @vdo: The vdo from which to construct the vio.
+ * @journal: The journal which will use the vio.
+ *
+ * Return: VDO_SUCCESS or an error.
+ */
+static int make_group_vio(struct vdo *vdo, struct recovery_journal *journal)
+{
+	char *data;
+	int result;
+
+	result = vdo_allocate(RECOVERY_JOURNAL_RESERVED_BLOCKS * VDO_BLOCK_SIZE, char, __func__,
+			      &data);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	result = create_multi_block_metadata_vio(vdo, VIO_TYPE_RECOVERY_JOURNAL,
+						 VIO_PRIORITY_HIGH, journal,
+						 RECOVERY_JOURNAL_RESERVED_BLOCKS, data,
+						 &journal->group_vio);
+	if (result != VDO_SUCCESS) {
+		vdo_free(data);
+		return result;
+	}
+
+	journal->group_vio->completion.callback_thread_id = journal->thread_id;
+	return VDO_SUCCESS;
+}
+
 /**
  * vdo_decode_recovery_journal() - Make a recovery journal and initialize it with the state that
  *                                 was decoded from the super block.
@@ -729,6 +783,18 @@ int vdo_decode_recovery_journal(struct recovery_journal_state_7_0 state, nonce_t
 	journal->logical_blocks_used = state.logical_blocks_used;
 	journal->block_map_data_blocks = state.block_map_data_blocks;
 	journal->entries_per_block = RECOVERY_JOURNAL_ENTRIES_PER_BLOCK;
+	journal->group_commit = vdo->device_config->journal_group_commit;
+	if (vdo->device_config->journal_commit_delay > 0) {
+		journal->commit_delay =
+			max_t(u64, usecs_to_jiffies(vdo->device_config->journal_commit_delay), 1);
+	}
+
+	atomic_set(&journal->commit_timer_state, COMMIT_TIMER_IDLE);
+	timer_setup(&journal->commit_timer, expire_commit_delay, 0);
+	vdo_initialize_completion(&journal->commit_completion, vdo,
+				  VDO_RECOVERY_JOURNAL_COMPLETION);
+	vdo_set_completion_callback(&journal->commit_completion, write_delayed_commit,
+				    journal->thread_id);
 	set_journal_tail(journal, state.journal_start);
 	initialize_journal_state(journal);
 	/* TODO: this will have to change if we make initial resume of a VDO a real resume */
@@ -757,6 +823,14 @@ int vdo_decode_recovery_journal(struct recovery_journal_state_7_0 state, nonce_t
 		return result;
 	}
 
+	if (journal->group_commit) {
+		result = make_group_vio(vdo, journal);
+		if (result != VDO_SUCCESS) {
+			vdo_free_recovery_journal(journal);
+			return result;
+		}
+	}
+
 	result = vdo_register_read_only_listener(vdo, journal,
 						 notify_recovery_journal_of_read_only_mode,
 						 journal->thread_id);
@@ -787,6 +861,8 @@ void vdo_free_recovery_journal(struct recovery_journal *journal)
 	if (journal == NULL)
 		return;
 
+	/* A journal which was never drained, such as one which failed to load, may have a timer. */
+	del_timer_sync(&journal->commit_timer);
 	vdo_free(vdo_forget(journal->lock_counter.logical_zone_counts));
 	vdo_free(vdo_forget(journal->lock_counter.physical_zone_counts));
 	vdo_free(vdo_forget(journal->lock_counter.journal_counters));
@@ -794,6 +870,10 @@ void vdo_free_recovery_journal(struct recovery_journal *journal)
 	vdo_free(vdo_forget(journal->lock_counter.logical_counters));
 	vdo_free(vdo_forget(journal->lock_counter.physical_counters));
 	free_vio(vdo_forget(journal->flush_vio));
+	if (journal->group_vio != NULL) {
+		vdo_free(vdo_forget(journal->group_vio->data));
+		free_vio(vdo_forget(journal->group_vio));
+	}
 
 	/*
 	 * FIXME: eventually, the journal should be constructed in a quiescent state which
@@ -1029,8 +1109,6 @@ static bool prepare_to_assign_entry(struct recovery_journal *journal)
 	return true;
 }
 
-static void write_blocks(struct recovery_journal *journal);
-
 /**
  * schedule_block_write() - Queue a block for writing.
  * @journal: The journal in question.
@@ -1184,7 +1262,7 @@ static void continue_committed_waiter(struct vdo_waiter *waiter, void *context)
 			    data_vio->recovery_journal_point.entry_count);
 
 	journal->commit_point = data_vio->recovery_journal_point;
-	data_vio->last_async_operation = VIO_ASYNC_OP_UPDATE_REFERENCE_COUNTS;
+	set_data_vio_async_operation(data_vio, VIO_ASYNC_OP_UPDATE_REFERENCE_COUNTS);
 	if (result != VDO_SUCCESS) {
 		continue_data_vio_with_error(data_vio, result);
 		return;
@@ -1255,19 +1333,38 @@ static void recycle_journal_blocks(struct recovery_journal *journal)
 }
 
 /**
- * complete_write() - Handle post-commit processing.
- * @completion: The completion of the VIO writing this block.
- *
- * This is the callback registered by write_block(). If more entries accumulated in the block being
- * committed while the commit was in progress, another commit will be initiated.
+ * record_commit() - Update the commit size and latency histograms for a completed commit.
+ * @journal: The journal.
+ * @entries: The number of new entries in the commit.
+ * @start: The time at which the commit was issued.
  */
-static void complete_write(struct vdo_completion *completion)
+static void record_commit(struct recovery_journal *journal, u64 entries, u64 start)
 {
-	struct recovery_journal_block *block = completion->parent;
-	struct recovery_journal *journal = block->journal;
-	struct recovery_journal_block *last_active_block;
+	struct commit_size_statistics *size = &journal->events.commit_size;
+	u64 microseconds = (current_time_ns(CLOCK_MONOTONIC) - start) / NSEC_PER_USEC;
 
-	assert_on_journal_thread(journal, __func__);
+	if (entries == 1)
+		size->one_entry++;
+	else if (entries < 16)
+		size->under_16++;
+	else if (entries < 64)
+		size->under_64++;
+	else if (entries <= journal->entries_per_block)
+		size->one_block++;
+	else
+		size->multiple_blocks++;
+
+	vdo_record_stage_latency(&journal->events.commit_latency, microseconds);
+}
+
+/**
+ * finish_block_write() - Update a block and the journal now that a write of the block has
+ *                        completed.
+ * @block: The block which was written.
+ */
+static void finish_block_write(struct recovery_journal_block *block)
+{
+	struct recovery_journal *journal = block->journal;
 
 	journal->pending_write_count -= 1;
 	journal->events.blocks.committed += 1;
@@ -1279,19 +1376,37 @@ static void complete_write(struct vdo_completion *completion)
 	/* If this block is the latest block to be acknowledged, record that fact. */
 	if (block->sequence_number > journal->last_write_acknowledged)
 		journal->last_write_acknowledged = block->sequence_number;
+}
+
+/**
+ * finish_commit() - Release the waiters on a completed commit and start the next one.
+ * @journal: The journal.
+ * @first: The first block written by the commit.
+ * @count: The number of adjacent blocks written by the commit.
+ */
+static void finish_commit(struct recovery_journal *journal,
+			  struct recovery_journal_block *first, block_count_t count)
+{
+	struct recovery_journal_block *last_active_block;
+	struct recovery_journal_block *block = first;
+	block_count_t i;
 
 	last_active_block = get_journal_block(&journal->active_tail_blocks);
-	VDO_ASSERT_LOG_ONLY((block->sequence_number >= last_active_block->sequence_number),
+	VDO_ASSERT_LOG_ONLY((first->sequence_number >= last_active_block->sequence_number),
 			    "completed journal write is still active");
 
 	notify_commit_waiters(journal);
 
 	/*
-	 * Is this block now full? Reaping, and adding entries, might have already sent it off for
-	 * rewriting; else, queue it for rewrite.
+	 * Are any of these blocks now full? Reaping, and adding entries, might have already sent
+	 * them off for rewriting; else, queue them for rewrite.
 	 */
-	if (is_block_dirty(block) && is_block_full(block))
-		schedule_block_write(journal, block);
+	for (i = 0; i < count; i++) {
+		if (is_block_dirty(block) && is_block_full(block))
+			schedule_block_write(journal, block);
+
+		block = list_next_entry(block, list_node);
+	}
 
 	recycle_journal_blocks(journal);
 	write_blocks(journal);
@@ -1299,6 +1414,24 @@ static void complete_write(struct vdo_completion *completion)
 	check_for_drain_complete(journal);
 }
 
+/**
+ * complete_write() - Handle post-commit processing.
+ * @completion: The completion of the VIO writing this block.
+ *
+ * This is the callback registered by write_block(). If more entries accumulated in the block being
+ * committed while the commit was in progress, another commit will be initiated.
+ */
+static void complete_write(struct vdo_completion *completion)
+{
+	struct recovery_journal_block *block = completion->parent;
+	struct recovery_journal *journal = block->journal;
+
+	assert_on_journal_thread(journal, __func__);
+	record_commit(journal, block->entries_in_commit, block->commit_start);
+	finish_block_write(block);
+	finish_commit(journal, block, 1);
+}
+
 static void handle_write_error(struct vdo_completion *completion)
 {
 	struct recovery_journal_block *block = completion->parent;
@@ -1321,6 +1454,53 @@ static void complete_write_endio(struct bio *bio)
 	continue_vio_after_io(vio, complete_write, journal->thread_id);
 }
 
+/**
+ * complete_group_write() - Handle post-commit processing for a write of several blocks.
+ * @completion: The completion of the journal's group vio.
+ *
+ * This is the callback registered by write_block_group().
+ */
+static void complete_group_write(struct vdo_completion *completion)
+{
+	struct recovery_journal *journal = completion->parent;
+	struct recovery_journal_block *block = journal->group_head;
+	u64 start = block->commit_start;
+	u64 entries = 0;
+	block_count_t i;
+
+	assert_on_journal_thread(journal, __func__);
+	for (i = 0; i < journal->group_size; i++) {
+		entries += block->entries_in_commit;
+		finish_block_write(block);
+		block = list_next_entry(block, list_node);
+	}
+
+	record_commit(journal, entries, start);
+	finish_commit(journal, journal->group_head, journal->group_size);
+}
+
+static void handle_group_write_error(struct vdo_completion *completion)
+{
+	struct recovery_journal *journal = completion->parent;
+
+	vio_record_metadata_io_error(as_vio(completion));
+	vdo_log_error_strerror(completion->result,
+			       "cannot write recovery journal blocks %llu through %llu",
+			       (unsigned long long) journal->group_head->sequence_number,
+			       (unsigned long long) (journal->group_head->sequence_number +
+						     journal->group_size - 1));
+	enter_journal_read_only_mode(journal, completion->result);
+	complete_group_write(completion);
+}
+
+static void complete_group_write_endio(struct bio *bio)
+{
+	struct vio *vio = bio->bi_private;
+	struct recovery_journal *journal = vio->completion.parent;
+
+	continue_vio_after_io(vio, complete_group_write, journal->thread_id);
+}
+
 /**
  * add_queued_recovery_entries() - Actually add entries from the queue to the given block.
  * @block: The journal block.
@@ -1361,20 +1541,19 @@ static void add_queued_recovery_entries(struct recovery_journal_block *block)
 }
 
 /**
- * write_block() - Issue a block for writing.
+ * prepare_block_for_write() - Add a block's queued entries to it and mark it as committing.
+ * @block: The block to write.
  *
- * Implements waiter_callback_fn.
+ * Return: true if the block has new entries and should be written.
  */
-static void write_block(struct vdo_waiter *waiter, void __always_unused *context)
+static bool prepare_block_for_write(struct recovery_journal_block *block)
 {
-	struct recovery_journal_block *block =
-		container_of(waiter, struct recovery_journal_block, write_waiter);
 	struct recovery_journal *journal = block->journal;
 	struct packed_journal_header *header = get_block_header(block);
 
 	if (block->committing || !vdo_waitq_has_waiters(&block->entry_waiters) ||
 	    is_read_only(journal))
-		return;
+		return false;
 
 	block->entries_in_commit = vdo_waitq_num_waiters(&block->entry_waiters);
 	add_queued_recovery_entries(block);
@@ -1388,17 +1567,138 @@ static void write_block(struct vdo_waiter *waiter, void __always_unused *context
 	header->entry_count = __cpu_to_le16(block->entry_count);
 
 	block->committing = true;
+	block->commit_start = current_time_ns(CLOCK_MONOTONIC);
+	return true;
+}
 
-	/*
-	 * We must issue a flush and a FUA for every commit. The flush is necessary to ensure that
-	 * the data being referenced is stable. The FUA is necessary to ensure that the journal
-	 * block itself is stable before allowing overwrites of the lbn's previous data.
-	 */
-	vdo_submit_metadata_vio(&block->vio, journal->origin + block->block_number,
+/*
+ * We must issue a flush and a FUA for every commit. The flush is necessary to ensure that the
+ * data being referenced is stable. The FUA is necessary to ensure that the journal block itself is
+ * stable before allowing overwrites of the lbn's previous data.
+ */
+#define JOURNAL_COMMIT_OPERATION (REQ_OP_WRITE | REQ_PRIO | REQ_PREFLUSH | REQ_SYNC | REQ_FUA)
+
+/**
+ * write_block() - Issue a block for writing.
+ *
+ * Implements waiter_callback_fn.
+ */
+static void write_block(struct vdo_waiter *waiter, void __always_unused *context)
+{
+	struct recovery_journal_block *block =
+		container_of(waiter, struct recovery_journal_block, write_waiter);
+
+	if (!prepare_block_for_write(block))
+		return;
+
+	vdo_submit_metadata_vio(&block->vio, block->journal->origin + block->block_number,
 				complete_write_endio, handle_write_error,
-				REQ_OP_WRITE | REQ_PRIO | REQ_PREFLUSH | REQ_SYNC | REQ_FUA);
+				JOURNAL_COMMIT_OPERATION);
 }
 
+/**
+ * is_next_block() - Check whether a block immediately follows another, both in the journal and
+ *                   on disk.
+ * @previous: The earlier block.
+ * @block: The block which may follow it.
+ *
+ * Return: true if the two blocks may be written together.
+ */
+static bool is_next_block(const struct recovery_journal_block *previous,
+			  const struct recovery_journal_block *block)
+{
+	return ((block->sequence_number == previous->sequence_number + 1) &&
+		(block->block_number == previous->block_number + 1));
+}
+
+/**
+ * write_block_group() - Write the first run of pending blocks which are adjacent on disk, along
+ *                       with the active block if it follows them, as a single commit.
+ * @journal: The recovery journal.
+ *
+ * Blocks which do not follow the run remain queued. A group of one block is written with that
+ * block's own vio.
+ */
+static void write_block_group(struct recovery_journal *journal)
+{
+	struct recovery_journal_block *first = NULL, *last = NULL, *block;
+	block_count_t count = 0;
+	struct vdo_waiter *waiter;
+	block_count_t i;
+
+	while ((waiter = vdo_waitq_get_first_waiter(&journal->pending_writes)) != NULL) {
+		block = container_of(waiter, struct recovery_journal_block, write_waiter);
+		if ((last != NULL) && !is_next_block(last, block))
+			break;
+
+		vdo_waitq_dequeue_waiter(&journal->pending_writes);
+		if (!prepare_block_for_write(block))
+			continue;
+
+		if (first == NULL)
+			first = block;
+		last = block;
+		count++;
+	}
+
+	if (count == 0)
+		return;
+
+	/* The active block can share the commit, even though it isn't full. */
+	block = journal->active_block;
+	if ((block != NULL) && is_next_block(last, block) && prepare_block_for_write(block))
+		count++;
+
+	if (count == 1) {
+		vdo_submit_metadata_vio(&first->vio, journal->origin + first->block_number,
+					complete_write_endio, handle_write_error,
+					JOURNAL_COMMIT_OPERATION);
+		return;
+	}
+
+	block = first;
+	for (i = 0; i < count; i++) {
+		memcpy(journal->group_vio->data + (i * VDO_BLOCK_SIZE), block->vio.data,
+		       VDO_BLOCK_SIZE);
+		block = list_next_entry(block, list_node);
+	}
+
+	journal->group_head = first;
+	journal->group_size = count;
+	journal->events.multi_block_writes++;
+	vdo_submit_metadata_vio_with_size(journal->group_vio,
+					  journal->origin + first->block_number,
+					  complete_group_write_endio, handle_group_write_error,
+					  JOURNAL_COMMIT_OPERATION, count * VDO_BLOCK_SIZE);
+}
+
+/**
+ * delay_commit() - Check whether to wait for more entries before writing the active block, and
+ *                  start the commit timer if so.
+ * @journal: The recovery journal.
+ *
+ * Return: true if the write of the active block should wait.
+ */
+static bool delay_commit(struct recovery_journal *journal)
+{
+	if ((journal->commit_delay == 0) || !vdo_is_state_normal(&journal->state))
+		return false;
+
+	switch (atomic_cmpxchg(&journal->commit_timer_state, COMMIT_TIMER_IDLE,
+			       COMMIT_TIMER_RUNNING)) {
+	case COMMIT_TIMER_IDLE:
+		journal->events.delayed_commits++;
+		mod_timer(&journal->commit_timer, jiffies + journal->commit_delay);
+		return true;
+
+	case COMMIT_TIMER_RUNNING:
+		return true;
+
+	default:
+		/* The delay has just expired. */
+		return false;
+	}
+}
 
 /**
  * write_blocks() - Attempt to commit blocks, according to write policy.
@@ -1406,11 +1706,14 @@ static void write_block(struct vdo_waiter *waiter, void __always_unused *context
  */
 static void write_blocks(struct recovery_journal *journal)
 {
+	struct recovery_journal_block *active_block;
+
 	assert_on_journal_thread(journal, __func__);
 	/*
 	 * We call this function after adding entries to the journal and after finishing a block
 	 * write. Thus, when this function terminates we must either have no VIOs waiting in the
-	 * journal or have some outstanding IO to provide a future wakeup.
+	 * journal, have some outstanding IO to provide a future wakeup, or have the commit timer
+	 * running.
 	 *
 	 * We want to only issue full blocks if there are no pending writes. However, if there are
 	 * no outstanding writes and some unwritten entries, we must issue a block, even if it's
@@ -1419,15 +1722,53 @@ static void write_blocks(struct recovery_journal *journal)
 	if (journal->pending_write_count > 0)
 		return;
 
-	/* Write all the full blocks. */
+	/* Write all the full blocks, with as many as possible in one commit in group mode. */
+	if (journal->group_commit)
+		write_block_group(journal);
 	vdo_waitq_notify_all_waiters(&journal->pending_writes, write_block, NULL);
 
 	/*
 	 * Do we need to write the active block? Only if we have no outstanding writes, even after
-	 * issuing all of the full writes.
+	 * issuing all of the full writes, and the commit delay, if any, has expired.
 	 */
-	if ((journal->pending_write_count == 0) && (journal->active_block != NULL))
-		write_block(&journal->active_block->write_waiter, NULL);
+	active_block = journal->active_block;
+	if ((journal->pending_write_count > 0) || (active_block == NULL) ||
+	    active_block->committing || !vdo_waitq_has_waiters(&active_block->entry_waiters) ||
+	    is_read_only(journal) || delay_commit(journal))
+		return;
+
+	write_block(&active_block->write_waiter, NULL);
+}
+
+/**
+ * write_delayed_commit() - Write the active block once the commit delay has expired.
+ * @completion: The journal's commit completion.
+ *
+ * This callback is registered in vdo_decode_recovery_journal() and launched by
+ * expire_commit_delay().
+ */
+static void write_delayed_commit(struct vdo_completion *completion)
+{
+	struct recovery_journal *journal =
+		container_of(completion, struct recovery_journal, commit_completion);
+
+	assert_on_journal_thread(journal, __func__);
+	write_blocks(journal);
+	atomic_set(&journal->commit_timer_state, COMMIT_TIMER_IDLE);
+	check_for_drain_complete(journal);
+}
+
+/**
+ * expire_commit_delay() - Launch the journal's commit completion to write the active block.
+ * @timer: The journal's commit timer.
+ */
+static void expire_commit_delay(struct timer_list *timer)
+{
+	struct recovery_journal *journal = from_timer(journal, timer, commit_timer);
+
+	if (atomic_cmpxchg(&journal->commit_timer_state, COMMIT_TIMER_RUNNING,
+			   COMMIT_TIMER_FIRED) == COMMIT_TIMER_RUNNING)
+		vdo_launch_completion(&journal->commit_completion);
 }
 
 /**
@@ -1618,7 +1959,11 @@ void vdo_release_journal_entry_lock(struct recovery_journal *journal,
  */
 static void initiate_drain(struct admin_state *state)
 {
-	check_for_drain_complete(container_of(state, struct recovery_journal, state));
+	struct recovery_journal *journal = container_of(state, struct recovery_journal, state);
+
+	/* Don't wait out the commit delay for a partial block. */
+	write_blocks(journal);
+	check_for_drain_complete(journal);
 }
 
 /**
@@ -7,6 +7,7 @@
 #define VDO_RECOVERY_JOURNAL_H
 
 #include <linux/list.h>
+#include <linux/timer.h>
 
 #include "numeric.h"
 
@@ -81,6 +82,11 @@
  * 'reap_completion', and will be woken the next time a journal block is reaped.
  */
 
+enum {
+	/* The longest commit delay, in microseconds, which may be configured */
+	VDO_MAX_JOURNAL_COMMIT_DELAY = 10000,
+};
+
 enum vdo_zone_type {
 	VDO_ZONE_TYPE_ADMIN,
 	VDO_ZONE_TYPE_JOURNAL,
@@ -136,6 +142,8 @@ struct recovery_journal_block {
 	journal_entry_count_t uncommitted_entry_count;
 	/* The number of new entries in the current commit */
 	journal_entry_count_t entries_in_commit;
+	/* The time at which the current commit was issued */
+	u64 commit_start;
 	/* The queue of vios which will make entries for the next commit */
 	struct vdo_wait_queue entry_waiters;
 	/* The queue of vios waiting for the current commit */
@@ -209,6 +217,22 @@ struct recovery_journal {
 	block_count_t pending_write_count;
 	/* The threshold at which slab journal tail blocks will be written out */
 	block_count_t slab_journal_commit_threshold;
+	/* Whether to write adjacent journal blocks together */
+	bool group_commit;
+	/* The vio for writing several adjacent journal blocks at once */
+	struct vio *group_vio;
+	/* The first block being written by the group vio */
+	struct recovery_journal_block *group_head;
+	/* The number of blocks being written by the group vio */
+	block_count_t group_size;
+	/* The time, in jiffies, to wait for more entries before writing a partial block */
+	u64 commit_delay;
+	/* The timer for writing a partial block whose commit has been delayed */
+	struct timer_list commit_timer;
+	/* The state of the commit timer, a commit_timer_state */
+	atomic_t commit_timer_state;
+	/* The completion for writing a delayed commit on the journal thread */
+	struct vdo_completion commit_completion;
 	/* Counters for events in the journal that are reported as statistics */
 	struct recovery_journal_statistics events;
 	/* The locks for each on-disk block */
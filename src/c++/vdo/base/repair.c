@@ -5,11 +5,8 @@
 
 #include "repair.h"
 
-#include <linux/min_heap.h>
+#include <linux/jiffies.h>
 #include <linux/minmax.h>
-#ifndef VDO_UPSTREAM
-#include <linux/version.h>
-#endif /* VDO_UPSTREAM */
 
 #include "logger.h"
 #include "memory-alloc.h"
@@ -54,21 +51,50 @@ struct recovery_point {
 	bool increment_applied;
 };
 
-#ifndef VDO_UPSTREAM
-#undef VDO_USE_ALTERNATE
-#if defined(RHEL_RELEASE_CODE) && defined(RHEL_MINOR) && (RHEL_MINOR < 50)
-#if (RHEL_RELEASE_CODE < RHEL_RELEASE_VERSION(10, 0))
-#define VDO_USE_ALTERNATE
-#endif
-#else /* !RHEL_RELEASE_CODE */
-#if (LINUX_VERSION_CODE < KERNEL_VERSION(6, 11, 0))
-#define VDO_USE_ALTERNATE
-#endif
-#endif /* !RHEL_RELEASE_CODE */
-#endif /* !VDO_UPSTREAM */
-#ifndef VDO_USE_ALTERNATE
-DEFINE_MIN_HEAP(struct numbered_block_mapping, replay_heap);
-#endif
+/* The smallest number of journal blocks worth handing to a thread of its own to extract */
+enum {
+	MINIMUM_BLOCKS_PER_EXTRACTION = 16,
+};
+
+/* The size and number of the reads issued by a streaming read-only rebuild */
+enum {
+	LEAF_READ_BLOCKS = 32,
+	LEAF_READERS = 16,
+};
+
+/* A range of recovery journal blocks from which one cpu thread extracts block map entries. */
+struct journal_extraction {
+	struct vdo_completion completion;
+	/* The first sequence number of the range */
+	sequence_number_t first;
+	/* The sequence number just beyond the range */
+	sequence_number_t end;
+	/* The index in the entry array at which this range's entries are stored */
+	size_t start;
+	/* The number of entries extracted from the range */
+	size_t count;
+};
+
+/*
+ * A reader which, during a streaming read-only rebuild, reads a run of block map leaf pages which
+ * lie within LEAF_READ_BLOCKS of each other with a single I/O, and then rebuilds the reference
+ * counts from each page of the run.
+ */
+struct leaf_reader {
+	struct vio vio;
+	struct repair_completion *repair;
+	/* The first block read */
+	physical_block_number_t start;
+	/* The index in the repair's leaf_pbns of the first page of the run */
+	page_count_t first;
+	/* The number of leaf pages in the run */
+	page_count_t count;
+	/* The number of pages of the run which have been processed */
+	page_count_t processed;
+	/* Whether the run is being read one page at a time after a read error */
+	bool reading_singly;
+};
+
 struct repair_completion {
 	/* The completion header */
 	struct vdo_completion completion;
@@ -100,6 +126,19 @@ struct repair_completion {
 	/* The number of block map data blocks known to be allocated */
 	block_count_t block_map_data_blocks;
 
+	/* When the current phase of the repair started, in jiffies */
+	u64 phase_start;
+
+	/* These fields are for extracting the block map entries from the journal */
+	/* The format of the journal blocks (read-only rebuild only) */
+	enum vdo_metadata_type format;
+	/* The number of entries in each journal block */
+	journal_entry_count_t entries_per_block;
+	/* The ranges of the journal being extracted in parallel */
+	struct journal_extraction *extractions;
+	unsigned int extraction_count;
+	unsigned int extractions_complete;
+
 	/* These fields are for playing the journal into the block map */
 	/* The entry data for the block map recovery */
 	struct numbered_block_mapping *entries;
@@ -110,21 +149,12 @@ struct repair_completion {
 	/* number of page completions */
 	page_count_t page_count;
 	bool launching;
-	/*
-	 * a heap wrapping journal_entries. It re-orders and sorts journal entries in ascending LBN
-	 * order, then original journal order. This permits efficient iteration over the journal
-	 * entries in order.
-	 */
-#ifdef VDO_USE_ALTERNATE
-	struct min_heap replay_heap;
-#else
-	struct replay_heap replay_heap;
-#endif
-	/* Fields tracking progress through the journal entries. */
-	struct numbered_block_mapping *current_entry;
+	/* The first entry not yet assigned to a page fetch */
 	struct numbered_block_mapping *current_unfetched_entry;
-	/* Current requested page's PBN */
-	physical_block_number_t pbn;
+	/* The first entry to apply to the page each page completion is fetching */
+	struct numbered_block_mapping **page_entries;
+	/* The number of block map pages to which entries have been applied */
+	page_count_t pages_replayed;
 
 	/* These fields are only used during recovery. */
 	/* A location just beyond the last valid entry of the journal */
@@ -142,6 +172,14 @@ struct repair_completion {
 	page_count_t leaf_pages;
 	/* the last slot of the block map */
 	struct block_map_slot last_slot;
+	/* The PBNs of the allocated leaf pages, sorted by PBN if streaming */
+	physical_block_number_t *leaf_pbns;
+	/* The number of allocated leaf pages */
+	page_count_t leaf_pbn_count;
+	/* The readers for a streaming rebuild, and the buffer they share */
+	struct leaf_reader *readers;
+	unsigned int reader_count;
+	char *leaf_data;
 
 	/*
 	 * The page completions used for playing the journal into the block map, and, during
@@ -150,83 +188,6 @@ struct repair_completion {
 	struct vdo_page_completion page_completions[];
 };
 
-/*
- * This is a min_heap callback function that orders numbered_block_mappings using the
- * 'block_map_slot' field as the primary key and the mapping 'number' field as the secondary key.
- * Using the mapping number preserves the journal order of entries for the same slot, allowing us
- * to sort by slot while still ensuring we replay all entries with the same slot in the exact order
- * as they appeared in the journal.
- */
-#ifdef VDO_USE_ALTERNATE
-static bool mapping_is_less_than(const void *item1, const void *item2)
-#else
-static bool mapping_is_less_than(const void *item1, const void *item2, void __always_unused *args)
-#endif
-{
-	const struct numbered_block_mapping *mapping1 =
-		(const struct numbered_block_mapping *) item1;
-	const struct numbered_block_mapping *mapping2 =
-		(const struct numbered_block_mapping *) item2;
-
-	if (mapping1->block_map_slot.pbn != mapping2->block_map_slot.pbn)
-		return mapping1->block_map_slot.pbn < mapping2->block_map_slot.pbn;
-
-	if (mapping1->block_map_slot.slot != mapping2->block_map_slot.slot)
-		return mapping1->block_map_slot.slot < mapping2->block_map_slot.slot;
-
-	if (mapping1->number != mapping2->number)
-		return mapping1->number < mapping2->number;
-
-	return 0;
-}
-
-#ifdef VDO_USE_ALTERNATE
-static void swap_mappings(void *item1, void *item2)
-#else
-static void swap_mappings(void *item1, void *item2, void __always_unused *args)
-#endif
-{
-	struct numbered_block_mapping *mapping1 = item1;
-	struct numbered_block_mapping *mapping2 = item2;
-
-	swap(*mapping1, *mapping2);
-}
-
-static const struct min_heap_callbacks repair_min_heap = {
-#ifdef VDO_USE_ALTERNATE
-	.elem_size = sizeof(struct numbered_block_mapping),
-#endif
-	.less = mapping_is_less_than,
-	.swp = swap_mappings,
-};
-
-static struct numbered_block_mapping *sort_next_heap_element(struct repair_completion *repair)
-{
-#ifdef VDO_USE_ALTERNATE
-	struct min_heap *heap = &repair->replay_heap;
-#else
-	struct replay_heap *heap = &repair->replay_heap;
-#endif
-	struct numbered_block_mapping *last;
-
-	if (heap->nr == 0)
-		return NULL;
-
-	/*
-	 * Swap the next heap element with the last one on the heap, popping it off the heap,
-	 * restore the heap invariant, and return a pointer to the popped element.
-	 */
-	last = &repair->entries[--heap->nr];
-#ifdef VDO_USE_ALTERNATE
-	swap_mappings(heap->data, last);
-	min_heapify(heap, 0, &repair_min_heap);
-#else
-	swap_mappings(heap->data, last, NULL);
-	min_heap_sift_down(heap, 0, &repair_min_heap, NULL);
-#endif
-	return last;
-}
-
 /**
  * as_repair_completion() - Convert a generic completion to a repair_completion.
  * @completion: The completion to convert.
@@ -282,8 +243,16 @@ STATIC void free_repair_completion(struct repair_completion *repair)
 	repair->completion.vdo->block_map->zones[0].page_cache.rebuilding = false;
 
 	uninitialize_vios(repair);
+	while (repair->reader_count > 0)
+		free_vio_components(&repair->readers[--repair->reader_count].vio);
+
+	vdo_free(vdo_forget(repair->readers));
+	vdo_free(vdo_forget(repair->leaf_data));
+	vdo_free(vdo_forget(repair->leaf_pbns));
 	vdo_free(vdo_forget(repair->journal_data));
+	vdo_free(vdo_forget(repair->extractions));
 	vdo_free(vdo_forget(repair->entries));
+	vdo_free(vdo_forget(repair->page_entries));
 	vdo_free(repair);
 }
 
@@ -419,25 +388,23 @@ static void handle_page_load_error(struct vdo_completion *completion)
 /**
  * unmap_entry() - Unmap an invalid entry and indicate that its page must be written out.
  * @page: The page containing the entries
- * @completion: The page_completion for writing the page
  * @slot: The slot to unmap
+ * @dirty: Set to true to indicate that the page must be written out
  */
-static void unmap_entry(struct block_map_page *page, struct vdo_completion *completion,
-			slot_number_t slot)
+static void unmap_entry(struct block_map_page *page, slot_number_t slot, bool *dirty)
 {
 	page->entries[slot] = UNMAPPED_BLOCK_MAP_ENTRY;
-	vdo_request_page_write(completion);
+	*dirty = true;
 }
 
 /**
  * remove_out_of_bounds_entries() - Unmap entries which outside the logical space.
  * @page: The page containing the entries
- * @completion: The page_completion for writing the page
  * @start: The first slot to check
+ * @dirty: Set to true if any entry is unmapped
  */
-static void remove_out_of_bounds_entries(struct block_map_page *page,
-					 struct vdo_completion *completion,
-					 slot_number_t start)
+static void remove_out_of_bounds_entries(struct block_map_page *page, slot_number_t start,
+					 bool *dirty)
 {
 	slot_number_t slot;
 
@@ -445,28 +412,28 @@ static void remove_out_of_bounds_entries(struct block_map_page *page,
 		struct data_location mapping = vdo_unpack_block_map_entry(&page->entries[slot]);
 
 		if (vdo_is_mapped_location(&mapping))
-			unmap_entry(page, completion, slot);
+			unmap_entry(page, slot, dirty);
 	}
 }
 
 /**
  * process_slot() - Update the reference counts for a single entry.
+ * @depot: The slab depot
  * @page: The page containing the entries
- * @completion: The page_completion for writing the page
  * @slot: The slot to check
+ * @dirty: Set to true if the entry is unmapped
  *
  * Return: true if the entry was a valid mapping
  */
-static bool process_slot(struct block_map_page *page, struct vdo_completion *completion,
-			 slot_number_t slot)
+static bool process_slot(struct slab_depot *depot, struct block_map_page *page,
+			 slot_number_t slot, bool *dirty)
 {
-	struct slab_depot *depot = completion->vdo->depot;
 	int result;
 	struct data_location mapping = vdo_unpack_block_map_entry(&page->entries[slot]);
 
 	if (!vdo_is_valid_location(&mapping)) {
 		/* This entry is invalid, so remove it from the page. */
-		unmap_entry(page, completion, slot);
+		unmap_entry(page, slot, dirty);
 		return false;
 	}
 
@@ -482,7 +449,7 @@ static bool process_slot(struct block_map_page *page, struct vdo_completion *com
 		 * This is a nonsense mapping. Remove it from the map so we're at least consistent
 		 * and mark the page dirty.
 		 */
-		unmap_entry(page, completion, slot);
+		unmap_entry(page, slot, dirty);
 		return false;
 	}
 
@@ -495,44 +462,64 @@ static bool process_slot(struct block_map_page *page, struct vdo_completion *com
 			       "Could not adjust reference count for PBN %llu, slot %u mapped to PBN %llu",
 			       (unsigned long long) vdo_get_block_map_page_pbn(page),
 			       slot, (unsigned long long) mapping.pbn);
-	unmap_entry(page, completion, slot);
+	unmap_entry(page, slot, dirty);
 	return false;
 }
 
 /**
- * rebuild_reference_counts_from_page() - Rebuild reference counts from a block map page.
+ * rebuild_reference_counts_from_block() - Rebuild reference counts from the entries of a block
+ *                                         map page.
  * @repair: The repair completion.
- * @completion: The page completion holding the page.
+ * @page: The page.
+ *
+ * Return: true if any entries were unmapped, so the page must be written out.
  */
-static void rebuild_reference_counts_from_page(struct repair_completion *repair,
-					       struct vdo_completion *completion)
+static bool rebuild_reference_counts_from_block(struct repair_completion *repair,
+						struct block_map_page *page)
 {
+	struct slab_depot *depot = repair->completion.vdo->depot;
 	slot_number_t slot, last_slot;
-	struct block_map_page *page;
-	int result;
-
-	result = vdo_get_cached_page(completion, &page);
-	if (result != VDO_SUCCESS) {
-		vdo_set_completion_result(&repair->completion, result);
-		return;
-	}
+	bool dirty = false;
 
 	if (!page->header.initialized)
-		return;
+		return false;
 
 	/* Remove any bogus entries which exist beyond the end of the logical space. */
 	if (vdo_get_block_map_page_pbn(page) == repair->last_slot.pbn) {
 		last_slot = repair->last_slot.slot;
-		remove_out_of_bounds_entries(page, completion, last_slot);
+		remove_out_of_bounds_entries(page, last_slot, &dirty);
 	} else {
 		last_slot = VDO_BLOCK_MAP_ENTRIES_PER_PAGE;
 	}
 
 	/* Inform the slab depot of all entries on this page. */
 	for (slot = 0; slot < last_slot; slot++) {
-		if (process_slot(page, completion, slot))
+		if (process_slot(depot, page, slot, &dirty))
 			repair->logical_blocks_used++;
 	}
+
+	return dirty;
+}
+
+/**
+ * rebuild_reference_counts_from_page() - Rebuild reference counts from a block map page.
+ * @repair: The repair completion.
+ * @completion: The page completion holding the page.
+ */
+static void rebuild_reference_counts_from_page(struct repair_completion *repair,
+					       struct vdo_completion *completion)
+{
+	struct block_map_page *page;
+	int result;
+
+	result = vdo_get_cached_page(completion, &page);
+	if (result != VDO_SUCCESS) {
+		vdo_set_completion_result(&repair->completion, result);
+		return;
+	}
+
+	if (rebuild_reference_counts_from_block(repair, page))
+		vdo_request_page_write(completion);
 }
 
 /**
@@ -547,28 +534,32 @@ static void page_loaded(struct vdo_completion *completion)
 
 	repair->outstanding--;
 	rebuild_reference_counts_from_page(repair, completion);
+	atomic64_inc(&completion->vdo->stats.rebuild_pages_done);
 	vdo_release_page_completion(completion);
 
 	/* Advance progress to the next page, and fetch the next page we haven't yet requested. */
 	fetch_page(repair, completion);
 }
 
-static physical_block_number_t get_pbn_to_fetch(struct repair_completion *repair,
-						struct block_map *block_map)
+static physical_block_number_t get_pbn_to_fetch(struct repair_completion *repair)
 {
-	physical_block_number_t pbn = VDO_ZERO_BLOCK;
-
-	if (repair->completion.result != VDO_SUCCESS)
+	if ((repair->completion.result != VDO_SUCCESS) ||
+	    (repair->page_to_fetch >= repair->leaf_pbn_count))
 		return VDO_ZERO_BLOCK;
 
-	while ((pbn == VDO_ZERO_BLOCK) && (repair->page_to_fetch < repair->leaf_pages))
-		pbn = vdo_find_block_map_page_pbn(block_map, repair->page_to_fetch++);
-
-	if (vdo_is_physical_data_block(repair->completion.vdo->depot, pbn))
-		return pbn;
+	return repair->leaf_pbns[repair->page_to_fetch++];
+}
 
-	vdo_set_completion_result(&repair->completion, VDO_BAD_MAPPING);
-	return VDO_ZERO_BLOCK;
+/**
+ * finish_leaf_rebuild() - Move on to flushing the block map once every leaf page has been
+ *                         processed.
+ * @repair: The repair completion.
+ */
+static void finish_leaf_rebuild(struct repair_completion *repair)
+{
+	vdo_log_info("Rebuilt reference counts from %u block map leaf pages in %u ms",
+		     repair->leaf_pbn_count, jiffies_to_msecs(jiffies - repair->phase_start));
+	launch_repair_completion(repair, flush_block_map_updates, VDO_ZONE_TYPE_ADMIN);
 }
 
 /**
@@ -583,7 +574,7 @@ static bool fetch_page(struct repair_completion *repair,
 {
 	struct vdo_page_completion *page_completion = (struct vdo_page_completion *) completion;
 	struct block_map *block_map = repair->completion.vdo->block_map;
-	physical_block_number_t pbn = get_pbn_to_fetch(repair, block_map);
+	physical_block_number_t pbn = get_pbn_to_fetch(repair);
 
 	if (pbn != VDO_ZERO_BLOCK) {
 		repair->outstanding++;
@@ -598,10 +589,407 @@ static bool fetch_page(struct repair_completion *repair,
 	if (repair->outstanding > 0)
 		return false;
 
-	launch_repair_completion(repair, flush_block_map_updates, VDO_ZONE_TYPE_ADMIN);
+	finish_leaf_rebuild(repair);
 	return true;
 }
 
+static void read_leaf_run(struct leaf_reader *reader);
+static void read_next_leaf_page(struct vdo_completion *completion);
+
+static inline struct leaf_reader *as_leaf_reader(struct vdo_completion *completion)
+{
+	return container_of(as_vio(completion), struct leaf_reader, vio);
+}
+
+static char *get_leaf_buffer(struct leaf_reader *reader, physical_block_number_t pbn)
+{
+	return reader->vio.data + ((pbn - reader->start) * VDO_BLOCK_SIZE);
+}
+
+static void continue_leaf_run(struct vdo_completion *completion);
+
+static void handle_leaf_write_error(struct vdo_completion *completion)
+{
+	struct leaf_reader *reader = as_leaf_reader(completion);
+
+	vio_record_metadata_io_error(as_vio(completion));
+	vdo_set_completion_result(&reader->repair->completion, completion->result);
+	vdo_reset_completion(completion);
+	continue_leaf_run(completion);
+}
+
+static void write_leaf_endio(struct bio *bio)
+{
+	struct vio *vio = bio->bi_private;
+
+	continue_vio_after_io(vio, continue_leaf_run,
+			      vio->completion.vdo->block_map->zones[0].thread_id);
+}
+
+/**
+ * process_leaf_page() - Rebuild the reference counts from one leaf page of a run, writing it back
+ *                       if any of its entries had to be removed.
+ * @reader: The reader holding the page.
+ *
+ * Return: true if the page is being written.
+ */
+static bool process_leaf_page(struct leaf_reader *reader)
+{
+	struct repair_completion *repair = reader->repair;
+	struct vdo *vdo = repair->completion.vdo;
+	physical_block_number_t pbn = repair->leaf_pbns[reader->first + reader->processed++];
+	struct block_map_page *page = (struct block_map_page *) get_leaf_buffer(reader, pbn);
+	enum block_map_page_validity validity;
+
+	atomic64_inc(&vdo->stats.rebuild_pages_done);
+	validity = vdo_validate_block_map_page(page, vdo->block_map->nonce, pbn);
+	if (validity == VDO_BLOCK_MAP_PAGE_BAD) {
+		int result = vdo_log_error_strerror(VDO_BAD_PAGE,
+						    "Expected page %llu but got page %llu instead",
+						    (unsigned long long) pbn,
+						    (unsigned long long) vdo_get_block_map_page_pbn(page));
+
+		vdo_set_completion_result(&repair->completion, result);
+		return false;
+	}
+
+	/* A page which was never written has no mappings. */
+	if ((validity == VDO_BLOCK_MAP_PAGE_INVALID) ||
+	    !rebuild_reference_counts_from_block(repair, page))
+		return false;
+
+	__submit_metadata_vio(&reader->vio, pbn, write_leaf_endio, handle_leaf_write_error,
+			      REQ_OP_WRITE | REQ_PRIO, (char *) page, VDO_BLOCK_SIZE);
+	return true;
+}
+
+/**
+ * process_leaf_run() - Rebuild the reference counts from each page of a run which has been read.
+ * @completion: The vio of the leaf reader.
+ *
+ * This callback is registered in read_leaf_run_endio() and, via continue_leaf_run(), in
+ * write_leaf_endio().
+ */
+static void process_leaf_run(struct vdo_completion *completion)
+{
+	struct leaf_reader *reader = as_leaf_reader(completion);
+
+	while (reader->processed < reader->count) {
+		if (reader->repair->completion.result != VDO_SUCCESS)
+			break;
+
+		if (process_leaf_page(reader))
+			return;
+	}
+
+	read_leaf_run(reader);
+}
+
+static void continue_leaf_run(struct vdo_completion *completion)
+{
+	if (as_leaf_reader(completion)->reading_singly)
+		read_next_leaf_page(completion);
+	else
+		process_leaf_run(completion);
+}
+
+/**
+ * process_single_leaf_page() - Rebuild the reference counts from a page which was read on its own.
+ * @completion: The vio of the leaf reader.
+ *
+ * This callback is registered in read_leaf_page_endio().
+ */
+static void process_single_leaf_page(struct vdo_completion *completion)
+{
+	if (!process_leaf_page(as_leaf_reader(completion)))
+		read_next_leaf_page(completion);
+}
+
+static void read_leaf_page_endio(struct bio *bio)
+{
+	struct vio *vio = bio->bi_private;
+
+	continue_vio_after_io(vio, process_single_leaf_page,
+			      vio->completion.vdo->block_map->zones[0].thread_id);
+}
+
+/**
+ * handle_leaf_page_read_error() - Treat a page which can't be read as one which was never
+ *                                 written, as the block map cache does during a rebuild.
+ * @completion: The vio of the leaf reader.
+ */
+static void handle_leaf_page_read_error(struct vdo_completion *completion)
+{
+	struct leaf_reader *reader = as_leaf_reader(completion);
+
+	vio_record_metadata_io_error(as_vio(completion));
+	vdo_reset_completion(completion);
+	reader->processed++;
+	atomic64_inc(&reader->repair->completion.vdo->stats.rebuild_pages_done);
+	read_next_leaf_page(completion);
+}
+
+/**
+ * read_next_leaf_page() - Read the next page of a run on its own.
+ * @completion: The vio of the leaf reader.
+ *
+ * Once the page has been processed, and written back if necessary, the next page will be read.
+ */
+static void read_next_leaf_page(struct vdo_completion *completion)
+{
+	struct leaf_reader *reader = as_leaf_reader(completion);
+	physical_block_number_t pbn;
+
+	if ((reader->processed == reader->count) ||
+	    (reader->repair->completion.result != VDO_SUCCESS)) {
+		read_leaf_run(reader);
+		return;
+	}
+
+	pbn = reader->repair->leaf_pbns[reader->first + reader->processed];
+	__submit_metadata_vio(&reader->vio, pbn, read_leaf_page_endio,
+			      handle_leaf_page_read_error, REQ_OP_READ | REQ_PRIO,
+			      get_leaf_buffer(reader, pbn), VDO_BLOCK_SIZE);
+}
+
+/**
+ * handle_leaf_run_read_error() - Retry each page of a run which could not be read in one piece.
+ * @completion: The vio of the leaf reader.
+ */
+static void handle_leaf_run_read_error(struct vdo_completion *completion)
+{
+	struct leaf_reader *reader = as_leaf_reader(completion);
+
+	vio_record_metadata_io_error(as_vio(completion));
+	vdo_reset_completion(completion);
+	reader->reading_singly = true;
+	read_next_leaf_page(completion);
+}
+
+static void read_leaf_run_endio(struct bio *bio)
+{
+	struct vio *vio = bio->bi_private;
+
+	continue_vio_after_io(vio, process_leaf_run,
+			      vio->completion.vdo->block_map->zones[0].thread_id);
+}
+
+/**
+ * read_leaf_run() - Read the next run of leaf pages, or finish the rebuild if this is the last
+ *                   reader and there are none left.
+ * @reader: The reader.
+ */
+static void read_leaf_run(struct leaf_reader *reader)
+{
+	struct repair_completion *repair = reader->repair;
+	physical_block_number_t end;
+
+	if ((repair->completion.result != VDO_SUCCESS) ||
+	    (repair->page_to_fetch == repair->leaf_pbn_count)) {
+		if (--repair->outstanding == 0)
+			finish_leaf_rebuild(repair);
+		return;
+	}
+
+	reader->first = repair->page_to_fetch;
+	reader->start = repair->leaf_pbns[reader->first];
+	end = reader->start + LEAF_READ_BLOCKS;
+	while ((repair->page_to_fetch < repair->leaf_pbn_count) &&
+	       (repair->leaf_pbns[repair->page_to_fetch] < end))
+		repair->page_to_fetch++;
+
+	reader->count = repair->page_to_fetch - reader->first;
+	reader->processed = 0;
+	reader->reading_singly = false;
+	end = repair->leaf_pbns[repair->page_to_fetch - 1] + 1;
+	vdo_submit_metadata_vio_with_size(&reader->vio, reader->start, read_leaf_run_endio,
+					  handle_leaf_run_read_error, REQ_OP_READ | REQ_PRIO,
+					  (end - reader->start) * VDO_BLOCK_SIZE);
+}
+
+/**
+ * radix_sort_by_key() - Sort an array by a u64 key of each element.
+ * @elements: The array to sort.
+ * @scratch: A buffer as large as the array.
+ * @count: The number of elements.
+ * @size: The size of each element.
+ * @get_key: A function which returns the key of an element.
+ * @sorted_ptr: A pointer to hold the sorted array, which is either @elements or @scratch.
+ *
+ * This is a least-significant-digit radix sort, making one pass for each significant byte of the
+ * largest key. Since each pass is stable, elements with the same key remain in their original
+ * order. It is inlined so that each caller gets a copy specialized for its element type.
+ *
+ * Return: VDO_SUCCESS or an error.
+ */
+static __always_inline int radix_sort_by_key(void *elements, void *scratch, size_t count,
+					     size_t size, u64 (*get_key)(const void *element),
+					     void **sorted_ptr)
+{
+	u8 *from = elements;
+	u8 *to = scratch;
+	u64 largest = 0;
+	unsigned int shift;
+	size_t *offsets;
+	size_t i;
+	int result;
+
+	for (i = 0; i < count; i++)
+		largest = max(largest, get_key(from + (i * size)));
+
+	result = vdo_allocate(U8_MAX + 1, size_t, __func__, &offsets);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	for (shift = 0; (shift < 64) && ((largest >> shift) > 0); shift += 8) {
+		size_t total = 0;
+		unsigned int digit;
+
+		memset(offsets, 0, (U8_MAX + 1) * sizeof(size_t));
+		for (i = 0; i < count; i++)
+			offsets[(get_key(from + (i * size)) >> shift) & U8_MAX]++;
+
+		for (digit = 0; digit <= U8_MAX; digit++) {
+			size_t digit_count = offsets[digit];
+
+			offsets[digit] = total;
+			total += digit_count;
+		}
+
+		for (i = 0; i < count; i++) {
+			const u8 *element = from + (i * size);
+			size_t slot = offsets[(get_key(element) >> shift) & U8_MAX]++;
+
+			memcpy(to + (slot * size), element, size);
+		}
+
+		swap(from, to);
+	}
+
+	vdo_free(offsets);
+	*sorted_ptr = from;
+	return VDO_SUCCESS;
+}
+
+static u64 get_leaf_pbn(const void *element)
+{
+	return *((const physical_block_number_t *) element);
+}
+
+/**
+ * sort_leaf_pages() - Sort the leaf page PBNs into physical order.
+ * @repair: The repair completion.
+ *
+ * Return: VDO_SUCCESS or an error.
+ */
+static int sort_leaf_pages(struct repair_completion *repair)
+{
+	physical_block_number_t *scratch;
+	void *sorted;
+	int result;
+
+	result = vdo_allocate(repair->leaf_pbn_count, physical_block_number_t, __func__,
+			      &scratch);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	result = radix_sort_by_key(repair->leaf_pbns, scratch, repair->leaf_pbn_count,
+				   sizeof(physical_block_number_t), get_leaf_pbn, &sorted);
+	if (result != VDO_SUCCESS) {
+		vdo_free(scratch);
+		return result;
+	}
+
+	vdo_free((sorted == scratch) ? repair->leaf_pbns : scratch);
+	repair->leaf_pbns = sorted;
+	return VDO_SUCCESS;
+}
+
+/**
+ * stream_leaf_pages() - Rebuild the reference counts from the leaf pages by reading them in
+ *                       physical order, several at a time, bypassing the block map cache.
+ * @repair: The repair completion.
+ */
+static void stream_leaf_pages(struct repair_completion *repair)
+{
+	struct vdo *vdo = repair->completion.vdo;
+	unsigned int count = min_t(unsigned int, LEAF_READERS,
+				   DIV_ROUND_UP(repair->leaf_pbn_count, LEAF_READ_BLOCKS));
+	unsigned int i;
+	int result;
+
+	result = sort_leaf_pages(repair);
+	if (abort_on_error(result, repair))
+		return;
+
+	result = vdo_allocate(count, struct leaf_reader, __func__, &repair->readers);
+	if (abort_on_error(result, repair))
+		return;
+
+	result = vdo_allocate(count * LEAF_READ_BLOCKS * VDO_BLOCK_SIZE, char, __func__,
+			      &repair->leaf_data);
+	if (abort_on_error(result, repair))
+		return;
+
+	for (; repair->reader_count < count; repair->reader_count++) {
+		struct leaf_reader *reader = &repair->readers[repair->reader_count];
+
+		reader->repair = repair;
+		result = allocate_vio_components(vdo, VIO_TYPE_BLOCK_MAP,
+						 VIO_PRIORITY_METADATA, reader,
+						 LEAF_READ_BLOCKS,
+						 repair->leaf_data + (repair->reader_count *
+								      LEAF_READ_BLOCKS *
+								      VDO_BLOCK_SIZE),
+						 &reader->vio);
+		if (abort_on_error(result, repair))
+			return;
+	}
+
+	repair->outstanding = count;
+	for (i = 0; i < count; i++)
+		read_leaf_run(&repair->readers[i]);
+}
+
+/**
+ * find_leaf_pages() - Make a list, in logical order, of the leaf pages of the block map which
+ *                     have been allocated.
+ * @repair: The repair completion.
+ *
+ * The traversal of the block map tree has counted every allocated tree page, leaves included, so
+ * that count bounds the size of the list.
+ *
+ * Return: VDO_SUCCESS or an error.
+ */
+static int find_leaf_pages(struct repair_completion *repair)
+{
+	struct vdo *vdo = repair->completion.vdo;
+	page_number_t page;
+	int result;
+
+	result = vdo_allocate(repair->block_map_data_blocks, physical_block_number_t,
+			      __func__, &repair->leaf_pbns);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	for (page = 0; page < repair->leaf_pages; page++) {
+		physical_block_number_t pbn = vdo_find_block_map_page_pbn(vdo->block_map, page);
+
+		if (pbn == VDO_ZERO_BLOCK)
+			continue;
+
+		if (!vdo_is_physical_data_block(vdo->depot, pbn) ||
+		    (repair->leaf_pbn_count == repair->block_map_data_blocks))
+			return VDO_BAD_MAPPING;
+
+		repair->leaf_pbns[repair->leaf_pbn_count++] = pbn;
+	}
+
+	atomic64_set(&vdo->stats.rebuild_pages_total, repair->leaf_pbn_count);
+	atomic64_set(&vdo->stats.rebuild_pages_done, 0);
+	return VDO_SUCCESS;
+}
+
 /**
  * rebuild_from_leaves() - Rebuild reference counts from the leaf block map pages.
  * @completion: The repair completion.
@@ -617,6 +1005,7 @@ static void rebuild_from_leaves(struct vdo_completion *completion)
 	struct block_map *map = completion->vdo->block_map;
 
 	repair->logical_blocks_used = 0;
+	repair->phase_start = jiffies;
 
 	/*
 	 * The PBN calculation doesn't work until the tree pages have been loaded, so we can't set
@@ -630,6 +1019,15 @@ static void rebuild_from_leaves(struct vdo_completion *completion)
 	if (repair->last_slot.slot == 0)
 		repair->last_slot.slot = VDO_BLOCK_MAP_ENTRIES_PER_PAGE;
 
+	if (abort_on_error(find_leaf_pages(repair), repair))
+		return;
+
+	if (completion->vdo->device_config->streaming_rebuild &&
+	    (repair->leaf_pbn_count > 0)) {
+		stream_leaf_pages(repair);
+		return;
+	}
+
 	for (i = 0; i < repair->page_count; i++) {
 		if (fetch_page(repair, &repair->page_completions[i].completion)) {
 			/*
@@ -961,23 +1359,12 @@ static bool finish_if_done(struct repair_completion *repair)
 		return false;
 
 	if (repair->completion.result != VDO_SUCCESS) {
-		page_count_t i;
-
-		for (i = 0; i < repair->page_count; i++) {
-			struct vdo_page_completion *page_completion =
-				&repair->page_completions[i];
-
-			if (page_completion->ready)
-				vdo_release_page_completion(&page_completion->completion);
-		}
-
 		vdo_launch_completion(&repair->completion);
 		return true;
 	}
 
-	if (repair->current_entry >= repair->entries)
-		return false;
-
+	vdo_log_info("Replayed recovery entries into %u block map pages in %u ms",
+		     repair->pages_replayed, jiffies_to_msecs(jiffies - repair->phase_start));
 	launch_repair_completion(repair, flush_block_map, VDO_ZONE_TYPE_ADMIN);
 	return true;
 }
@@ -988,157 +1375,146 @@ static void abort_block_map_recovery(struct repair_completion *repair, int resul
 	finish_if_done(repair);
 }
 
-/**
- * find_entry_starting_next_page() - Find the first journal entry after a given entry which is not
- *                                   on the same block map page.
- * @repair: The repair completion.
- * @current_entry: The entry to search from.
- * @needs_sort: Whether sorting is needed to proceed.
- *
- * Return: Pointer to the first later journal entry on a different block map page, or a pointer to
- *         just before the journal entries if no subsequent entry is on a different block map page.
- */
-static struct numbered_block_mapping *
-find_entry_starting_next_page(struct repair_completion *repair,
-			      struct numbered_block_mapping *current_entry, bool needs_sort)
-{
-	size_t current_page;
-
-	/* If current_entry is invalid, return immediately. */
-	if (current_entry < repair->entries)
-		return current_entry;
-
-	current_page = current_entry->block_map_slot.pbn;
-
-	/* Decrement current_entry until it's out of bounds or on a different page. */
-	while ((current_entry >= repair->entries) &&
-	       (current_entry->block_map_slot.pbn == current_page)) {
-		if (needs_sort) {
-			struct numbered_block_mapping *just_sorted_entry =
-				sort_next_heap_element(repair);
-			VDO_ASSERT_LOG_ONLY(just_sorted_entry < current_entry,
-					    "heap is returning elements in an unexpected order");
-		}
-
-		current_entry--;
-	}
-
-	return current_entry;
+static inline struct numbered_block_mapping *get_end_of_entries(struct repair_completion *repair)
+{
+	return &repair->entries[repair->block_map_entry_count];
 }
 
-/*
- * Apply a range of journal entries [starting_entry, ending_entry) journal
- * entries to a block map page.
- */
-static void apply_journal_entries_to_page(struct block_map_page *page,
-					  struct numbered_block_mapping *starting_entry,
-					  struct numbered_block_mapping *ending_entry)
+static u64 get_entry_page_pbn(const void *element)
 {
-	struct numbered_block_mapping *current_entry = starting_entry;
-
-	while (current_entry != ending_entry) {
-		page->entries[current_entry->block_map_slot.slot] = current_entry->block_map_entry;
-		current_entry--;
-	}
+	return ((const struct numbered_block_mapping *) element)->block_map_slot.pbn;
 }
 
-static void recover_ready_pages(struct repair_completion *repair,
-				struct vdo_completion *completion);
-
-static void block_map_page_loaded(struct vdo_completion *completion)
+/**
+ * sort_entries() - Sort the journal entries by block map page.
+ * @repair: The repair completion.
+ *
+ * Since the sort is stable, entries for the same page remain in journal order, so replaying them
+ * in order leaves each slot with its latest mapping.
+ *
+ * Return: VDO_SUCCESS or an error.
+ */
+static int sort_entries(struct repair_completion *repair)
 {
-	struct repair_completion *repair = as_repair_completion(completion->parent);
+	struct numbered_block_mapping *scratch;
+	void *sorted;
+	int result;
 
-	repair->outstanding--;
-	if (!repair->launching)
-		recover_ready_pages(repair, completion);
-}
+	result = vdo_allocate(repair->block_map_entry_count, struct numbered_block_mapping,
+			      __func__, &scratch);
+	if (result != VDO_SUCCESS)
+		return result;
 
-static void handle_block_map_page_load_error(struct vdo_completion *completion)
-{
-	struct repair_completion *repair = as_repair_completion(completion->parent);
+	result = radix_sort_by_key(repair->entries, scratch, repair->block_map_entry_count,
+				   sizeof(struct numbered_block_mapping), get_entry_page_pbn,
+				   &sorted);
+	if (result != VDO_SUCCESS) {
+		vdo_free(scratch);
+		return result;
+	}
 
-	repair->outstanding--;
-	abort_block_map_recovery(repair, completion->result);
+	vdo_free((sorted == scratch) ? repair->entries : scratch);
+	repair->entries = sorted;
+	return VDO_SUCCESS;
 }
 
+static void block_map_page_loaded(struct vdo_completion *completion);
+static void handle_block_map_page_load_error(struct vdo_completion *completion);
+
+/**
+ * fetch_block_map_page() - Fetch the page for the next entries which have not been assigned to a
+ *                          page completion.
+ * @repair: The repair completion.
+ * @page_completion: The idle page completion to use.
+ *
+ * The page is requested with requeue set so that a page which is already cached does not recurse
+ * into applying its entries and fetching the next page.
+ */
 static void fetch_block_map_page(struct repair_completion *repair,
-				 struct vdo_completion *completion)
+				 struct vdo_page_completion *page_completion)
 {
+	struct numbered_block_mapping *end = get_end_of_entries(repair);
+	struct numbered_block_mapping *entry = repair->current_unfetched_entry;
 	physical_block_number_t pbn;
 
-	if (repair->current_unfetched_entry < repair->entries)
+	if (entry == end)
 		/* Nothing left to fetch. */
 		return;
 
-	/* Fetch the next page we haven't yet requested. */
-	pbn = repair->current_unfetched_entry->block_map_slot.pbn;
-	repair->current_unfetched_entry =
-		find_entry_starting_next_page(repair, repair->current_unfetched_entry,
-					      true);
+	pbn = entry->block_map_slot.pbn;
+	repair->page_entries[page_completion - repair->page_completions] = entry;
+	while ((entry < end) && (entry->block_map_slot.pbn == pbn))
+		entry++;
+
+	repair->current_unfetched_entry = entry;
 	repair->outstanding++;
-	vdo_get_page(((struct vdo_page_completion *) completion),
-		     &repair->completion.vdo->block_map->zones[0], pbn, true,
+	vdo_get_page(page_completion, &repair->completion.vdo->block_map->zones[0], pbn, true,
 		     &repair->completion, block_map_page_loaded,
-		     handle_block_map_page_load_error, false);
-}
-
-static struct vdo_page_completion *get_next_page_completion(struct repair_completion *repair,
-							    struct vdo_page_completion *completion)
-{
-	completion++;
-	if (completion == (&repair->page_completions[repair->page_count]))
-		completion = &repair->page_completions[0];
-	return completion;
+		     handle_block_map_page_load_error, true);
 }
 
-static void recover_ready_pages(struct repair_completion *repair,
-				struct vdo_completion *completion)
+/**
+ * apply_journal_entries_to_page() - Apply the entries for a loaded page, then reuse its page
+ *                                   completion to fetch another page.
+ * @repair: The repair completion.
+ * @completion: The page completion holding the page.
+ *
+ * Pages are applied in whatever order they arrive, so a slow read does not hold up the pages
+ * fetched after it.
+ */
+static void apply_journal_entries_to_page(struct repair_completion *repair,
+					  struct vdo_completion *completion)
 {
 	struct vdo_page_completion *page_completion = (struct vdo_page_completion *) completion;
+	struct numbered_block_mapping *end = get_end_of_entries(repair);
+	struct numbered_block_mapping *entry;
+	struct block_map_page *page;
+	int result;
 
-	if (finish_if_done(repair))
+	result = vdo_get_cached_page(completion, &page);
+	if (result != VDO_SUCCESS) {
+		vdo_release_page_completion(completion);
+		vdo_set_completion_result(&repair->completion, result);
 		return;
+	}
 
-	if (repair->pbn != page_completion->pbn)
-		return;
+	for (entry = repair->page_entries[page_completion - repair->page_completions];
+	     (entry < end) && (entry->block_map_slot.pbn == page_completion->pbn); entry++)
+		page->entries[entry->block_map_slot.slot] = entry->block_map_entry;
 
-	while (page_completion->ready) {
-		struct numbered_block_mapping *start_of_next_page;
-		struct block_map_page *page;
-		int result;
+	repair->pages_replayed++;
+	vdo_request_page_write(completion);
+	vdo_release_page_completion(completion);
+	fetch_block_map_page(repair, page_completion);
+}
 
-		result = vdo_get_cached_page(completion, &page);
-		if (result != VDO_SUCCESS) {
-			abort_block_map_recovery(repair, result);
-			return;
-		}
+static void block_map_page_loaded(struct vdo_completion *completion)
+{
+	struct repair_completion *repair = as_repair_completion(completion->parent);
 
-		start_of_next_page =
-			find_entry_starting_next_page(repair, repair->current_entry,
-						      false);
-		apply_journal_entries_to_page(page, repair->current_entry,
-					      start_of_next_page);
-		repair->current_entry = start_of_next_page;
-		vdo_request_page_write(completion);
+	repair->outstanding--;
+	if (repair->completion.result == VDO_SUCCESS)
+		apply_journal_entries_to_page(repair, completion);
+	else
 		vdo_release_page_completion(completion);
 
-		if (finish_if_done(repair))
-			return;
+	finish_if_done(repair);
+}
 
-		repair->pbn = repair->current_entry->block_map_slot.pbn;
-		fetch_block_map_page(repair, completion);
-		page_completion = get_next_page_completion(repair, page_completion);
-		completion = &page_completion->completion;
-	}
+static void handle_block_map_page_load_error(struct vdo_completion *completion)
+{
+	struct repair_completion *repair = as_repair_completion(completion->parent);
+
+	repair->outstanding--;
+	abort_block_map_recovery(repair, completion->result);
 }
 
 STATIC void recover_block_map(struct vdo_completion *completion)
 {
 	struct repair_completion *repair = as_repair_completion(completion);
 	struct vdo *vdo = completion->vdo;
-	struct numbered_block_mapping *first_sorted_entry;
 	page_count_t i;
+	int result;
 
 	vdo_assert_on_logical_zone_thread(vdo, 0, __func__);
 
@@ -1156,24 +1532,20 @@ STATIC void recover_block_map(struct vdo_completion *completion)
 		return;
 	}
 
-	/*
-	 * Organize the journal entries into a binary heap so we can iterate over them in sorted
-	 * order incrementally, avoiding an expensive sort call.
-	 */
-#ifdef VDO_USE_ALTERNATE
-	repair->replay_heap = (struct min_heap) {
-#else
-	repair->replay_heap = (struct replay_heap) {
-#endif
-		.data = repair->entries,
-		.nr = repair->block_map_entry_count,
-		.size = repair->block_map_entry_count,
-	};
-#ifdef VDO_USE_ALTERNATE
-	min_heapify_all(&repair->replay_heap, &repair_min_heap);
-#else
-	min_heapify_all(&repair->replay_heap, &repair_min_heap, NULL);
-#endif
+	/* Sort the entries so that all of the entries for each page can be applied at once. */
+	repair->phase_start = jiffies;
+	result = sort_entries(repair);
+	if (abort_on_error(result, repair))
+		return;
+
+	vdo_log_info("Sorted %zu recovery entries by block map page in %u ms",
+		     repair->block_map_entry_count,
+		     jiffies_to_msecs(jiffies - repair->phase_start));
+
+	result = vdo_allocate(repair->page_count, struct numbered_block_mapping *, __func__,
+			      &repair->page_entries);
+	if (abort_on_error(result, repair))
+		return;
 
 #ifdef INTERNAL
 	/* This message must be in sync with VDOTest::RebuildBase. */
@@ -1181,25 +1553,20 @@ STATIC void recover_block_map(struct vdo_completion *completion)
 	vdo_log_info("Replaying %zu recovery entries into block map",
 		     repair->block_map_entry_count);
 
-	repair->current_entry = &repair->entries[repair->block_map_entry_count - 1];
-	first_sorted_entry = sort_next_heap_element(repair);
-	VDO_ASSERT_LOG_ONLY(first_sorted_entry == repair->current_entry,
-			    "heap is returning elements in an unexpected order");
-
-	/* Prevent any page from being processed until all pages have been launched. */
+	/* Prevent the repair from finishing until all pages have been launched. */
+	repair->phase_start = jiffies;
 	repair->launching = true;
-	repair->pbn = repair->current_entry->block_map_slot.pbn;
-	repair->current_unfetched_entry = repair->current_entry;
+	repair->current_unfetched_entry = repair->entries;
 	for (i = 0; i < repair->page_count; i++) {
-		if (repair->current_unfetched_entry < repair->entries)
+		if (repair->current_unfetched_entry == get_end_of_entries(repair))
 			break;
 
-		fetch_block_map_page(repair, &repair->page_completions[i].completion);
+		fetch_block_map_page(repair, &repair->page_completions[i]);
 	}
 	repair->launching = false;
 
-	/* Process any ready pages. */
-	recover_ready_pages(repair, &repair->page_completions[0].completion);
+	/* The pages may all have been applied already. */
+	finish_if_done(repair);
 }
 
 /**
@@ -1363,21 +1730,40 @@ static bool unpack_entry(struct vdo *vdo, char *packed, enum vdo_metadata_type f
 	return (validate_recovery_journal_entry(vdo, entry) == VDO_SUCCESS);
 }
 
+/**
+ * add_mapping() - Add the mapping from a journal entry to the entries extracted from a range of
+ *                 the journal, numbering it by its position in the entry array.
+ * @extraction: The extraction of the range containing the entry.
+ * @entry: The journal entry.
+ */
+static void add_mapping(struct journal_extraction *extraction,
+			const struct recovery_journal_entry *entry)
+{
+	struct repair_completion *repair = extraction->completion.parent;
+	size_t index = extraction->start + extraction->count++;
+
+	repair->entries[index] = (struct numbered_block_mapping) {
+		.block_map_slot = entry->slot,
+		.block_map_entry = vdo_pack_block_map_entry(entry->mapping.pbn,
+							    entry->mapping.state),
+		.number = index,
+	};
+}
+
 /**
  * append_sector_entries() - Append an array of recovery journal entries from a journal block
- *                           sector to the array of numbered mappings in the repair completion,
- *                           numbering each entry in the order they are appended.
- * @repair: The repair completion.
+ *                           sector to the entries extracted from a range of the journal.
+ * @extraction: The extraction of the range containing the sector.
  * @entries: The entries in the sector.
  * @format: The format of the sector.
  * @entry_count: The number of entries to append.
  */
-static void append_sector_entries(struct repair_completion *repair, char *entries,
+static void append_sector_entries(struct journal_extraction *extraction, char *entries,
 				  enum vdo_metadata_type format,
 				  journal_entry_count_t entry_count)
 {
 	journal_entry_count_t i;
-	struct vdo *vdo = repair->completion.vdo;
+	struct vdo *vdo = extraction->completion.vdo;
 	off_t increment = ((format == VDO_METADATA_RECOVERY_JOURNAL_2)
 			   ? sizeof(struct packed_recovery_journal_entry)
 			   : sizeof(struct packed_recovery_journal_entry_1));
@@ -1389,14 +1775,7 @@ static void append_sector_entries(struct repair_completion *repair, char *entrie
 			/* When recovering from read-only mode, ignore damaged entries. */
 			continue;
 
-		repair->entries[repair->block_map_entry_count] =
-			(struct numbered_block_mapping) {
-			.block_map_slot = entry.slot,
-			.block_map_entry = vdo_pack_block_map_entry(entry.mapping.pbn,
-								    entry.mapping.state),
-			.number = repair->block_map_entry_count,
-		};
-		repair->block_map_entry_count++;
+		add_mapping(extraction, &entry);
 	}
 }
 
@@ -1411,13 +1790,14 @@ static journal_entry_count_t entries_per_sector(enum vdo_metadata_type format,
 		: RECOVERY_JOURNAL_1_ENTRIES_PER_SECTOR);
 }
 
-static void extract_entries_from_block(struct repair_completion *repair,
+static void extract_entries_from_block(struct journal_extraction *extraction,
 				       struct recovery_journal *journal,
 				       sequence_number_t sequence,
 				       enum vdo_metadata_type format,
 				       journal_entry_count_t entries)
 {
 	sector_count_t i;
+	struct repair_completion *repair = extraction->completion.parent;
 	struct recovery_block_header header =
 		get_recovery_journal_block_header(journal, repair->journal_data,
 						  sequence);
@@ -1437,7 +1817,7 @@ static void extract_entries_from_block(struct repair_completion *repair,
 
 		if (vdo_is_valid_recovery_journal_sector(&header, sector, i)) {
 			/* Only extract as many as the block header calls for. */
-			append_sector_entries(repair, (char *) sector->entries, format,
+			append_sector_entries(extraction, (char *) sector->entries, format,
 					      min_t(journal_entry_count_t,
 						    sector->entry_count,
 						    sector_entries));
@@ -1453,8 +1833,6 @@ static void extract_entries_from_block(struct repair_completion *repair,
 
 static int parse_journal_for_rebuild(struct repair_completion *repair)
 {
-	int result;
-	sequence_number_t i;
 	block_count_t count;
 	enum vdo_metadata_type format;
 	struct vdo *vdo = repair->completion.vdo;
@@ -1468,18 +1846,13 @@ static int parse_journal_for_rebuild(struct repair_completion *repair)
 
 	/*
 	 * Allocate an array of numbered_block_mapping structures large enough to transcribe every
-	 * packed_recovery_journal_entry from every valid journal block.
+	 * packed_recovery_journal_entry from every valid journal block. The entries are extracted
+	 * by extract_journal_entries().
 	 */
 	count = ((repair->highest_tail - repair->block_map_head + 1) * entries_per_block);
-	result = vdo_allocate(count, struct numbered_block_mapping, __func__,
-			      &repair->entries);
-	if (result != VDO_SUCCESS)
-		return result;
-
-	for (i = repair->block_map_head; i <= repair->highest_tail; i++)
-		extract_entries_from_block(repair, journal, i, format, entries_per_block);
-
-	return VDO_SUCCESS;
+	repair->format = format;
+	repair->entries_per_block = entries_per_block;
+	return vdo_allocate(count, struct numbered_block_mapping, __func__, &repair->entries);
 }
 
 static int validate_heads(struct repair_completion *repair)
@@ -1498,57 +1871,42 @@ static int validate_heads(struct repair_completion *repair)
 }
 
 /**
- * extract_new_mappings() - Find all valid new mappings to be applied to the block map.
- * @repair: The repair completion.
+ * extract_recovery_entries() - Extract the new mappings to be applied to the block map from a
+ *                              range of the journal during recovery.
+ * @extraction: The extraction of the range.
  *
- * The mappings are extracted from the journal and stored in a sortable array so that all of the
- * mappings to be applied to a given block map page can be done in a single page fetch.
+ * Return: VDO_SUCCESS or an error if an entry is invalid.
  */
-static int extract_new_mappings(struct repair_completion *repair)
+static int extract_recovery_entries(struct journal_extraction *extraction)
 {
-	int result;
-	struct vdo *vdo = repair->completion.vdo;
+	struct repair_completion *repair = extraction->completion.parent;
 	struct recovery_point recovery_point = {
-		.sequence_number = repair->block_map_head,
+		.sequence_number = extraction->first,
+		.sector_count = 1,
+		.entry_count = 0,
+	};
+	struct recovery_point end = {
+		.sequence_number = extraction->end,
 		.sector_count = 1,
 		.entry_count = 0,
 	};
 
-	/*
-	 * Allocate an array of numbered_block_mapping structs just large enough to transcribe
-	 * every packed_recovery_journal_entry from every valid journal block.
-	 */
-	result = vdo_allocate(repair->entry_count, struct numbered_block_mapping,
-			      __func__, &repair->entries);
-	if (result != VDO_SUCCESS)
-		return result;
+	if (before_recovery_point(&repair->tail_recovery_point, &end))
+		end = repair->tail_recovery_point;
 
-	for (; before_recovery_point(&recovery_point, &repair->tail_recovery_point);
+	for (; before_recovery_point(&recovery_point, &end);
 	     increment_recovery_point(&recovery_point)) {
 		struct recovery_journal_entry entry = get_entry(repair, &recovery_point);
+		int result;
 
-		result = validate_recovery_journal_entry(vdo, &entry);
-		if (result != VDO_SUCCESS) {
-			vdo_enter_read_only_mode(vdo, result);
+		result = validate_recovery_journal_entry(extraction->completion.vdo, &entry);
+		if (result != VDO_SUCCESS)
 			return result;
-		}
 
-		repair->entries[repair->block_map_entry_count] =
-			(struct numbered_block_mapping) {
-			.block_map_slot = entry.slot,
-			.block_map_entry = vdo_pack_block_map_entry(entry.mapping.pbn,
-								    entry.mapping.state),
-			.number = repair->block_map_entry_count,
-		};
-		repair->block_map_entry_count++;
+		add_mapping(extraction, &entry);
 	}
 
-	result = VDO_ASSERT((repair->block_map_entry_count <= repair->entry_count),
-			    "approximate entry count is an upper bound");
-	if (result != VDO_SUCCESS)
-		vdo_enter_read_only_mode(vdo, result);
-
-	return result;
+	return VDO_SUCCESS;
 }
 
 /**
@@ -1692,11 +2050,14 @@ static int parse_journal_for_recovery(struct repair_completion *repair)
 		     (unsigned long long) repair->highest_tail,
 		     (unsigned long long) repair->tail);
 
-	result = extract_new_mappings(repair);
-	if (result != VDO_SUCCESS)
-		return result;
-
-	return compute_usages(repair);
+	/*
+	 * Allocate an array of numbered_block_mapping structs just large enough to transcribe
+	 * every packed_recovery_journal_entry from every valid journal block. The entries are
+	 * extracted by extract_journal_entries().
+	 */
+	repair->entries_per_block = journal->entries_per_block;
+	return vdo_allocate(repair->entry_count, struct numbered_block_mapping, __func__,
+			    &repair->entries);
 }
 
 static int parse_journal(struct repair_completion *repair)
@@ -1709,17 +2070,176 @@ static int parse_journal(struct repair_completion *repair)
 		parse_journal_for_recovery(repair));
 }
 
+/**
+ * finish_recovery_extraction() - Finish parsing the journal for recovery once the new mappings
+ *                                have been extracted.
+ * @repair: The repair completion.
+ * @result: The result of the extraction.
+ *
+ * Return: VDO_SUCCESS or an error.
+ */
+static int finish_recovery_extraction(struct repair_completion *repair, int result)
+{
+	struct vdo *vdo = repair->completion.vdo;
+
+	if (result == VDO_SUCCESS)
+		result = VDO_ASSERT((repair->block_map_entry_count <= repair->entry_count),
+				    "approximate entry count is an upper bound");
+
+	if (result != VDO_SUCCESS) {
+		vdo_enter_read_only_mode(vdo, result);
+		return result;
+	}
+
+	return compute_usages(repair);
+}
+
+/**
+ * finish_extraction() - Note that a range of the journal has been extracted, and once all of
+ *                       them have, gather up the entries and go on to recover the block map.
+ * @completion: The extraction of the range.
+ */
+static void finish_extraction(struct vdo_completion *completion)
+{
+	struct repair_completion *repair = completion->parent;
+	struct vdo *vdo = completion->vdo;
+	int result = VDO_SUCCESS;
+	unsigned int i;
+
+	vdo_assert_on_admin_thread(vdo, __func__);
+	if (++repair->extractions_complete < repair->extraction_count)
+		return;
+
+	/* Close up the gaps left by ranges with fewer entries than they had room for. */
+	repair->block_map_entry_count = 0;
+	for (i = 0; i < repair->extraction_count; i++) {
+		struct journal_extraction *extraction = &repair->extractions[i];
+
+		if (result == VDO_SUCCESS)
+			result = extraction->completion.result;
+
+		if (extraction->start != repair->block_map_entry_count)
+			memmove(&repair->entries[repair->block_map_entry_count],
+				&repair->entries[extraction->start],
+				extraction->count * sizeof(struct numbered_block_mapping));
+
+		repair->block_map_entry_count += extraction->count;
+	}
+
+	vdo_log_info("Extracted %zu block map entries from the recovery journal with %u threads in %u ms",
+		     repair->block_map_entry_count, repair->extraction_count,
+		     jiffies_to_msecs(jiffies - repair->phase_start));
+	vdo_free(vdo_forget(repair->extractions));
+
+	if (!vdo_state_requires_read_only_rebuild(vdo->load_state))
+		result = finish_recovery_extraction(repair, result);
+
+	prepare_repair_completion(repair, recover_block_map, VDO_ZONE_TYPE_LOGICAL);
+	vdo_continue_completion(&repair->completion, result);
+}
+
+/**
+ * extract_journal_range() - Extract the block map entries from a range of the journal.
+ * @completion: The extraction of the range.
+ *
+ * This callback runs on a cpu thread, so the ranges are extracted in parallel.
+ */
+static void extract_journal_range(struct vdo_completion *completion)
+{
+	struct journal_extraction *extraction =
+		container_of(completion, struct journal_extraction, completion);
+	struct repair_completion *repair = completion->parent;
+	struct vdo *vdo = completion->vdo;
+	int result = VDO_SUCCESS;
+
+	if (vdo_state_requires_read_only_rebuild(vdo->load_state)) {
+		sequence_number_t i;
+
+		for (i = extraction->first; i < extraction->end; i++)
+			extract_entries_from_block(extraction, vdo->recovery_journal, i,
+						   repair->format, repair->entries_per_block);
+	} else {
+		result = extract_recovery_entries(extraction);
+	}
+
+	vdo_set_completion_result(completion, result);
+	vdo_launch_completion_callback(completion, finish_extraction,
+				       vdo->thread_config.admin_thread);
+}
+
+/**
+ * extract_journal_entries() - Divide the journal from the block map head up to a given block
+ *                             between the cpu threads, and extract the entries to be applied to
+ *                             the block map in parallel.
+ * @repair: The repair completion.
+ * @end: The sequence number just beyond the last block to extract.
+ *
+ * Each range of blocks is extracted into its own part of the entry array, numbered by position,
+ * so that the entries remain in journal order once the ranges are put back together.
+ *
+ * Return: VDO_SUCCESS or an error.
+ */
+static int extract_journal_entries(struct repair_completion *repair, sequence_number_t end)
+{
+	struct vdo *vdo = repair->completion.vdo;
+	block_count_t blocks = end - repair->block_map_head;
+	sequence_number_t first = repair->block_map_head;
+	unsigned int count, i;
+	int result;
+
+	count = min_t(block_count_t, vdo->device_config->thread_counts.cpu_threads,
+		      DIV_ROUND_UP(blocks, MINIMUM_BLOCKS_PER_EXTRACTION));
+	result = vdo_allocate(count, struct journal_extraction, __func__, &repair->extractions);
+	if (result != VDO_SUCCESS)
+		return result;
+
+	repair->extraction_count = count;
+	repair->extractions_complete = 0;
+	repair->phase_start = jiffies;
+	for (i = 0; i < count; i++) {
+		struct journal_extraction *extraction = &repair->extractions[i];
+		sequence_number_t last = repair->block_map_head + ((blocks * (i + 1)) / count);
+
+		*extraction = (struct journal_extraction) {
+			.first = first,
+			.end = last,
+			.start = (first - repair->block_map_head) * repair->entries_per_block,
+		};
+		vdo_initialize_completion(&extraction->completion, vdo,
+					  VDO_JOURNAL_EXTRACTION_COMPLETION);
+		extraction->completion.parent = repair;
+		vdo_launch_completion_callback(&extraction->completion, extract_journal_range,
+					       vdo->thread_config.cpu_thread);
+		first = last;
+	}
+
+	return VDO_SUCCESS;
+}
+
 static void finish_journal_load(struct vdo_completion *completion)
 {
 	struct repair_completion *repair = completion->parent;
+	sequence_number_t end;
+	int result;
 
 	if (++repair->vios_complete != repair->vio_count)
 		return;
 
-	vdo_log_info("Finished reading recovery journal");
+	vdo_log_info("Finished reading recovery journal in %u ms",
+		     jiffies_to_msecs(jiffies - repair->phase_start));
 	uninitialize_vios(repair);
 	prepare_repair_completion(repair, recover_block_map, VDO_ZONE_TYPE_LOGICAL);
-	vdo_continue_completion(&repair->completion, parse_journal(repair));
+	result = parse_journal(repair);
+	if ((result != VDO_SUCCESS) || (repair->entries == NULL)) {
+		vdo_continue_completion(&repair->completion, result);
+		return;
+	}
+
+	end = (vdo_state_requires_read_only_rebuild(repair->completion.vdo->load_state) ?
+	       repair->highest_tail : repair->tail_recovery_point.sequence_number) + 1;
+	result = extract_journal_entries(repair, end);
+	if (result != VDO_SUCCESS)
+		vdo_continue_completion(&repair->completion, result);
 }
 
 static void handle_journal_load_error(struct vdo_completion *completion)
@@ -1811,6 +2331,7 @@ void vdo_repair(struct vdo_completion *parent)
 		remaining -= blocks;
 	}
 
+	repair->phase_start = jiffies;
 	for (vio_count = 0; vio_count < repair->vio_count;
 	     vio_count++, pbn += MAX_BLOCKS_PER_VIO) {
 		vdo_submit_metadata_vio(&repair->vios[vio_count], pbn, read_journal_endio,
@@ -7,7 +7,9 @@
 
 #include <linux/atomic.h>
 #include <linux/bio.h>
+#include <linux/bitops.h>
 #include <linux/err.h>
+#include <linux/jiffies.h>
 #include <linux/log2.h>
 #include <linux/min_heap.h>
 #include <linux/minmax.h>
@@ -41,6 +43,9 @@
 static const u64 BYTES_PER_WORD = sizeof(u64);
 static const bool NORMAL_OPERATION = true;
 
+/* The number of slabs each slab scrubber keeps in progress at once */
+unsigned int vdo_slab_scrubbing_depth = SLAB_SCRUBBER_DEPTH;
+
 /**
  * get_lock() - Get the lock object for a slab journal block by sequence number.
  * @journal: vdo_slab journal to retrieve from.
@@ -1131,6 +1136,22 @@ STATIC vdo_refcount_t * __must_check get_reference_counters_for_block(struct ref
 	return &block->slab->counters[block_index * COUNTS_PER_BLOCK];
 }
 
+/**
+ * update_full_block_summary() - Record in its slab whether a reference block has any free
+ *                               counters after its allocated count has changed.
+ * @block: The reference_block in question.
+ */
+static inline void update_full_block_summary(struct reference_block *block)
+{
+	struct vdo_slab *slab = block->slab;
+	size_t block_index = block - slab->reference_blocks;
+
+	if (block->allocated_count == COUNTS_PER_BLOCK)
+		__set_bit(block_index, slab->full_blocks);
+	else
+		__clear_bit(block_index, slab->full_blocks);
+}
+
 /**
  * pack_reference_block() - Copy data from a reference block to a buffer ready to be written out.
  * @block: The block to copy.
@@ -1429,6 +1450,7 @@ static int increment_for_data(struct vdo_slab *slab, struct reference_block *blo
 	case RS_FREE:
 		*counter_ptr = 1;
 		block->allocated_count++;
+		update_full_block_summary(block);
 		slab->free_blocks--;
 		if (adjust_block_count)
 			adjust_free_block_count(slab, false);
@@ -1497,6 +1519,7 @@ static int decrement_for_data(struct vdo_slab *slab, struct reference_block *blo
 
 		*counter_ptr = EMPTY_REFERENCE_COUNT;
 		block->allocated_count--;
+		update_full_block_summary(block);
 		slab->free_blocks++;
 		if (adjust_block_count)
 			adjust_free_block_count(slab, true);
@@ -1545,6 +1568,7 @@ static int increment_for_block_map(struct vdo_slab *slab, struct reference_block
 
 		*counter_ptr = MAXIMUM_REFERENCE_COUNT;
 		block->allocated_count++;
+		update_full_block_summary(block);
 		slab->free_blocks--;
 		if (adjust_block_count)
 			adjust_free_block_count(slab, false);
@@ -1901,34 +1925,38 @@ static void reset_search_cursor(struct vdo_slab *slab)
 
 /**
  * advance_search_cursor() - Advance the search cursor to the start of the next reference block in
- *                           a slab,
+ *                           a slab which has free counters,
  *
- * Wraps around to the first reference block if the current block is the last reference block.
+ * Full reference blocks are skipped using the slab's summary of them. Wraps around to the first
+ * reference block if there is no such block after the current one.
  *
- * Return: true unless the cursor was at the last reference block.
+ * Return: true unless there was no reference block with free counters after the current block.
  */
 static bool advance_search_cursor(struct vdo_slab *slab)
 {
 	struct search_cursor *cursor = &slab->search_cursor;
+	size_t block_index = cursor->block - cursor->first_block;
 
 	/*
-	 * If we just finished searching the last reference block, then wrap back around to the
-	 * start of the array.
+	 * If we just finished searching the last reference block which might have a free counter,
+	 * then wrap back around to the start of the array.
 	 */
-	if (cursor->block == cursor->last_block) {
+	block_index = find_next_zero_bit(slab->full_blocks, slab->reference_block_count,
+					 block_index + 1);
+	if (block_index >= slab->reference_block_count) {
 		reset_search_cursor(slab);
 		return false;
 	}
 
-	/* We're not already at the end, so advance to cursor to the next block. */
-	cursor->block++;
-	cursor->index = cursor->end_index;
+	/* Advance the cursor to the next block which is not full. */
+	cursor->block = &cursor->first_block[block_index];
+	cursor->index = block_index * COUNTS_PER_BLOCK;
 
 	if (cursor->block == cursor->last_block) {
 		/* The last reference block will usually be a runt. */
 		cursor->end_index = slab->block_count;
 	} else {
-		cursor->end_index += COUNTS_PER_BLOCK;
+		cursor->end_index = cursor->index + COUNTS_PER_BLOCK;
 	}
 
 	return true;
@@ -2004,6 +2032,24 @@ STATIC int replay_reference_count_change(struct vdo_slab *slab,
 	return VDO_SUCCESS;
 }
 
+/**
+ * zero_byte_mask() - Get a mask of the zero counters in a word-sized range of reference counters.
+ * @word_ptr: A pointer to the eight counter bytes to check.
+ *
+ * The high bit of each byte of the mask is set if the corresponding counter may be zero. A borrow
+ * can also set the bit for a counter of one which follows a zero counter, but never for a counter
+ * before the first zero, so the lowest set bit always identifies the first zero counter, and the
+ * mask is zero if and only if no counter is.
+ *
+ * Return: The mask, in which byte n corresponds to word_ptr[n].
+ */
+static inline u64 zero_byte_mask(const u8 *word_ptr)
+{
+	u64 word = get_unaligned_le64(word_ptr);
+
+	return (word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;
+}
+
 /**
  * find_zero_byte_in_word() - Find the array index of the first zero byte in word-sized range of
  *                            reference counters.
@@ -2020,19 +2066,12 @@ static inline slab_block_number find_zero_byte_in_word(const u8 *word_ptr,
 						       slab_block_number start_index,
 						       slab_block_number fail_index)
 {
-	u64 word = get_unaligned_le64(word_ptr);
+	u64 mask = zero_byte_mask(word_ptr);
 
-	/* This looks like a loop, but GCC will unroll the eight iterations for us. */
-	unsigned int offset;
+	if (mask == 0)
+		return fail_index;
 
-	for (offset = 0; offset < BYTES_PER_WORD; offset++) {
-		/* Assumes little-endian byte order, which we have on X86. */
-		if ((word & 0xFF) == 0)
-			return (start_index + offset);
-		word >>= 8;
-	}
-
-	return fail_index;
+	return start_index + (__ffs64(mask) / BITS_PER_BYTE);
 }
 
 /**
@@ -2071,7 +2110,25 @@ STATIC bool find_free_block(const struct vdo_slab *slab, slab_block_number *inde
 	next_counter += BYTES_PER_WORD;
 
 	/*
-	 * Now we're word-aligned; check an word at a time until we find a word containing a zero.
+	 * Skip over runs of four words with no zero counters using a single branch for each run.
+	 * Only runs which lie entirely within the range are checked here, so the word search below
+	 * will find any zero in the run which stops this loop.
+	 */
+	while ((next_index + (4 * BYTES_PER_WORD)) <= end_index) {
+		u64 mask = (zero_byte_mask(next_counter) |
+			    zero_byte_mask(next_counter + BYTES_PER_WORD) |
+			    zero_byte_mask(next_counter + (2 * BYTES_PER_WORD)) |
+			    zero_byte_mask(next_counter + (3 * BYTES_PER_WORD)));
+
+		if (mask != 0)
+			break;
+
+		next_index += 4 * BYTES_PER_WORD;
+		next_counter += 4 * BYTES_PER_WORD;
+	}
+
+	/*
+	 * Now check a word at a time until we find a word containing a zero.
 	 * (Array is padded so reading past end is safe.)
 	 */
 	while (next_counter < end_counter) {
@@ -2153,6 +2210,7 @@ static void make_provisional_reference(struct vdo_slab *slab,
 
 	/* Account for the allocation. */
 	block->allocated_count++;
+	update_full_block_summary(block);
 	slab->free_blocks--;
 }
 
@@ -2292,6 +2350,7 @@ static void unpack_reference_block(struct packed_reference_block *packed,
 	}
 
 	block->allocated_count = count_valid_references(counters);
+	update_full_block_summary(block);
 }
 
 /**
@@ -2462,6 +2521,14 @@ STATIC int allocate_slab_counters(struct vdo_slab *slab)
 		return result;
 	}
 
+	result = vdo_allocate(BITS_TO_LONGS(slab->reference_block_count), unsigned long,
+			      "full reference blocks", &slab->full_blocks);
+	if (result != VDO_SUCCESS) {
+		vdo_free(vdo_forget(slab->counters));
+		vdo_free(vdo_forget(slab->reference_blocks));
+		return result;
+	}
+
 	slab->search_cursor.first_block = slab->reference_blocks;
 	slab->search_cursor.last_block = &slab->reference_blocks[slab->reference_block_count - 1];
 	reset_search_cursor(slab);
@@ -2700,13 +2767,52 @@ STATIC void initiate_slab_action(struct admin_state *state)
 	vdo_finish_operation(state, VDO_INVALID_ADMIN_STATE);
 }
 
+/**
+ * get_slab_for_waiters() - Choose the slab to scrub when allocation is waiting for a clean slab.
+ * @scrubber: The slab scrubber.
+ *
+ * Of the next few queued slabs, prefer one whose journal need not be read, since it will be ready
+ * soonest, and otherwise the one which the slab summary says has the most free blocks.
+ *
+ * Return: The slab to scrub or NULL if there are none.
+ */
+static struct vdo_slab *get_slab_for_waiters(struct slab_scrubber *scrubber)
+{
+	struct block_allocator *allocator =
+		container_of(scrubber, struct block_allocator, scrubber);
+	struct vdo_slab *slab, *best = NULL;
+	unsigned int best_score = 0;
+	unsigned int examined = 0;
+
+	list_for_each_entry(slab, &scrubber->slabs, allocq_entry) {
+		const struct slab_summary_entry *entry =
+			&allocator->summary_entries[slab->slab_number];
+		unsigned int score = entry->fullness_hint;
+
+		if (!entry->is_dirty)
+			score += BIT(VDO_SLAB_SUMMARY_FULLNESS_HINT_BITS);
+
+		if ((best == NULL) || (score > best_score)) {
+			best = slab;
+			best_score = score;
+		}
+
+		if (++examined == SLAB_SCRUBBER_LOOKAHEAD)
+			break;
+	}
+
+	return best;
+}
+
 /**
  * get_next_slab() - Get the next slab to scrub.
  * @scrubber: The slab scrubber.
+ * @allocation_waiting: Whether allocation is waiting for a clean slab.
  *
  * Return: The next slab to scrub or NULL if there are none.
  */
-static struct vdo_slab *get_next_slab(struct slab_scrubber *scrubber)
+static struct vdo_slab *get_next_slab(struct slab_scrubber *scrubber,
+				      bool allocation_waiting)
 {
 	struct vdo_slab *slab;
 
@@ -2715,6 +2821,9 @@ static struct vdo_slab *get_next_slab(struct slab_scrubber *scrubber)
 	if (slab != NULL)
 		return slab;
 
+	if (allocation_waiting)
+		return get_slab_for_waiters(scrubber);
+
 	return list_first_entry_or_null(&scrubber->slabs, struct vdo_slab,
 					allocq_entry);
 }
@@ -2727,23 +2836,67 @@ static struct vdo_slab *get_next_slab(struct slab_scrubber *scrubber)
  */
 static inline bool __must_check has_slabs_to_scrub(struct slab_scrubber *scrubber)
 {
-	return (get_next_slab(scrubber) != NULL);
+	return (!list_empty(&scrubber->high_priority_slabs) || !list_empty(&scrubber->slabs));
+}
+
+/**
+ * may_scrub_next_slab() - Check whether a scrubber has a slab it should start scrubbing.
+ * @scrubber: The scrubber to check.
+ *
+ * Return: true if there is a slab to scrub which the scrubber is not restricted from scrubbing.
+ */
+static inline bool __must_check may_scrub_next_slab(struct slab_scrubber *scrubber)
+{
+	if (scrubber->high_priority_only)
+		return !list_empty(&scrubber->high_priority_slabs);
+
+	return has_slabs_to_scrub(scrubber);
 }
 
 /**
- * uninitialize_scrubber_vio() - Clean up the slab_scrubber's vio.
+ * uninitialize_scrubber_vios() - Clean up the slab_scrubber's vios.
  * @scrubber: The scrubber.
  */
-static void uninitialize_scrubber_vio(struct slab_scrubber *scrubber)
+static void uninitialize_scrubber_vios(struct slab_scrubber *scrubber)
 {
-	vdo_free(vdo_forget(scrubber->vio.data));
-	free_vio_components(&scrubber->vio);
+	unsigned int i;
+
+	for (i = 0; i < SLAB_SCRUBBER_DEPTH; i++) {
+		vdo_free(vdo_forget(scrubber->slots[i].vio.data));
+		free_vio_components(&scrubber->slots[i].vio);
+	}
+}
+
+/**
+ * as_scrubbing_slot() - Convert a scrubber vio's completion to the slot which owns it.
+ * @completion: The completion to convert.
+ *
+ * Return: The scrubbing slot.
+ */
+static inline struct scrubbing_slot *as_scrubbing_slot(struct vdo_completion *completion)
+{
+	return container_of(as_vio(completion), struct scrubbing_slot, vio);
+}
+
+/**
+ * release_scrubbing_slot() - Mark a slot idle once it is done with its slab.
+ * @slot: The slot to release.
+ *
+ * Return: The scrubber which owns the slot.
+ */
+static struct slab_scrubber *release_scrubbing_slot(struct scrubbing_slot *slot)
+{
+	struct slab_scrubber *scrubber = &slot->slab->allocator->scrubber;
+
+	slot->slab = NULL;
+	scrubber->active_slots--;
+	return scrubber;
 }
 
 /**
  * finish_scrubbing() - Stop scrubbing, either because there are no more slabs to scrub or because
  *                      there's been an error.
- * @scrubber: The scrubber.
+ * @scrubber: The scrubber, which must have no slabs in progress.
  */
 static void finish_scrubbing(struct slab_scrubber *scrubber, int result)
 {
@@ -2753,11 +2906,11 @@ static void finish_scrubbing(struct slab_scrubber *scrubber, int result)
 		container_of(scrubber, struct block_allocator, scrubber);
 
 	if (done)
-		uninitialize_scrubber_vio(scrubber);
+		uninitialize_scrubber_vios(scrubber);
 
 	if (scrubber->high_priority_only) {
 		scrubber->high_priority_only = false;
-		vdo_fail_completion(vdo_forget(scrubber->vio.completion.parent), result);
+		vdo_fail_completion(vdo_forget(scrubber->parent), result);
 	} else if (done && (atomic_add_return(-1, &allocator->depot->zones_to_scrub) == 0)) {
 		/* All of our slabs were scrubbed, and we're the last allocator to finish. */
 		enum vdo_state prior_state =
@@ -2800,6 +2953,29 @@ static void finish_scrubbing(struct slab_scrubber *scrubber, int result)
 
 static void scrub_next_slab(struct slab_scrubber *scrubber);
 
+/**
+ * report_scrubbing_progress() - Log the progress of a scrubber each time it finishes another
+ *                               quarter of its slabs.
+ * @scrubber: The scrubber, which has just finished a slab.
+ *
+ * This lets each physical zone's progress be followed when reference counts are being loaded
+ * lazily as well as when slabs are being recovered.
+ */
+static void report_scrubbing_progress(struct slab_scrubber *scrubber)
+{
+	struct block_allocator *allocator =
+		container_of(scrubber, struct block_allocator, scrubber);
+	unsigned int scrubbed = scrubber->slabs_scrubbed;
+	unsigned int total = scrubbed + scrubber->slab_count;
+
+	if (((scrubbed * 4) / total) == (((scrubbed - 1) * 4) / total))
+		return;
+
+	vdo_log_info("physical zone %u has scrubbed %u of %u slabs in %u ms",
+		     allocator->zone_number, scrubbed, total,
+		     jiffies_to_msecs(jiffies - scrubber->start_jiffies));
+}
+
 /**
  * slab_scrubbed() - Notify the scrubber that a slab has been scrubbed.
  * @completion: The slab rebuild completion.
@@ -2808,26 +2984,44 @@ static void scrub_next_slab(struct slab_scrubber *scrubber);
  */
 static void slab_scrubbed(struct vdo_completion *completion)
 {
-	struct slab_scrubber *scrubber =
-		container_of(as_vio(completion), struct slab_scrubber, vio);
-	struct vdo_slab *slab = scrubber->slab;
+	struct scrubbing_slot *slot = as_scrubbing_slot(completion);
+	struct vdo_slab *slab = slot->slab;
+	struct slab_scrubber *scrubber;
 
 	slab->status = VDO_SLAB_REBUILT;
 	queue_slab(slab);
 	reopen_slab_journal(slab);
+	scrubber = release_scrubbing_slot(slot);
 	WRITE_ONCE(scrubber->slab_count, scrubber->slab_count - 1);
+	WRITE_ONCE(scrubber->slabs_scrubbed, scrubber->slabs_scrubbed + 1);
+	if (slab->loading_lazily) {
+		struct block_allocator_statistics *statistics = &slab->allocator->statistics;
+
+		slab->loading_lazily = false;
+		WRITE_ONCE(statistics->lazy_slabs_loaded, statistics->lazy_slabs_loaded + 1);
+	}
+
+	report_scrubbing_progress(scrubber);
 	scrub_next_slab(scrubber);
 }
 
 /**
  * abort_scrubbing() - Abort scrubbing due to an error.
- * @scrubber: The slab scrubber.
+ * @slot: The slot whose slab could not be scrubbed.
  * @result: The error.
+ *
+ * Scrubbing finishes once any other slabs in progress are done.
  */
-static void abort_scrubbing(struct slab_scrubber *scrubber, int result)
+static void abort_scrubbing(struct scrubbing_slot *slot, int result)
 {
-	vdo_enter_read_only_mode(scrubber->vio.completion.vdo, result);
-	finish_scrubbing(scrubber, result);
+	struct slab_scrubber *scrubber;
+
+	vdo_enter_read_only_mode(slot->vio.completion.vdo, result);
+	scrubber = release_scrubbing_slot(slot);
+	if (scrubber->result == VDO_SUCCESS)
+		scrubber->result = result;
+
+	scrub_next_slab(scrubber);
 }
 
 /**
@@ -2839,8 +3033,7 @@ static void handle_scrubber_error(struct vdo_completion *completion)
 	struct vio *vio = as_vio(completion);
 
 	vio_record_metadata_io_error(vio);
-	abort_scrubbing(container_of(vio, struct slab_scrubber, vio),
-			completion->result);
+	abort_scrubbing(container_of(vio, struct scrubbing_slot, vio), completion->result);
 }
 
 /**
@@ -2901,15 +3094,14 @@ static int apply_block_entries(struct packed_slab_journal_block *block,
 static void apply_journal_entries(struct vdo_completion *completion)
 {
 	int result;
-	struct slab_scrubber *scrubber =
-		container_of(as_vio(completion), struct slab_scrubber, vio);
-	struct vdo_slab *slab = scrubber->slab;
+	struct scrubbing_slot *slot = as_scrubbing_slot(completion);
+	struct vdo_slab *slab = slot->slab;
 	struct slab_journal *journal = &slab->journal;
 
 	/* Find the boundaries of the useful part of the journal. */
 	sequence_number_t tail = journal->tail;
 	tail_block_offset_t end_index = (tail - 1) % journal->size;
-	char *end_data = scrubber->vio.data + (end_index * VDO_BLOCK_SIZE);
+	char *end_data = slot->vio.data + (end_index * VDO_BLOCK_SIZE);
 	struct packed_slab_journal_block *end_block =
 		(struct packed_slab_journal_block *) end_data;
 
@@ -2922,7 +3114,7 @@ static void apply_journal_entries(struct vdo_completion *completion)
 	sequence_number_t sequence;
 
 	for (sequence = head; sequence < tail; sequence++) {
-		char *block_data = scrubber->vio.data + (index * VDO_BLOCK_SIZE);
+		char *block_data = slot->vio.data + (index * VDO_BLOCK_SIZE);
 		struct packed_slab_journal_block *block =
 			(struct packed_slab_journal_block *) block_data;
 		struct slab_journal_block_header header;
@@ -2938,13 +3130,13 @@ static void apply_journal_entries(struct vdo_completion *completion)
 			/* The block is not what we expect it to be. */
 			vdo_log_error("vdo_slab journal block for slab %u was invalid",
 				      slab->slab_number);
-			abort_scrubbing(scrubber, VDO_CORRUPT_JOURNAL);
+			abort_scrubbing(slot, VDO_CORRUPT_JOURNAL);
 			return;
 		}
 
 		result = apply_block_entries(block, header.entry_count, sequence, slab);
 		if (result != VDO_SUCCESS) {
-			abort_scrubbing(scrubber, result);
+			abort_scrubbing(slot, result);
 			return;
 		}
 
@@ -2963,7 +3155,7 @@ static void apply_journal_entries(struct vdo_completion *completion)
 						      &ref_counts_point),
 			    "Refcounts are not more accurate than the slab journal");
 	if (result != VDO_SUCCESS) {
-		abort_scrubbing(scrubber, result);
+		abort_scrubbing(slot, result);
 		return;
 	}
 
@@ -2978,42 +3170,69 @@ static void apply_journal_entries(struct vdo_completion *completion)
 static void read_slab_journal_endio(struct bio *bio)
 {
 	struct vio *vio = bio->bi_private;
-	struct slab_scrubber *scrubber = container_of(vio, struct slab_scrubber, vio);
+	struct scrubbing_slot *slot = container_of(vio, struct scrubbing_slot, vio);
 
 	continue_vio_after_io(bio->bi_private, apply_journal_entries,
-			      scrubber->slab->allocator->thread_id);
+			      slot->slab->allocator->thread_id);
 }
 
 /**
- * start_scrubbing() - Read the current slab's journal from disk now that it has been flushed.
- * @completion: The scrubber's vio completion.
+ * start_scrubbing() - Read a slab's journal from disk now that it has been flushed.
+ * @completion: The vio completion of the slot scrubbing the slab.
  *
- * This callback is registered in scrub_next_slab().
+ * This callback is registered in start_next_slab().
  */
 static void start_scrubbing(struct vdo_completion *completion)
 {
-	struct slab_scrubber *scrubber =
-		container_of(as_vio(completion), struct slab_scrubber, vio);
-	struct vdo_slab *slab = scrubber->slab;
+	struct scrubbing_slot *slot = as_scrubbing_slot(completion);
+	struct vdo_slab *slab = slot->slab;
 
 	if (!slab->allocator->summary_entries[slab->slab_number].is_dirty) {
 		slab_scrubbed(completion);
 		return;
 	}
 
-	vdo_submit_metadata_vio(&scrubber->vio, slab->journal_origin,
+	vdo_submit_metadata_vio(&slot->vio, slab->journal_origin,
 				read_slab_journal_endio, handle_scrubber_error,
 				REQ_OP_READ);
 }
 
 /**
- * scrub_next_slab() - Scrub the next slab if there is one.
+ * start_next_slab() - Start scrubbing the next slab in an idle slot.
+ * @scrubber: The scrubber, which must have an idle slot.
+ * @allocation_waiting: Whether allocation is waiting for a clean slab.
+ */
+static void start_next_slab(struct slab_scrubber *scrubber, bool allocation_waiting)
+{
+	struct vdo_slab *slab = get_next_slab(scrubber, allocation_waiting);
+	struct scrubbing_slot *slot = scrubber->slots;
+	struct vdo_completion *completion;
+
+	while (slot->slab != NULL)
+		slot++;
+
+	list_del_init(&slab->allocq_entry);
+	slot->slab = slab;
+	scrubber->active_slots++;
+	completion = &slot->vio.completion;
+	vdo_prepare_completion(completion, start_scrubbing, handle_scrubber_error,
+			       slab->allocator->thread_id, NULL);
+	vdo_start_operation_with_waiter(&slab->state, VDO_ADMIN_STATE_SCRUBBING,
+					completion, initiate_slab_action);
+}
+
+/**
+ * scrub_next_slab() - Keep as many slabs being scrubbed as the scrubber has slots for.
  * @scrubber: The scrubber.
+ *
+ * Once no slabs are in progress, either finish scrubbing, if there are no more slabs to scrub or
+ * there has been an error, or finish draining.
  */
 static void scrub_next_slab(struct slab_scrubber *scrubber)
 {
-	struct vdo_completion *completion = &scrubber->vio.completion;
-	struct vdo_slab *slab;
+	struct vdo *vdo = container_of(scrubber, struct block_allocator, scrubber)->depot->vdo;
+	bool allocation_waiting = vdo_waitq_has_waiters(&scrubber->waiters);
+	unsigned int depth;
 
 	/*
 	 * Note: this notify call is always safe only because scrubbing can only be started when
@@ -3021,27 +3240,39 @@ static void scrub_next_slab(struct slab_scrubber *scrubber)
 	 */
 	vdo_waitq_notify_all_waiters(&scrubber->waiters, NULL, NULL);
 
-	if (vdo_is_read_only(completion->vdo)) {
-		finish_scrubbing(scrubber, VDO_READ_ONLY);
+	/* A slab which was finished while starting another will be replaced by the loop below. */
+	if (scrubber->launching)
+		return;
+
+	/* The tunable is clamped when set, but never trust it to index the slots. */
+	depth = min_t(unsigned int, READ_ONCE(vdo_slab_scrubbing_depth), SLAB_SCRUBBER_DEPTH);
+	scrubber->launching = true;
+	while ((scrubber->active_slots < depth) &&
+	       (scrubber->result == VDO_SUCCESS) && !vdo_is_read_only(vdo) &&
+	       may_scrub_next_slab(scrubber) &&
+	       !vdo_is_state_draining(&scrubber->admin_state))
+		start_next_slab(scrubber, allocation_waiting);
+	scrubber->launching = false;
+
+	if (scrubber->active_slots > 0)
+		return;
+
+	if (scrubber->result != VDO_SUCCESS) {
+		finish_scrubbing(scrubber, scrubber->result);
 		return;
 	}
 
-	slab = get_next_slab(scrubber);
-	if ((slab == NULL) ||
-	    (scrubber->high_priority_only && list_empty(&scrubber->high_priority_slabs))) {
-		finish_scrubbing(scrubber, VDO_SUCCESS);
+	if (vdo_is_read_only(vdo)) {
+		finish_scrubbing(scrubber, VDO_READ_ONLY);
 		return;
 	}
 
-	if (vdo_finish_draining(&scrubber->admin_state))
+	if (!may_scrub_next_slab(scrubber)) {
+		finish_scrubbing(scrubber, VDO_SUCCESS);
 		return;
+	}
 
-	list_del_init(&slab->allocq_entry);
-	scrubber->slab = slab;
-	vdo_prepare_completion(completion, start_scrubbing, handle_scrubber_error,
-			       slab->allocator->thread_id, completion->parent);
-	vdo_start_operation_with_waiter(&slab->state, VDO_ADMIN_STATE_SCRUBBING,
-					completion, initiate_slab_action);
+	vdo_finish_draining(&scrubber->admin_state);
 }
 
 /**
@@ -3053,8 +3284,9 @@ STATIC void scrub_slabs(struct block_allocator *allocator, struct vdo_completion
 {
 	struct slab_scrubber *scrubber = &allocator->scrubber;
 
-	scrubber->vio.completion.parent = parent;
+	scrubber->parent = parent;
 	scrubber->high_priority_only = (parent != NULL);
+	scrubber->result = VDO_SUCCESS;
 	if (!has_slabs_to_scrub(scrubber)) {
 		finish_scrubbing(scrubber, VDO_SUCCESS);
 		return;
@@ -3063,7 +3295,7 @@ STATIC void scrub_slabs(struct block_allocator *allocator, struct vdo_completion
 	if (scrubber->high_priority_only &&
 	    vdo_is_priority_table_empty(allocator->prioritized_slabs) &&
 	    list_empty(&scrubber->high_priority_slabs))
-		register_slab_for_scrubbing(get_next_slab(scrubber), true);
+		register_slab_for_scrubbing(get_next_slab(scrubber, false), true);
 
 	vdo_resume_if_quiescent(&scrubber->admin_state);
 	scrub_next_slab(scrubber);
@@ -3287,6 +3519,172 @@ int vdo_allocate_block(struct block_allocator *allocator,
 	return allocate_slab_block(allocator->open_slab, block_number_ptr);
 }
 
+/**
+ * allocate_specific_block() - Allocate a particular block from the open slab if it is free.
+ * @allocator: The block_allocator.
+ * @pbn: The block to allocate.
+ *
+ * Return: true if the block was allocated.
+ */
+static bool allocate_specific_block(struct block_allocator *allocator,
+				    physical_block_number_t pbn)
+{
+	struct vdo_slab *slab = allocator->open_slab;
+	slab_block_number block_number;
+
+	if ((slab == NULL) || !is_slab_open(slab) ||
+	    (slab_block_number_from_pbn(slab, pbn, &block_number) != VDO_SUCCESS) ||
+	    (slab->counters[block_number] != EMPTY_REFERENCE_COUNT))
+		return false;
+
+	make_provisional_reference(slab, block_number);
+	adjust_free_block_count(slab, false);
+	return true;
+}
+
+/**
+ * start_run() - Reserve a run of blocks in the open slab for a sequential write stream.
+ * @allocator: The block_allocator.
+ * @stream: The stream.
+ * @lbn: The logical block corresponding to the start of the run.
+ * @pbn: The block, just allocated for lbn, at which the run starts.
+ *
+ * The blocks are reserved by moving the open slab's search cursor past them, so that other
+ * allocations will not take them until the slab is next opened. The run is cut short at the end of
+ * the reference block containing the cursor.
+ */
+static void start_run(struct block_allocator *allocator, struct allocation_stream *stream,
+		      logical_block_number_t lbn, physical_block_number_t pbn)
+{
+	struct vdo_slab *slab = allocator->open_slab;
+	struct search_cursor *cursor = &slab->search_cursor;
+	slab_block_number start = pbn - slab->start;
+	slab_block_number end = min_t(slab_block_number, start + BLOCK_ALLOCATOR_RUN_BLOCKS,
+				      cursor->end_index);
+
+	stream->run_lbn = lbn;
+	stream->run_pbn = pbn;
+	if ((start < cursor->end_index) && (end > cursor->index))
+		cursor->index = end;
+}
+
+/**
+ * find_allocation_stream() - Find the sequential write stream which a logical block continues.
+ * @allocator: The block_allocator.
+ * @lbn: The logical block being written.
+ *
+ * Return: The stream, or NULL if the block does not continue any stream.
+ */
+static struct allocation_stream *find_allocation_stream(struct block_allocator *allocator,
+							logical_block_number_t lbn)
+{
+	unsigned int i;
+
+	for (i = 0; i < BLOCK_ALLOCATOR_STREAM_COUNT; i++) {
+		struct allocation_stream *stream = &allocator->streams[i];
+
+		if (stream->next_lbn == 0)
+			continue;
+
+		if ((lbn == stream->next_lbn) ||
+		    ((stream->run_pbn != VDO_ZERO_BLOCK) && (lbn >= stream->run_lbn) &&
+		     ((lbn - stream->run_lbn) < BLOCK_ALLOCATOR_RUN_BLOCKS)))
+			return stream;
+	}
+
+	return NULL;
+}
+
+/**
+ * get_least_recently_used_stream() - Find the stream to replace when a new one starts.
+ * @allocator: The block_allocator.
+ *
+ * Return: The least recently used stream.
+ */
+static struct allocation_stream *
+get_least_recently_used_stream(struct block_allocator *allocator)
+{
+	struct allocation_stream *oldest = &allocator->streams[0];
+	unsigned int i;
+
+	for (i = 1; i < BLOCK_ALLOCATOR_STREAM_COUNT; i++) {
+		if (allocator->streams[i].last_used < oldest->last_used)
+			oldest = &allocator->streams[i];
+	}
+
+	return oldest;
+}
+
+/**
+ * vdo_allocate_block_for_lbn() - Allocate a new block for writing a logical block.
+ * @allocator: The block_allocator.
+ * @lbn: The logical block which will be written to the new block.
+ * @block_number_ptr: A pointer to receive the allocated block number.
+ *
+ * Writes to consecutive logical blocks are tracked as streams. If the allocator is reserving runs,
+ * each stream is given a run of consecutive free blocks, and blocks are taken from it so that
+ * sequential logical blocks map to sequential physical blocks. Whether or not runs are reserved,
+ * the allocator counts how often a stream's blocks are physically contiguous.
+ *
+ * Return: VDO_SUCCESS or an error code.
+ */
+int vdo_allocate_block_for_lbn(struct block_allocator *allocator, logical_block_number_t lbn,
+			       physical_block_number_t *block_number_ptr)
+{
+	int result;
+	bool in_run;
+	physical_block_number_t expected;
+	struct allocation_stream *stream = find_allocation_stream(allocator, lbn);
+
+	allocator->stream_clock++;
+	if (stream == NULL) {
+		result = vdo_allocate_block(allocator, block_number_ptr);
+		if (result != VDO_SUCCESS)
+			return result;
+
+		/* This may be the start of a stream, so replace the least recently used one. */
+		stream = get_least_recently_used_stream(allocator);
+		*stream = (struct allocation_stream) {
+			.next_lbn = lbn + 1,
+			.next_pbn = *block_number_ptr + 1,
+			.last_used = allocator->stream_clock,
+		};
+		return VDO_SUCCESS;
+	}
+
+	in_run = ((stream->run_pbn != VDO_ZERO_BLOCK) && (lbn >= stream->run_lbn) &&
+		  ((lbn - stream->run_lbn) < BLOCK_ALLOCATOR_RUN_BLOCKS));
+	expected = (in_run ? stream->run_pbn + (lbn - stream->run_lbn) : stream->next_pbn);
+	if (allocator->reserve_runs && allocate_specific_block(allocator, expected)) {
+		*block_number_ptr = expected;
+		if (!in_run)
+			start_run(allocator, stream, lbn, expected);
+	} else {
+		result = vdo_allocate_block(allocator, block_number_ptr);
+		if (result != VDO_SUCCESS)
+			return result;
+
+		if (allocator->reserve_runs)
+			start_run(allocator, stream, lbn, *block_number_ptr);
+	}
+
+	if (*block_number_ptr == expected) {
+		WRITE_ONCE(allocator->statistics.contiguous_allocations,
+			   allocator->statistics.contiguous_allocations + 1);
+	} else {
+		WRITE_ONCE(allocator->statistics.fragmented_allocations,
+			   allocator->statistics.fragmented_allocations + 1);
+	}
+
+	if (lbn >= stream->next_lbn) {
+		stream->next_lbn = lbn + 1;
+		stream->next_pbn = *block_number_ptr + 1;
+	}
+
+	stream->last_used = allocator->stream_clock;
+	return VDO_SUCCESS;
+}
+
 /**
  * vdo_enqueue_clean_slab_waiter() - Wait for a clean slab.
  * @allocator: The block_allocator on which to wait.
@@ -3330,7 +3728,12 @@ void vdo_modify_reference_count(struct vdo_completion *completion,
 	}
 
 	vdo_waitq_enqueue_waiter(&slab->journal.entry_waiters, &updater->waiter);
-	if ((slab->status != VDO_SLAB_REBUILT) && requires_reaping(&slab->journal))
+	/*
+	 * When reference counts are loaded lazily, a slab which is in use should be loaded ahead
+	 * of those which are not.
+	 */
+	if ((slab->status != VDO_SLAB_REBUILT) &&
+	    (slab->allocator->depot->lazy_ref_counts || requires_reaping(&slab->journal)))
 		register_slab_for_scrubbing(slab, true);
 
 	add_entries(&slab->journal);
@@ -3621,6 +4024,13 @@ STATIC int __must_check vdo_prepare_slabs_for_allocation(struct block_allocator
 
 	WRITE_ONCE(allocator->allocated_blocks,
 		   allocator->slab_count * depot->slab_config.data_blocks);
+
+	/* Each load starts a new scrub, which is timed and counted from its own start. */
+	WRITE_ONCE(allocator->scrubber.start_jiffies, jiffies);
+	WRITE_ONCE(allocator->scrubber.slabs_scrubbed, 0);
+	WRITE_ONCE(allocator->statistics.lazy_slabs, 0);
+	WRITE_ONCE(allocator->statistics.lazy_slabs_loaded, 0);
+
 	result = get_slab_statuses(allocator, &slab_statuses);
 	if (result != VDO_SUCCESS)
 		return result;
@@ -3662,9 +4072,16 @@ STATIC int __must_check vdo_prepare_slabs_for_allocation(struct block_allocator
 		}
 
 		slab->status = VDO_SLAB_REQUIRES_SCRUBBING;
+		slab->loading_lazily = (current_slab_status.is_clean && depot->lazy_ref_counts &&
+					(depot->load_type == VDO_SLAB_DEPOT_NORMAL_LOAD));
+		if (slab->loading_lazily)
+			WRITE_ONCE(allocator->statistics.lazy_slabs,
+				   allocator->statistics.lazy_slabs + 1);
+
 		journal = &slab->journal;
 		high_priority = ((current_slab_status.is_clean &&
-				 (depot->load_type == VDO_SLAB_DEPOT_NORMAL_LOAD)) ||
+				  !depot->lazy_ref_counts &&
+				  (depot->load_type == VDO_SLAB_DEPOT_NORMAL_LOAD)) ||
 				 (journal_length(journal) >= journal->scrubbing_threshold));
 		register_slab_for_scrubbing(slab, high_priority);
 	}
@@ -3764,8 +4181,9 @@ void vdo_dump_block_allocator(const struct block_allocator *allocator)
 		}
 	}
 
-	vdo_log_info("slab_scrubber slab_count %u waiters %zu %s%s",
-		     READ_ONCE(scrubber->slab_count),
+	vdo_log_info("slab_scrubber slab_count %u scrubbed %u active %u waiters %zu %s%s",
+		     READ_ONCE(scrubber->slab_count), READ_ONCE(scrubber->slabs_scrubbed),
+		     scrubber->active_slots,
 		     vdo_waitq_num_waiters(&scrubber->waiters),
 		     vdo_get_admin_state_code(&scrubber->admin_state)->name,
 		     scrubber->high_priority_only ? ", high_priority_only " : "");
@@ -3781,6 +4199,7 @@ STATIC void free_slab(struct vdo_slab *slab)
 	vdo_free(vdo_forget(slab->journal.locks));
 	vdo_free(vdo_forget(slab->counters));
 	vdo_free(vdo_forget(slab->reference_blocks));
+	vdo_free(vdo_forget(slab->full_blocks));
 	vdo_free(slab);
 }
 
@@ -4060,22 +4479,26 @@ STATIC int initialize_slab_scrubber(struct block_allocator *allocator)
 	struct slab_scrubber *scrubber = &allocator->scrubber;
 	block_count_t slab_journal_size =
 		allocator->depot->slab_config.slab_journal_blocks;
-	char *journal_data;
-	int result;
+	unsigned int i;
 
-	result = vdo_allocate(VDO_BLOCK_SIZE * slab_journal_size,
-			      char, __func__, &journal_data);
-	if (result != VDO_SUCCESS)
-		return result;
+	for (i = 0; i < SLAB_SCRUBBER_DEPTH; i++) {
+		char *journal_data;
+		int result;
 
-	result = allocate_vio_components(allocator->completion.vdo,
-					 VIO_TYPE_SLAB_JOURNAL,
-					 VIO_PRIORITY_METADATA,
-					 allocator, slab_journal_size,
-					 journal_data, &scrubber->vio);
-	if (result != VDO_SUCCESS) {
-		vdo_free(journal_data);
-		return result;
+		result = vdo_allocate(VDO_BLOCK_SIZE * slab_journal_size,
+				      char, __func__, &journal_data);
+		if (result != VDO_SUCCESS)
+			return result;
+
+		result = allocate_vio_components(allocator->completion.vdo,
+						 VIO_TYPE_SLAB_JOURNAL,
+						 VIO_PRIORITY_METADATA,
+						 allocator, slab_journal_size,
+						 journal_data, &scrubber->slots[i].vio);
+		if (result != VDO_SUCCESS) {
+			vdo_free(journal_data);
+			return result;
+		}
 	}
 
 	INIT_LIST_HEAD(&scrubber->high_priority_slabs);
@@ -4129,6 +4552,7 @@ static int __must_check initialize_block_allocator(struct slab_depot *depot,
 		.zone_number = zone,
 		.thread_id = vdo->thread_config.physical_threads[zone],
 		.nonce = vdo->states.vdo.nonce,
+		.reserve_runs = vdo->device_config->allocation_locality,
 	};
 
 	INIT_LIST_HEAD(&allocator->dirty_slab_journals);
@@ -4379,7 +4803,7 @@ void vdo_free_slab_depot(struct slab_depot *depot)
 			dm_kcopyd_client_destroy(vdo_forget(allocator->eraser));
 
 		uninitialize_allocator_summary(allocator);
-		uninitialize_scrubber_vio(&allocator->scrubber);
+		uninitialize_scrubber_vios(&allocator->scrubber);
 		free_vio_pool(vdo_forget(allocator->vio_pool));
 		free_vio_pool(vdo_forget(allocator->refcount_big_vio_pool));
 		vdo_free_priority_table(vdo_forget(allocator->prioritized_slabs));
@@ -4779,6 +5203,7 @@ void vdo_prepare_slab_depot_to_allocate(struct slab_depot *depot,
 					struct vdo_completion *parent)
 {
 	depot->load_type = load_type;
+	depot->lazy_ref_counts = depot->vdo->device_config->lazy_ref_counts;
 	atomic_set(&depot->zones_to_scrub, depot->zone_count);
 	vdo_schedule_action(depot->action_manager, NULL,
 			    prepare_to_allocate, NULL, parent);
@@ -4897,7 +5322,7 @@ void vdo_use_new_slabs(struct slab_depot *depot, struct vdo_completion *parent)
 }
 
 /**
- * stop_scrubbing() - Tell the scrubber to stop scrubbing after it finishes the slab it is
+ * stop_scrubbing() - Tell the scrubber to stop scrubbing after it finishes the slabs it is
  *                    currently working on.
  * @allocator: The block allocator owning the scrubber to stop.
  */
@@ -5130,6 +5555,36 @@ void vdo_scrub_all_unrecovered_slabs(struct slab_depot *depot,
 			    NULL, parent);
 }
 
+/**
+ * vdo_set_slab_scrubbing_depth() - Set the number of slabs each scrubber keeps in progress.
+ * @depth: The requested depth, which is limited to between 1 and SLAB_SCRUBBER_DEPTH.
+ */
+void vdo_set_slab_scrubbing_depth(unsigned int depth)
+{
+	WRITE_ONCE(vdo_slab_scrubbing_depth,
+		   min_t(unsigned int, max(depth, 1U), SLAB_SCRUBBER_DEPTH));
+}
+
+/**
+ * estimate_scrubbing_time() - Estimate how long a scrubber will take to finish, from the rate at
+ *                             which it has scrubbed slabs so far.
+ * @scrubber: The slab scrubber.
+ *
+ * Return: The estimated number of seconds remaining, or 0 if there is no estimate.
+ */
+static u64 estimate_scrubbing_time(const struct slab_scrubber *scrubber)
+{
+	slab_count_t remaining = READ_ONCE(scrubber->slab_count);
+	slab_count_t scrubbed = READ_ONCE(scrubber->slabs_scrubbed);
+	u64 elapsed_ms;
+
+	if ((remaining == 0) || (scrubbed == 0))
+		return 0;
+
+	elapsed_ms = jiffies_to_msecs(jiffies - READ_ONCE(scrubber->start_jiffies));
+	return DIV_ROUND_UP(elapsed_ms * remaining, (u64) scrubbed * 1000);
+}
+
 /**
  * get_block_allocator_statistics() - Get the total of the statistics from all the block allocators
  *                                    in the depot.
@@ -5152,6 +5607,16 @@ get_block_allocator_statistics(const struct slab_depot *depot)
 		totals.slab_count += allocator->slab_count;
 		totals.slabs_opened += READ_ONCE(stats->slabs_opened);
 		totals.slabs_reopened += READ_ONCE(stats->slabs_reopened);
+		totals.contiguous_allocations += READ_ONCE(stats->contiguous_allocations);
+		totals.fragmented_allocations += READ_ONCE(stats->fragmented_allocations);
+		totals.slabs_to_scrub += READ_ONCE(allocator->scrubber.slab_count);
+		totals.slabs_scrubbed += READ_ONCE(allocator->scrubber.slabs_scrubbed);
+		totals.lazy_slabs += READ_ONCE(stats->lazy_slabs);
+		totals.lazy_slabs_loaded += READ_ONCE(stats->lazy_slabs_loaded);
+		/* The allocators scrub concurrently, so the slowest one determines the total. */
+		totals.scrub_seconds_remaining =
+			max(totals.scrub_seconds_remaining,
+			    estimate_scrubbing_time(&allocator->scrubber));
 	}
 
 	return totals;
@@ -48,10 +48,22 @@ enum {
 
 	/*
 	 * The number of vios in the vio pool used for loading reference count data. A slab's
-	 * refcounts is capped at ~8MB, and we process one at a time in a zone, so 9 should be
-	 * plenty.
+	 * refcounts is capped at ~8MB, and the slabs being scrubbed in a zone share the pool, so 9
+	 * should be plenty.
 	 */
 	BLOCK_ALLOCATOR_REFCOUNT_VIO_POOL_SIZE = 9,
+
+	/* The number of sequential write streams tracked by each block allocator */
+	BLOCK_ALLOCATOR_STREAM_COUNT = 8,
+
+	/* The number of blocks reserved at a time for a sequential write stream */
+	BLOCK_ALLOCATOR_RUN_BLOCKS = 32,
+
+	/* The most slabs each slab scrubber may have in progress at once */
+	SLAB_SCRUBBER_DEPTH = 4,
+
+	/* The number of queued slabs a scrubber considers when allocation is waiting on it */
+	SLAB_SCRUBBER_LOOKAHEAD = 16,
 };
 
 /*
@@ -238,6 +250,8 @@ struct vdo_slab {
 	enum slab_rebuild_status status;
 	/* Whether the slab was ever queued for scrubbing */
 	bool was_queued_for_scrubbing;
+	/* Whether the slab is clean but waiting for its reference counts to be loaded lazily */
+	bool loading_lazily;
 
 	/* The priority at which this slab has been queued for allocation */
 	u8 priority;
@@ -252,6 +266,8 @@ struct vdo_slab {
 
 	/* The saved block pointer and array indexes for the free block search */
 	struct search_cursor search_cursor;
+	/* A bitmap of the reference blocks which have no free counters */
+	unsigned long *full_blocks;
 
 	/* A list of the dirty blocks waiting to be written out */
 	struct vdo_wait_queue dirty_blocks;
@@ -278,6 +294,14 @@ enum block_allocator_drain_step {
 	VDO_DRAIN_ALLOCATOR_STEP_FINISHED,
 };
 
+/* A slab being scrubbed, and the vio for loading its slab journal */
+struct scrubbing_slot {
+	/* The slab being scrubbed, or NULL if the slot is idle */
+	struct vdo_slab *slab;
+	/* The vio for loading slab journal blocks */
+	struct vio vio;
+};
+
 struct slab_scrubber {
 	/* The queue of slabs to scrub first */
 	struct list_head high_priority_slabs;
@@ -296,10 +320,21 @@ struct slab_scrubber {
 	struct admin_state admin_state;
 	/* Whether to only scrub high-priority slabs */
 	bool high_priority_only;
-	/* The slab currently being scrubbed */
-	struct vdo_slab *slab;
-	/* The vio for loading slab journal blocks */
-	struct vio vio;
+	/* The completion to notify when high-priority scrubbing is done */
+	struct vdo_completion *parent;
+	/* The first error encountered while scrubbing */
+	int result;
+	/* Whether slabs are being started, so completions should not start more */
+	bool launching;
+	/* The number of slots with a slab in progress */
+	unsigned int active_slots;
+	/* The slabs being scrubbed */
+	struct scrubbing_slot slots[SLAB_SCRUBBER_DEPTH];
+
+	/* The number of slabs scrubbed since loading; queried by other threads */
+	slab_count_t slabs_scrubbed;
+	/* The time at which the current scrub started, in jiffies; queried by other threads */
+	u64 start_jiffies;
 };
 
 /* A sub-structure for applying actions in parallel to all an allocator's slabs. */
@@ -375,6 +410,23 @@ struct atomic_slab_summary_statistics {
 	atomic64_t blocks_written;
 };
 
+/*
+ * An allocation_stream tracks a run of writes to consecutive logical blocks so that, when the
+ * allocator is keeping sequential writes together, they can be given consecutive physical blocks.
+ */
+struct allocation_stream {
+	/* The logical block which would continue the stream, or 0 if the stream is unused */
+	logical_block_number_t next_lbn;
+	/* The physical block which would continue the stream */
+	physical_block_number_t next_pbn;
+	/* The logical block corresponding to the start of the reserved run */
+	logical_block_number_t run_lbn;
+	/* The first physical block of the reserved run, or VDO_ZERO_BLOCK if there is none */
+	physical_block_number_t run_pbn;
+	/* The allocator's stream clock when this stream was last used */
+	u64 last_used;
+};
+
 struct block_allocator {
 	struct vdo_completion completion;
 	/* The slab depot for this allocator */
@@ -398,6 +450,12 @@ struct block_allocator {
 
 	/* The slab from which blocks are currently being allocated */
 	struct vdo_slab *open_slab;
+	/* Whether to reserve runs of blocks for sequential write streams */
+	bool reserve_runs;
+	/* The sequential write streams seen by this allocator */
+	struct allocation_stream streams[BLOCK_ALLOCATOR_STREAM_COUNT];
+	/* A counter of allocations, used to find the least recently used stream */
+	u64 stream_clock;
 	/* A priority queue containing all slabs available for allocation */
 	struct priority_table *prioritized_slabs;
 	/* The slab scrubber */
@@ -474,6 +532,8 @@ struct slab_depot {
 
 	/* Determines how slabs should be queued during load */
 	enum slab_depot_load_type load_type;
+	/* Whether clean slabs load their reference counts after the depot comes online */
+	bool lazy_ref_counts;
 
 	/* The state for notifying slab journals to release recovery journal */
 	sequence_number_t active_release_request;
@@ -514,6 +574,8 @@ struct slab_depot {
 
 struct reference_updater;
 
+extern unsigned int vdo_slab_scrubbing_depth;
+
 bool __must_check vdo_attempt_replay_into_slab(struct vdo_slab *slab,
 					       physical_block_number_t pbn,
 					       enum journal_operation operation,
@@ -538,6 +600,10 @@ int __must_check vdo_acquire_provisional_reference(struct vdo_slab *slab,
 int __must_check vdo_allocate_block(struct block_allocator *allocator,
 				    physical_block_number_t *block_number_ptr);
 
+int __must_check vdo_allocate_block_for_lbn(struct block_allocator *allocator,
+					    logical_block_number_t lbn,
+					    physical_block_number_t *block_number_ptr);
+
 int vdo_enqueue_clean_slab_waiter(struct block_allocator *allocator,
 				  struct vdo_waiter *waiter);
 
@@ -607,6 +673,8 @@ void vdo_commit_oldest_slab_journal_tail_blocks(struct slab_depot *depot,
 void vdo_scrub_all_unrecovered_slabs(struct slab_depot *depot,
 				     struct vdo_completion *parent);
 
+void vdo_set_slab_scrubbing_depth(unsigned int depth);
+
 void vdo_dump_slab_depot(const struct slab_depot *depot);
 
 #ifdef INTERNAL
@@ -21,7 +21,7 @@
 #include "types.h"
 
 enum {
-	STATISTICS_VERSION = 36,
+	STATISTICS_VERSION = 48,
 };
 
 struct block_allocator_statistics {
@@ -31,6 +31,20 @@ struct block_allocator_statistics {
 	u64 slabs_opened;
 	/* The number of times since loading that a slab has been re-opened */
 	u64 slabs_reopened;
+	/* The number of sequential allocations which were physically contiguous */
+	u64 contiguous_allocations;
+	/* The number of sequential allocations which were not physically contiguous */
+	u64 fragmented_allocations;
+	/* The number of slabs which have yet to be scrubbed since loading */
+	u64 slabs_to_scrub;
+	/* The number of slabs which have been scrubbed since loading */
+	u64 slabs_scrubbed;
+	/* The estimated number of seconds until all slabs are scrubbed */
+	u64 scrub_seconds_remaining;
+	/* The number of clean slabs whose reference counts were deferred when loading */
+	u64 lazy_slabs;
+	/* The number of deferred slabs whose reference counts have since been loaded */
+	u64 lazy_slabs_loaded;
 };
 
 /**
@@ -49,6 +63,42 @@ struct commit_statistics {
 	u64 committed;
 };
 
+/** A histogram of the time taken by one stage of the write path, or by journal commits. */
+struct stage_latency_statistics {
+	/* Number of times a write has completed this stage */
+	u64 count;
+	/* Total time spent in this stage, in microseconds */
+	u64 total_microseconds;
+	/* Number of times the stage took less than 10 microseconds */
+	u64 under_10us;
+	/* Number of times the stage took 10 to 100 microseconds */
+	u64 under_100us;
+	/* Number of times the stage took 100 microseconds to 1 millisecond */
+	u64 under_1ms;
+	/* Number of times the stage took 1 to 10 milliseconds */
+	u64 under_10ms;
+	/* Number of times the stage took 10 to 100 milliseconds */
+	u64 under_100ms;
+	/* Number of times the stage took 100 milliseconds to 1 second */
+	u64 under_1s;
+	/* Number of times the stage took 1 second or more */
+	u64 over_1s;
+};
+
+/** A histogram of the number of new entries in each recovery journal commit. */
+struct commit_size_statistics {
+	/* Number of commits of a single entry */
+	u64 one_entry;
+	/* Number of commits of 2 to 15 entries */
+	u64 under_16;
+	/* Number of commits of 16 to 63 entries */
+	u64 under_64;
+	/* Number of commits of 64 entries up to a full block */
+	u64 one_block;
+	/* Number of commits of more than a full block of entries */
+	u64 multiple_blocks;
+};
+
 /** Counters for events in the recovery journal */
 struct recovery_journal_statistics {
 	/* Number of times the on-disk journal was full */
@@ -59,6 +109,14 @@ struct recovery_journal_statistics {
 	struct commit_statistics entries;
 	/* Write/Commit totals for journal blocks */
 	struct commit_statistics blocks;
+	/* Number of commits which wrote several adjacent blocks at once */
+	u64 multi_block_writes;
+	/* Number of commits which waited for more entries */
+	u64 delayed_commits;
+	/* The number of new entries in each commit */
+	struct commit_size_statistics commit_size;
+	/* The time from issuing each commit until it completes */
+	struct stage_latency_statistics commit_latency;
 };
 
 /** The statistics for the compressed block packer. */
@@ -71,6 +129,20 @@ struct packer_statistics {
 	u64 compressed_fragments_in_packer;
 };
 
+/** The statistics for compressing data blocks. */
+struct compression_statistics {
+	/* Number of blocks given to the compression codec to compress */
+	u64 attempts;
+	/* Number of compression attempts which did not produce a fragment */
+	u64 failures;
+	/* Number of blocks not compressed because fast-reject judged them incompressible */
+	u64 fast_reject_skips;
+	/* Number of blocks judged incompressible which were compressed anyway to check fast-reject */
+	u64 fast_reject_checks;
+	/* Number of fast-reject checks which produced a fragment */
+	u64 fast_reject_mispredictions;
+};
+
 /** The statistics for the slab journals. */
 struct slab_journal_statistics {
 	/* Number of times the on-disk journal was full */
@@ -139,6 +211,24 @@ struct block_map_statistics {
 	u64 pages_saved;
 	/* the number of flushes issued */
 	u64 flush_count;
+	/* number of fetched pages which were recently evicted from probation */
+	u64 ghost_hits;
+	/* number of pages loaded speculatively by readahead */
+	u64 readahead_pages;
+	/* number of readahead pages which were used before being evicted */
+	u64 readahead_used;
+	/* number of readahead pages evicted without being used */
+	u64 readahead_wasted;
+	/* number of writes issued to save pages */
+	u64 writes_issued;
+	/* number of pages loaded to warm up the cache */
+	u64 warmup_pages;
+	/* number of pages read from the cache device */
+	u64 tier_pages_read;
+	/* number of evicted pages written to the cache device */
+	u64 tier_pages_written;
+	/* number of cache device pages which were invalid or could not be read or written */
+	u64 tier_pages_rejected;
 };
 
 /** The dedupe statistics from hash locks */
@@ -153,6 +243,12 @@ struct hash_lock_statistics {
 	u64 concurrent_hash_collisions;
 	/* Current number of dedupe queries that are in flight */
 	u32 curr_dedupe_queries;
+	/* Number of writes which requested a hash lock, summed over all hash zones */
+	u64 lock_requests;
+	/* Number of hash lock requests handled by the busiest hash zone */
+	u64 max_zone_lock_requests;
+	/* Number of hash lock requests handled by the least busy hash zone */
+	u64 min_zone_lock_requests;
 };
 
 /** Counts of error conditions in VDO. */
@@ -207,6 +303,28 @@ struct index_statistics {
 	u64 entries_discarded;
 };
 
+/** The time data_vios spend in each stage of the write path. */
+struct write_latency_statistics {
+	/* From accepting the bio until the block map lookup starts */
+	struct stage_latency_statistics launch;
+	/* Waiting for and computing the record name */
+	struct stage_latency_statistics hash;
+	/* Waiting for a hash lock */
+	struct stage_latency_statistics hash_lock;
+	/* Querying the dedupe index */
+	struct stage_latency_statistics dedupe_query;
+	/* Allocating a physical block */
+	struct stage_latency_statistics allocation;
+	/* Writing the data to storage */
+	struct stage_latency_statistics data_write;
+	/* Making the recovery journal entry */
+	struct stage_latency_statistics journal;
+	/* Updating the block map */
+	struct stage_latency_statistics block_map;
+	/* Acknowledging the bio */
+	struct stage_latency_statistics acknowledge;
+};
+
 /** The statistics of the vdo service. */
 struct vdo_statistics {
 	u32 version;
@@ -236,6 +354,8 @@ struct vdo_statistics {
 	u8 recovery_percentage;
 	/* The statistics for the compressed block packer */
 	struct packer_statistics packer;
+	/* The statistics for compressing data blocks */
+	struct compression_statistics compression;
 	/* Counters for events in the block allocator */
 	struct block_allocator_statistics allocator;
 	/* Counters for events in the recovery journal */
@@ -281,6 +401,8 @@ struct vdo_statistics {
 	struct bio_stats bios_acknowledged_partial;
 	/* Current number of bios in progress */
 	struct bio_stats bios_in_progress;
+	/* Time spent in each stage of the write path */
+	struct write_latency_statistics write_latency;
 	/* Memory usage stats. */
 	struct memory_usage memory_usage;
 	/* The statistics for the UDS index */
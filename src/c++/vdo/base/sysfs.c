@@ -9,6 +9,8 @@
 
 #include "constants.h"
 #include "dedupe.h"
+#include "funnel-workqueue.h"
+#include "slab-depot.h"
 #include "vdo.h"
 
 #ifdef VDO_INTERNAL
@@ -53,6 +55,29 @@ static int vdo_min_dedupe_timer_interval_store(const char *buf,
 	return 0;
 }
 
+static int vdo_work_queue_max_spin_interval_store(const char *buf,
+						  const struct kernel_param *kp)
+{
+	int result = param_set_uint(buf, kp);
+
+	if (result != 0)
+		return result;
+	vdo_set_work_queue_max_spin_interval(*(uint *)kp->arg);
+	return 0;
+}
+
+static int vdo_slab_scrubbing_depth_store(const char *buf, const struct kernel_param *kp)
+{
+	unsigned int depth;
+	int result = kstrtouint(buf, 0, &depth);
+
+	/* Only the setter may store the depth, since it must not exceed the slots available. */
+	if (result != 0)
+		return result;
+	vdo_set_slab_scrubbing_depth(depth);
+	return 0;
+}
+
 #ifdef VDO_INTERNAL
 static const struct kernel_param_ops requests_ops = {
 	.set = vdo_max_req_active_store,
@@ -70,6 +95,16 @@ static const struct kernel_param_ops dedupe_timer_ops = {
 	.get = param_get_uint,
 };
 
+static const struct kernel_param_ops work_queue_spin_ops = {
+	.set = vdo_work_queue_max_spin_interval_store,
+	.get = param_get_uint,
+};
+
+static const struct kernel_param_ops slab_scrubbing_depth_ops = {
+	.set = vdo_slab_scrubbing_depth_store,
+	.get = param_get_uint,
+};
+
 #ifdef VDO_INTERNAL
 module_param_cb(max_requests_active, &requests_ops, &data_vio_count, 0644);
 #endif //VDO_INTERNAL
@@ -79,3 +114,9 @@ module_param_cb(deduplication_timeout_interval, &dedupe_timeout_ops,
 
 module_param_cb(min_deduplication_timer_interval, &dedupe_timer_ops,
 		&vdo_dedupe_index_min_timer_interval, 0644);
+
+module_param_cb(work_queue_max_spin_interval, &work_queue_spin_ops,
+		&vdo_work_queue_max_spin_interval, 0644);
+
+module_param_cb(slab_scrubbing_depth, &slab_scrubbing_depth_ops,
+		&vdo_slab_scrubbing_depth, 0644);
@@ -163,6 +163,16 @@ enum {
 		(VDO_MAPPING_STATE_COMPRESSED_MAX - VDO_MAPPING_STATE_COMPRESSED_BASE + 1),
 };
 
+/*
+ * The codecs which may be used to compress data blocks. The codec which compressed the fragments
+ * in a compressed block is recorded in the block's header, so these values must never change.
+ */
+enum vdo_compression_codec {
+	VDO_CODEC_LZ4 = 0,
+	VDO_CODEC_DEFLATE = 1,
+	VDO_CODEC_COUNT,
+} __packed;
+
 
 struct data_location {
 	physical_block_number_t pbn;
@@ -206,6 +216,7 @@ struct thread_count_config {
 	unsigned int logical_zones;
 	unsigned int physical_zones;
 	unsigned int hash_zones;
+	unsigned int numa_nodes;
 } __packed;
 
 struct device_config {
@@ -226,9 +237,30 @@ struct device_config {
 	unsigned int logical_block_size;
 	unsigned int cache_size;
 	unsigned int block_map_maximum_age;
+	bool block_map_cache_2q;
+	unsigned int block_map_readahead;
+	bool block_map_warmup;
+	/* The fast device holding the second-level block map cache, if any */
+	char *block_map_tier_name;
+	struct dm_dev *block_map_tier_device;
+	block_count_t block_map_tier_blocks;
 	bool deduplication;
 	bool compression;
+	enum vdo_compression_codec compression_codec;
 	int compression_level;
+	bool compression_fast_reject;
+	bool packer_bucketed;
+	unsigned int packer_max_age;
+	/* Whether to keep sequential writes physically contiguous */
+	bool allocation_locality;
+	/* Whether to load the reference counts of clean slabs after the vdo starts */
+	bool lazy_ref_counts;
+	/* Whether a read-only rebuild should read the block map leaves in physical order */
+	bool streaming_rebuild;
+	/* Whether to write adjacent recovery journal blocks together */
+	bool journal_group_commit;
+	/* How long, in microseconds, to wait for more entries before a partial journal commit */
+	unsigned int journal_commit_delay;
 	struct thread_count_config thread_counts;
 	block_count_t max_discard_blocks;
 };
@@ -244,11 +276,15 @@ enum vdo_completion_type {
 	VDO_FLUSH_COMPLETION,
 	VDO_FLUSH_NOTIFICATION_COMPLETION,
 	VDO_GENERATION_FLUSHED_COMPLETION,
+	VDO_HASH_BATCH_COMPLETION,
 	VDO_HASH_ZONE_COMPLETION,
 	VDO_HASH_ZONES_COMPLETION,
+	VDO_JOURNAL_EXTRACTION_COMPLETION,
 	VDO_LOCK_COUNTER_COMPLETION,
+	VDO_PACKER_COMPLETION,
 	VDO_PAGE_COMPLETION,
 	VDO_READ_ONLY_MODE_COMPLETION,
+	VDO_RECOVERY_JOURNAL_COMPLETION,
 	VDO_REPAIR_COMPLETION,
 	VDO_SYNC_COMPLETION,
 	VIO_COMPLETION,
@@ -354,6 +390,7 @@ enum vio_type {
 	VIO_TYPE_BLOCK_ALLOCATOR,
 	VIO_TYPE_BLOCK_MAP,
 	VIO_TYPE_BLOCK_MAP_INTERIOR,
+	VIO_TYPE_BLOCK_MAP_TIER,
 	VIO_TYPE_GEOMETRY,
 	VIO_TYPE_PARTITION_COPY,
 	VIO_TYPE_RECOVERY_JOURNAL,
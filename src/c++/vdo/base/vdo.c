@@ -31,8 +31,9 @@
 
 #include <linux/completion.h>
 #include <linux/device-mapper.h>
-#include <linux/lz4.h>
+#include <linux/minmax.h>
 #include <linux/mutex.h>
+#include <linux/nodemask.h>
 #include <linux/spinlock.h>
 #include <linux/types.h>
 
@@ -43,6 +44,7 @@
 
 #include "block-map.h"
 #include "completion.h"
+#include "compression.h"
 #include "data-vio.h"
 #include "dedupe.h"
 #include "encodings.h"
@@ -171,6 +173,7 @@ static const struct vdo_work_queue_type bio_ack_q_type = {
 	.finish = NULL,
 	.max_priority = BIO_ACK_Q_MAX_PRIORITY,
 	.default_priority = BIO_ACK_Q_ACK_PRIORITY,
+	.allow_stealing = true,
 };
 
 static const struct vdo_work_queue_type cpu_q_type = {
@@ -178,6 +181,7 @@ static const struct vdo_work_queue_type cpu_q_type = {
 	.finish = NULL,
 	.max_priority = CPU_Q_MAX_PRIORITY,
 	.default_priority = CPU_Q_MAX_PRIORITY,
+	.allow_stealing = true,
 };
 
 STATIC void uninitialize_thread_config(struct thread_config *config)
@@ -186,6 +190,7 @@ STATIC void uninitialize_thread_config(struct thread_config *config)
 	vdo_free(vdo_forget(config->physical_threads));
 	vdo_free(vdo_forget(config->hash_zone_threads));
 	vdo_free(vdo_forget(config->bio_threads));
+	vdo_free(vdo_forget(config->logical_nodes));
 	memset(config, 0, sizeof(struct thread_config));
 }
 
@@ -198,6 +203,37 @@ static void assign_thread_ids(struct thread_config *config,
 		thread_ids[zone] = config->thread_count++;
 }
 
+/**
+ * get_online_node() - Get the nth online NUMA node, wrapping around if there are fewer than n.
+ */
+static int get_online_node(unsigned int n)
+{
+	unsigned int count = num_online_nodes();
+	int node;
+
+	n %= count;
+	for_each_online_node(node) {
+		if (n-- == 0)
+			return node;
+	}
+
+	return NUMA_NO_NODE;
+}
+
+/**
+ * assign_logical_nodes() - Spread the logical zones across NUMA nodes, round-robin.
+ * @node_count: The number of nodes to use; if 0, the logical zones have no NUMA placement.
+ */
+static void assign_logical_nodes(struct thread_config *config, unsigned int node_count)
+{
+	zone_count_t zone;
+
+	for (zone = 0; zone < config->logical_zone_count; zone++) {
+		config->logical_nodes[zone] =
+			((node_count == 0) ? NUMA_NO_NODE : get_online_node(zone % node_count));
+	}
+}
+
 /**
  * initialize_thread_config() - Initialize the thread mapping
  *
@@ -252,6 +288,15 @@ STATIC int __must_check initialize_thread_config(struct thread_count_config coun
 		return result;
 	}
 
+	result = vdo_allocate(config->logical_zone_count, int, "logical node array",
+			      &config->logical_nodes);
+	if (result != VDO_SUCCESS) {
+		uninitialize_thread_config(config);
+		return result;
+	}
+
+	assign_logical_nodes(config, counts.numa_nodes);
+
 	if (single) {
 		config->logical_threads[0] = config->thread_count;
 		config->physical_threads[0] = config->thread_count;
@@ -409,6 +454,23 @@ STATIC void get_thread_name(const struct thread_config *thread_config,
 	snprintf(buffer, buffer_length, "reqQ%d", thread_id);
 }
 
+/**
+ * get_thread_node() - Get the NUMA node on which a thread should run.
+ *
+ * Return: The node of the logical zone served by the thread, or NUMA_NO_NODE.
+ */
+static int get_thread_node(const struct thread_config *config, thread_id_t thread_id)
+{
+	zone_count_t zone;
+
+	for (zone = 0; zone < config->logical_zone_count; zone++) {
+		if (config->logical_threads[zone] == thread_id)
+			return config->logical_nodes[zone];
+	}
+
+	return NUMA_NO_NODE;
+}
+
 /**
  * vdo_make_thread() - Construct a single vdo work_queue and its associated thread (or threads for
  *                     round-robin queues).
@@ -443,8 +505,9 @@ int vdo_make_thread(struct vdo *vdo, thread_id_t thread_id,
 	thread->vdo = vdo;
 	thread->thread_id = thread_id;
 	get_thread_name(&vdo->thread_config, thread_id, queue_name, sizeof(queue_name));
-	return vdo_make_work_queue(vdo->thread_name_prefix, queue_name, thread,
-				   type, queue_count, contexts, &thread->queue);
+	return vdo_make_work_queue(vdo->thread_name_prefix, queue_name, thread, type,
+				   get_thread_node(&vdo->thread_config, thread_id),
+				   queue_count, contexts, &thread->queue);
 }
 
 /**
@@ -510,18 +573,18 @@ static int initialize_vdo(struct vdo *vdo, struct device_config *config,
 		     config->thread_counts.hash_zones, vdo->thread_config.thread_count);
 
 	/* Compression context storage */
-	result = vdo_allocate(config->thread_counts.cpu_threads, char *, "LZ4 context",
+	result = vdo_allocate(config->thread_counts.cpu_threads, char *, "compression context",
 			      &vdo->compression_context);
 	if (result != VDO_SUCCESS) {
-		*reason = "cannot allocate LZ4 context";
+		*reason = "cannot allocate compression context";
 		return result;
 	}
 
 	for (i = 0; i < config->thread_counts.cpu_threads; i++) {
-		result = vdo_allocate(LZ4_MEM_COMPRESS, char, "LZ4 context",
-				      &vdo->compression_context[i]);
+		result = vdo_allocate(vdo_get_compression_workspace_size(), char,
+				      "compression context", &vdo->compression_context[i]);
 		if (result != VDO_SUCCESS) {
-			*reason = "cannot allocate LZ4 context";
+			*reason = "cannot allocate compression context";
 			return result;
 		}
 	}
@@ -890,6 +953,19 @@ struct block_device *vdo_get_backing_device(const struct vdo *vdo)
 	return vdo->device_config->owned_device->bdev;
 }
 
+/**
+ * vdo_get_block_map_tier_device() - Get the block device holding the second-level block map cache.
+ * @vdo: The vdo.
+ *
+ * Return: The block map cache device, or NULL if the vdo does not have one.
+ */
+struct block_device *vdo_get_block_map_tier_device(const struct vdo *vdo)
+{
+	struct dm_dev *device = vdo->device_config->block_map_tier_device;
+
+	return ((device == NULL) ? NULL : device->bdev);
+}
+
 /**
  * vdo_get_device_name() - Get the device name associated with the vdo target.
  * @target: The target device interface.
@@ -1050,6 +1126,9 @@ void vdo_save_components(struct vdo *vdo, struct vdo_completion *parent)
 	record_vdo(vdo);
 
 	vdo_encode_super_block(super_block->buffer, &vdo->states);
+	if (vdo->block_map != NULL)
+		vdo_encode_hot_page_list(super_block->buffer, &vdo->block_map->hot_pages);
+
 	super_block->vio.completion.parent = parent;
 	super_block->vio.completion.callback_thread_id = parent->callback_thread_id;
 	vdo_submit_metadata_vio(&super_block->vio,
@@ -1494,6 +1573,34 @@ bool vdo_get_compressing(struct vdo *vdo)
 	return READ_ONCE(vdo->compressing);
 }
 
+/**
+ * warm_up_block_map_callback() - Callback to start or cancel warming up the block map cache.
+ * @completion: The sync completion.
+ */
+static void warm_up_block_map_callback(struct vdo_completion *completion)
+{
+	bool start = *((bool *) completion->parent);
+
+	vdo_prepare_completion(completion, complete_synchronous_action,
+			       complete_synchronous_action, completion->callback_thread_id,
+			       NULL);
+	vdo_warm_up_block_map(completion->vdo->block_map, start, completion);
+}
+
+/**
+ * vdo_warm_up_block_map_cache() - Start or cancel loading the block map pages which were cached
+ *                                 when the vdo was last saved.
+ * @vdo: The vdo.
+ * @start: Whether to start warming up the cache rather than cancel a warm-up in progress.
+ *
+ * Return: VDO_SUCCESS or an error if the vdo is not running.
+ */
+int vdo_warm_up_block_map_cache(struct vdo *vdo, bool start)
+{
+	return perform_synchronous_action(vdo, warm_up_block_map_callback,
+					  vdo->thread_config.journal_thread, &start);
+}
+
 static size_t get_block_map_cache_size(const struct vdo *vdo)
 {
 	return ((size_t) vdo->device_config->cache_size) * VDO_BLOCK_SIZE;
@@ -1515,6 +1622,26 @@ static struct error_statistics __must_check get_vdo_error_statistics(const struc
 	};
 }
 
+static struct compression_statistics __must_check
+get_vdo_compression_statistics(const struct vdo *vdo)
+{
+	const struct atomic_statistics *atoms = &vdo->stats;
+	/*
+	 * A check is counted after its prediction, so reading the checks first keeps them from
+	 * outnumbering the predictions.
+	 */
+	u64 checks = atomic64_read(&atoms->fast_reject_checks);
+	u64 predictions = atomic64_read(&atoms->fast_reject_predictions);
+
+	return (struct compression_statistics) {
+		.attempts = atomic64_read(&atoms->compression_attempts),
+		.failures = atomic64_read(&atoms->compression_failures),
+		.fast_reject_skips = predictions - min(checks, predictions),
+		.fast_reject_checks = checks,
+		.fast_reject_mispredictions = atomic64_read(&atoms->fast_reject_mispredictions),
+	};
+}
+
 static void copy_bio_stat(struct bio_stats *b, const struct atomic_bio_stats *a)
 {
 	b->read = atomic64_read(&a->read);
@@ -1525,6 +1652,85 @@ static void copy_bio_stat(struct bio_stats *b, const struct atomic_bio_stats *a)
 	b->fua = atomic64_read(&a->fua);
 }
 
+/* Get the counter of a latency histogram for each of the VDO_LATENCY_BUCKETS buckets. */
+static void get_latency_counters(struct stage_latency_statistics *s,
+				 u64 *buckets[VDO_LATENCY_BUCKETS])
+{
+	buckets[0] = &s->under_10us;
+	buckets[1] = &s->under_100us;
+	buckets[2] = &s->under_1ms;
+	buckets[3] = &s->under_10ms;
+	buckets[4] = &s->under_100ms;
+	buckets[5] = &s->under_1s;
+	buckets[6] = &s->over_1s;
+}
+
+/**
+ * vdo_get_latency_bucket() - Find the decade-wide latency bucket, from under 10us up, for a time.
+ * @microseconds: The time to classify.
+ *
+ * Return: The index of the bucket, less than VDO_LATENCY_BUCKETS.
+ */
+unsigned int vdo_get_latency_bucket(u64 microseconds)
+{
+	unsigned int bucket = 0;
+	u64 limit = 10;
+
+	while ((bucket < VDO_LATENCY_BUCKETS - 1) && (microseconds >= limit)) {
+		bucket++;
+		limit *= 10;
+	}
+
+	return bucket;
+}
+
+/**
+ * vdo_record_stage_latency() - Add a time to a latency histogram which is not updated concurrently.
+ * @stats: The histogram.
+ * @microseconds: The time to add.
+ */
+void vdo_record_stage_latency(struct stage_latency_statistics *stats, u64 microseconds)
+{
+	u64 *buckets[VDO_LATENCY_BUCKETS];
+
+	get_latency_counters(stats, buckets);
+	stats->count++;
+	stats->total_microseconds += microseconds;
+	(*buckets[vdo_get_latency_bucket(microseconds)])++;
+}
+
+static void copy_stage_latency(struct stage_latency_statistics *s,
+			       const struct atomic_stage_latency *a)
+{
+	u64 *buckets[VDO_LATENCY_BUCKETS];
+	unsigned int i;
+
+	get_latency_counters(s, buckets);
+	s->count = 0;
+	for (i = 0; i < VDO_LATENCY_BUCKETS; i++) {
+		*buckets[i] = atomic64_read(&a->buckets[i]);
+		s->count += *buckets[i];
+	}
+
+	s->total_microseconds = atomic64_read(&a->total_microseconds);
+}
+
+static void get_write_latency_statistics(const struct vdo *vdo,
+					 struct write_latency_statistics *stats)
+{
+	const struct atomic_stage_latency *stages = vdo->stats.write_stages;
+
+	copy_stage_latency(&stats->launch, &stages[VDO_WRITE_STAGE_LAUNCH]);
+	copy_stage_latency(&stats->hash, &stages[VDO_WRITE_STAGE_HASH]);
+	copy_stage_latency(&stats->hash_lock, &stages[VDO_WRITE_STAGE_HASH_LOCK]);
+	copy_stage_latency(&stats->dedupe_query, &stages[VDO_WRITE_STAGE_DEDUPE_QUERY]);
+	copy_stage_latency(&stats->allocation, &stages[VDO_WRITE_STAGE_ALLOCATION]);
+	copy_stage_latency(&stats->data_write, &stages[VDO_WRITE_STAGE_DATA_WRITE]);
+	copy_stage_latency(&stats->journal, &stages[VDO_WRITE_STAGE_JOURNAL]);
+	copy_stage_latency(&stats->block_map, &stages[VDO_WRITE_STAGE_BLOCK_MAP]);
+	copy_stage_latency(&stats->acknowledge, &stages[VDO_WRITE_STAGE_ACKNOWLEDGE]);
+}
+
 static struct bio_stats subtract_bio_stats(struct bio_stats minuend,
 					   struct bio_stats subtrahend)
 {
@@ -1622,6 +1828,7 @@ static void get_vdo_statistics(const struct vdo *vdo, struct vdo_statistics *sta
 	vdo_get_slab_depot_statistics(vdo->depot, stats);
 	stats->journal = vdo_get_recovery_journal_statistics(journal);
 	stats->packer = vdo_get_packer_statistics(vdo->packer);
+	stats->compression = get_vdo_compression_statistics(vdo);
 	stats->block_map = vdo_get_block_map_statistics(vdo->block_map);
 	vdo_get_dedupe_statistics(vdo->hash_zones, stats);
 	stats->errors = get_vdo_error_statistics(vdo);
@@ -1650,6 +1857,7 @@ static void get_vdo_statistics(const struct vdo *vdo, struct vdo_statistics *sta
 	copy_bio_stat(&stats->bios_acknowledged_partial, &vdo->stats.bios_acknowledged_partial);
 	stats->bios_in_progress =
 		subtract_bio_stats(stats->bios_in, stats->bios_acknowledged);
+	get_write_latency_statistics(vdo, &stats->write_latency);
 #ifdef __KERNEL__
 	vdo_get_memory_stats(&stats->memory_usage.bytes_used,
 			     &stats->memory_usage.peak_bytes_used);
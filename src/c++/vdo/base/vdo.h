@@ -93,6 +93,31 @@ struct atomic_bio_stats {
 	atomic64_t fua; /* Number of REQ_FUA bios */
 };
 
+/* The stages of the write path whose latency is tracked, named for their async operations */
+enum vdo_write_stage {
+	VDO_WRITE_STAGE_LAUNCH,
+	VDO_WRITE_STAGE_HASH,
+	VDO_WRITE_STAGE_HASH_LOCK,
+	VDO_WRITE_STAGE_DEDUPE_QUERY,
+	VDO_WRITE_STAGE_ALLOCATION,
+	VDO_WRITE_STAGE_DATA_WRITE,
+	VDO_WRITE_STAGE_JOURNAL,
+	VDO_WRITE_STAGE_BLOCK_MAP,
+	VDO_WRITE_STAGE_ACKNOWLEDGE,
+	VDO_WRITE_STAGE_COUNT,
+};
+
+enum {
+	/* The number of decade-wide buckets, from under 10us to over 1s, for each stage */
+	VDO_LATENCY_BUCKETS = 7,
+};
+
+/* Keep a latency histogram for one write stage atomically */
+struct atomic_stage_latency {
+	atomic64_t total_microseconds;
+	atomic64_t buckets[VDO_LATENCY_BUCKETS];
+};
+
 /* Counters are atomic since updates can arrive concurrently from arbitrary threads. */
 struct atomic_statistics {
 	atomic64_t bios_submitted;
@@ -101,6 +126,13 @@ struct atomic_statistics {
 	atomic64_t invalid_advice_pbn_count;
 	atomic64_t no_space_error_count;
 	atomic64_t read_only_error_count;
+	atomic64_t compression_attempts;
+	atomic64_t compression_failures;
+	atomic64_t fast_reject_predictions;
+	atomic64_t fast_reject_checks;
+	atomic64_t fast_reject_mispredictions;
+	atomic64_t rebuild_pages_total;
+	atomic64_t rebuild_pages_done;
 	struct atomic_bio_stats bios_in;
 	struct atomic_bio_stats bios_in_partial;
 	struct atomic_bio_stats bios_out;
@@ -113,6 +145,7 @@ struct atomic_statistics {
 	struct atomic_bio_stats bios_journal_completed;
 	struct atomic_bio_stats bios_page_cache;
 	struct atomic_bio_stats bios_page_cache_completed;
+	struct atomic_stage_latency write_stages[VDO_WRITE_STAGE_COUNT];
 };
 
 struct read_only_notifier {
@@ -150,6 +183,8 @@ struct thread_config {
 	thread_id_t *physical_threads;
 	thread_id_t *hash_zone_threads;
 	thread_id_t *bio_threads;
+	/* The NUMA node of each logical zone, or NUMA_NO_NODE */
+	int *logical_nodes;
 };
 
 struct thread_count_config;
@@ -284,7 +319,7 @@ struct vdo {
 	struct kobject stats_directory;
 
 #endif
-	/* N blobs of context data for LZ4 code, one per CPU thread. */
+	/* N blobs of workspace for the compression codecs, one per CPU thread. */
 	char **compression_context;
 };
 
@@ -340,6 +375,8 @@ int __must_check vdo_add_sysfs_stats_dir(struct vdo *vdo);
 #endif
 struct block_device * __must_check vdo_get_backing_device(const struct vdo *vdo);
 
+struct block_device * __must_check vdo_get_block_map_tier_device(const struct vdo *vdo);
+
 const char * __must_check vdo_get_device_name(const struct dm_target *target);
 
 int __must_check vdo_synchronous_flush(struct vdo *vdo);
@@ -350,6 +387,8 @@ bool vdo_set_compressing(struct vdo *vdo, bool enable);
 
 bool vdo_get_compressing(struct vdo *vdo);
 
+int vdo_warm_up_block_map_cache(struct vdo *vdo, bool start);
+
 void vdo_fetch_statistics(struct vdo *vdo, struct vdo_statistics *stats);
 
 thread_id_t vdo_get_callback_thread_id(void);
@@ -391,6 +430,10 @@ void vdo_assert_on_physical_zone_thread(const struct vdo *vdo, zone_count_t phys
 int __must_check vdo_get_physical_zone(const struct vdo *vdo, physical_block_number_t pbn,
 				       struct physical_zone **zone_ptr);
 
+unsigned int __must_check vdo_get_latency_bucket(u64 microseconds);
+
+void vdo_record_stage_latency(struct stage_latency_statistics *stats, u64 microseconds);
+
 void vdo_dump_status(const struct vdo *vdo);
 
 #ifdef INTERNAL
@@ -46,7 +46,10 @@ physical_block_number_t pbn_from_vio_bio(struct bio *bio)
 	struct vdo *vdo = vio->completion.vdo;
 	physical_block_number_t pbn = bio->bi_iter.bi_sector / VDO_SECTORS_PER_BLOCK;
 
-	return ((pbn == VDO_GEOMETRY_BLOCK_LOCATION) ? pbn : pbn + vdo->geometry.bio_offset);
+	if ((pbn == VDO_GEOMETRY_BLOCK_LOCATION) || (vio->type == VIO_TYPE_BLOCK_MAP_TIER))
+		return pbn;
+
+	return pbn + vdo->geometry.bio_offset;
 }
 
 static int create_multi_block_bio(block_count_t size, struct bio **bio_ptr)
@@ -178,7 +181,10 @@ void vdo_set_bio_properties(struct bio *bio, struct vio *vio, bio_end_io_t callb
 	struct vdo *vdo = vio->completion.vdo;
 	struct device_config *config = vdo->device_config;
 
-	pbn -= vdo->geometry.bio_offset;
+	/* The block map cache device is addressed by its own block numbers. */
+	if (vio->type != VIO_TYPE_BLOCK_MAP_TIER)
+		pbn -= vdo->geometry.bio_offset;
+
 	vio->bio_zone = ((pbn / config->thread_counts.bio_rotation_interval) %
 			 config->thread_counts.bio_threads);
 
@@ -418,21 +424,37 @@ bool is_vio_pool_busy(struct vio_pool *pool)
  * @waiter: Object that is requesting a vio.
  */
 void acquire_vio_from_pool(struct vio_pool *pool, struct vdo_waiter *waiter)
+{
+	struct pooled_vio *pooled = try_acquire_vio_from_pool(pool);
+
+	if (pooled == NULL) {
+		vdo_waitq_enqueue_waiter(&pool->waiting, waiter);
+		return;
+	}
+
+	(*waiter->callback)(waiter, pooled);
+}
+
+/**
+ * try_acquire_vio_from_pool() - Acquire a vio and buffer from the pool if one is available.
+ * @pool: The vio pool.
+ *
+ * Return: The acquired vio, or NULL if all of the pool's vios are in use.
+ */
+struct pooled_vio *try_acquire_vio_from_pool(struct vio_pool *pool)
 {
 	struct pooled_vio *pooled;
 
 	VDO_ASSERT_LOG_ONLY((pool->thread_id == vdo_get_callback_thread_id()),
 			    "acquire from active vio_pool called from correct thread");
 
-	if (list_empty(&pool->available)) {
-		vdo_waitq_enqueue_waiter(&pool->waiting, waiter);
-		return;
-	}
+	pooled = list_first_entry_or_null(&pool->available, struct pooled_vio, pool_entry);
+	if (pooled == NULL)
+		return NULL;
 
-	pooled = list_first_entry(&pool->available, struct pooled_vio, pool_entry);
 	pool->busy_count++;
 	list_move_tail(&pooled->pool_entry, &pool->busy);
-	(*waiter->callback)(waiter, pooled);
+	return pooled;
 }
 
 /**
@@ -199,6 +199,7 @@ int __must_check make_vio_pool(struct vdo *vdo, size_t pool_size, size_t block_c
 void free_vio_pool(struct vio_pool *pool);
 bool __must_check is_vio_pool_busy(struct vio_pool *pool);
 void acquire_vio_from_pool(struct vio_pool *pool, struct vdo_waiter *waiter);
+struct pooled_vio * __must_check try_acquire_vio_from_pool(struct vio_pool *pool);
 void return_vio_to_pool(struct pooled_vio *vio);
 
 #endif /* VIO_H */
@@ -18,6 +18,13 @@ struct completion {
   struct cond_var condition;
 };
 
+#define DECLARE_COMPLETION_ONSTACK(work)				\
+	struct completion work = {					\
+		.done = false,						\
+		.mutex = UDS_MUTEX_INITIALIZER,				\
+		.condition = { .condition = PTHREAD_COND_INITIALIZER },	\
+	}
+
 /**
  * Initialize a completion.
  *
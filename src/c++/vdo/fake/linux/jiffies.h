@@ -16,11 +16,20 @@ unsigned long getUnitTestJiffies(void);
 
 #define jiffies (getUnitTestJiffies() / 1)
 
+/* Compare jiffies values correctly even if the jiffies counter has wrapped. */
+#define time_after(a, b) ((long) ((b) - (a)) < 0)
+#define time_before(a, b) time_after(b, a)
+
 static inline unsigned long msecs_to_jiffies(const unsigned int m)
 {
 	return m / MS_PER_JIFFY;
 }
 
+static inline unsigned long usecs_to_jiffies(const unsigned int u)
+{
+	return (u + US_PER_JIFFY - 1) / US_PER_JIFFY;
+}
+
 static inline unsigned int jiffies_to_msecs(const unsigned long j)
 {
 	return j * MS_PER_JIFFY;
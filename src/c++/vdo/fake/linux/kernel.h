@@ -9,6 +9,12 @@
 #ifndef LINUX_KERNEL_H
 #define LINUX_KERNEL_H
 
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+
 #include "permassert.h"
 
 /* generic data direction definitions */
@@ -28,4 +34,40 @@
 #endif
 #define BUG()	BUG_ON(1)
 
+/* From linux/sprintf.h: like snprintf(), but return the length actually written. */
+static inline int __printf(3, 4) scnprintf(char *buf, size_t size, const char *fmt, ...)
+{
+	va_list args;
+	int length;
+
+	if (size == 0)
+		return 0;
+
+	va_start(args, fmt);
+	length = vsnprintf(buf, size, fmt, args);
+	va_end(args);
+	if (length < 0)
+		return 0;
+
+	return ((size_t) length < size) ? length : (int) (size - 1);
+}
+
+/* From linux/string.h: copy a string, truncating it to fit. */
+static inline ssize_t strscpy(char *dest, const char *src, size_t count)
+{
+	size_t length = strnlen(src, count);
+
+	if (count == 0)
+		return -E2BIG;
+
+	if (length == count) {
+		memcpy(dest, src, count - 1);
+		dest[count - 1] = '\0';
+		return -E2BIG;
+	}
+
+	memcpy(dest, src, length + 1);
+	return length;
+}
+
 #endif // LINUX_KERNEL_H
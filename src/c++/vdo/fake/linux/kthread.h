@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Unit test requirements from linux/kthread.h.
+ *
+ * Copyright 2024 Red Hat
+ *
+ */
+
+#ifndef LINUX_KTHREAD_H
+#define LINUX_KTHREAD_H
+
+#include <linux/compiler_attributes.h>
+#include <linux/err.h>
+#include <linux/kernel.h>
+#include <linux/sched.h>
+#include <linux/types.h>
+#include <linux/wait.h>
+
+/*
+ * Create a thread which will run threadfn(data) once it has been woken with
+ * wake_up_process(). The node is ignored.
+ */
+struct task_struct * __printf(4, 5)
+kthread_create_on_node(int (*threadfn)(void *data),
+		       void *data,
+		       int node,
+		       const char namefmt[], ...);
+
+/* Create a thread and wake it. */
+#define kthread_run(threadfn, data, namefmt, ...)				\
+	({									\
+		struct task_struct *__k						\
+			= kthread_create_on_node(threadfn, data, -1, namefmt,	\
+						 ## __VA_ARGS__);		\
+		if (!IS_ERR(__k))						\
+			wake_up_process(__k);					\
+		__k;								\
+	})
+
+/**********************************************************************/
+bool kthread_should_stop(void);
+
+/* Ask a thread to stop, wake it, and wait for it to exit. */
+int kthread_stop(struct task_struct *task);
+
+/*
+ * Return the function a thread was created to run, or NULL if it was not made by
+ * kthread_create_on_node(). Unlike the kernel, the function keeps its own type,
+ * since ISO C does not allow converting it to a void pointer.
+ */
+int (*kthread_func(struct task_struct *task))(void *data);
+
+/**********************************************************************/
+void *kthread_data(struct task_struct *task);
+
+#endif // LINUX_KTHREAD_H
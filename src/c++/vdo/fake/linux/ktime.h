@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Unit test requirements from linux/ktime.h.
+ *
+ * Copyright 2024 Red Hat
+ *
+ */
+
+#ifndef LINUX_KTIME_H
+#define LINUX_KTIME_H
+
+#include "time-utils.h"
+
+static inline u64 ktime_get_ns(void)
+{
+	return current_time_ns(CLOCK_MONOTONIC);
+}
+
+#endif // LINUX_KTIME_H
@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Unit test requirements from linux/nodemask.h.
+ *
+ * Copyright 2024 Red Hat
+ *
+ */
+
+#ifndef LINUX_NODEMASK_H
+#define LINUX_NODEMASK_H
+
+#include <linux/numa.h>
+
+// For unit tests, all memory is on a single node
+static inline unsigned int num_online_nodes(void)
+{
+	return 1;
+}
+
+#define for_each_online_node(node) for ((node) = 0; (node) < 1; (node)++)
+
+#endif /* LINUX_NODEMASK_H */
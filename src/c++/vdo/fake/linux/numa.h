@@ -0,0 +1,14 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Unit test requirements from linux/numa.h.
+ *
+ * Copyright 2024 Red Hat
+ *
+ */
+
+#ifndef LINUX_NUMA_H
+#define LINUX_NUMA_H
+
+#define NUMA_NO_NODE (-1)
+
+#endif /* LINUX_NUMA_H */
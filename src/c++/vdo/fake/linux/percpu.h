@@ -0,0 +1,17 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Unit test requirements from linux/percpu.h.
+ *
+ * Copyright 2024 Red Hat
+ *
+ */
+
+#ifndef LINUX_PERCPU_H
+#define LINUX_PERCPU_H
+
+/* Unit tests have no fixed CPUs, so per-cpu variables are per-thread instead. */
+#define DEFINE_PER_CPU(type, name) __thread type name
+
+#define this_cpu_inc_return(pcp) (++(pcp))
+
+#endif // LINUX_PERCPU_H
@@ -33,11 +33,35 @@ enum {
   TASK_COMM_LEN = 16,
 };
 
+struct cpumask;
 struct task_struct;
 
+/* Unit test threads are never asked to give up the CPU. */
+#define need_resched() (0)
+#define in_interrupt() (0)
+
+/* From asm/processor.h; only keeps the compiler from optimizing away a spin. */
+#define cpu_relax() __asm__ __volatile__("" ::: "memory")
+
 /**********************************************************************/
 void io_schedule(void);
 
+/* Sleep until woken, unless the current thread has already been woken. */
+void schedule(void);
+
+/**********************************************************************/
+int wake_up_process(struct task_struct *task);
+
+/**********************************************************************/
+char task_state_to_char(struct task_struct *task);
+
+/* Unit test threads are not placed on particular CPUs. */
+static inline int set_cpus_allowed_ptr(struct task_struct *task,
+				       const struct cpumask *new_mask)
+{
+	return 0;
+}
+
 /* Modifications for VDO - used in mutexUtils.c */
 void set_current_state(int state_value);
 
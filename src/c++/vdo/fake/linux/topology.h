@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Unit test requirements from linux/topology.h.
+ *
+ * Copyright 2024 Red Hat
+ *
+ */
+
+#ifndef LINUX_TOPOLOGY_H
+#define LINUX_TOPOLOGY_H
+
+#include <stddef.h>
+
+struct cpumask;
+
+/* Unit tests do not place threads, so there is no mask for any node. */
+static inline const struct cpumask *cpumask_of_node(int node)
+{
+	return NULL;
+}
+
+#endif // LINUX_TOPOLOGY_H
@@ -34,6 +34,11 @@ typedef struct wait_queue_entry {
 /**********************************************************************/
 void init_waitqueue_head(struct wait_queue_head *wq_head);
 
+/**********************************************************************/
+void prepare_to_wait(struct wait_queue_head *wq_head,
+		     struct wait_queue_entry *wq_entry,
+		     int state);
+
 /**********************************************************************/
 void prepare_to_wait_exclusive(struct wait_queue_head *wq_head,
 			       struct wait_queue_entry *wq_entry,
@@ -45,6 +50,7 @@ void finish_wait(struct wait_queue_head *wq_head, struct wait_queue_entry *wq_en
 /**********************************************************************/
 void __wake_up(struct wait_queue_head *wq_head, unsigned int mode, int nr, void *key);
 
+#define wake_up(x)		__wake_up(x, TASK_NORMAL, 1, NULL)
 #define wake_up_nr(x, nr)	__wake_up(x, TASK_NORMAL, nr, NULL)
 
 #endif // LINUX_WAIT_H
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Fake implementation of linux/zlib.h for unit tests, using the user space
+ * zlib library.
+ *
+ * Copyright 2023 Red Hat
+ */
+
+#ifndef LINUX_ZLIB_H
+#define LINUX_ZLIB_H
+
+#define ZLIB_CONST
+#include <zlib.h>
+
+/**********************************************************************/
+static inline int zlib_deflate_workspacesize(int windowBits __attribute__((unused)),
+                                             int memLevel __attribute__((unused)))
+{
+  return 0;
+}
+
+/**********************************************************************/
+static inline int zlib_inflate_workspacesize(void)
+{
+  return 0;
+}
+
+#define zlib_deflateInit2 deflateInit2
+#define zlib_deflate      deflate
+#define zlib_deflateEnd   deflateEnd
+#define zlib_inflateInit2 inflateInit2
+#define zlib_inflate      inflate
+#define zlib_inflateEnd   inflateEnd
+
+#endif // LINUX_ZLIB_H
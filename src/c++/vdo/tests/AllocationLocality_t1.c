@@ -0,0 +1,178 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include "slab-depot.h"
+#include "statistics.h"
+#include "vdo.h"
+
+#include "blockMapUtils.h"
+#include "ioRequest.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  STREAM_BLOCKS = 64,
+  STREAM_A      = 1000,
+  STREAM_B      = 3000,
+  ZONE_BLOCKS   = 128,
+};
+
+/**
+ * Initialize a VDO with its block map tree allocated, so that the only
+ * allocations are for data.
+ *
+ * @param locality       Whether to keep sequential writes together
+ * @param physicalZones  The number of physical zones
+ **/
+static void initialize(bool locality, thread_count_t physicalZones)
+{
+  TestParameters parameters = {
+    .logicalBlocks        = 4096,
+    .physicalBlocks       = 8192,
+    .slabSize             = 1024,
+    .journalBlocks        = 16,
+    .physicalThreadCount  = physicalZones,
+    .noIndexRegion        = true,
+    .disableDeduplication = true,
+    .allocationLocality   = locality,
+  };
+
+  initializeVDOTest(&parameters);
+  populateBlockMapTree();
+}
+
+/**
+ * Write two sequential streams of single blocks, alternating between them.
+ **/
+static void writeInterleavedStreams(void)
+{
+  for (block_count_t i = 0; i < STREAM_BLOCKS; i++) {
+    writeData(STREAM_A + i, STREAM_A + i, 1, VDO_SUCCESS);
+    writeData(STREAM_B + i, STREAM_B + i, 1, VDO_SUCCESS);
+  }
+}
+
+/**
+ * Count the logical blocks of a stream which are mapped to the physical block
+ * following the one to which the preceding logical block is mapped.
+ *
+ * @param start  The first logical block of the stream
+ *
+ * @return The number of physically contiguous blocks in the stream
+ **/
+static block_count_t countContiguousBlocks(logical_block_number_t start)
+{
+  block_count_t contiguous = 0;
+  physical_block_number_t previous = lookupLBN(start).pbn;
+  for (block_count_t i = 1; i < STREAM_BLOCKS; i++) {
+    physical_block_number_t pbn = lookupLBN(start + i).pbn;
+    if (pbn == previous + 1) {
+      contiguous++;
+    }
+
+    previous = pbn;
+  }
+
+  return contiguous;
+}
+
+/**
+ * Get the statistics for the block allocators.
+ **/
+static struct block_allocator_statistics getAllocatorStatistics(void)
+{
+  struct vdo_statistics stats;
+  vdo_fetch_statistics(vdo, &stats);
+  return stats.allocator;
+}
+
+/**
+ * Test that without allocation locality, interleaved sequential writes are
+ * interleaved physically, and that the statistics count them as fragmented.
+ **/
+static void testInterleavedWithoutLocality(void)
+{
+  initialize(false, 1);
+  writeInterleavedStreams();
+  CU_ASSERT_EQUAL(countContiguousBlocks(STREAM_A), 0);
+  CU_ASSERT_EQUAL(countContiguousBlocks(STREAM_B), 0);
+
+  struct block_allocator_statistics stats = getAllocatorStatistics();
+  CU_ASSERT_EQUAL(stats.contiguous_allocations, 0);
+  CU_ASSERT_EQUAL(stats.fragmented_allocations, 2 * (STREAM_BLOCKS - 1));
+}
+
+/**
+ * Test that with allocation locality, interleaved sequential writes are each
+ * given runs of contiguous blocks.
+ **/
+static void testInterleavedWithLocality(void)
+{
+  initialize(true, 1);
+  writeInterleavedStreams();
+  verifyData(STREAM_A, STREAM_A, STREAM_BLOCKS);
+  verifyData(STREAM_B, STREAM_B, STREAM_BLOCKS);
+
+  block_count_t contiguous
+    = countContiguousBlocks(STREAM_A) + countContiguousBlocks(STREAM_B);
+  struct block_allocator_statistics stats = getAllocatorStatistics();
+  CU_ASSERT_EQUAL(stats.contiguous_allocations, contiguous);
+  CU_ASSERT_EQUAL(stats.contiguous_allocations + stats.fragmented_allocations,
+                  2 * (STREAM_BLOCKS - 1));
+
+  // Each stream should be broken only where one of its runs ends.
+  block_count_t runs = DIV_ROUND_UP(STREAM_BLOCKS, BLOCK_ALLOCATOR_RUN_BLOCKS);
+  CU_ASSERT(stats.fragmented_allocations <= 2 * runs);
+}
+
+/**
+ * Get the physical zone from which the block mapped to a logical block was
+ * allocated.
+ **/
+static zone_count_t getAllocationZone(logical_block_number_t lbn)
+{
+  struct vdo_slab *slab = vdo_get_slab(vdo->depot, lookupLBN(lbn).pbn);
+  return slab->allocator->zone_number;
+}
+
+/**
+ * Test that with allocation locality, each aligned group of logical blocks is
+ * allocated from a single physical zone.
+ **/
+static void testZoneSelection(void)
+{
+  initialize(true, 2);
+  writeData(0, 1, 2 * ZONE_BLOCKS, VDO_SUCCESS);
+  for (block_count_t i = 0; i < 2 * ZONE_BLOCKS; i++) {
+    CU_ASSERT_EQUAL(getAllocationZone(i), i / ZONE_BLOCKS);
+  }
+}
+
+/**********************************************************************/
+
+static CU_TestInfo tests[] = {
+  { "interleaved streams without locality", testInterleavedWithoutLocality },
+  { "interleaved streams with locality",    testInterleavedWithLocality    },
+  { "zone selection with locality",         testZoneSelection              },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Allocation locality (AllocationLocality_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = NULL,
+  .cleaner                  = tearDownVDOTest,
+  .tests                    = tests,
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
@@ -0,0 +1,149 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * Performance testing of data block comparison and zero detection.
+ *
+ * $Id$
+ */
+
+#include "assertions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include "constants.h"
+#include "data-vio.h"
+#include "dedupe.h"
+
+enum {
+  // Should be larger than CPU cache size.
+  BLOCK_COUNT = 10 * 1024,
+  ITERATIONS  = 200,
+};
+
+typedef bool (*ZeroCheck)(char *block);
+typedef bool (*BlockCompare)(char *block1, char *block2);
+
+static char *blocks;
+static char *copies;
+
+/**********************************************************************/
+static uint64_t cpuTime(void)
+{
+  /* user cpu time */
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) < 0) {
+    perror("getrusage");
+    exit(1);
+  }
+  return ((uint64_t) ru.ru_utime.tv_sec * 1000000) + ru.ru_utime.tv_usec;
+}
+
+/**
+ * The zero check used before the cache line stride version.
+ **/
+static bool wordAtATimeIsZero(char *block)
+{
+  for (int i = 0; i < VDO_BLOCK_SIZE; i += sizeof(uint64_t)) {
+    if (*((uint64_t *) &block[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * The block comparison used before the cache line stride version.
+ **/
+static bool wordAtATimeEqual(char *block1, char *block2)
+{
+  for (int i = 0; i < VDO_BLOCK_SIZE; i += sizeof(uint64_t)) {
+    if (*((uint64_t *) &block1[i]) != *((uint64_t *) &block2[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**********************************************************************/
+static void report(const char *name, uint64_t duration)
+{
+  double perBlock = (double) duration / ((uint64_t) ITERATIONS * BLOCK_COUNT);
+  printf("  %-24s %5.2fs (%6.1fns/block, %7.1fMB/s)\n",
+         name, duration * 1.0e-6, 1000 * perBlock,
+         (VDO_BLOCK_SIZE / perBlock) * (1.0e6 / (1024 * 1024)));
+}
+
+/**********************************************************************/
+static void timeZeroCheck(const char *name, ZeroCheck check, bool expected)
+{
+  uint64_t startTime = cpuTime();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+      CU_ASSERT_EQUAL(check(blocks + ((size_t) b * VDO_BLOCK_SIZE)), expected);
+    }
+  }
+  report(name, cpuTime() - startTime);
+}
+
+/**********************************************************************/
+static void timeCompare(const char *name, BlockCompare compare, bool expected)
+{
+  uint64_t startTime = cpuTime();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+      size_t offset = (size_t) b * VDO_BLOCK_SIZE;
+      CU_ASSERT_EQUAL(compare(blocks + offset, copies + offset), expected);
+    }
+  }
+  report(name, cpuTime() - startTime);
+}
+
+/**********************************************************************/
+int main(void)
+{
+  size_t size = (size_t) BLOCK_COUNT * VDO_BLOCK_SIZE;
+  CU_ASSERT_EQUAL(posix_memalign((void **) &blocks, VDO_BLOCK_SIZE, size), 0);
+  CU_ASSERT_EQUAL(posix_memalign((void **) &copies, VDO_BLOCK_SIZE, size), 0);
+
+  // Zero blocks must be examined in full, which is the worst case.
+  memset(blocks, 0, size);
+  printf("Zero detection, zero blocks:\n");
+  timeZeroCheck("word at a time", wordAtATimeIsZero, true);
+  timeZeroCheck("is_zero_block", is_zero_block, true);
+
+  // Blocks which are zero except for their last byte.
+  for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+    blocks[((size_t) b + 1) * VDO_BLOCK_SIZE - 1] = 1;
+  }
+  printf("Zero detection, non-zero final byte:\n");
+  timeZeroCheck("word at a time", wordAtATimeIsZero, false);
+  timeZeroCheck("is_zero_block", is_zero_block, false);
+
+  // A successful verification must also examine the whole block.
+  for (size_t i = 0; i < size; i++) {
+    blocks[i] = random() & 0xff;
+  }
+  memcpy(copies, blocks, size);
+  printf("Block comparison, identical blocks:\n");
+  timeCompare("word at a time", wordAtATimeEqual, true);
+  timeCompare("blocks_equal", blocks_equal, true);
+
+  for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+    copies[((size_t) b + 1) * VDO_BLOCK_SIZE - 1] ^= 1;
+  }
+  printf("Block comparison, differing final byte:\n");
+  timeCompare("word at a time", wordAtATimeEqual, false);
+  timeCompare("blocks_equal", blocks_equal, false);
+
+  free(blocks);
+  free(copies);
+  return 0;
+}
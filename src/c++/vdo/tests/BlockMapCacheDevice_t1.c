@@ -0,0 +1,206 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include "memory-alloc.h"
+
+#include "block-map.h"
+#include "vdo.h"
+#include "vio.h"
+
+#include "asyncLayer.h"
+#include "blockMapUtils.h"
+#include "ioRequest.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  CACHE_SIZE  = 16,
+  LEAF_PAGES  = 64,
+  TIER_BLOCKS = 128,
+};
+
+/* The contents of the fake block map cache device */
+static char *tierBlocks;
+/* Whether reads from the cache device should fail */
+static bool failTierReads;
+
+/**
+ * Perform I/O to the block map cache device on the in-memory copy of it.
+ *
+ * Implements BIOSubmitHook.
+ **/
+static bool handleTierIO(struct bio *bio)
+{
+  struct vio *vio = bio->bi_private;
+  if ((vio == NULL) || (vio->type != VIO_TYPE_BLOCK_MAP_TIER)) {
+    return true;
+  }
+
+  physical_block_number_t block = bio->bi_iter.bi_sector / VDO_SECTORS_PER_BLOCK;
+  CU_ASSERT(block < TIER_BLOCKS);
+  char *data = (char *) bio->bi_io_vec->bv_page;
+  char *tierBlock = &tierBlocks[block * VDO_BLOCK_SIZE];
+  bio->bi_status = BLK_STS_OK;
+  if (bio_data_dir(bio) == WRITE) {
+    memcpy(tierBlock, data, VDO_BLOCK_SIZE);
+  } else if (failTierReads) {
+    bio->bi_status = BLK_STS_VDO_INJECTED;
+  } else {
+    memcpy(data, tierBlock, VDO_BLOCK_SIZE);
+  }
+
+  bio->bi_end_io(bio);
+  return false;
+}
+
+/**
+ * Initialize a VDO with a small block map cache and a block map cache device,
+ * and write a block mapped by each leaf page so that every page is different.
+ **/
+static void initialize(void)
+{
+  TestParameters parameters = getBlockMapCacheParameters(LEAF_PAGES,
+                                                         CACHE_SIZE);
+  parameters.logicalThreadCount = 2;
+  parameters.blockMapCacheDeviceBlocks = TIER_BLOCKS;
+
+  VDO_ASSERT_SUCCESS(vdo_allocate(TIER_BLOCKS * VDO_BLOCK_SIZE, char, __func__,
+                                  &tierBlocks));
+  failTierReads = false;
+  initializeVDOTest(&parameters);
+  setBIOSubmitHook(handleTierIO);
+  writeLeafPages(0, LEAF_PAGES, 1);
+  restartVDO(false);
+}
+
+/**********************************************************************/
+static void tearDown(void)
+{
+  tearDownVDOTest();
+  vdo_free(vdo_forget(tierBlocks));
+}
+
+/**
+ * Get the number of block map pages which have been read from storage rather
+ * than the cache device.
+ **/
+static block_count_t getPagesReadFromStorage(void)
+{
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  return stats.pages_loaded - stats.tier_pages_read;
+}
+
+/**
+ * Test that pages evicted from the cache are written to the cache device and
+ * read back from it rather than from storage.
+ **/
+static void testEvictedPagesReadFromDevice(void)
+{
+  initialize();
+  verifyLeafPages(0, LEAF_PAGES, 1);
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_EQUAL(stats.pages_loaded, LEAF_PAGES);
+  CU_ASSERT_EQUAL(stats.tier_pages_read, 0);
+  CU_ASSERT_EQUAL(stats.tier_pages_written, LEAF_PAGES - CACHE_SIZE);
+
+  verifyLeafPages(0, LEAF_PAGES, 1);
+  stats = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_EQUAL(stats.pages_loaded, 2 * LEAF_PAGES);
+  CU_ASSERT_EQUAL(stats.tier_pages_read, LEAF_PAGES);
+  CU_ASSERT_EQUAL(stats.tier_pages_rejected, 0);
+  CU_ASSERT_EQUAL(getPagesReadFromStorage(), LEAF_PAGES);
+
+  // The cache device is empty after a restart.
+  restartVDO(false);
+  verifyLeafPages(0, LEAF_PAGES, 1);
+  stats = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_EQUAL(stats.tier_pages_read, 0);
+  CU_ASSERT_EQUAL(getPagesReadFromStorage(), LEAF_PAGES);
+}
+
+/**
+ * Test that copies of pages on the cache device which do not belong where
+ * they are found are rejected in favor of storage.
+ **/
+static void testInvalidPagesRejected(void)
+{
+  initialize();
+  verifyLeafPages(0, LEAF_PAGES, 1);
+
+  // Shift every block by one, so that each holds the wrong page.
+  char *first;
+  VDO_ASSERT_SUCCESS(vdo_allocate(VDO_BLOCK_SIZE, char, __func__, &first));
+  memcpy(first, tierBlocks, VDO_BLOCK_SIZE);
+  memmove(tierBlocks, tierBlocks + VDO_BLOCK_SIZE,
+          (TIER_BLOCKS - 1) * VDO_BLOCK_SIZE);
+  memcpy(tierBlocks + ((TIER_BLOCKS - 1) * VDO_BLOCK_SIZE), first,
+         VDO_BLOCK_SIZE);
+  vdo_free(first);
+
+  // Wipe the block which now holds the first zone's oldest page.
+  memset(tierBlocks, 0, VDO_BLOCK_SIZE);
+
+  /*
+   * Only the pages which were cached at the end of the first pass, and so
+   * were written to the cache device during this one, are read from it.
+   */
+  verifyLeafPages(0, LEAF_PAGES, 1);
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_EQUAL(stats.tier_pages_read, CACHE_SIZE);
+  CU_ASSERT_EQUAL(stats.tier_pages_rejected, LEAF_PAGES - CACHE_SIZE);
+  CU_ASSERT_EQUAL(getPagesReadFromStorage(), (2 * LEAF_PAGES) - CACHE_SIZE);
+  CU_ASSERT_FALSE(vdo_in_read_only_mode(vdo));
+}
+
+/**
+ * Test that a failed read from the cache device is retried from storage
+ * without putting the VDO into read-only mode.
+ **/
+static void testReadErrorsIgnored(void)
+{
+  initialize();
+  verifyLeafPages(0, LEAF_PAGES, 1);
+  failTierReads = true;
+  verifyLeafPages(0, LEAF_PAGES, 1);
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_EQUAL(stats.tier_pages_read, 0);
+  CU_ASSERT_EQUAL(stats.tier_pages_rejected, LEAF_PAGES);
+  CU_ASSERT_EQUAL(getPagesReadFromStorage(), 2 * LEAF_PAGES);
+  CU_ASSERT_FALSE(vdo_in_read_only_mode(vdo));
+}
+
+/**********************************************************************/
+
+static CU_TestInfo tests[] = {
+  { "evicted pages are read from the cache device",
+    testEvictedPagesReadFromDevice                                  },
+  { "invalid pages on the cache device are rejected",
+    testInvalidPagesRejected                                        },
+  { "cache device read errors fall back to storage",
+    testReadErrorsIgnored                                           },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Block map cache device (BlockMapCacheDevice_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = NULL,
+  .cleaner                  = tearDown,
+  .tests                    = tests,
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
@@ -0,0 +1,144 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include <stdlib.h>
+
+#include "albtest.h"
+
+#include "block-map.h"
+#include "vdo.h"
+
+#include "blockMapUtils.h"
+#include "ioRequest.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  CACHE_SIZE = 64,
+  LEAF_PAGES = 240,
+  READAHEAD  = 8,
+};
+
+/**
+ * Initialize a VDO with a small block map cache and allocate its whole block
+ * map tree, then restart it so that neither the tree nor the cache is loaded.
+ *
+ * @param readahead  The number of block map pages to read ahead
+ **/
+static void initialize(unsigned int readahead)
+{
+  TestParameters parameters = getBlockMapCacheParameters(LEAF_PAGES,
+                                                         CACHE_SIZE);
+  parameters.blockMapReadahead = readahead;
+  initializePopulatedBlockMap(&parameters, true);
+}
+
+/**
+ * Read the first block mapped by each leaf page, in order, and return the
+ * block map statistics once the pages read ahead have finished loading.
+ *
+ * @param readahead  The number of block map pages to read ahead
+ **/
+static struct block_map_statistics readSequentially(unsigned int readahead)
+{
+  initialize(readahead);
+  readLeafPages(0, LEAF_PAGES);
+  waitForBlockMapCacheIdle();
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  tearDownVDOTest();
+  return stats;
+}
+
+/**
+ * Test that a sequential stream of leaf page fetches is read ahead, and that
+ * the pages read ahead are used.
+ **/
+static void testSequentialReadahead(void)
+{
+  struct block_map_statistics without = readSequentially(0);
+  CU_ASSERT_EQUAL(without.readahead_pages, 0);
+  CU_ASSERT_EQUAL(without.pages_loaded, LEAF_PAGES);
+  CU_ASSERT_EQUAL(without.fetch_required + without.discard_required,
+                  LEAF_PAGES);
+
+  struct block_map_statistics with = readSequentially(READAHEAD);
+  CU_ASSERT(with.readahead_pages > 0);
+  CU_ASSERT_EQUAL(with.readahead_wasted, 0);
+  CU_ASSERT(with.readahead_used + READAHEAD >= with.readahead_pages);
+  CU_ASSERT_EQUAL(with.pages_loaded,
+                  (without.pages_loaded + with.readahead_pages
+                   - with.readahead_used));
+  CU_ASSERT(with.fetch_required + with.discard_required
+            < without.fetch_required + without.discard_required);
+
+  // The suite cleaner will tear down again.
+  initialize(0);
+}
+
+/**
+ * Test that fetches of leaf pages in no particular order are not read ahead.
+ **/
+static void testRandomNoReadahead(void)
+{
+  initialize(READAHEAD);
+  srandom(42);
+  for (unsigned int i = 0; i < LEAF_PAGES; i++) {
+    readLeafPages(random() % LEAF_PAGES, 1);
+  }
+
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT(stats.readahead_pages <= READAHEAD);
+}
+
+/**
+ * Test that reading ahead while the cache is full of dirty pages does not
+ * lose any of their updates.
+ **/
+static void testReadaheadWithDirtyPages(void)
+{
+  initialize(READAHEAD);
+
+  // Dirty every page the cache can hold, then read sequentially past them.
+  for (page_number_t page = 0; page < CACHE_SIZE; page++) {
+    writeData(page * VDO_BLOCK_MAP_ENTRIES_PER_PAGE, page, 1, VDO_SUCCESS);
+  }
+
+  readLeafPages(CACHE_SIZE, LEAF_PAGES - CACHE_SIZE);
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT(stats.readahead_pages > 0);
+
+  restartVDO(false);
+  for (page_number_t page = 0; page < CACHE_SIZE; page++) {
+    verifyData(page * VDO_BLOCK_MAP_ENTRIES_PER_PAGE, page, 1);
+  }
+}
+
+/**********************************************************************/
+
+static CU_TestInfo tests[] = {
+  { "sequential fetches are read ahead", testSequentialReadahead     },
+  { "random fetches are not",            testRandomNoReadahead       },
+  { "readahead with dirty pages",        testReadaheadWithDirtyPages },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Block map readahead (BlockMapReadahead_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = NULL,
+  .cleaner                  = tearDownVDOTest,
+  .tests                    = tests,
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
@@ -0,0 +1,189 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include "block-map.h"
+#include "encodings.h"
+#include "status-codes.h"
+#include "vdo.h"
+
+#include "asyncLayer.h"
+#include "blockMapUtils.h"
+#include "ioRequest.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  CACHE_SIZE = 256,
+  LEAF_PAGES = 240,
+};
+
+/**
+ * Initialize a VDO with two logical zones and its whole block map tree
+ * allocated.
+ *
+ * @param warmup  Whether the VDO should warm up its cache when loaded
+ **/
+static void initialize(bool warmup)
+{
+  TestParameters parameters = getBlockMapCacheParameters(LEAF_PAGES,
+                                                         CACHE_SIZE);
+  parameters.logicalThreadCount = 2;
+  parameters.disableBlockMapWarmup = !warmup;
+  initializePopulatedBlockMap(&parameters, false);
+}
+
+/**
+ * Test that the pages cached when a VDO is saved are recorded in the super
+ * block, that the list survives encoding, and that a damaged or missing list
+ * is rejected.
+ **/
+static void testEncoding(void)
+{
+  static struct hot_page_list list, decoded;
+  u8 buffer[VDO_BLOCK_SIZE];
+
+  initialize(true);
+  readLeafPages(0, LEAF_PAGES);
+  restartVDO(false);
+  VDO_ASSERT_SUCCESS(layer->reader(layer, getSuperBlockLocation(), 1,
+                                   (char *) buffer));
+  VDO_ASSERT_SUCCESS(vdo_decode_hot_page_list(buffer, &decoded));
+  CU_ASSERT_EQUAL(2, decoded.zone_count);
+  page_count_t pages = 0;
+  for (u16 i = 0; i < decoded.run_count; i++) {
+    pages += decoded.runs[i].page_count;
+  }
+  CU_ASSERT_EQUAL(LEAF_PAGES, pages);
+
+  memset(buffer, 0, sizeof(buffer));
+  CU_ASSERT_EQUAL(VDO_INCORRECT_COMPONENT,
+                  vdo_decode_hot_page_list(buffer, &decoded));
+  CU_ASSERT_EQUAL(0, decoded.run_count);
+
+  list.zone_count = 3;
+  list.run_count = VDO_MAX_HOT_PAGE_RUNS;
+  for (u16 i = 0; i < list.run_count; i++) {
+    list.runs[i] = (struct hot_page_run) {
+      .pbn        = 1000 + (i * 37),
+      .page_count = i + 1,
+      .zone       = i % 3,
+    };
+  }
+
+  vdo_encode_hot_page_list(buffer, &list);
+  VDO_ASSERT_SUCCESS(vdo_decode_hot_page_list(buffer, &decoded));
+  CU_ASSERT_EQUAL(list.zone_count, decoded.zone_count);
+  CU_ASSERT_EQUAL(list.run_count, decoded.run_count);
+  for (u16 i = 0; i < list.run_count; i++) {
+    CU_ASSERT_EQUAL(list.runs[i].pbn, decoded.runs[i].pbn);
+    CU_ASSERT_EQUAL(list.runs[i].page_count, decoded.runs[i].page_count);
+    CU_ASSERT_EQUAL(list.runs[i].zone, decoded.runs[i].zone);
+  }
+
+  // The super block proper occupies only the first sector.
+  CU_ASSERT_EQUAL(0, buffer[VDO_SECTOR_SIZE - 1]);
+
+  buffer[VDO_BLOCK_SIZE - 100]++;
+  CU_ASSERT_EQUAL(VDO_CHECKSUM_MISMATCH,
+                  vdo_decode_hot_page_list(buffer, &decoded));
+  CU_ASSERT_EQUAL(0, decoded.run_count);
+}
+
+/**
+ * Test that the pages cached when a VDO is saved are loaded when it restarts.
+ **/
+static void testWarmupAfterRestart(void)
+{
+  initialize(true);
+  readLeafPages(0, LEAF_PAGES);
+  restartVDO(false);
+  waitForBlockMapCacheIdle();
+
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_EQUAL(stats.warmup_pages, LEAF_PAGES);
+  CU_ASSERT_EQUAL(stats.pages_loaded, LEAF_PAGES);
+
+  // Every leaf page is now found in the cache.
+  readLeafPages(0, LEAF_PAGES);
+  struct block_map_statistics after
+    = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_EQUAL(after.pages_loaded, stats.pages_loaded);
+  CU_ASSERT_EQUAL(after.fetch_required, stats.fetch_required);
+  CU_ASSERT_EQUAL(after.found_in_cache - stats.found_in_cache, LEAF_PAGES);
+}
+
+/**
+ * Test that the warm-up can be started and cancelled while the VDO runs.
+ **/
+static void testWarmupMessages(void)
+{
+  initialize(true);
+  readLeafPages(0, LEAF_PAGES);
+  restartVDO(false);
+  waitForBlockMapCacheIdle();
+
+  // Starting again loads nothing, since every page is already cached.
+  VDO_ASSERT_SUCCESS(vdo_warm_up_block_map_cache(vdo, true));
+  waitForBlockMapCacheIdle();
+  VDO_ASSERT_SUCCESS(vdo_warm_up_block_map_cache(vdo, false));
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_EQUAL(stats.warmup_pages, LEAF_PAGES);
+
+  // A suspend without saving keeps the list from the last save.
+  performSuccessfulSuspendAndResume(false);
+  CU_ASSERT_NOT_EQUAL(0, vdo->block_map->hot_pages.run_count);
+}
+
+/**
+ * Test that the cache is not warmed up on load if warm-up is disabled, but
+ * that the list of cached pages is still saved and may be loaded on request.
+ **/
+static void testWarmupDisabled(void)
+{
+  initialize(false);
+  readLeafPages(0, LEAF_PAGES);
+  restartVDO(false);
+  waitForBlockMapCacheIdle();
+
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_EQUAL(stats.warmup_pages, 0);
+  CU_ASSERT_EQUAL(stats.pages_loaded, 0);
+
+  VDO_ASSERT_SUCCESS(vdo_warm_up_block_map_cache(vdo, true));
+  waitForBlockMapCacheIdle();
+  stats = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_EQUAL(stats.warmup_pages, LEAF_PAGES);
+}
+
+/**********************************************************************/
+
+static CU_TestInfo tests[] = {
+  { "hot page list encoding",           testEncoding           },
+  { "cache is warmed up after restart", testWarmupAfterRestart },
+  { "warm-up start and cancel",         testWarmupMessages     },
+  { "warm-up on load may be disabled",  testWarmupDisabled     },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Block map cache warm-up (BlockMapWarmup_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = NULL,
+  .cleaner                  = tearDownVDOTest,
+  .tests                    = tests,
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
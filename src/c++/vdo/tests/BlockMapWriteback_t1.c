@@ -0,0 +1,185 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include "block-map.h"
+#include "int-map.h"
+#include "vdo.h"
+
+#include "asyncLayer.h"
+#include "asyncVIO.h"
+#include "blockMapUtils.h"
+#include "ioRequest.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  CACHE_SIZE = 256,
+  LEAF_PAGES = 240,
+  // The first leaf page of each tree is allocated along with its ancestors.
+  FIRST_PAGE = DEFAULT_VDO_BLOCK_MAP_TREE_ROOT_COUNT,
+};
+
+/* The first PBN of the multi-page write which failed */
+static physical_block_number_t failedPBN;
+/* The number of pages in the multi-page write which failed */
+static page_count_t failedPages;
+
+/**
+ * Initialize a VDO with its whole block map tree allocated, so that most
+ * leaf pages have consecutive PBNs.
+ **/
+static void initialize(void)
+{
+  TestParameters parameters = getBlockMapCacheParameters(LEAF_PAGES,
+                                                         CACHE_SIZE);
+  initializePopulatedBlockMap(&parameters, true);
+}
+
+/**
+ * Save the dirty block map pages, and return the number of pages saved and
+ * the number of writes used to save them.
+ **/
+static void saveDirtyPages(u64 *pagesSaved, u64 *writesIssued)
+{
+  struct block_map_statistics before
+    = vdo_get_block_map_statistics(vdo->block_map);
+  performSuccessfulSuspendAndResume(true);
+  struct block_map_statistics after
+    = vdo_get_block_map_statistics(vdo->block_map);
+  *pagesSaved = after.pages_saved - before.pages_saved;
+  *writesIssued = after.writes_issued - before.writes_issued;
+}
+
+/**
+ * Test that dirty leaf pages with consecutive PBNs are saved together.
+ **/
+static void testConsecutivePagesCombined(void)
+{
+  initialize();
+  writeLeafPages(FIRST_PAGE, LEAF_PAGES - FIRST_PAGE, 1);
+
+  u64 pagesSaved, writesIssued;
+  saveDirtyPages(&pagesSaved, &writesIssued);
+  CU_ASSERT_EQUAL(pagesSaved, LEAF_PAGES - FIRST_PAGE);
+  CU_ASSERT_EQUAL(writesIssued,
+                  DIV_ROUND_UP(pagesSaved, BLOCK_MAP_MAX_PAGES_PER_WRITE));
+
+  restartVDO(false);
+  verifyLeafPages(FIRST_PAGE, LEAF_PAGES - FIRST_PAGE, 1);
+}
+
+/**
+ * Test that dirty leaf pages which are not adjacent are saved one at a time.
+ **/
+static void testScatteredPagesNotCombined(void)
+{
+  initialize();
+  writeLeafPages(FIRST_PAGE, LEAF_PAGES - FIRST_PAGE, 2);
+
+  u64 pagesSaved, writesIssued;
+  saveDirtyPages(&pagesSaved, &writesIssued);
+  CU_ASSERT_EQUAL(pagesSaved, (LEAF_PAGES - FIRST_PAGE) / 2);
+  CU_ASSERT_EQUAL(writesIssued, pagesSaved);
+
+  restartVDO(false);
+  verifyLeafPages(FIRST_PAGE, LEAF_PAGES - FIRST_PAGE, 2);
+}
+
+/**
+ * Fail the first block map write of more than one page.
+ *
+ * Implements BIOSubmitHook.
+ **/
+static bool failPageRunWrite(struct bio *bio)
+{
+  struct vio *vio = bio->bi_private;
+  if ((failedPages > 0)
+      || !vioTypeIs(&vio->completion, VIO_TYPE_BLOCK_MAP)
+      || !isMetadataWrite(&vio->completion)
+      || (bio->bi_iter.bi_size <= VDO_BLOCK_SIZE)) {
+    return true;
+  }
+
+  failedPBN = pbnFromVIO(vio);
+  failedPages = bio->bi_iter.bi_size / VDO_BLOCK_SIZE;
+  bio->bi_status = BLK_STS_VDO_INJECTED;
+  bio->bi_end_io(bio);
+  return false;
+}
+
+/**
+ * Check that no page in the cache of the current zone is still being written,
+ * and that each page of the failed write is dirty again.
+ *
+ * Implements vdo_action_fn.
+ **/
+static void checkFailedRunReleased(struct vdo_completion *completion)
+{
+  struct block_map_zone *zone = &vdo->block_map->zones[0];
+  struct vdo_page_cache *cache = &zone->page_cache;
+  CU_ASSERT_EQUAL(cache->outstanding_writes, 0);
+  CU_ASSERT_TRUE(list_empty(&cache->outgoing_list));
+  CU_ASSERT_TRUE(list_empty(&cache->write_list));
+  CU_ASSERT_FALSE(is_vio_pool_busy(cache->write_vio_pool));
+  for (page_count_t i = 0; i < failedPages; i++) {
+    struct page_info *info = vdo_int_map_get(cache->page_map, failedPBN + i);
+    CU_ASSERT_PTR_NOT_NULL(info);
+    CU_ASSERT_EQUAL(info->state, PS_DIRTY);
+    CU_ASSERT_EQUAL(info->busy, 0);
+  }
+
+  vdo_finish_completion(completion);
+}
+
+/**
+ * Test that a failed write of a run of pages puts the vdo in read-only mode
+ * and releases every page in the run.
+ **/
+static void testPageRunWriteError(void)
+{
+  initialize();
+  writeLeafPages(FIRST_PAGE, LEAF_PAGES - FIRST_PAGE, 1);
+
+  failedPages = 0;
+  setBIOSubmitHook(failPageRunWrite);
+  CU_ASSERT_EQUAL(suspendVDO(true), VDO_READ_ONLY);
+  clearBIOSubmitHook();
+  CU_ASSERT_TRUE(failedPages > 1);
+  CU_ASSERT_TRUE(vdo_in_read_only_mode(vdo));
+
+  struct block_map_statistics stats
+    = vdo_get_block_map_statistics(vdo->block_map);
+  CU_ASSERT_TRUE(stats.failed_writes >= failedPages);
+  performSuccessfulActionOnThread(checkFailedRunReleased,
+                                  vdo->block_map->zones[0].thread_id);
+  setStartStopExpectation(VDO_READ_ONLY);
+}
+
+/**********************************************************************/
+
+static CU_TestInfo tests[] = {
+  { "consecutive pages are combined",   testConsecutivePagesCombined  },
+  { "scattered pages are not combined", testScatteredPagesNotCombined },
+  { "page run write error",             testPageRunWriteError         },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Block map writeback (BlockMapWriteback_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = NULL,
+  .cleaner                  = tearDownVDOTest,
+  .tests                    = tests,
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
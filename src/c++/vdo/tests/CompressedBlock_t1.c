@@ -66,7 +66,7 @@ static void testInvalidBlock(void)
 /**********************************************************************/
 static void testAbsurdBlock(void)
 {
-  initialize_compressed_block(&compressedBlock, 101);
+  initialize_compressed_block(&compressedBlock, 101, VDO_CODEC_LZ4);
   for (unsigned int i = 1; i < VDO_MAX_COMPRESSION_SLOTS; ++i) {
     compressedBlock.header.sizes[i] = __cpu_to_le16(VDO_BLOCK_SIZE + i * 101);
   }
@@ -111,7 +111,8 @@ static void testValidFragments(void)
     if (i == 0) {
       /* The compressor will put the fragment 0 data in place already */
       memcpy(compressedBlock.data, originalData, offsets[1]);
-      initialize_compressed_block(&compressedBlock, offsets[1]);
+      initialize_compressed_block(&compressedBlock, offsets[1],
+                                  VDO_CODEC_LZ4);
       continue;
     }
 
@@ -0,0 +1,159 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * Performance testing of the compression codecs and the fast-reject check
+ * on data shaped like that of the genDataBlocks tool.
+ *
+ * $Id$
+ */
+
+#include "assertions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include "compression.h"
+#include "constants.h"
+#include "packer.h"
+
+enum {
+  // Should be larger than CPU cache size.
+  BLOCK_COUNT = 4 * 1024,
+  ITERATIONS  = 10,
+};
+
+typedef struct {
+  const char                 *name;
+  enum vdo_compression_codec  codec;
+  int                         level;
+  bool                        fastReject;
+} Compressor;
+
+static const Compressor COMPRESSORS[] = {
+  { "fast-reject check only", VDO_CODEC_COUNT,   0, true  },
+  { "lz4",                    VDO_CODEC_LZ4,     1, false },
+  { "lz4 with fast-reject",   VDO_CODEC_LZ4,     1, true  },
+  { "deflate:1",              VDO_CODEC_DEFLATE, 1, false },
+  { "deflate:1 fast-reject",  VDO_CODEC_DEFLATE, 1, true  },
+  { "deflate:6",              VDO_CODEC_DEFLATE, 6, false },
+};
+
+// The compression fractions of the genDataBlocks streams to time.
+static const double COMPRESS_FRACTIONS[] = { 0.0, 0.1, 0.25, 0.5, 0.75, 0.9 };
+
+static char *blocks;
+static char *fragment;
+static char *workspace;
+
+/**********************************************************************/
+static uint64_t cpuTime(void)
+{
+  /* user cpu time */
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) < 0) {
+    perror("getrusage");
+    exit(1);
+  }
+  return ((uint64_t) ru.ru_utime.tv_sec * 1000000) + ru.ru_utime.tv_usec;
+}
+
+/**
+ * Generate a block the way genDataBlocks generates a block of a tagged
+ * stream: a header naming the stream and block, then random data, then
+ * enough zeros to make the block compressible by the given fraction.
+ **/
+static void generateBlock(char *block, unsigned int number, double compress)
+{
+  int nData = VDO_BLOCK_SIZE - (int) (VDO_BLOCK_SIZE * compress);
+  memset(block, 0, VDO_BLOCK_SIZE);
+  memcpy(block, "Compress", 8);
+  memcpy(&block[8], &number, sizeof(number));
+  srandom(number + 1);
+  for (int i = 16; i < nData; i++) {
+    block[i] = random() & 0xff;
+  }
+}
+
+/**
+ * Compress every block, returning the number which fit in a fragment and
+ * accumulating their compressed sizes.
+ **/
+static unsigned int compressAll(const Compressor *compressor,
+                                uint64_t         *totalSize)
+{
+  unsigned int compressed = 0;
+  for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+    char *block = &blocks[(size_t) b * VDO_BLOCK_SIZE];
+    if (compressor->fastReject && vdo_is_probably_incompressible(block)) {
+      continue;
+    }
+
+    if (compressor->codec == VDO_CODEC_COUNT) {
+      continue;
+    }
+
+    int size = vdo_compress_block(compressor->codec, compressor->level, block,
+                                  fragment, VDO_MAX_COMPRESSED_FRAGMENT_SIZE,
+                                  workspace);
+    if (size > 0) {
+      compressed++;
+      *totalSize += size;
+    }
+  }
+
+  return compressed;
+}
+
+/**********************************************************************/
+static void timeCompressor(const Compressor *compressor)
+{
+  uint64_t totalSize = 0;
+  unsigned int compressed = 0;
+  uint64_t startTime = cpuTime();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    compressed = compressAll(compressor, &totalSize);
+  }
+
+  uint64_t duration = cpuTime() - startTime;
+  double perBlock = (double) duration / ((uint64_t) ITERATIONS * BLOCK_COUNT);
+  double averageSize
+    = ((compressed == 0) ? 0 : (double) totalSize / ((uint64_t) ITERATIONS * compressed));
+  printf("  %-24s %7.2fus/block %7.1fMB/s %5.1f%% compressed, average %6.0f bytes\n",
+         compressor->name, perBlock,
+         (VDO_BLOCK_SIZE / perBlock) * (1.0e6 / (1024 * 1024)),
+         (100.0 * compressed) / BLOCK_COUNT, averageSize);
+}
+
+/**********************************************************************/
+int main(void)
+{
+  size_t size = (size_t) BLOCK_COUNT * VDO_BLOCK_SIZE;
+  CU_ASSERT_EQUAL(posix_memalign((void **) &blocks, VDO_BLOCK_SIZE, size), 0);
+  fragment = malloc(VDO_BLOCK_SIZE);
+  workspace = malloc(vdo_get_compression_workspace_size());
+  CU_ASSERT_PTR_NOT_NULL(fragment);
+  CU_ASSERT_PTR_NOT_NULL(workspace);
+
+  for (unsigned int f = 0; f < ARRAY_SIZE(COMPRESS_FRACTIONS); f++) {
+    for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+      generateBlock(&blocks[(size_t) b * VDO_BLOCK_SIZE], b,
+                    COMPRESS_FRACTIONS[f]);
+    }
+
+    printf("genDataBlocks stream with compression %.2f:\n",
+           COMPRESS_FRACTIONS[f]);
+    for (unsigned int c = 0; c < ARRAY_SIZE(COMPRESSORS); c++) {
+      timeCompressor(&COMPRESSORS[c]);
+    }
+  }
+
+  free(blocks);
+  free(fragment);
+  free(workspace);
+  return 0;
+}
@@ -0,0 +1,329 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * Tests of the selectable compression codecs and the fast-reject check.
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include "memory-alloc.h"
+
+#include "compression.h"
+#include "packer.h"
+#include "vdo.h"
+
+#include "blockMapUtils.h"
+#include "dataBlocks.h"
+#include "ioRequest.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  // Blocks with at least this index are filled with random bytes.
+  RANDOM_INDEX = 1000,
+};
+
+static char *block;
+static char *fragment;
+static char *workspace;
+
+/**
+ * Fill a block with bytes from a simple generator seeded by an index.
+ **/
+static void fillRandomly(char *buffer, size_t size, uint64_t seed)
+{
+  uint64_t state = seed * 0x9e3779b97f4a7c15UL + 1;
+  for (size_t i = 0; i < size; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    buffer[i] = state >> 56;
+  }
+}
+
+/**
+ * Fill blocks with compressible data at low indexes and random data at high
+ * ones.
+ *
+ * <p>Implements DataFormatter.
+ **/
+static void fillMixed(char *buffer, block_count_t index)
+{
+  if (index < RANDOM_INDEX) {
+    fillWithOffset(buffer, index);
+  } else {
+    fillRandomly(buffer, VDO_BLOCK_SIZE, index);
+  }
+}
+
+/**
+ * Fill a block the way genDataBlocks does: random data followed by enough
+ * zeros to make the block compress by the given percentage.
+ **/
+static void fillPartlyRandom(char *buffer, uint64_t seed, unsigned int percent)
+{
+  size_t randomBytes = VDO_BLOCK_SIZE - (VDO_BLOCK_SIZE * percent / 100);
+  memset(buffer, 0, VDO_BLOCK_SIZE);
+  fillRandomly(buffer, randomBytes, seed);
+}
+
+/**
+ * Fill a block with English-like text.
+ **/
+static void fillWithText(char *buffer)
+{
+  static const char *WORDS[] = {
+    "the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dog ",
+    "and ", "then ", "sleeps. ", "A ", "vdo ", "volume ", "compresses ",
+  };
+  uint64_t state = 1;
+  size_t offset = 0;
+  while (offset < VDO_BLOCK_SIZE) {
+    state = state * 6364136223846793005UL + 1442695040888963407UL;
+    const char *word = WORDS[(state >> 33) % ARRAY_SIZE(WORDS)];
+    size_t length = min(strlen(word), (size_t) VDO_BLOCK_SIZE - offset);
+    memcpy(&buffer[offset], word, length);
+    offset += length;
+  }
+}
+
+/**
+ * Test-specific initialization.
+ **/
+static void initializeCompressionT3(void)
+{
+  const TestParameters parameters = {
+    .mappableBlocks        = 256,
+    .logicalBlocks         = 256 * 3,
+    .journalBlocks         = 32,
+    .enableCompression     = true,
+    .compressionCodec      = VDO_CODEC_DEFLATE,
+    .compressionLevel      = 6,
+    .compressionFastReject = true,
+    .dataFormatter         = fillMixed,
+  };
+  initializeVDOTest(&parameters);
+
+  VDO_ASSERT_SUCCESS(vdo_allocate(VDO_BLOCK_SIZE, char, __func__, &block));
+  VDO_ASSERT_SUCCESS(vdo_allocate(VDO_BLOCK_SIZE, char, __func__, &fragment));
+  VDO_ASSERT_SUCCESS(vdo_allocate(vdo_get_compression_workspace_size(), char,
+                                  __func__, &workspace));
+}
+
+/**
+ * Test-specific tear down.
+ **/
+static void tearDownCompressionT3(void)
+{
+  vdo_free(vdo_forget(block));
+  vdo_free(vdo_forget(fragment));
+  vdo_free(vdo_forget(workspace));
+  tearDownVDOTest();
+}
+
+/**
+ * Compress the test block with a codec and check that it decompresses to the
+ * original, and that a truncated fragment is rejected.
+ *
+ * @return The size of the compressed fragment
+ **/
+static int checkRoundTrip(enum vdo_compression_codec codec, int level)
+{
+  int size = vdo_compress_block(codec, level, block, fragment,
+                                VDO_MAX_COMPRESSED_FRAGMENT_SIZE, workspace);
+  CU_ASSERT_TRUE(size > 0);
+  CU_ASSERT_TRUE(size < VDO_BLOCK_SIZE * 3 / 4);
+
+  char buffer[VDO_BLOCK_SIZE];
+  VDO_ASSERT_SUCCESS(vdo_decompress_fragment(codec, fragment, size, buffer,
+                                             workspace));
+  UDS_ASSERT_EQUAL_BYTES(block, buffer, VDO_BLOCK_SIZE);
+
+  CU_ASSERT_EQUAL(vdo_decompress_fragment(codec, fragment, size / 2, buffer,
+                                          workspace),
+                  VDO_INVALID_FRAGMENT);
+  return size;
+}
+
+/**
+ * Test that each codec round trips, and that the codecs can be found by name.
+ **/
+static void testCodecs(void)
+{
+  fillWithText(block);
+  for (enum vdo_compression_codec codec = 0; codec < VDO_CODEC_COUNT;
+       codec++) {
+    const char *name = vdo_get_compression_codec_name(codec);
+    enum vdo_compression_codec parsed;
+    VDO_ASSERT_SUCCESS(vdo_parse_compression_codec(name, strlen(name),
+                                                   &parsed));
+    CU_ASSERT_EQUAL(parsed, codec);
+    int level = vdo_get_default_compression_level(codec);
+    VDO_ASSERT_SUCCESS(vdo_validate_compression_level(codec, level));
+    checkRoundTrip(codec, level);
+  }
+
+  // Names must match exactly.
+  enum vdo_compression_codec parsed;
+  CU_ASSERT_EQUAL(vdo_parse_compression_codec("lz", 2, &parsed),
+                  VDO_BAD_CONFIGURATION);
+  CU_ASSERT_EQUAL(vdo_parse_compression_codec("deflated", 8, &parsed),
+                  VDO_BAD_CONFIGURATION);
+
+  // Deflate takes zlib levels, and compresses text better at higher ones.
+  CU_ASSERT_EQUAL(vdo_validate_compression_level(VDO_CODEC_DEFLATE, 0),
+                  VDO_BAD_CONFIGURATION);
+  CU_ASSERT_EQUAL(vdo_validate_compression_level(VDO_CODEC_DEFLATE, 10),
+                  VDO_BAD_CONFIGURATION);
+  CU_ASSERT_TRUE(checkRoundTrip(VDO_CODEC_DEFLATE, 9)
+                 <= checkRoundTrip(VDO_CODEC_DEFLATE, 1));
+  CU_ASSERT_TRUE(checkRoundTrip(VDO_CODEC_DEFLATE, 6)
+                 < checkRoundTrip(VDO_CODEC_LZ4, 1));
+
+  // Random data can't be compressed into a fragment.
+  fillRandomly(block, VDO_BLOCK_SIZE, 1);
+  for (enum vdo_compression_codec codec = 0; codec < VDO_CODEC_COUNT;
+       codec++) {
+    int level = vdo_get_default_compression_level(codec);
+    CU_ASSERT_EQUAL(vdo_compress_block(codec, level, block, fragment,
+                                       VDO_MAX_COMPRESSED_FRAGMENT_SIZE,
+                                       workspace),
+                    0);
+  }
+}
+
+/**
+ * Test that the fast-reject check rejects only data which no codec could
+ * compress.
+ **/
+static void testFastReject(void)
+{
+  for (uint64_t seed = 1; seed <= 100; seed++) {
+    fillRandomly(block, VDO_BLOCK_SIZE, seed);
+    CU_ASSERT_TRUE(vdo_is_probably_incompressible(block));
+
+    // genDataBlocks data which compresses by a quarter or more.
+    fillPartlyRandom(block, seed, 25);
+    CU_ASSERT_FALSE(vdo_is_probably_incompressible(block));
+    fillPartlyRandom(block, seed, 50);
+    CU_ASSERT_FALSE(vdo_is_probably_incompressible(block));
+
+    // Random data repeated is compressible despite its byte distribution.
+    fillRandomly(block, VDO_BLOCK_SIZE / 2, seed);
+    memcpy(&block[VDO_BLOCK_SIZE / 2], block, VDO_BLOCK_SIZE / 2);
+    CU_ASSERT_FALSE(vdo_is_probably_incompressible(block));
+  }
+
+  fillWithText(block);
+  CU_ASSERT_FALSE(vdo_is_probably_incompressible(block));
+  fillWithOffset(block, 12345);
+  CU_ASSERT_FALSE(vdo_is_probably_incompressible(block));
+}
+
+/**
+ * Test that blocks written with deflate are marked as such and read back
+ * correctly, and that random blocks are not compressed.
+ **/
+static void testDeflateVolume(void)
+{
+  // A full bin of compressible blocks is written as one compressed block.
+  writeData(0, 1, VDO_MAX_COMPRESSION_SLOTS, VDO_SUCCESS);
+  struct zoned_pbn mapping = lookupLBN(0);
+  CU_ASSERT_TRUE(vdo_is_state_compressed(mapping.state));
+  for (logical_block_number_t lbn = 1; lbn < VDO_MAX_COMPRESSION_SLOTS; lbn++) {
+    struct zoned_pbn other = lookupLBN(lbn);
+    CU_ASSERT_TRUE(vdo_is_state_compressed(other.state));
+    CU_ASSERT_EQUAL(other.pbn, mapping.pbn);
+  }
+
+  struct compressed_block *compressed = (struct compressed_block *) block;
+  VDO_ASSERT_SUCCESS(layer->reader(layer, mapping.pbn, 1, block));
+  CU_ASSERT_EQUAL(vdo_get_compressed_block_codec(compressed),
+                  VDO_CODEC_DEFLATE);
+  uint16_t offset, size;
+  VDO_ASSERT_SUCCESS(vdo_get_compressed_block_fragment(mapping.state,
+                                                       compressed, &offset,
+                                                       &size));
+  char buffer[VDO_BLOCK_SIZE];
+  VDO_ASSERT_SUCCESS(vdo_decompress_fragment(VDO_CODEC_DEFLATE,
+                                             &compressed->data[offset], size,
+                                             buffer, workspace));
+  UDS_ASSERT_EQUAL_BYTES(buffer, getDataBlock(1), VDO_BLOCK_SIZE);
+
+  // A codec which this version doesn't know is rejected.
+  compressed->header.version.minor_version = __cpu_to_le32(VDO_CODEC_COUNT);
+  CU_ASSERT_EQUAL(vdo_get_compressed_block_fragment(mapping.state, compressed,
+                                                    &offset, &size),
+                  VDO_INVALID_FRAGMENT);
+
+  verifyData(0, 1, VDO_MAX_COMPRESSION_SLOTS);
+
+  // Random blocks are rejected before reaching the packer.
+  writeData(VDO_MAX_COMPRESSION_SLOTS, RANDOM_INDEX, VDO_MAX_COMPRESSION_SLOTS,
+            VDO_SUCCESS);
+  for (logical_block_number_t lbn = VDO_MAX_COMPRESSION_SLOTS;
+       lbn < 2 * VDO_MAX_COMPRESSION_SLOTS; lbn++) {
+    CU_ASSERT_EQUAL(lookupLBN(lbn).state, VDO_MAPPING_STATE_UNCOMPRESSED);
+  }
+
+  verifyData(VDO_MAX_COMPRESSION_SLOTS, RANDOM_INDEX,
+             VDO_MAX_COMPRESSION_SLOTS);
+}
+
+/**
+ * Test that the compression statistics account for every block, and that
+ * fast-reject predictions are periodically checked.
+ **/
+static void testFastRejectStatistics(void)
+{
+  enum {
+    COMPRESSIBLE_BLOCKS = 2 * VDO_MAX_COMPRESSION_SLOTS,
+    RANDOM_BLOCKS       = 128,
+  };
+
+  writeData(0, 1, COMPRESSIBLE_BLOCKS, VDO_SUCCESS);
+  writeData(COMPRESSIBLE_BLOCKS, RANDOM_INDEX, RANDOM_BLOCKS, VDO_SUCCESS);
+
+  struct vdo_statistics stats;
+  vdo_fetch_statistics(vdo, &stats);
+  CU_ASSERT_EQUAL(stats.compression.attempts, COMPRESSIBLE_BLOCKS);
+  CU_ASSERT_EQUAL(stats.compression.failures, 0);
+  CU_ASSERT_EQUAL(stats.compression.fast_reject_checks, RANDOM_BLOCKS / 64);
+  CU_ASSERT_EQUAL(stats.compression.fast_reject_skips,
+                  RANDOM_BLOCKS - stats.compression.fast_reject_checks);
+  CU_ASSERT_EQUAL(stats.compression.fast_reject_mispredictions, 0);
+
+  // The checked blocks could not be compressed, so were written uncompressed.
+  verifyData(COMPRESSIBLE_BLOCKS, RANDOM_INDEX, RANDOM_BLOCKS);
+  for (logical_block_number_t lbn = COMPRESSIBLE_BLOCKS;
+       lbn < COMPRESSIBLE_BLOCKS + RANDOM_BLOCKS; lbn++) {
+    CU_ASSERT_EQUAL(lookupLBN(lbn).state, VDO_MAPPING_STATE_UNCOMPRESSED);
+  }
+}
+
+/**********************************************************************/
+static CU_TestInfo vdoTests[] = {
+  { "codecs round trip",          testCodecs        },
+  { "fast reject",                testFastReject    },
+  { "deflate compressed volume",  testDeflateVolume },
+  { "fast reject statistics",     testFastRejectStatistics },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo vdoSuite = {
+  .name                     = "Compression codecs (Compression_t3)",
+  .initializerWithArguments = NULL,
+  .initializer              = initializeCompressionT3,
+  .cleaner                  = tearDownCompressionT3,
+  .tests                    = vdoTests,
+};
+
+/**********************************************************************/
+CU_SuiteInfo *initializeModule(void)
+{
+  return &vdoSuite;
+}
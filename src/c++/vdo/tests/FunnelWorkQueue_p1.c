@@ -0,0 +1,166 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * Performance testing of work stealing between the threads of a round-robin
+ * work queue, with a job mix in which a few jobs take far longer than the
+ * rest.
+ *
+ * $Id$
+ */
+
+#include "assertions.h"
+
+#include <linux/atomic.h>
+#include <linux/ktime.h>
+#include <linux/numa.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "funnel-workqueue.h"
+#include "memory-alloc.h"
+
+#include "completion.h"
+
+#include "mutexUtils.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  THREAD_COUNT   = 4,
+  JOB_COUNT      = 20000,
+  // One job in this many is a long one
+  LONG_INTERVAL  = 100,
+  SHORT_JOB_NS   = 1000,
+  // Long jobs sleep, so that they hold up their thread even on a single CPU
+  LONG_JOB_US    = 1000,
+  // Jobs are enqueued in bursts, with a pause between bursts
+  BURST_SIZE     = 8,
+  BURST_PAUSE_US = 20,
+};
+
+typedef struct {
+  struct vdo_completion completion;
+  bool                  isLong;
+  u64                   enqueued;
+  u64                   started;
+} Job;
+
+static Job      *jobs;
+static atomic_t  jobsDone;
+
+/**
+ * Record when a job started, then do its work.
+ *
+ * Implements vdo_action_fn.
+ **/
+static void runJob(struct vdo_completion *completion)
+{
+  Job *job = container_of(completion, Job, completion);
+  job->started = ktime_get_ns();
+  if (job->isLong) {
+    usleep(LONG_JOB_US);
+  } else {
+    while ((ktime_get_ns() - job->started) < SHORT_JOB_NS) {
+      cpu_relax();
+    }
+  }
+
+  atomic_inc(&jobsDone);
+}
+
+/**********************************************************************/
+static int compareLatencies(const void *a, const void *b)
+{
+  u64 latencyA = *((const u64 *) a);
+  u64 latencyB = *((const u64 *) b);
+  return ((latencyA < latencyB) ? -1 : ((latencyA > latencyB) ? 1 : 0));
+}
+
+/**
+ * Report a percentile of the sorted latencies.
+ **/
+static double percentileUS(const u64 *latencies, double percentile)
+{
+  size_t index = (size_t) ((JOB_COUNT - 1) * percentile / 100);
+  return latencies[index] / 1000.0;
+}
+
+/**
+ * Run the job mix through a work queue, and report the time from each job
+ * being enqueued to its starting to run.
+ *
+ * @param allowStealing  Whether idle threads may take their siblings' work
+ **/
+static void timeJobs(bool allowStealing)
+{
+  struct vdo_work_queue_type type = {
+    .max_priority     = 0,
+    .default_priority = 0,
+    .allow_stealing   = allowStealing,
+  };
+  struct vdo_work_queue *queue;
+  VDO_ASSERT_SUCCESS(vdo_make_work_queue("perf", "fwq", NULL, &type,
+                                         NUMA_NO_NODE, THREAD_COUNT, NULL,
+                                         &queue));
+
+  srandom(42);
+  atomic_set(&jobsDone, 0);
+  for (unsigned int i = 0; i < JOB_COUNT; i++) {
+    jobs[i] = (Job) {
+      .completion = {
+        .callback = runJob,
+        .priority = VDO_WORK_Q_DEFAULT_PRIORITY,
+      },
+      .isLong     = ((random() % LONG_INTERVAL) == 0),
+    };
+  }
+
+  for (unsigned int i = 0; i < JOB_COUNT; i++) {
+    jobs[i].enqueued = ktime_get_ns();
+    vdo_enqueue_work_queue(queue, &jobs[i].completion);
+    if ((i % BURST_SIZE) == (BURST_SIZE - 1)) {
+      usleep(BURST_PAUSE_US);
+    }
+  }
+
+  while (atomic_read(&jobsDone) < JOB_COUNT) {
+    usleep(1000);
+  }
+
+  struct vdo_work_queue_statistics stats = { 0 };
+  vdo_add_work_queue_statistics(queue, &stats);
+  vdo_free_work_queue(queue);
+  CU_ASSERT_EQUAL(stats.completions, JOB_COUNT);
+
+  u64 *latencies;
+  VDO_ASSERT_SUCCESS(vdo_allocate(JOB_COUNT, u64, __func__, &latencies));
+  for (unsigned int i = 0; i < JOB_COUNT; i++) {
+    latencies[i] = jobs[i].started - jobs[i].enqueued;
+  }
+
+  qsort(latencies, JOB_COUNT, sizeof(u64), compareLatencies);
+  printf("  %-12s p50 %8.1fus  p99 %8.1fus  p99.9 %8.1fus  max %8.1fus\n",
+         (allowStealing ? "stealing" : "no stealing"),
+         percentileUS(latencies, 50), percentileUS(latencies, 99),
+         percentileUS(latencies, 99.9), percentileUS(latencies, 100));
+  vdo_free(latencies);
+}
+
+/**********************************************************************/
+int main(void)
+{
+  initializeMutexUtils();
+  VDO_ASSERT_SUCCESS(vdo_allocate(JOB_COUNT, Job, __func__, &jobs));
+
+  printf("Enqueue to start latency, %u threads, 1 job in %u taking %uus:\n",
+         THREAD_COUNT, LONG_INTERVAL, LONG_JOB_US);
+  timeJobs(false);
+  timeJobs(true);
+
+  vdo_free(jobs);
+  tearDownVDOTestBase();
+  return 0;
+}
@@ -0,0 +1,443 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "funnel-workqueue.h"
+
+#include <linux/atomic.h>
+#include <linux/numa.h>
+#include <unistd.h>
+
+#include "memory-alloc.h"
+#include "time-utils.h"
+
+#include "completion.h"
+
+#include "albtest.h"
+#include "vdoAsserts.h"
+
+enum {
+  // Long enough that a missing wakeup fails the test rather than hanging it
+  WAIT_SECONDS       = 10,
+  // How long to wait to be sure that a completion is not going to run
+  NOT_RUN_MS         = 50,
+  CONTENTION_THREADS = 4,
+  CONTENTION_COUNT   = 20000,
+  // Every this many completions of the contention test sleeps for a while
+  SLOW_INTERVAL      = 64,
+  // The number of completions drained without a scheduler check
+  BATCH_SIZE         = 16,
+};
+
+typedef struct {
+  struct vdo_completion  completion;
+  /* The queue whose thread ran the completion */
+  struct vdo_work_queue *ranOn;
+  atomic_t               runs;
+} TestCompletion;
+
+static struct mutex                mutex;
+static struct cond_var             condition;
+static struct vdo_work_queue_type  queueType;
+static struct vdo_work_queue      *queue;
+static bool                        blockerRunning;
+static bool                        blockerReleased;
+static unsigned int                completed;
+
+/**********************************************************************/
+static void initializeFunnelWorkQueueT1(void)
+{
+  VDO_ASSERT_SUCCESS(mutex_init(&mutex));
+  uds_init_cond(&condition);
+  blockerRunning  = false;
+  blockerReleased = false;
+  completed       = 0;
+  queue           = NULL;
+}
+
+/**********************************************************************/
+static void tearDownFunnelWorkQueueT1(void)
+{
+  vdo_free_work_queue(vdo_forget(queue));
+  uds_destroy_cond(&condition);
+  mutex_destroy(&mutex);
+}
+
+/**********************************************************************/
+static TestCompletion *asTestCompletion(struct vdo_completion *completion)
+{
+  return container_of(completion, TestCompletion, completion);
+}
+
+/**
+ * Record which queue ran a completion. A stolen completion must have been
+ * reassigned to the thief before it was processed, or process_completion()
+ * would not have cleared my_queue.
+ **/
+static void recordRun(struct vdo_completion *completion)
+{
+  TestCompletion *testCompletion = asTestCompletion(completion);
+  CU_ASSERT_PTR_NULL(completion->my_queue);
+  testCompletion->ranOn = vdo_get_current_work_queue();
+  atomic_inc(&testCompletion->runs);
+}
+
+/**
+ * Count a completion as done, and wake the test thread.
+ *
+ * Implements vdo_action_fn.
+ **/
+static void countCompletion(struct vdo_completion *completion)
+{
+  recordRun(completion);
+  mutex_lock(&mutex);
+  completed++;
+  uds_broadcast_cond(&condition);
+  mutex_unlock(&mutex);
+}
+
+/**
+ * Keep the thread which runs this completion busy until the test releases it.
+ *
+ * Implements vdo_action_fn.
+ **/
+static void blockQueue(struct vdo_completion *completion)
+{
+  recordRun(completion);
+  mutex_lock(&mutex);
+  blockerRunning = true;
+  uds_broadcast_cond(&condition);
+  while (!blockerReleased) {
+    uds_wait_cond(&condition, &mutex);
+  }
+  mutex_unlock(&mutex);
+}
+
+/**
+ * Keep a worker thread busy for a while now and then, so that its siblings
+ * have queued work to steal.
+ *
+ * Implements vdo_action_fn.
+ **/
+static void sometimesSleep(struct vdo_completion *completion)
+{
+  if ((((uintptr_t) completion->parent) % SLOW_INTERVAL) == 0) {
+    usleep(100);
+  }
+
+  countCompletion(completion);
+}
+
+/**
+ * Prepare a completion to be enqueued directly. Its parent is used only to
+ * number it.
+ **/
+static void initializeTestCompletion(TestCompletion *testCompletion,
+                                     vdo_action_fn callback,
+                                     uintptr_t number)
+{
+  memset(testCompletion, 0, sizeof(*testCompletion));
+  testCompletion->completion.callback = callback;
+  testCompletion->completion.priority = VDO_WORK_Q_DEFAULT_PRIORITY;
+  testCompletion->completion.parent   = (void *) number;
+  atomic_set(&testCompletion->runs, 0);
+}
+
+/**
+ * Wait until a number of completions have finished, or until it is clear that
+ * they will not.
+ *
+ * @param expected  The number of completions to wait for
+ *
+ * @return The number of completions which have finished
+ **/
+static unsigned int waitForCompletions(unsigned int expected)
+{
+  mutex_lock(&mutex);
+  while ((completed < expected)
+         && (uds_timed_wait_cond(&condition, &mutex,
+                                 ms_to_ktime(WAIT_SECONDS * 1000)) == 0)) {
+  }
+  unsigned int result = completed;
+  mutex_unlock(&mutex);
+  return result;
+}
+
+/**
+ * Make the queue under test.
+ *
+ * @param threadCount    The number of threads for the queue
+ * @param allowStealing  Whether idle threads may take their siblings' work
+ **/
+static void makeQueue(unsigned int threadCount, bool allowStealing)
+{
+  queueType = (struct vdo_work_queue_type) {
+    .max_priority     = 0,
+    .default_priority = 0,
+    .allow_stealing   = allowStealing,
+  };
+  VDO_ASSERT_SUCCESS(vdo_make_work_queue("test", "fwq", NULL, &queueType,
+                                         NUMA_NO_NODE, threadCount, NULL,
+                                         &queue));
+}
+
+/**
+ * Make a two thread queue, and occupy one of its threads with a completion
+ * which blocks until released.
+ *
+ * @param allowStealing  Whether idle threads may take their siblings' work
+ * @param blocker        The completion to block the thread with
+ **/
+static void startBlockedQueue(bool allowStealing, TestCompletion *blocker)
+{
+  makeQueue(2, allowStealing);
+
+  initializeTestCompletion(blocker, blockQueue, 0);
+  vdo_enqueue_work_queue(queue, &blocker->completion);
+  mutex_lock(&mutex);
+  while (!blockerRunning) {
+    uds_wait_cond(&condition, &mutex);
+  }
+  mutex_unlock(&mutex);
+}
+
+/**********************************************************************/
+static void releaseBlocker(void)
+{
+  mutex_lock(&mutex);
+  blockerReleased = true;
+  uds_broadcast_cond(&condition);
+  mutex_unlock(&mutex);
+}
+
+/**
+ * Test that while one thread of a round-robin queue is busy, the completions
+ * assigned to it are taken and run by its idle sibling.
+ **/
+static void testStealFromBusySibling(void)
+{
+  TestCompletion blocker;
+  TestCompletion completions[8];
+  startBlockedQueue(true, &blocker);
+
+  // The round-robin rotor assigns every other completion to the busy thread.
+  for (unsigned int i = 0; i < ARRAY_SIZE(completions); i++) {
+    initializeTestCompletion(&completions[i], countCompletion, i + 1);
+    vdo_enqueue_work_queue(queue, &completions[i].completion);
+  }
+
+  CU_ASSERT_EQUAL(waitForCompletions(ARRAY_SIZE(completions)),
+                  ARRAY_SIZE(completions));
+  for (unsigned int i = 0; i < ARRAY_SIZE(completions); i++) {
+    CU_ASSERT_EQUAL(atomic_read(&completions[i].runs), 1);
+    CU_ASSERT_PTR_NOT_NULL(completions[i].ranOn);
+    CU_ASSERT_NOT_EQUAL(completions[i].ranOn, blocker.ranOn);
+  }
+
+  releaseBlocker();
+  vdo_finish_work_queue(queue);
+  CU_ASSERT_EQUAL(atomic_read(&blocker.runs), 1);
+
+  struct vdo_work_queue_statistics stats = { 0 };
+  vdo_add_work_queue_statistics(queue, &stats);
+  CU_ASSERT_EQUAL(stats.completions, ARRAY_SIZE(completions) + 1);
+}
+
+/**
+ * Test that without stealing, the completions assigned to a busy thread wait
+ * for it.
+ **/
+static void testNoStealing(void)
+{
+  TestCompletion blocker;
+  TestCompletion completions[8];
+  startBlockedQueue(false, &blocker);
+
+  for (unsigned int i = 0; i < ARRAY_SIZE(completions); i++) {
+    initializeTestCompletion(&completions[i], countCompletion, i + 1);
+    vdo_enqueue_work_queue(queue, &completions[i].completion);
+  }
+
+  unsigned int half = ARRAY_SIZE(completions) / 2;
+  CU_ASSERT_EQUAL(waitForCompletions(half), half);
+  // The rest are queued behind the blocker, and the idle thread leaves them.
+  usleep(NOT_RUN_MS * 1000);
+  CU_ASSERT_EQUAL(waitForCompletions(0), half);
+
+  releaseBlocker();
+  CU_ASSERT_EQUAL(waitForCompletions(ARRAY_SIZE(completions)),
+                  ARRAY_SIZE(completions));
+  unsigned int onBlockedThread = 0;
+  for (unsigned int i = 0; i < ARRAY_SIZE(completions); i++) {
+    CU_ASSERT_EQUAL(atomic_read(&completions[i].runs), 1);
+    if (completions[i].ranOn == blocker.ranOn) {
+      onBlockedThread++;
+    }
+  }
+
+  CU_ASSERT_EQUAL(onBlockedThread, half);
+  vdo_finish_work_queue(queue);
+}
+
+/**
+ * Test that when the threads of a queue are polling their own queues while
+ * their siblings try to steal from them, every completion runs exactly once.
+ **/
+static void testContention(void)
+{
+  makeQueue(CONTENTION_THREADS, true);
+
+  TestCompletion *completions;
+  VDO_ASSERT_SUCCESS(vdo_allocate(CONTENTION_COUNT, TestCompletion, __func__,
+                                  &completions));
+  for (unsigned int i = 0; i < CONTENTION_COUNT; i++) {
+    initializeTestCompletion(&completions[i], sometimesSleep, i + 1);
+    vdo_enqueue_work_queue(queue, &completions[i].completion);
+  }
+
+  CU_ASSERT_EQUAL(waitForCompletions(CONTENTION_COUNT), CONTENTION_COUNT);
+  vdo_finish_work_queue(queue);
+  for (unsigned int i = 0; i < CONTENTION_COUNT; i++) {
+    CU_ASSERT_EQUAL(atomic_read(&completions[i].runs), 1);
+  }
+
+  struct vdo_work_queue_statistics stats = { 0 };
+  vdo_add_work_queue_statistics(queue, &stats);
+  CU_ASSERT_EQUAL(stats.completions, CONTENTION_COUNT);
+  vdo_free(completions);
+}
+
+/**
+ * Test the choice of how long an idle thread spins before sleeping.
+ **/
+static void testSpinWindow(void)
+{
+  // With no history, or spinning turned off, don't spin.
+  CU_ASSERT_EQUAL(compute_spin_window(0, 10), 0);
+  CU_ASSERT_EQUAL(compute_spin_window(500, 0), 0);
+
+  // Spin for twice the average wait, up to the maximum.
+  CU_ASSERT_EQUAL(compute_spin_window(1, 10), 2);
+  CU_ASSERT_EQUAL(compute_spin_window(3000, 10), 6000);
+  CU_ASSERT_EQUAL(compute_spin_window(5000, 10), 10000);
+  CU_ASSERT_EQUAL(compute_spin_window(7000, 10), 10000);
+  CU_ASSERT_EQUAL(compute_spin_window(10000, 10), 10000);
+
+  // Once the average wait is longer than the maximum, don't spin.
+  CU_ASSERT_EQUAL(compute_spin_window(10001, 10), 0);
+  CU_ASSERT_EQUAL(compute_spin_window(1000000, 1000), 1000000);
+  CU_ASSERT_EQUAL(compute_spin_window(1000001, 1000), 0);
+}
+
+/**
+ * Test that the spin window follows the rate at which work arrives.
+ **/
+static void testSpinWindowAdapts(void)
+{
+  u64 average = 0;
+  CU_ASSERT_EQUAL(update_average_idle_time(average, 8000), 1000);
+
+  // Work arriving every 2us brings the window to about 4us.
+  for (unsigned int i = 0; i < 100; i++) {
+    average = update_average_idle_time(average, 2000);
+  }
+
+  CU_ASSERT_TRUE(average <= 2000);
+  CU_ASSERT_TRUE(average > 1900);
+  u64 window = compute_spin_window(average, 10);
+  CU_ASSERT_TRUE(window > 3800);
+  CU_ASSERT_TRUE(window <= 4000);
+
+  // One long wait stops spinning; it resumes as work arrives quickly again.
+  average = update_average_idle_time(average, 1000000);
+  CU_ASSERT_EQUAL(compute_spin_window(average, 10), 0);
+  unsigned int samples = 0;
+  while (compute_spin_window(average, 10) == 0) {
+    average = update_average_idle_time(average, 2000);
+    samples++;
+  }
+
+  CU_ASSERT_TRUE(samples > 1);
+  CU_ASSERT_TRUE(samples < 50);
+}
+
+/**
+ * Test that the configured spin interval is capped at a millisecond.
+ **/
+static void testMaxSpinInterval(void)
+{
+  unsigned int saved = vdo_work_queue_max_spin_interval;
+  vdo_set_work_queue_max_spin_interval(0);
+  CU_ASSERT_EQUAL(vdo_work_queue_max_spin_interval, 0);
+  vdo_set_work_queue_max_spin_interval(20);
+  CU_ASSERT_EQUAL(vdo_work_queue_max_spin_interval, 20);
+  vdo_set_work_queue_max_spin_interval(1000);
+  CU_ASSERT_EQUAL(vdo_work_queue_max_spin_interval, 1000);
+  vdo_set_work_queue_max_spin_interval(1001);
+  CU_ASSERT_EQUAL(vdo_work_queue_max_spin_interval, 1000);
+  vdo_set_work_queue_max_spin_interval(UINT_MAX);
+  CU_ASSERT_EQUAL(vdo_work_queue_max_spin_interval, 1000);
+  vdo_set_work_queue_max_spin_interval(saved);
+}
+
+/**
+ * Test that a thread which finds a backlog drains it in batches.
+ **/
+static void testBatchDrain(void)
+{
+  makeQueue(1, false);
+  TestCompletion blocker;
+  initializeTestCompletion(&blocker, blockQueue, 0);
+  vdo_enqueue_work_queue(queue, &blocker.completion);
+  mutex_lock(&mutex);
+  while (!blockerRunning) {
+    uds_wait_cond(&condition, &mutex);
+  }
+  mutex_unlock(&mutex);
+
+  // The blocker starts a batch which the backlog completes, then two more.
+  TestCompletion completions[(2 * BATCH_SIZE) + (BATCH_SIZE / 2) + 1];
+  for (unsigned int i = 0; i < ARRAY_SIZE(completions); i++) {
+    initializeTestCompletion(&completions[i], countCompletion, i + 1);
+    vdo_enqueue_work_queue(queue, &completions[i].completion);
+  }
+
+  releaseBlocker();
+  CU_ASSERT_EQUAL(waitForCompletions(ARRAY_SIZE(completions)),
+                  ARRAY_SIZE(completions));
+  vdo_finish_work_queue(queue);
+
+  struct vdo_work_queue_statistics stats = { 0 };
+  vdo_add_work_queue_statistics(queue, &stats);
+  CU_ASSERT_EQUAL(stats.completions, ARRAY_SIZE(completions) + 1);
+  CU_ASSERT_EQUAL(stats.batches, 3);
+}
+
+/**********************************************************************/
+
+static CU_TestInfo tests[] = {
+  { "idle thread steals from busy sibling", testStealFromBusySibling },
+  { "busy thread keeps work without stealing", testNoStealing        },
+  { "contended stealing runs work once",    testContention           },
+  { "spin window",                          testSpinWindow           },
+  { "spin window follows arrivals",         testSpinWindowAdapts     },
+  { "max spin interval is capped",          testMaxSpinInterval      },
+  { "backlog drained in batches",           testBatchDrain           },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "FunnelWorkQueue_t1",
+  .initializer              = initializeFunnelWorkQueueT1,
+  .cleaner                  = tearDownFunnelWorkQueueT1,
+  .tests                    = tests,
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
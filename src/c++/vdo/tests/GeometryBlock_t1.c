@@ -87,6 +87,37 @@ static u8 EXPECTED_GEOMETRY_5_0_ENCODING[] =
     0xd6, 0x99, 0x9d, 0x04,                         // checksum = 0x049d99d6
   };
 
+/*
+ * A captured encoding of the geometry block version 6.0 created by
+ * encodingTest_6_0(). This is used to check that the encoding format hasn't
+ * changed and is platform-independent.
+ */
+static u8 EXPECTED_GEOMETRY_6_0_ENCODING[] =
+  {
+    0x64, 0x6d, 0x76, 0x64, 0x6f, 0x30, 0x30, 0x31, // magic = "dmvdo001"
+    0x05, 0x00, 0x00, 0x00,                         // header.id = GEOMETRY
+    0x06, 0x00, 0x00, 0x00,                         //   .majorVersion = 6
+    0x00, 0x00, 0x00, 0x00,                         //   .minorVersion = 0
+    0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //   .size = 102
+    0x1d, 0x1c, 0x1b, 0x1a,                         // unused = 0x1a1b1c1d
+    0xb5, 0x1a, 0xf5, 0xee, 0x4b, 0x30, 0x20, 0x10, // nonce = NONCE
+    0x66, 0x61, 0x6b, 0x65, 0x00, 0x75, 0x75, 0x69, // uuid = TEST_UUID
+    0x64, 0x20, 0x68, 0x61, 0x72, 0x65, 0x73, 0x00, //   ...  TEST_UUID
+    0x18, 0x17, 0x16, 0x15, 0x14, 0x13, 0x12, 0x11, // bio_offset = 0x111213...
+                                                    // region
+    0x00, 0x00, 0x00, 0x00,                         //   .id = VDO_INDEX_REGION
+    0x28, 0x27, 0x26, 0x25, 0x24, 0x23, 0x22, 0x21, //   .start  = 0x212223...
+                                                    // region
+    0x01, 0x00, 0x00, 0x00,                         //   .id = VDO_DATA_REGION
+    0x38, 0x37, 0x36, 0x35, 0x34, 0x33, 0x32, 0x31, //   .start  = 0x313233...
+                                                    // index_config
+    0x4d, 0x4c, 0x4b, 0x4a,                         //   mem = 0x4a4b4c4d
+    0x00, 0x00, 0x00, 0x00,                         //   (unused)
+    0x01,                                           //   sparse = true
+    0x01,                                           // hash_algorithm = striped
+    0xb2, 0x59, 0x88, 0x63,                         // checksum = 0x638859b2
+  };
+
 /**********************************************************************/
 static void encodingTest_4_0(void)
 {
@@ -147,6 +178,43 @@ static void encodingTest_5_0(void)
   UDS_ASSERT_EQUAL_BYTES(&geometry, &decoded, sizeof(decoded));
 }
 
+/**********************************************************************/
+static void encodingTest_6_0(void)
+{
+  struct volume_geometry geometry;
+  VDO_ASSERT_SUCCESS(initializeVolumeGeometry(NONCE, &TEST_UUID, NULL, &geometry));
+
+  // Fill the geometry fields with bogus values that will test endianness.
+  geometry.unused                            = 0x1a1b1c1d;
+  geometry.bio_offset                        = 0x1112131415161718;
+  geometry.regions[0].start_block            = 0x2122232425262728;
+  geometry.regions[1].start_block            = 0x3132333435363738;
+  geometry.index_config.mem                  = 0x4a4b4c4d;
+  geometry.index_config.sparse               = true;
+  geometry.hash_algorithm                    = VDO_HASH_MURMUR3_STRIPED;
+
+  // A non-default hash algorithm should select version 6_0.
+  PhysicalLayer *layer = getSynchronousLayer();
+  VDO_ASSERT_SUCCESS(writeVolumeGeometry(layer, &geometry));
+
+  // Read and compare it to the expected byte sequence for version 6_0.
+  char block[VDO_BLOCK_SIZE];
+  VDO_ASSERT_SUCCESS(layer->reader(layer, 0, 1, block));
+  UDS_ASSERT_EQUAL_BYTES(EXPECTED_GEOMETRY_6_0_ENCODING,
+                         block, sizeof(EXPECTED_GEOMETRY_6_0_ENCODING));
+
+  // Read, decode, and compare the decoded volume_geometry.
+  struct volume_geometry decoded;
+  VDO_ASSERT_SUCCESS(loadVolumeGeometry(getSynchronousLayer(), &decoded));
+  UDS_ASSERT_EQUAL_BYTES(&geometry, &decoded, sizeof(decoded));
+
+  // An unknown hash algorithm must be rejected.
+  geometry.hash_algorithm = VDO_HASH_ALGORITHM_COUNT;
+  VDO_ASSERT_SUCCESS(writeVolumeGeometry(layer, &geometry));
+  CU_ASSERT_EQUAL(loadVolumeGeometry(getSynchronousLayer(), &decoded),
+                  VDO_UNSUPPORTED_VERSION);
+}
+
 /**********************************************************************/
 static void assertRegionIs(struct volume_region  *region,
                            enum volume_region_id  id,
@@ -208,6 +276,7 @@ static CU_TestInfo tests[] = {
   { "Saves and loads", basicTest        },
   { "Encoding v4_0",   encodingTest_4_0 },
   { "Encoding v5_0",   encodingTest_5_0 },
+  { "Encoding v6_0",   encodingTest_6_0 },
   CU_TEST_INFO_NULL
 };
 
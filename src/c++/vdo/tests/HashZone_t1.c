@@ -15,6 +15,7 @@
 #include "dedupe.h"
 #include "vdo.h"
 
+#include "ioRequest.h"
 #include "vdoAsserts.h"
 #include "vdoTestBase.h"
 
@@ -40,15 +41,13 @@ static void verifySelectHashZone(struct vdo *vdo, thread_count_t hashZones)
   unsigned int histogram[hashZones];
   memset(histogram, 0, sizeof(histogram));
 
-  struct uds_record_name name;
-  createRandomBlockName(&name);
-
-  // Since we only use the first byte to select hash zone, we can easily
-  // test all possible values.
-  enum { NAME_COUNT = 256 };
-  for (unsigned int selector = 0; selector < NAME_COUNT; selector++) {
-    // XXX factor ala hashUtils
-    name.name[0] = selector;
+  // The whole name is used to select a zone, so use random names. With this
+  // many names per zone, the standard deviation of each count is about 1.5%.
+  enum { NAMES_PER_ZONE = 4096 };
+  unsigned int nameCount = NAMES_PER_ZONE * hashZones;
+  for (unsigned int i = 0; i < nameCount; i++) {
+    struct uds_record_name name;
+    createRandomBlockName(&name);
     struct hash_zone *zone = vdo_select_hash_zone(vdo->hash_zones, &name);
     histogram[zone->zone_number] += 1;
     // Check that we get the same name if we ask again, which should catch the
@@ -61,18 +60,45 @@ static void verifySelectHashZone(struct vdo *vdo, thread_count_t hashZones)
   unsigned int maximum = 0;
   unsigned int total = 0;
   for (zone_count_t i = 0; i < ARRAY_SIZE(histogram); i++) {
-    if (i < hashZones) {
-      total += histogram[i];
-      minimum = min(minimum, histogram[i]);
-      maximum = max(maximum, histogram[i]);
-    } else {
-      CU_ASSERT_EQUAL(0, histogram[i]);
-    }
+    total += histogram[i];
+    minimum = min(minimum, histogram[i]);
+    maximum = max(maximum, histogram[i]);
   }
-  CU_ASSERT_EQUAL(NAME_COUNT, total);
+  CU_ASSERT_EQUAL(nameCount, total);
 
-  // An even distibution will be all equal, or at most differ by one.
-  CU_ASSERT_TRUE((maximum - minimum) <= 1);
+  // Allow seven standard deviations either way.
+  CU_ASSERT_TRUE(minimum >= NAMES_PER_ZONE * 9 / 10);
+  CU_ASSERT_TRUE(maximum <= NAMES_PER_ZONE * 11 / 10);
+}
+
+/**
+ * Verify that names which differ only outside their first byte still get
+ * spread among the hash zones.
+ *
+ * @param vdo       The vdo containing the hash zones
+ * @param hashZone  The configured number of hash zones
+ **/
+static void verifyWholeNameUsed(struct vdo *vdo, thread_count_t hashZones)
+{
+  if (hashZones == 1) {
+    return;
+  }
+
+  struct uds_record_name name;
+  createRandomBlockName(&name);
+  struct hash_zone *first = vdo_select_hash_zone(vdo->hash_zones, &name);
+  for (unsigned int byte = 1; byte < UDS_RECORD_NAME_SIZE; byte++) {
+    struct uds_record_name other = name;
+    bool moved = false;
+    for (unsigned int value = 0; value < 256; value++) {
+      other.name[byte] = value;
+      if (vdo_select_hash_zone(vdo->hash_zones, &other) != first) {
+        moved = true;
+        break;
+      }
+    }
+    CU_ASSERT_TRUE(moved);
+  }
 }
 
 /**
@@ -100,13 +126,42 @@ static void testSelectVdoHashZone(void)
     reconfigureHashZones(hashZones);
     CU_ASSERT_EQUAL(hashZones, vdo->thread_config.hash_zone_count);
     verifySelectHashZone(vdo, hashZones);
+    verifyWholeNameUsed(vdo, hashZones);
   }
 }
 
+/**
+ * Check that the per-zone hash lock request counters account for every
+ * write which is hashed.
+ **/
+static void testZoneLoadStatistics(void)
+{
+  enum {
+    BLOCK_COUNT = 256,
+    HASH_ZONES  = 4,
+  };
+
+  reconfigureHashZones(HASH_ZONES);
+  writeData(0, 1, BLOCK_COUNT, VDO_SUCCESS);
+
+  struct vdo_statistics stats;
+  vdo_fetch_statistics(vdo, &stats);
+  CU_ASSERT_EQUAL(stats.hash_lock.lock_requests, BLOCK_COUNT);
+  CU_ASSERT_TRUE(stats.hash_lock.min_zone_lock_requests > 0);
+  CU_ASSERT_TRUE(stats.hash_lock.min_zone_lock_requests
+                 <= stats.hash_lock.max_zone_lock_requests);
+  CU_ASSERT_TRUE(stats.hash_lock.max_zone_lock_requests < BLOCK_COUNT);
+  CU_ASSERT_TRUE(stats.hash_lock.min_zone_lock_requests * HASH_ZONES
+                 <= BLOCK_COUNT);
+  CU_ASSERT_TRUE(stats.hash_lock.max_zone_lock_requests * HASH_ZONES
+                 >= BLOCK_COUNT);
+}
+
 /**********************************************************************/
 
 static CU_TestInfo tests[] = {
-  { "test vdo_select_hash_zone", testSelectVdoHashZone },
+  { "test vdo_select_hash_zone",  testSelectVdoHashZone  },
+  { "per-zone load statistics",   testZoneLoadStatistics },
   CU_TEST_INFO_NULL
 };
 
@@ -0,0 +1,196 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include "memory-alloc.h"
+
+#include "recovery-journal.h"
+#include "statistics.h"
+#include "vdo.h"
+#include "wait-queue.h"
+
+#include "asyncLayer.h"
+#include "ioRequest.h"
+#include "mutexUtils.h"
+#include "testTimer.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  // Enough writes to fill four journal blocks while the first commit waits
+  WRITE_COUNT = 1400,
+};
+
+static block_count_t pendingBlocks;
+static size_t        waitingEntries;
+
+/**
+ * Initialize a VDO with its block map tree allocated, so that the only
+ * journal entries are for data writes.
+ *
+ * @param groupCommit  Whether to commit adjacent journal blocks together
+ **/
+static void initialize(bool groupCommit)
+{
+  TestParameters parameters = {
+    .logicalBlocks        = 4096,
+    .physicalBlocks       = 8192,
+    .slabSize             = 1024,
+    .journalBlocks        = 32,
+    .noIndexRegion        = true,
+    .disableDeduplication = true,
+    .journalGroupCommit   = groupCommit,
+  };
+
+  initializeVDOTest(&parameters);
+  populateBlockMapTree();
+}
+
+/**
+ * Check for a recovery journal block write.
+ *
+ * Implements BlockCondition.
+ **/
+static bool
+isRecoveryJournalBlockWrite(struct vdo_completion *completion,
+                            void *context __attribute__((unused)))
+{
+  return (vioTypeIs(completion, VIO_TYPE_RECOVERY_JOURNAL)
+          && isMetadataWrite(completion));
+}
+
+/**
+ * Sample the number of full blocks waiting to be written and the number of
+ * entries waiting to be added to the active block.
+ *
+ * <p>Implements vdo_action_fn.
+ **/
+static void sampleJournal(struct vdo_completion *completion)
+{
+  struct recovery_journal *journal = vdo->recovery_journal;
+  pendingBlocks = vdo_waitq_num_waiters(&journal->pending_writes);
+  waitingEntries = ((journal->active_block == NULL)
+                    ? 0
+                    : vdo_waitq_num_waiters(&journal->active_block->entry_waiters));
+  vdo_finish_completion(completion);
+}
+
+/**
+ * Sample the journal on its own thread.
+ **/
+static void sampleJournalOnThread(void)
+{
+  performSuccessfulActionOnThread(sampleJournal,
+                                  vdo->thread_config.journal_thread);
+}
+
+/**
+ * Test that full journal blocks which pile up behind a commit are written
+ * together, and that they can be replayed.
+ **/
+static void testGroupCommit(void)
+{
+  initialize(true);
+
+  struct vdo_statistics before;
+  vdo_fetch_statistics(vdo, &before);
+
+  // Hold the first commit so that the following blocks fill up behind it.
+  setBlockVIOCompletionEnqueueHook(isRecoveryJournalBlockWrite, true);
+  IORequest *first = launchIndexedWrite(0, 1, 1);
+  struct vio *blockedVIO = getBlockedVIO();
+
+  IORequest *rest = launchIndexedWrite(1, WRITE_COUNT, 2);
+  do {
+    sampleJournalOnThread();
+  } while (pendingBlocks < 3);
+
+  reallyEnqueueVIO(blockedVIO);
+  awaitAndFreeSuccessfulRequest(vdo_forget(first));
+  awaitAndFreeSuccessfulRequest(vdo_forget(rest));
+
+  struct vdo_statistics after;
+  vdo_fetch_statistics(vdo, &after);
+  CU_ASSERT_TRUE(after.journal.multi_block_writes
+                 > before.journal.multi_block_writes);
+  CU_ASSERT_TRUE(after.journal.commit_size.multiple_blocks
+                 > before.journal.commit_size.multiple_blocks);
+  CU_ASSERT_EQUAL(after.journal.entries.committed
+                  - before.journal.entries.committed,
+                  WRITE_COUNT + 1);
+
+  // The grouped blocks must be replayable.
+  crashVDO();
+  startVDO(VDO_DIRTY);
+  verifyData(0, 1, 1);
+  verifyData(1, 2, WRITE_COUNT);
+}
+
+/**
+ * Test that a partial block is held for the commit delay, gathering entries,
+ * and is then committed once.
+ **/
+static void testCommitDelay(void)
+{
+  initialize(false);
+  writeData(0, 1, 2, VDO_SUCCESS);
+
+  struct device_config config = getTestConfig().deviceConfig;
+  config.journal_commit_delay = 1000;
+  reloadVDO(config);
+
+  struct vdo_statistics before;
+  vdo_fetch_statistics(vdo, &before);
+
+  // Neither overwrite may be committed until the timer fires.
+  IORequest *first = launchIndexedWrite(0, 1, 3);
+  do {
+    sampleJournalOnThread();
+  } while (waitingEntries < 1);
+  CU_ASSERT_NOT_EQUAL(getNextTimeout(), ULONG_MAX);
+
+  IORequest *second = launchIndexedWrite(1, 1, 4);
+  do {
+    sampleJournalOnThread();
+  } while (waitingEntries < 2);
+
+  CU_ASSERT_TRUE(fireTimers(getNextTimeout()));
+  awaitAndFreeSuccessfulRequest(vdo_forget(first));
+  awaitAndFreeSuccessfulRequest(vdo_forget(second));
+
+  struct vdo_statistics after;
+  vdo_fetch_statistics(vdo, &after);
+  CU_ASSERT_EQUAL(after.journal.delayed_commits
+                  - before.journal.delayed_commits, 1);
+  CU_ASSERT_EQUAL(after.journal.blocks.written
+                  - before.journal.blocks.written, 1);
+  CU_ASSERT_EQUAL(after.journal.commit_size.under_16
+                  - before.journal.commit_size.under_16, 1);
+  verifyData(0, 3, 2);
+}
+
+/**********************************************************************/
+static CU_TestInfo tests[] = {
+  { "commit adjacent journal blocks together", testGroupCommit },
+  { "delay partial journal block commits",     testCommitDelay },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Recovery journal group commit (JournalGroupCommit_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = NULL,
+  .cleaner                  = tearDownVDOTest,
+  .tests                    = tests
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
@@ -0,0 +1,156 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include "slab-depot.h"
+#include "vdo.h"
+
+#include "blockMapUtils.h"
+#include "ioRequest.h"
+#include "recoveryModeUtils.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+static slab_count_t  totalSlabs;
+static block_count_t dataPerSlab;
+static bool          loaded;
+
+/**
+ * Test-specific initialization.
+ **/
+static void initializeLazyRefCountsT1(void)
+{
+  const TestParameters parameters = {
+    .mappableBlocks      = 256,
+    .journalBlocks       = 32,
+    .slabJournalBlocks   = 8,
+    .slabSize            = 32,
+    .logicalThreadCount  = 1,
+    .physicalThreadCount = 1,
+    .hashZoneThreadCount = 1,
+    .lazyRefCounts       = true,
+  };
+  initializeRecoveryModeTest(&parameters);
+  totalSlabs  = vdo->depot->slab_count;
+  dataPerSlab = vdo->depot->slab_config.data_blocks;
+}
+
+/**
+ * Check whether the allocator has loaded all of its slabs.
+ *
+ * <p>Implements vdo_action_fn.
+ **/
+static void checkLoaded(struct vdo_completion *completion)
+{
+  loaded = (vdo->depot->allocators[0].scrubber.slab_count == 0);
+  vdo_finish_completion(completion);
+}
+
+/**
+ * Wait for the allocator to finish loading reference counts.
+ **/
+static void waitForSlabsToLoad(void)
+{
+  loaded = false;
+  while (!loaded) {
+    performSuccessfulActionOnThread(checkLoaded,
+                                    vdo->thread_config.physical_threads[0]);
+  }
+}
+
+/**
+ * Get the slab holding the block mapped to a logical block.
+ *
+ * @param lbn  The logical block
+ *
+ * @return The slab number
+ **/
+static slab_count_t getSlabNumber(logical_block_number_t lbn)
+{
+  return vdo_get_slab(vdo->depot, lookupLBN(lbn).pbn)->slab_number;
+}
+
+/**
+ * Test that a clean vdo starts without loading all of its reference counts,
+ * and that a slab which is used is loaded before the others.
+ **/
+static void testLazyLoading(void)
+{
+  /*
+   * Fill seven and a half slabs so that the half full slab is the one loaded
+   * at startup, and the full ones are then loaded in slab order.
+   */
+  block_count_t blocks = (15 * dataPerSlab) / 2;
+  writeData(0, 1, blocks, VDO_SUCCESS);
+  slab_count_t lastFullSlab = getSlabNumber(blocks - 1) - 1;
+  CU_ASSERT_TRUE(lastFullSlab > 1);
+  logical_block_number_t lbn = blocks - (dataPerSlab * 3 / 2);
+  CU_ASSERT_EQUAL(getSlabNumber(lbn), lastFullSlab);
+  stopVDO();
+
+  // The vdo must start even though loading the first full slab is blocked.
+  setupSlabLoadingLatch(0);
+  startVDO(VDO_CLEAN);
+  waitForSlabLatch(0);
+
+  struct vdo_statistics stats;
+  vdo_fetch_statistics(vdo, &stats);
+  CU_ASSERT_EQUAL(stats.allocator.slabs_to_scrub, lastFullSlab + 1);
+  // The half full slab was deferred too, but has been loaded.
+  CU_ASSERT_EQUAL(stats.allocator.lazy_slabs, lastFullSlab + 2);
+  CU_ASSERT_EQUAL(stats.allocator.lazy_slabs_loaded, 1);
+  CU_ASSERT_EQUAL(vdo->depot->slabs[lastFullSlab]->status,
+                  VDO_SLAB_REQUIRES_SCRUBBING);
+
+  // Overwriting a block makes its slab jump the queue.
+  writeData(lbn, 2 * blocks, 1, VDO_SUCCESS);
+  CU_ASSERT_EQUAL(vdo->depot->slabs[lastFullSlab]->status,
+                  VDO_SLAB_REQUIRES_HIGH_PRIORITY_SCRUBBING);
+  setupSlabLoadingLatch(1);
+  setupSlabLoadingLatch(lastFullSlab);
+  releaseSlabLatch(0);
+  CU_ASSERT_EQUAL(waitForAnySlabToLatch(totalSlabs), lastFullSlab);
+
+  releaseAllSlabLatches(totalSlabs);
+  waitForSlabsToLoad();
+  vdo_fetch_statistics(vdo, &stats);
+  CU_ASSERT_EQUAL(stats.allocator.slabs_to_scrub, 0);
+  CU_ASSERT_EQUAL(stats.allocator.lazy_slabs_loaded, lastFullSlab + 2);
+  verifyData(0, 1, lbn);
+  verifyData(lbn, 2 * blocks, 1);
+  verifyData(lbn + 1, lbn + 2, blocks - lbn - 1);
+
+  // The counts must be the same as if they had been loaded eagerly.
+  block_count_t freeBlocks = getPhysicalBlocksFree();
+  restartVDO(false);
+  waitForSlabsToLoad();
+  CU_ASSERT_EQUAL(getPhysicalBlocksFree(), freeBlocks);
+  vdo_fetch_statistics(vdo, &stats);
+  CU_ASSERT_EQUAL(stats.allocator.lazy_slabs_loaded, stats.allocator.lazy_slabs);
+  CU_ASSERT_EQUAL(stats.allocator.slabs_scrubbed, stats.allocator.lazy_slabs);
+}
+
+/**********************************************************************/
+static CU_TestInfo tests[] = {
+  { "load reference counts lazily", testLazyLoading },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Lazy reference count loading (LazyRefCounts_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = initializeLazyRefCountsT1,
+  .cleaner                  = tearDownRecoveryModeTest,
+  .tests                    = tests
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
@@ -0,0 +1,110 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * Performance testing of hashing data blocks one at a time versus
+ * several at a time in interleaved lanes.
+ *
+ * $Id$
+ */
+
+#include "assertions.h"
+#include "indexer.h"
+#include "murmurhash3.h"
+#include "permassert.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+enum {
+  BLOCK_SIZE = 4096,
+  // Should be larger than CPU cache size.
+  BLOCK_COUNT = 10 * 1024,
+  ITERATIONS = 100,
+  SEED = 0x62ea60be,
+};
+
+static unsigned char buffer[BLOCK_COUNT][BLOCK_SIZE]
+  __attribute__ ((__aligned__(64)));
+static struct uds_record_name singleNames[BLOCK_COUNT];
+static struct uds_record_name laneNames[BLOCK_COUNT];
+
+/**********************************************************************/
+static uint64_t cpuTime(void)
+{
+  /* user cpu time */
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) < 0) {
+    perror("getrusage");
+    exit(1);
+  }
+  return ((uint64_t) ru.ru_utime.tv_sec * 1000000) + ru.ru_utime.tv_usec;
+}
+
+/**********************************************************************/
+static void report(const char *name, uint64_t duration)
+{
+  uint64_t hashes = (uint64_t) ITERATIONS * BLOCK_COUNT;
+  double perHash = (double) duration / hashes;
+  printf("%-22s %9lu hashes: %5.2fs (%.3fus/block, %7.1fMB/s)\n",
+         name, hashes, duration * 1.0e-6, perHash,
+         (BLOCK_SIZE / perHash) * (1.0e6 / (1024 * 1024)));
+}
+
+/**********************************************************************/
+static void hashSingly(void)
+{
+  for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+    murmurhash3_128(buffer[b], BLOCK_SIZE, SEED, &singleNames[b]);
+  }
+}
+
+/**********************************************************************/
+static void hashInLanes(void)
+{
+  for (unsigned int b = 0; b < BLOCK_COUNT; b += MURMURHASH3_LANES) {
+    const void *keys[MURMURHASH3_LANES];
+    void *names[MURMURHASH3_LANES];
+    for (unsigned int lane = 0; lane < MURMURHASH3_LANES; lane++) {
+      keys[lane] = buffer[b + lane];
+      names[lane] = &laneNames[b + lane];
+    }
+    murmurhash3_128_lanes(keys, BLOCK_SIZE, SEED, names);
+  }
+}
+
+/**********************************************************************/
+static void timeHashing(const char *name, void (*hasher)(void))
+{
+  // Run once untimed to make sure the code is cached.
+  hasher();
+  uint64_t startTime = cpuTime();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    hasher();
+  }
+  report(name, cpuTime() - startTime);
+}
+
+/**********************************************************************/
+int main(void)
+{
+  STATIC_ASSERT(BLOCK_COUNT % MURMURHASH3_LANES == 0);
+  for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+    for (unsigned int i = 0; i < BLOCK_SIZE; i++) {
+      buffer[b][i] = random() & 0xff;
+    }
+  }
+
+  printf("Hashing %u-byte blocks, %u lanes:\n", BLOCK_SIZE, MURMURHASH3_LANES);
+  timeHashing("one at a time", hashSingly);
+  timeHashing("interleaved lanes", hashInLanes);
+
+  for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+    UDS_ASSERT_BLOCKNAME_EQUAL(singleNames[b].name, laneNames[b].name);
+  }
+
+  return 0;
+}
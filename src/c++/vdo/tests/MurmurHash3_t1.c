@@ -10,6 +10,8 @@
 #include "murmurhash3.h"
 #include "assertions.h"
 
+#include <stdlib.h>
+
 static const char *input1 = "The quick brown fox jumps over the lazy dog";
 static const char *input2 = "The quick brown fox jumps over the lazy cog";
 
@@ -65,10 +67,40 @@ static void testChunkName(void)
   checkChunkName(input2, result2);
 }
 
+/**********************************************************************/
+static void testLanes(void)
+{
+  enum { MAX_LENGTH = 4096 + 15 };
+  static char keys[MURMURHASH3_LANES][MAX_LENGTH];
+  unsigned char hashes[MURMURHASH3_LANES][128 / 8];
+  unsigned char expected[128 / 8];
+  const void *keyPointers[MURMURHASH3_LANES];
+  void *hashPointers[MURMURHASH3_LANES];
+
+  for (int lane = 0; lane < MURMURHASH3_LANES; lane++) {
+    for (int i = 0; i < MAX_LENGTH; i++) {
+      keys[lane][i] = random() & 0xff;
+    }
+    keyPointers[lane] = keys[lane];
+    hashPointers[lane] = hashes[lane];
+  }
+
+  // Cover every tail length, as well as a full data block.
+  const int lengths[] = { 0, 1, 7, 8, 9, 15, 16, 17, 31, 43, 4096, MAX_LENGTH };
+  for (unsigned int l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+    murmurhash3_128_lanes(keyPointers, lengths[l], 0x62ea60be, hashPointers);
+    for (int lane = 0; lane < MURMURHASH3_LANES; lane++) {
+      murmurhash3_128(keys[lane], lengths[l], 0x62ea60be, expected);
+      UDS_ASSERT_EQUAL_BYTES(expected, hashes[lane], sizeof(expected));
+    }
+  }
+}
+
 /**********************************************************************/
 static CU_TestInfo murmurTests[] = {
   {"murmurhash3_128",     testHash128 },
   {"murmurHashChunkName", testChunkName },
+  {"murmurhash3_128_lanes", testLanes },
   CU_TEST_INFO_NULL,
 };
 
@@ -0,0 +1,263 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include "memory-alloc.h"
+
+#include "data-vio.h"
+#include "packer.h"
+#include "vdo.h"
+
+#include "adminUtils.h"
+#include "asyncLayer.h"
+#include "callbackWrappingUtils.h"
+#include "ioRequest.h"
+#include "mutexUtils.h"
+#include "packerUtils.h"
+#include "testTimer.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  PACKER_MAX_AGE = 1000,
+};
+
+static block_count_t packedItemCount;
+static block_count_t targetItemCount;
+static bool          packed;
+static block_size_t  compressedSizes[16];
+
+/**
+ * Set up a VDO with a bucketed packer which writes out bins after
+ * PACKER_MAX_AGE milliseconds.
+ **/
+static void initialize(void)
+{
+  const TestParameters parameters = {
+    .mappableBlocks       = 64,
+    .journalBlocks        = 8,
+    .logicalThreadCount   = 1,
+    .enableCompression    = true,
+    .disableDeduplication = true,
+    .packerBucketed       = true,
+    .packerMaxAge         = PACKER_MAX_AGE,
+    .dataFormatter        = fillWithOffsetPlusOne,
+  };
+  initializeVDOTest(&parameters);
+  populateBlockMapTree();
+}
+
+/**
+ * Set the compressed size on exit from the compressor, and signal once the
+ * expected number of data_vios are waiting in the packer.
+ *
+ * Implements vdo_action_fn
+ **/
+static void setCompressedSize(struct vdo_completion *completion)
+{
+  struct data_vio *dataVIO = as_data_vio(completion);
+  dataVIO->compression.size = compressedSizes[dataVIO->logical.lbn];
+  runSavedCallbackAssertNoRequeue(completion);
+  if (++packedItemCount == targetItemCount) {
+    signalState(&packed);
+  }
+}
+
+/**
+ * Implements CompletionHook.
+ **/
+static bool wrapIfLeavingCompressor(struct vdo_completion *completion)
+{
+  if (isLeavingCompressor(completion)) {
+    wrapCompletionCallback(completion, setCompressedSize);
+  }
+
+  return true;
+}
+
+/**
+ * Launch writes of single blocks and wait for all of them to reach the
+ * packer without being written.
+ *
+ * @param start     The first logical block to write
+ * @param count     The number of blocks to write
+ * @param requests  The array in which to store the requests, indexed by lbn
+ **/
+static void packBlocks(logical_block_number_t start,
+                       block_count_t          count,
+                       IORequest             *requests[])
+{
+  packedItemCount = 0;
+  targetItemCount = count;
+  packed = false;
+  setCompletionEnqueueHook(wrapIfLeavingCompressor);
+  for (logical_block_number_t lbn = start; lbn < start + count; lbn++) {
+    requests[lbn] = launchIndexedWrite(lbn, 1, lbn);
+  }
+
+  waitForState(&packed);
+  clearCompletionEnqueueHooks();
+}
+
+/**
+ * Check that the packer stats match expectations.
+ *
+ * @param blocks     The expected number of compressed blocks written
+ * @param fragments  The expected number of fragments written
+ * @param waiting    The expected number of fragments in the packer
+ **/
+static void assertPackerStatistics(block_count_t blocks,
+                                   block_count_t fragments,
+                                   block_count_t waiting)
+{
+  struct packer_statistics stats = vdo_get_packer_statistics(vdo->packer);
+  CU_ASSERT_EQUAL(blocks, stats.compressed_blocks_written);
+  CU_ASSERT_EQUAL(fragments, stats.compressed_fragments_written);
+  CU_ASSERT_EQUAL(waiting, stats.compressed_fragments_in_packer);
+}
+
+/**
+ * Test that a bucketed packer fills a bin when fragments fit exactly.
+ **/
+static void bucketedBinBoundaryTest(void)
+{
+  block_count_t freeBlocks = getPhysicalBlocksFree();
+  writeData(0, 1, VDO_MAX_COMPRESSION_SLOTS, VDO_SUCCESS);
+  CU_ASSERT_EQUAL(getPhysicalBlocksFree(), freeBlocks - 1);
+}
+
+/**
+ * Test that bins are written once their oldest fragment reaches the maximum
+ * age, and that an aged bin takes fragments from younger bins which fit.
+ **/
+static void agedBinTest(void)
+{
+  IORequest *requests[4];
+
+  // The first fragment leaves most of its bin free.
+  compressedSizes[1] = 1000;
+  packBlocks(1, 1, requests);
+  assertPackerStatistics(0, 0, 1);
+
+  // Let time pass without reaching the maximum age of the first bin.
+  unsigned long deadline = getNextTimeout();
+  CU_ASSERT_NOT_EQUAL(deadline, ULONG_MAX);
+  CU_ASSERT_FALSE(fireTimers(deadline - 1));
+
+  // The second fragment doesn't fit in the first bin; the third fits best
+  // with the second.
+  compressedSizes[2] = VDO_COMPRESSED_BLOCK_DATA_SIZE - 600;
+  compressedSizes[3] = 500;
+  packBlocks(2, 2, requests);
+  assertPackerStatistics(0, 0, 3);
+
+  // Expiring the first bin should also take the third fragment.
+  CU_ASSERT_TRUE(fireTimers(getNextTimeout()));
+  awaitAndFreeSuccessfulRequest(vdo_forget(requests[1]));
+  awaitAndFreeSuccessfulRequest(vdo_forget(requests[3]));
+  assertPackerStatistics(1, 2, 1);
+
+  // The second bin is written when it ages out in turn. Since it holds only
+  // one fragment, that fragment is written uncompressed.
+  CU_ASSERT_TRUE(fireTimers(getNextTimeout()));
+  awaitAndFreeSuccessfulRequest(vdo_forget(requests[2]));
+  assertPackerStatistics(1, 2, 0);
+  CU_ASSERT_EQUAL(getNextTimeout(), ULONG_MAX);
+}
+
+/**
+ * Test that an aged bin is filled with the set of fragments from younger bins
+ * which fits exactly, rather than with the largest fragment which fits.
+ **/
+static void agedBinFilledExactlyTest(void)
+{
+  IORequest *requests[8];
+
+  // The first fragment leaves 1000 bytes free in its bin.
+  compressedSizes[1] = VDO_COMPRESSED_BLOCK_DATA_SIZE - 1000;
+  packBlocks(1, 1, requests);
+
+  unsigned long deadline = getNextTimeout();
+  CU_ASSERT_NOT_EQUAL(deadline, ULONG_MAX);
+  CU_ASSERT_FALSE(fireTimers(deadline - 1));
+
+  // Each large fragment starts a new bin, which the next, smaller fragment
+  // fills most of.
+  compressedSizes[2] = VDO_COMPRESSED_BLOCK_DATA_SIZE - 700;
+  compressedSizes[3] = 600;
+  compressedSizes[4] = VDO_COMPRESSED_BLOCK_DATA_SIZE - 600;
+  compressedSizes[5] = 500;
+  compressedSizes[6] = VDO_COMPRESSED_BLOCK_DATA_SIZE - 600;
+  compressedSizes[7] = 500;
+  for (logical_block_number_t lbn = 2; lbn <= 7; lbn++) {
+    packBlocks(lbn, 1, requests);
+  }
+  assertPackerStatistics(0, 0, 7);
+
+  // Taking the largest fragment which fits would leave 400 bytes free, but
+  // the two 500 byte fragments fill the first bin.
+  CU_ASSERT_TRUE(fireTimers(getNextTimeout()));
+  awaitAndFreeSuccessfulRequest(vdo_forget(requests[1]));
+  awaitAndFreeSuccessfulRequest(vdo_forget(requests[5]));
+  awaitAndFreeSuccessfulRequest(vdo_forget(requests[7]));
+  assertPackerStatistics(1, 3, 4);
+
+  // Suspending writes out the rest. Only one of the remaining bins can be
+  // written with two fragments, and the others hold only one.
+  performSuccessfulPackerAction(VDO_ADMIN_STATE_SUSPENDING);
+  for (logical_block_number_t lbn = 2; lbn <= 6; lbn++) {
+    if (lbn != 5) {
+      awaitAndFreeSuccessfulRequest(vdo_forget(requests[lbn]));
+    }
+  }
+  assertPackerStatistics(2, 5, 0);
+  performSuccessfulPackerAction(VDO_ADMIN_STATE_RESUMING);
+}
+
+/**
+ * Test that suspending the packer writes out waiting fragments and cancels
+ * the age timer.
+ **/
+static void suspendWithTimerTest(void)
+{
+  IORequest *requests[2];
+
+  compressedSizes[1] = 1000;
+  packBlocks(1, 1, requests);
+  CU_ASSERT_NOT_EQUAL(getNextTimeout(), ULONG_MAX);
+
+  performSuccessfulPackerAction(VDO_ADMIN_STATE_SUSPENDING);
+  awaitAndFreeSuccessfulRequest(vdo_forget(requests[1]));
+  assertPackerStatistics(0, 0, 0);
+  CU_ASSERT_EQUAL(getNextTimeout(), ULONG_MAX);
+  performSuccessfulPackerAction(VDO_ADMIN_STATE_RESUMING);
+}
+
+/**********************************************************************/
+
+static CU_TestInfo packerTests[] = {
+  { "bucketed bin boundary",   bucketedBinBoundaryTest  },
+  { "aged bins are written",   agedBinTest              },
+  { "aged bin filled exactly", agedBinFilledExactlyTest },
+  { "suspend with age timer",  suspendWithTimerTest     },
+  CU_TEST_INFO_NULL
+};
+
+static CU_SuiteInfo packerSuite = {
+  .name                     = "bucketed packer tests (Packer_t2)",
+  .initializerWithArguments = NULL,
+  .initializer              = initialize,
+  .cleaner                  = tearDownVDOTest,
+  .tests                    = packerTests
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &packerSuite;
+}
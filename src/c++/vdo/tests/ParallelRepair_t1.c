@@ -0,0 +1,137 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include <linux/atomic.h>
+
+#include "vdo.h"
+
+#include "asyncLayer.h"
+#include "ioRequest.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  BLOCK_COUNT = 2048,
+  ROUNDS      = 6,
+  CPU_THREADS = 4,
+};
+
+static atomic_t extractionCount;
+
+/**
+ * Test-specific initialization.
+ **/
+static void initializeParallelRepairT1(void)
+{
+  const TestParameters parameters = {
+    .logicalBlocks        = BLOCK_COUNT,
+    .physicalBlocks       = 16384,
+    .slabSize             = 1024,
+    .journalBlocks        = 512,
+    .cacheSize            = 64,
+    .cpuThreadCount       = CPU_THREADS,
+    .noIndexRegion        = true,
+    .disableDeduplication = true,
+  };
+  initializeVDOTest(&parameters);
+}
+
+/**
+ * Count the ranges of the journal sent to the cpu threads for extraction.
+ *
+ * Implements CompletionHook.
+ **/
+static bool countExtractions(struct vdo_completion *completion)
+{
+  if ((completion->type == VDO_JOURNAL_EXTRACTION_COMPLETION)
+      && (completion->callback_thread_id == vdo->thread_config.cpu_thread)) {
+    atomic_inc(&extractionCount);
+  }
+
+  return true;
+}
+
+/**
+ * Overwrite the same logical blocks several times, so that each block has
+ * entries in several ranges of the journal, ending with a partial round.
+ *
+ * @return The data index of the last full round
+ **/
+static block_count_t writeRounds(void)
+{
+  block_count_t index = 1;
+  for (unsigned int round = 0; round < ROUNDS; round++) {
+    index = 1 + (round * BLOCK_COUNT);
+    writeData(0, index, BLOCK_COUNT, VDO_SUCCESS);
+  }
+
+  writeData(0, index + BLOCK_COUNT, BLOCK_COUNT / 2, VDO_SUCCESS);
+  return index;
+}
+
+/**
+ * Restart the vdo, checking that the journal was extracted by more than one
+ * cpu thread and that the latest data for each block survived.
+ *
+ * @param loadState  The state in which to start the vdo
+ * @param lastRound  The data index of the last full round
+ **/
+static void repairAndVerify(enum vdo_state loadState, block_count_t lastRound)
+{
+  atomic_set(&extractionCount, 0);
+  addCompletionEnqueueHook(countExtractions);
+  startVDO(loadState);
+  removeCompletionEnqueueHook(countExtractions);
+
+  CU_ASSERT_TRUE(atomic_read(&extractionCount) > 1);
+  CU_ASSERT_TRUE(atomic_read(&extractionCount) <= CPU_THREADS);
+  verifyData(0, lastRound + BLOCK_COUNT, BLOCK_COUNT / 2);
+  verifyData(BLOCK_COUNT / 2, lastRound + (BLOCK_COUNT / 2), BLOCK_COUNT / 2);
+}
+
+/**
+ * Test recovery with the journal extracted in parallel.
+ **/
+static void testParallelRecovery(void)
+{
+  block_count_t lastRound = writeRounds();
+  crashVDO();
+  repairAndVerify(VDO_DIRTY, lastRound);
+}
+
+/**
+ * Test read-only rebuild with the journal extracted in parallel.
+ **/
+static void testParallelRebuild(void)
+{
+  block_count_t lastRound = writeRounds();
+  forceRebuild();
+  repairAndVerify(VDO_FORCE_REBUILD, lastRound);
+}
+
+/**********************************************************************/
+static CU_TestInfo tests[] = {
+  { "recover with parallel journal extraction", testParallelRecovery },
+  { "rebuild with parallel journal extraction", testParallelRebuild  },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Parallel journal extraction (ParallelRepair_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = initializeParallelRepairT1,
+  .cleaner                  = tearDownVDOTest,
+  .tests                    = tests
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
@@ -31,8 +31,10 @@ static unsigned int errorOperation;
 static void initializeReadOnlyModeT1(void)
 {
   const TestParameters parameters = {
-    .mappableBlocks = 16,
-    .journalBlocks  = 4,
+    .mappableBlocks        = 16,
+    .journalBlocks         = 4,
+    // The block map read must not be satisfied by warming up the cache.
+    .disableBlockMapWarmup = true,
   };
   initializeVDOTest(&parameters);
 }
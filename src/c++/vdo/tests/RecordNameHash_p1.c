@@ -0,0 +1,120 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * Performance testing of the record name hash algorithms which may be
+ * selected when a VDO is formatted. All hashing is done on one thread, so
+ * the rates reported are per core.
+ *
+ * $Id$
+ */
+
+#include "assertions.h"
+#include "indexer.h"
+#include "murmurhash3.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include "constants.h"
+#include "encodings.h"
+
+enum {
+  // Should be larger than CPU cache size.
+  BLOCK_COUNT = 10 * 1024,
+  ITERATIONS = 100,
+  SEED = 0x62ea60be,
+};
+
+static unsigned char buffer[BLOCK_COUNT][VDO_BLOCK_SIZE]
+  __attribute__ ((__aligned__(64)));
+static struct uds_record_name names[BLOCK_COUNT];
+
+/**********************************************************************/
+static uint64_t cpuTime(void)
+{
+  /* user cpu time */
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) < 0) {
+    perror("getrusage");
+    exit(1);
+  }
+  return ((uint64_t) ru.ru_utime.tv_sec * 1000000) + ru.ru_utime.tv_usec;
+}
+
+/**********************************************************************/
+static void report(const char *name, uint64_t duration)
+{
+  uint64_t hashes = (uint64_t) ITERATIONS * BLOCK_COUNT;
+  double perHash = (double) duration / hashes;
+  printf("%-32s %9lu hashes: %5.2fs (%.3fus/block, %7.1fMB/s/core)\n",
+         name, hashes, duration * 1.0e-6, perHash,
+         (VDO_BLOCK_SIZE / perHash) * (1.0e6 / (1024 * 1024)));
+}
+
+/**
+ * Hash each block by itself, as a data_vio which arrives alone is hashed.
+ **/
+static void hashMurmur3(void)
+{
+  for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+    murmurhash3_128(buffer[b], VDO_BLOCK_SIZE, SEED, &names[b]);
+  }
+}
+
+/**
+ * Hash blocks in groups, as a full batch of data_vios is hashed.
+ **/
+static void hashMurmur3Lanes(void)
+{
+  for (unsigned int b = 0; b < BLOCK_COUNT; b += MURMURHASH3_LANES) {
+    const void *keys[MURMURHASH3_LANES];
+    void *outs[MURMURHASH3_LANES];
+    for (unsigned int lane = 0; lane < MURMURHASH3_LANES; lane++) {
+      keys[lane] = buffer[b + lane];
+      outs[lane] = &names[b + lane];
+    }
+    murmurhash3_128_lanes(keys, VDO_BLOCK_SIZE, SEED, outs);
+  }
+}
+
+/**********************************************************************/
+static void hashMurmur3Striped(void)
+{
+  for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+    murmurhash3_128_striped(buffer[b], VDO_BLOCK_SIZE, SEED, &names[b]);
+  }
+}
+
+/**********************************************************************/
+static void timeHashing(const char *name, void (*hasher)(void))
+{
+  // Run once untimed to make sure the code is cached.
+  hasher();
+  uint64_t startTime = cpuTime();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    hasher();
+  }
+  report(name, cpuTime() - startTime);
+}
+
+/**********************************************************************/
+int main(void)
+{
+  STATIC_ASSERT(BLOCK_COUNT % MURMURHASH3_LANES == 0);
+  for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+    for (unsigned int i = 0; i < VDO_BLOCK_SIZE; i++) {
+      buffer[b][i] = random() & 0xff;
+    }
+  }
+
+  printf("Hashing %u-byte blocks on one core:\n", VDO_BLOCK_SIZE);
+  timeHashing(vdo_get_hash_algorithm_name(VDO_HASH_MURMUR3), hashMurmur3);
+  timeHashing("murmur3 (batched lanes)", hashMurmur3Lanes);
+  timeHashing(vdo_get_hash_algorithm_name(VDO_HASH_MURMUR3_STRIPED),
+              hashMurmur3Striped);
+  return 0;
+}
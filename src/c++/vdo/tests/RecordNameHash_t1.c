@@ -0,0 +1,282 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * Tests of the record name hash algorithms which may be selected when a VDO
+ * is formatted.
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include <linux/unaligned.h>
+#include <stdlib.h>
+
+#include "memory-alloc.h"
+#include "murmurhash3.h"
+
+#include "constants.h"
+#include "encodings.h"
+
+#include "vdoAsserts.h"
+
+enum {
+  // Enough blocks that each of 256 buckets should get 64 names.
+  DISTRIBUTION_BLOCKS = 16 * 1024,
+  COLLIDING_BLOCKS    = 128,
+  BUCKETS             = 256,
+  SEED                = 0x62ea60be,
+};
+
+/*
+ * The chi-squared statistic for 255 degrees of freedom has a mean of 255 and
+ * a standard deviation of about 22.6, so this is a seven sigma bound. The
+ * inputs are fixed, so the test is deterministic.
+ */
+static const double CHI_SQUARED_LIMIT = 255 + (7 * 22.6);
+
+/**
+ * Compute the record name of a block with a given algorithm.
+ **/
+static void hashBlock(enum vdo_hash_algorithm  algorithm,
+                      const u8                *block,
+                      int                      length,
+                      struct uds_record_name  *name)
+{
+  if (algorithm == VDO_HASH_MURMUR3_STRIPED) {
+    murmurhash3_128_striped(block, length, SEED, name);
+  } else {
+    murmurhash3_128(block, length, SEED, name);
+  }
+}
+
+/**
+ * Compare two record names for qsort().
+ **/
+static int compareNames(const void *name1, const void *name2)
+{
+  return memcmp(name1, name2, sizeof(struct uds_record_name));
+}
+
+/**
+ * Count the names which are the same as some other name in an array.
+ **/
+static unsigned int countDuplicateNames(struct uds_record_name *names,
+                                        unsigned int            count)
+{
+  qsort(names, count, sizeof(struct uds_record_name), compareNames);
+  unsigned int duplicates = 0;
+  for (unsigned int i = 1; i < count; i++) {
+    if (compareNames(&names[i - 1], &names[i]) == 0) {
+      duplicates++;
+    }
+  }
+
+  return duplicates;
+}
+
+/*
+ * The next three functions are the murmur3 collision generator from
+ * tools/murmur3collide.c. It rewrites two consecutive 16-byte blocks so that
+ * the murmur3 state after them is unchanged.
+ */
+
+/**********************************************************************/
+static inline u64 rotl64(u64 x, int8_t r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+/**********************************************************************/
+static void m3forward(u64 chunk[2])
+{
+  u64 k1 = __le64_to_cpu(chunk[0]);
+  u64 k2 = __le64_to_cpu(chunk[1]);
+  const u64 c1 = 0x87c37b91114253d5UL;
+  const u64 c2 = 0x4cf5ad432745937fUL;
+  k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2;
+  k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1;
+  chunk[0] = k1;
+  chunk[1] = k2;
+}
+
+/**********************************************************************/
+static void m3backward(u64 chunk[2])
+{
+  u64 k1 = chunk[0];
+  u64 k2 = chunk[1];
+  const u64 r1 = 0xa81e14edd9de2c7fUL;
+  const u64 r2 = 0xa98409e882ce4d7dUL;
+  k1 *= r1; k1 = rotl64(k1, 33); k1 *= r2;
+  k2 *= r2; k2 = rotl64(k2, 31); k2 *= r1;
+  chunk[0] = __cpu_to_le64(k1);
+  chunk[1] = __cpu_to_le64(k2);
+}
+
+/**
+ * Modify a block in place so that it has the same murmur3 hash but different
+ * contents. Successive calls choose chunks in a Gray-code-like order so that
+ * repeatedly colliding one block keeps producing new contents.
+ **/
+static void collide(u8 *block)
+{
+  static unsigned long counter = 0;
+  int index = 32 * (__builtin_ffsl(++counter) % (VDO_BLOCK_SIZE / 32));
+  u64 *chunk = (u64 *) &block[index];
+  m3forward(&chunk[0]);
+  m3forward(&chunk[2]);
+  chunk[0] ^= 0x0000001000000000UL;
+  chunk[1] ^= 0x0000000100000000UL;
+  chunk[2] ^= 0x8000000000000000UL;
+  m3backward(&chunk[0]);
+  m3backward(&chunk[2]);
+}
+
+/**
+ * Check that the striped hash is a different function from murmur3, that it
+ * gives distinct names for inputs of every length around the stripe and row
+ * boundaries.
+ **/
+static void testStripedLengths(void)
+{
+  enum { MAX_LENGTH = 320 };
+  u8 *buffer;
+  VDO_ASSERT_SUCCESS(vdo_allocate(MAX_LENGTH, u8, __func__, &buffer));
+  for (int i = 0; i < MAX_LENGTH; i++) {
+    buffer[i] = random() & 0xff;
+  }
+
+  struct uds_record_name *names;
+  VDO_ASSERT_SUCCESS(vdo_allocate(MAX_LENGTH + 1, struct uds_record_name,
+                                  __func__, &names));
+  for (int length = 0; length <= MAX_LENGTH; length++) {
+    struct uds_record_name murmur;
+    murmurhash3_128_striped(buffer, length, SEED, &names[length]);
+    murmurhash3_128(buffer, length, SEED, &murmur);
+    UDS_ASSERT_NOT_EQUAL_BYTES(&murmur, &names[length], sizeof(murmur));
+
+    struct uds_record_name again;
+    murmurhash3_128_striped(buffer, length, SEED, &again);
+    UDS_ASSERT_EQUAL_BYTES(&names[length], &again, sizeof(again));
+  }
+
+  CU_ASSERT_EQUAL(countDuplicateNames(names, MAX_LENGTH + 1), 0);
+  vdo_free(names);
+  vdo_free(buffer);
+}
+
+/**
+ * Check that blocks built by the murmur3 collision generator all collide
+ * under murmur3 and not under the striped hash.
+ **/
+static void testCollisions(void)
+{
+  u8 *block;
+  VDO_ASSERT_SUCCESS(vdo_allocate(VDO_BLOCK_SIZE, u8, __func__, &block));
+  for (int i = 0; i < VDO_BLOCK_SIZE; i++) {
+    block[i] = random() & 0xff;
+  }
+
+  struct uds_record_name *murmurNames, *stripedNames;
+  VDO_ASSERT_SUCCESS(vdo_allocate(COLLIDING_BLOCKS, struct uds_record_name,
+                                  __func__, &murmurNames));
+  VDO_ASSERT_SUCCESS(vdo_allocate(COLLIDING_BLOCKS, struct uds_record_name,
+                                  __func__, &stripedNames));
+  for (unsigned int b = 0; b < COLLIDING_BLOCKS; b++) {
+    hashBlock(VDO_HASH_MURMUR3, block, VDO_BLOCK_SIZE, &murmurNames[b]);
+    hashBlock(VDO_HASH_MURMUR3_STRIPED, block, VDO_BLOCK_SIZE,
+              &stripedNames[b]);
+    collide(block);
+  }
+
+  CU_ASSERT_EQUAL(countDuplicateNames(murmurNames, COLLIDING_BLOCKS),
+                  COLLIDING_BLOCKS - 1);
+  CU_ASSERT_EQUAL(countDuplicateNames(stripedNames, COLLIDING_BLOCKS), 0);
+  vdo_free(murmurNames);
+  vdo_free(stripedNames);
+  vdo_free(block);
+}
+
+/**
+ * Compute the chi-squared statistic for the distribution of one byte of a
+ * set of record names over its 256 possible values.
+ **/
+static double chiSquared(const struct uds_record_name *names,
+                         unsigned int                  count,
+                         unsigned int                  byte)
+{
+  unsigned int buckets[BUCKETS] = { 0, };
+  for (unsigned int i = 0; i < count; i++) {
+    buckets[names[i].name[byte]]++;
+  }
+
+  double expected = (double) count / BUCKETS;
+  double sum = 0;
+  for (unsigned int i = 0; i < BUCKETS; i++) {
+    double delta = buckets[i] - expected;
+    sum += (delta * delta) / expected;
+  }
+
+  return sum;
+}
+
+/**
+ * Check that every byte of the names of a set of very similar blocks is
+ * uniformly distributed. Byte 0 selects the hash zone, and the index uses
+ * the others, so any bias would unbalance the zones or the index.
+ **/
+static void checkDistribution(enum vdo_hash_algorithm algorithm)
+{
+  u8 *block;
+  VDO_ASSERT_SUCCESS(vdo_allocate(VDO_BLOCK_SIZE, u8, __func__, &block));
+
+  struct uds_record_name *names;
+  VDO_ASSERT_SUCCESS(vdo_allocate(DISTRIBUTION_BLOCKS, struct uds_record_name,
+                                  __func__, &names));
+  for (unsigned int b = 0; b < DISTRIBUTION_BLOCKS; b++) {
+    // Blocks which differ only in a counter at a stripe boundary.
+    put_unaligned_le32(b, &block[60]);
+    hashBlock(algorithm, block, VDO_BLOCK_SIZE, &names[b]);
+  }
+
+  for (unsigned int byte = 0; byte < UDS_RECORD_NAME_SIZE; byte++) {
+    double chi = chiSquared(names, DISTRIBUTION_BLOCKS, byte);
+    if (chi > CHI_SQUARED_LIMIT) {
+      CU_FAIL("%s byte %u has chi-squared %.1f > %.1f",
+              vdo_get_hash_algorithm_name(algorithm), byte, chi,
+              CHI_SQUARED_LIMIT);
+    }
+  }
+
+  CU_ASSERT_EQUAL(countDuplicateNames(names, DISTRIBUTION_BLOCKS), 0);
+  vdo_free(names);
+  vdo_free(block);
+}
+
+/**********************************************************************/
+static void testDistribution(void)
+{
+  checkDistribution(VDO_HASH_MURMUR3);
+  checkDistribution(VDO_HASH_MURMUR3_STRIPED);
+}
+
+/**********************************************************************/
+static CU_TestInfo tests[] = {
+  { "striped hash lengths",        testStripedLengths },
+  { "murmur3 generated collisions", testCollisions    },
+  { "name byte distribution",      testDistribution   },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name  = "Record name hash algorithms (RecordNameHash_t1)",
+  .tests = tests,
+};
+
+/**********************************************************************/
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
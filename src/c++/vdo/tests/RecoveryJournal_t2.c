@@ -456,6 +456,7 @@ static void attemptRebuild(CorruptionType  corruption,
     for (slab_count_t i = 0; i < vdo->depot->slab_count; i++) {
       vdo_free(vdo_forget(vdo->depot->slabs[i]->counters));
       vdo_free(vdo_forget(vdo->depot->slabs[i]->reference_blocks));
+      vdo_free(vdo_forget(vdo->depot->slabs[i]->full_blocks));
     }
   }
 
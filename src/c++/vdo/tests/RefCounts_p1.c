@@ -0,0 +1,164 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * Performance testing of the search for free reference counters.
+ *
+ * $Id$
+ */
+
+#include "assertions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include "encodings.h"
+#include "slab-depot.h"
+
+enum {
+  // The number of reference blocks in a slab of 2^23 blocks.
+  BLOCK_COUNT   = 2081,
+  COUNTER_COUNT = BLOCK_COUNT * COUNTS_PER_BLOCK,
+  ITERATIONS    = 200,
+  WORD_SIZE     = sizeof(u64),
+};
+
+typedef bool (*FreeBlockFinder)(const struct vdo_slab *slab,
+                                slab_block_number *index_ptr);
+
+static struct vdo_slab slab;
+
+/**********************************************************************/
+static uint64_t cpuTime(void)
+{
+  /* user cpu time */
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) < 0) {
+    perror("getrusage");
+    exit(1);
+  }
+  return ((uint64_t) ru.ru_utime.tv_sec * 1000000) + ru.ru_utime.tv_usec;
+}
+
+/**
+ * The check of one word of counters used before the zero byte mask version.
+ **/
+static inline slab_block_number
+byteAtATimeFindZero(const u8 *wordPtr,
+                    slab_block_number startIndex,
+                    slab_block_number failIndex)
+{
+  u64 word = get_unaligned_le64(wordPtr);
+  for (unsigned int offset = 0; offset < WORD_SIZE; offset++) {
+    if ((word & 0xFF) == 0) {
+      return (startIndex + offset);
+    }
+    word >>= 8;
+  }
+
+  return failIndex;
+}
+
+/**
+ * The free block search used before the zero byte mask version.
+ **/
+static bool byteAtATimeFindFreeBlock(const struct vdo_slab *slab,
+                                     slab_block_number *indexPtr)
+{
+  slab_block_number nextIndex = slab->search_cursor.index;
+  slab_block_number endIndex = slab->search_cursor.end_index;
+  u8 *nextCounter = &slab->counters[nextIndex];
+  u8 *endCounter = &slab->counters[endIndex];
+  while (nextCounter < endCounter) {
+    slab_block_number zeroIndex
+      = byteAtATimeFindZero(nextCounter, nextIndex, endIndex);
+    if (zeroIndex < endIndex) {
+      *indexPtr = zeroIndex;
+      return true;
+    }
+
+    nextIndex += WORD_SIZE;
+    nextCounter += WORD_SIZE;
+  }
+
+  return false;
+}
+
+/**********************************************************************/
+static void report(const char *name, uint64_t duration)
+{
+  double perBlock = (double) duration / ((uint64_t) ITERATIONS * BLOCK_COUNT);
+  printf("  %-24s %5.2fs (%7.1fns/reference block)\n",
+         name, duration * 1.0e-6, 1000 * perBlock);
+}
+
+/**
+ * Search each reference block from its start for a free counter, and check
+ * that the expected one is found.
+ **/
+static void timeSearch(const char *name,
+                       FreeBlockFinder find,
+                       slab_block_number *expected)
+{
+  uint64_t startTime = cpuTime();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+      slab_block_number freeIndex;
+      slab.search_cursor.index = b * COUNTS_PER_BLOCK;
+      slab.search_cursor.end_index = slab.search_cursor.index + COUNTS_PER_BLOCK;
+      CU_ASSERT_TRUE(find(&slab, &freeIndex));
+      CU_ASSERT_EQUAL(freeIndex, expected[b]);
+    }
+  }
+  report(name, cpuTime() - startTime);
+}
+
+/**
+ * Fill the counters so that each reference block has one free counter, and
+ * record where it is.
+ *
+ * @param expected  The array to receive the free counter of each block
+ * @param atRandom  Whether the free counter should be placed at random, rather
+ *                  than at the end of the block
+ **/
+static void fillCounters(slab_block_number *expected, bool atRandom)
+{
+  memset(slab.counters, 1, COUNTER_COUNT);
+  for (unsigned int b = 0; b < BLOCK_COUNT; b++) {
+    slab_block_number offset
+      = (atRandom ? (random() % COUNTS_PER_BLOCK) : (COUNTS_PER_BLOCK - 1));
+    expected[b] = (b * COUNTS_PER_BLOCK) + offset;
+    slab.counters[expected[b]] = 0;
+  }
+}
+
+/**********************************************************************/
+int main(void)
+{
+  slab_block_number *expected = malloc(BLOCK_COUNT * sizeof(slab_block_number));
+  CU_ASSERT_PTR_NOT_NULL(expected);
+  // The counters are padded just as allocate_slab_counters() does.
+  slab.counters = malloc(COUNTER_COUNT + (2 * WORD_SIZE));
+  CU_ASSERT_PTR_NOT_NULL(slab.counters);
+  memset(slab.counters, 0, COUNTER_COUNT + (2 * WORD_SIZE));
+  slab.block_count = COUNTER_COUNT;
+
+  // A free counter at the very end of each block is the worst case.
+  fillCounters(expected, false);
+  printf("Free counter search, last counter free:\n");
+  timeSearch("byte at a time", byteAtATimeFindFreeBlock, expected);
+  timeSearch("find_free_block", find_free_block, expected);
+
+  fillCounters(expected, true);
+  printf("Free counter search, random counter free:\n");
+  timeSearch("byte at a time", byteAtATimeFindFreeBlock, expected);
+  timeSearch("find_free_block", find_free_block, expected);
+
+  free(slab.counters);
+  free(expected);
+  return 0;
+}
@@ -133,10 +133,29 @@ static void testCorruptLeafEntries(void)
   verifyBlockMapping(0);
 }
 
+/**
+ * Verify that bad references are removed, and the repaired pages written
+ * out, when the leaf pages are streamed rather than read through the block
+ * map cache.
+ **/
+static void testCorruptLeafEntriesStreaming(void)
+{
+  struct device_config config = getTestConfig().deviceConfig;
+  config.streaming_rebuild = true;
+  reloadVDO(config);
+  testCorruptLeafEntries();
+
+  // The repairs must have reached the disk.
+  restartVDO(false);
+  verifyBlockMapping(0);
+}
+
 /**********************************************************************/
 
 static CU_TestInfo vdoTests[] = {
   { "test reference count rebuild on corrupt leaves", testCorruptLeafEntries },
+  { "test streaming rebuild on corrupt leaves",
+    testCorruptLeafEntriesStreaming },
   CU_TEST_INFO_NULL,
 };
 
@@ -279,6 +279,7 @@ static void testWaitForSlabJournalSpace(void)
   for (slab_count_t i = 0; i < vdo->depot->slab_count; i++) {
     vdo_free(vdo_forget(vdo->depot->slabs[i]->counters));
     vdo_free(vdo_forget(vdo->depot->slabs[i]->reference_blocks));
+    vdo_free(vdo_forget(vdo->depot->slabs[i]->full_blocks));
   }
 
   // Use a single-VIO pool so it's easy to keep the slab journal from having
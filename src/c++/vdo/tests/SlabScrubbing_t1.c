@@ -0,0 +1,94 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include "slab-depot.h"
+#include "vdo.h"
+
+#include "ioRequest.h"
+#include "recoveryModeUtils.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+static slab_count_t totalSlabs;
+
+/**
+ * Test-specific initialization.
+ **/
+static void initializeSlabScrubbingT1(void)
+{
+  const TestParameters parameters = {
+    .mappableBlocks      = 256,
+    .journalBlocks       = 32,
+    .slabJournalBlocks   = 8,
+    .slabSize            = 32,
+    .logicalThreadCount  = 1,
+    .physicalThreadCount = 1,
+    .hashZoneThreadCount = 1,
+  };
+  initializeRecoveryModeTest(&parameters);
+  vdo_set_slab_scrubbing_depth(SLAB_SCRUBBER_DEPTH);
+  totalSlabs = vdo->depot->slab_count;
+}
+
+/**
+ * Test that the scrubber works on several slabs at once and reports its
+ * progress.
+ **/
+static void testParallelScrubbing(void)
+{
+  // Fill eight slabs, one at a time.
+  block_count_t dataPerSlab = vdo->depot->slab_config.data_blocks;
+  for (block_count_t i = 0; i < 8; i++) {
+    block_count_t start = i * dataPerSlab;
+    writeData(start, start + 1, dataPerSlab, VDO_SUCCESS);
+  }
+  crashVDO();
+
+  latchAnyScrubbingSlab(totalSlabs);
+  startVDO(VDO_DIRTY);
+
+  // A full set of slabs can be held up at once, but no more than that.
+  waitForSlabsToLatch(SLAB_SCRUBBER_DEPTH, totalSlabs);
+  CU_ASSERT_EQUAL(countLatchedSlabs(totalSlabs), SLAB_SCRUBBER_DEPTH);
+
+  struct vdo_statistics stats;
+  vdo_fetch_statistics(vdo, &stats);
+  CU_ASSERT_TRUE(stats.allocator.slabs_to_scrub >= SLAB_SCRUBBER_DEPTH);
+  u64 slabsToScrub
+    = stats.allocator.slabs_to_scrub + stats.allocator.slabs_scrubbed;
+
+  releaseAllSlabLatches(totalSlabs);
+  waitForRecoveryDone();
+
+  vdo_fetch_statistics(vdo, &stats);
+  CU_ASSERT_EQUAL(stats.allocator.slabs_to_scrub, 0);
+  CU_ASSERT_EQUAL(stats.allocator.slabs_scrubbed, slabsToScrub);
+  CU_ASSERT_EQUAL(stats.allocator.scrub_seconds_remaining, 0);
+  verifyData(0, 1, 8 * dataPerSlab);
+}
+
+/**********************************************************************/
+static CU_TestInfo tests[] = {
+  { "scrub several slabs at once", testParallelScrubbing },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Parallel slab scrubbing (SlabScrubbing_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = initializeSlabScrubbingT1,
+  .cleaner                  = tearDownRecoveryModeTest,
+  .tests                    = tests
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
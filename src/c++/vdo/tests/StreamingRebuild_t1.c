@@ -0,0 +1,182 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include <linux/atomic.h>
+
+#include "vdo.h"
+
+#include "asyncLayer.h"
+#include "asyncVIO.h"
+#include "ioRequest.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  LEAF_PAGES      = 40,
+  BLOCKS_PER_PAGE = 4,
+};
+
+static block_count_t leafReads;
+static block_count_t leafBlocksRead;
+static block_count_t largestLeafRead;
+static block_count_t singlePageReads;
+static bool          failRunRead;
+
+/**
+ * Test-specific initialization.
+ **/
+static void initializeStreamingRebuildT1(void)
+{
+  const TestParameters parameters = {
+    .logicalBlocks        = LEAF_PAGES * VDO_BLOCK_MAP_ENTRIES_PER_PAGE,
+    .physicalBlocks       = 8192,
+    .slabSize             = 1024,
+    .journalBlocks        = 32,
+    .streamingRebuild     = true,
+    .noIndexRegion        = true,
+    .disableDeduplication = true,
+  };
+  initializeVDOTest(&parameters);
+}
+
+/**
+ * Get the first logical block mapped by a leaf page.
+ *
+ * @param page  The leaf page number
+ *
+ * @return The first logical block of the page
+ **/
+static logical_block_number_t getFirstLBN(page_count_t page)
+{
+  return page * VDO_BLOCK_MAP_ENTRIES_PER_PAGE;
+}
+
+/**
+ * Write a few blocks to each leaf page, starting with the last one, so that
+ * the leaf pages are spread through the slab in the reverse of their logical
+ * order.
+ **/
+static void writeLeafPages(void)
+{
+  for (page_count_t page = LEAF_PAGES; page > 0; page--) {
+    writeData(getFirstLBN(page - 1), page * BLOCKS_PER_PAGE, BLOCKS_PER_PAGE,
+              VDO_SUCCESS);
+  }
+}
+
+/**
+ * Verify the blocks written by writeLeafPages().
+ **/
+static void verifyLeafPages(void)
+{
+  for (page_count_t page = LEAF_PAGES; page > 0; page--) {
+    verifyData(getFirstLBN(page - 1), page * BLOCKS_PER_PAGE,
+               BLOCKS_PER_PAGE);
+  }
+}
+
+/**
+ * Record the size of each read by the rebuild's leaf page readers (which,
+ * unlike the block map cache, use vios of more than one block), optionally
+ * failing the first read of more than one block.
+ *
+ * Implements BIOSubmitHook.
+ **/
+static bool recordLeafRead(struct bio *bio)
+{
+  struct vio *vio = bio->bi_private;
+  if (!vioTypeIs(&vio->completion, VIO_TYPE_BLOCK_MAP)
+      || !isMetadataRead(&vio->completion)
+      || (vio->block_count == 1)) {
+    return true;
+  }
+
+  block_count_t blocks = bio->bi_iter.bi_size / VDO_BLOCK_SIZE;
+  if (failRunRead && (blocks > 1)) {
+    failRunRead = false;
+    bio->bi_status = BLK_STS_VDO_INJECTED;
+    bio->bi_end_io(bio);
+    return false;
+  }
+
+  leafReads++;
+  if (blocks == 1) {
+    singlePageReads++;
+  }
+
+  leafBlocksRead += blocks;
+  largestLeafRead = max(largestLeafRead, blocks);
+  return true;
+}
+
+/**
+ * Force a read-only rebuild while recording the leaf page reads, and check
+ * that every leaf page was counted.
+ **/
+static void rebuildAndCheckProgress(void)
+{
+  leafReads       = 0;
+  leafBlocksRead  = 0;
+  largestLeafRead = 0;
+  singlePageReads = 0;
+  forceRebuild();
+  setBIOSubmitHook(recordLeafRead);
+  startVDO(VDO_FORCE_REBUILD);
+  clearBIOSubmitHook();
+
+  CU_ASSERT_EQUAL(atomic64_read(&vdo->stats.rebuild_pages_total), LEAF_PAGES);
+  CU_ASSERT_EQUAL(atomic64_read(&vdo->stats.rebuild_pages_done), LEAF_PAGES);
+  CU_ASSERT_TRUE(leafBlocksRead >= LEAF_PAGES);
+  verifyLeafPages();
+}
+
+/**
+ * Test that the leaf pages are read several at a time.
+ **/
+static void testStreamingRebuild(void)
+{
+  writeLeafPages();
+  failRunRead = false;
+  rebuildAndCheckProgress();
+  CU_ASSERT_TRUE(largestLeafRead > 1);
+  CU_ASSERT_TRUE(leafReads < LEAF_PAGES);
+}
+
+/**
+ * Test that the pages of a run which can't be read at once are read singly.
+ **/
+static void testRunReadError(void)
+{
+  writeLeafPages();
+  failRunRead = true;
+  rebuildAndCheckProgress();
+  CU_ASSERT_FALSE(failRunRead);
+  CU_ASSERT_TRUE(singlePageReads > 1);
+}
+
+/**********************************************************************/
+static CU_TestInfo tests[] = {
+  { "stream leaf pages during rebuild",     testStreamingRebuild },
+  { "retry a failed run one page at a time", testRunReadError    },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Streaming read-only rebuild (StreamingRebuild_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = initializeStreamingRebuildT1,
+  .cleaner                  = tearDownVDOTest,
+  .tests                    = tests
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
@@ -6,6 +6,7 @@
  * $Id$
  */
 
+#include <linux/numa.h>
 #include <stddef.h>
 
 #include "albtest.h"
@@ -168,10 +169,41 @@ static void testBasicThreadConfig(void)
   uninitialize_thread_config(&config);
 }
 
+/**********************************************************************/
+static void testLogicalZoneNodes(void)
+{
+  enum {
+    LOGICAL_ZONES = 3,
+  };
+  struct thread_count_config counts = {
+    .logical_zones = LOGICAL_ZONES,
+    .physical_zones = 1,
+    .hash_zones = 1,
+    .bio_threads = 1,
+  };
+  struct thread_config config;
+  memset(&config, 0, sizeof(struct thread_config));
+  VDO_ASSERT_SUCCESS(initialize_thread_config(counts, &config));
+  for (zone_count_t zone = 0; zone < LOGICAL_ZONES; zone++) {
+    CU_ASSERT_EQUAL(NUMA_NO_NODE, config.logical_nodes[zone]);
+  }
+  uninitialize_thread_config(&config);
+
+  // The unit test environment has a single node for all zones to share.
+  counts.numa_nodes = 1;
+  memset(&config, 0, sizeof(struct thread_config));
+  VDO_ASSERT_SUCCESS(initialize_thread_config(counts, &config));
+  for (zone_count_t zone = 0; zone < LOGICAL_ZONES; zone++) {
+    CU_ASSERT_EQUAL(0, config.logical_nodes[zone]);
+  }
+  uninitialize_thread_config(&config);
+}
+
 /**********************************************************************/
 static CU_TestInfo tests[] = {
   { "test the single-thread configuration",       testOneThreadConfig   },
   { "test a basic multiple-thread configuration", testBasicThreadConfig },
+  { "test the NUMA nodes of logical zones",       testLogicalZoneNodes  },
   CU_TEST_INFO_NULL
 };
 
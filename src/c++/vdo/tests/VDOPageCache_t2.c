@@ -0,0 +1,257 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "albtest.h"
+
+#include "block-map.h"
+#include "completion.h"
+#include "slab-depot.h"
+#include "status-codes.h"
+
+#include "asyncLayer.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  CACHE_SIZE      = 32,
+  // The trace replayed by testScanAndRandomMix()
+  HOT_PAGES       = 16,
+  RANDOM_ACCESSES = 2048,
+  SCAN_START      = 64,
+  SCAN_PAGES      = 128,
+  SCAN_REPEAT     = 4,
+  ROUNDS          = 6,
+};
+
+typedef struct {
+  struct vdo_completion      completion;
+  struct vdo_page_completion pageCompletion;
+  page_number_t              pageNumber;
+} AccessCompletion;
+
+typedef struct {
+  u64 reads;
+  u64 hits;
+  u64 ghostHits;
+} CacheCounts;
+
+static struct block_map_zone   *zone;
+static struct vdo_page_cache   *cache;
+static physical_block_number_t  firstPBN;
+
+/**
+ * Initialize a VDO with a small block map cache.
+ *
+ * @param use2Q  Whether the cache should use the 2Q policy
+ **/
+static void initialize(bool use2Q)
+{
+  TestParameters parameters = {
+    .logicalBlocks        = 4096,
+    .physicalBlocks       = 1024,
+    .journalBlocks        = 8,
+    .slabSize             = 64,
+    .cacheSize            = CACHE_SIZE,
+    .noIndexRegion        = true,
+    .disableDeduplication = true,
+    .blockMapCache2Q      = use2Q,
+  };
+
+  initializeVDOTest(&parameters);
+  zone = &vdo->block_map->zones[0];
+  cache = &zone->page_cache;
+  firstPBN = vdo->depot->slabs[0]->start;
+}
+
+/**
+ * Release a page as soon as it has been fetched.
+ *
+ * Implements vdo_action_fn
+ **/
+static void releasePage(struct vdo_completion *completion)
+{
+  AccessCompletion *access = completion->parent;
+  int               result = completion->result;
+
+  vdo_release_page_completion(completion);
+  vdo_fail_completion(&access->completion, result);
+}
+
+/**
+ * Fetch a page for reading.
+ *
+ * Implements vdo_action_fn
+ **/
+static void fetchPage(struct vdo_completion *completion)
+{
+  AccessCompletion *access = container_of(completion,
+                                          AccessCompletion,
+                                          completion);
+  vdo_get_page(&access->pageCompletion,
+               zone,
+               firstPBN + access->pageNumber,
+               false,
+               access,
+               releasePage,
+               releasePage,
+               false);
+}
+
+/**
+ * Read a page through the cache, then release it.
+ *
+ * @param pageNumber  The page to read
+ **/
+static void readPage(page_number_t pageNumber)
+{
+  AccessCompletion access = {
+    .pageNumber = pageNumber,
+  };
+
+  vdo_initialize_completion(&access.completion, vdo, VDO_TEST_COMPLETION);
+  VDO_ASSERT_SUCCESS(performAction(fetchPage, &access.completion));
+}
+
+/**
+ * Get the counters of interest from the cache.
+ **/
+static CacheCounts getCacheCounts(void)
+{
+  return (CacheCounts) {
+    .reads     = READ_ONCE(cache->stats.read_count),
+    .hits      = READ_ONCE(cache->stats.found_in_cache),
+    .ghostHits = READ_ONCE(cache->stats.ghost_hits),
+  };
+}
+
+/**
+ * Read each page of a range in turn.
+ *
+ * @param start   The first page to read
+ * @param count   The number of pages to read
+ * @param repeat  The number of times to read each page before moving on
+ **/
+static void scanPages(page_number_t start, page_count_t count, unsigned int repeat)
+{
+  for (page_number_t page = start; page < start + count; page++) {
+    for (unsigned int i = 0; i < repeat; i++) {
+      readPage(page);
+    }
+  }
+}
+
+/**
+ * Test that pages which are loaded again soon after being evicted from
+ * probation survive a subsequent scan under the 2Q policy, and don't under
+ * LRU.
+ **/
+static void testGhostHitSurvivesScan(void)
+{
+  for (int use2Q = 0; use2Q <= 1; use2Q++) {
+    initialize(use2Q);
+
+    // Fill the cache, then push pages 0 and 1 out of it.
+    scanPages(0, 2, 1);
+    scanPages(SCAN_START, CACHE_SIZE, 1);
+    CacheCounts before = getCacheCounts();
+    scanPages(0, 2, 1);
+    CacheCounts after = getCacheCounts();
+    CU_ASSERT_EQUAL(after.hits, before.hits);
+    CU_ASSERT_EQUAL(after.ghostHits, (use2Q ? 2 : 0));
+
+    // A long scan, repeating each page, should not evict them under 2Q.
+    scanPages(SCAN_START + CACHE_SIZE, SCAN_PAGES, SCAN_REPEAT);
+    before = getCacheCounts();
+    scanPages(0, 2, 1);
+    after = getCacheCounts();
+    CU_ASSERT_EQUAL(after.hits - before.hits, (use2Q ? 2 : 0));
+
+    tearDownVDOTest();
+  }
+
+  // The suite cleaner will tear down again.
+  initialize(false);
+}
+
+/**
+ * Replay a trace of random reads of a small hot set interleaved with scans
+ * of a larger range, and return the number of reads of the hot set after
+ * the first round which missed the cache.
+ **/
+static u64 replayScanAndRandomMix(bool use2Q)
+{
+  initialize(use2Q);
+  srandom(42);
+
+  CacheCounts total = getCacheCounts();
+  u64 hotReads = 0;
+  u64 hotHits = 0;
+  for (unsigned int round = 0; round < ROUNDS; round++) {
+    CacheCounts before = getCacheCounts();
+    for (unsigned int i = 0; i < RANDOM_ACCESSES; i++) {
+      readPage(random() % HOT_PAGES);
+    }
+
+    CacheCounts after = getCacheCounts();
+    if (round > 0) {
+      hotReads += after.reads - before.reads;
+      hotHits += after.hits - before.hits;
+    }
+
+    scanPages(SCAN_START, SCAN_PAGES, SCAN_REPEAT);
+  }
+
+  CacheCounts after = getCacheCounts();
+  printf("  %s: %.1f%% hits, %.2f%% hot set hits, %llu ghost hits\n",
+         (use2Q ? "2q " : "lru"),
+         (100.0 * (after.hits - total.hits)) / (after.reads - total.reads),
+         (100.0 * hotHits) / hotReads,
+         (unsigned long long) (after.ghostHits - total.ghostHits));
+  tearDownVDOTest();
+  return hotReads - hotHits;
+}
+
+/**
+ * Test that 2Q keeps a hot set which fits in the cache across scans which
+ * evict it under LRU.
+ **/
+static void testScanAndRandomMix(void)
+{
+  printf("\n");
+  u64 lruMisses = replayScanAndRandomMix(false);
+  u64 twoQMisses = replayScanAndRandomMix(true);
+  CU_ASSERT(lruMisses > 0);
+  CU_ASSERT_EQUAL(twoQMisses, 0);
+
+  // The suite cleaner will tear down again.
+  initialize(false);
+}
+
+/**********************************************************************/
+
+static CU_TestInfo vdoPageCacheTests[] = {
+  { "ghost hit survives scan", testGhostHitSurvivesScan },
+  { "scan and random mix",     testScanAndRandomMix     },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo vdoPageCacheSuite = {
+  .name                     = "VDO Page Cache 2Q tests (VDOPageCache_t2)",
+  .initializerWithArguments = NULL,
+  .initializer              = NULL,
+  .cleaner                  = tearDownVDOTest,
+  .tests                    = vdoPageCacheTests
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &vdoPageCacheSuite;
+}
@@ -188,6 +188,18 @@ static void mismatchChecker(physical_block_number_t pbn,
     return;
   }
 
+  if (pbn == getSuperBlockLocation()) {
+    /*
+     * The super block itself occupies only the first sector. The rest of the
+     * block holds the list of cached block map pages, which depends on what
+     * the VDO did before it was saved.
+     */
+    UDS_ASSERT_EQUAL_BYTES(expectedBlock, actualBlock, VDO_SECTOR_SIZE);
+    static struct hot_page_list list;
+    VDO_ASSERT_SUCCESS(vdo_decode_hot_page_list((u8 *) actualBlock, &list));
+    return;
+  }
+
   // At this time, there should be no other mismatches */
   CU_FAIL("Unexpected mismatch at pbn %" PRIu64, pbn);
 }
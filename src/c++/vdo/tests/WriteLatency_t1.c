@@ -0,0 +1,123 @@
+/*
+ * %COPYRIGHT%
+ *
+ * %LICENSE%
+ *
+ * $Id$
+ */
+
+#include "albtest.h"
+
+#include "statistics.h"
+#include "vdo.h"
+
+#include "ioRequest.h"
+#include "vdoAsserts.h"
+#include "vdoTestBase.h"
+
+enum {
+  BLOCK_COUNT = 16,
+};
+
+/**
+ * Get the total of the buckets in a stage latency histogram.
+ **/
+static u64 sumBuckets(const struct stage_latency_statistics *stage)
+{
+  return (stage->under_10us + stage->under_100us + stage->under_1ms
+          + stage->under_10ms + stage->under_100ms + stage->under_1s
+          + stage->over_1s);
+}
+
+/**
+ * Check that a stage latency histogram is self-consistent, and return its
+ * sample count.
+ **/
+static u64 checkStage(const struct stage_latency_statistics *stage)
+{
+  CU_ASSERT_EQUAL(stage->count, sumBuckets(stage));
+  return stage->count;
+}
+
+/**
+ * Clear the stage latency histograms.
+ **/
+static void resetStageLatencies(void)
+{
+  memset(vdo->stats.write_stages, 0, sizeof(vdo->stats.write_stages));
+}
+
+/**
+ * Test that each stage of the write path is timed once per write of new data.
+ **/
+static void testNewDataStages(void)
+{
+  initializeDefaultVDOTest();
+
+  struct vdo_statistics stats;
+  vdo_fetch_statistics(vdo, &stats);
+  CU_ASSERT_EQUAL(0, checkStage(&stats.write_latency.launch));
+  CU_ASSERT_EQUAL(0, checkStage(&stats.write_latency.allocation));
+
+  // Allocate the block map tree so that the only allocations are for data.
+  populateBlockMapTree();
+  resetStageLatencies();
+
+  writeData(0, 1, BLOCK_COUNT, VDO_SUCCESS);
+  vdo_fetch_statistics(vdo, &stats);
+
+  struct write_latency_statistics *latency = &stats.write_latency;
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->launch));
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->hash));
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->hash_lock));
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->dedupe_query));
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->allocation));
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->data_write));
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->journal));
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->block_map));
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->acknowledge));
+}
+
+/**
+ * Test that reads are not timed, and that zero blocks skip the stages which
+ * handle data.
+ **/
+static void testReadsAndZeroBlocks(void)
+{
+  initializeDefaultVDOTest();
+  populateBlockMapTree();
+  resetStageLatencies();
+  zeroData(0, BLOCK_COUNT, VDO_SUCCESS);
+  verifyZeros(0, BLOCK_COUNT);
+
+  struct vdo_statistics stats;
+  vdo_fetch_statistics(vdo, &stats);
+
+  struct write_latency_statistics *latency = &stats.write_latency;
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->launch));
+  CU_ASSERT_EQUAL(0, checkStage(&latency->hash));
+  CU_ASSERT_EQUAL(0, checkStage(&latency->allocation));
+  CU_ASSERT_EQUAL(0, checkStage(&latency->data_write));
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->journal));
+  CU_ASSERT_EQUAL(BLOCK_COUNT, checkStage(&latency->block_map));
+}
+
+/**********************************************************************/
+static CU_TestInfo tests[] = {
+  { "new data stages",         testNewDataStages      },
+  { "reads and zero blocks",   testReadsAndZeroBlocks },
+  CU_TEST_INFO_NULL,
+};
+
+static CU_SuiteInfo suite = {
+  .name                     = "Write path stage latency (WriteLatency_t1)",
+  .initializerWithArguments = NULL,
+  .initializer              = NULL,
+  .cleaner                  = tearDownVDOTest,
+  .tests                    = tests,
+};
+
+CU_SuiteInfo *initializeModule(void)
+{
+  return &suite;
+}
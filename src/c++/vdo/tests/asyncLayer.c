@@ -291,17 +291,18 @@ static int processBIO(struct bio *bio)
   physical_block_number_t pbn = pbn_from_vio_bio(bio);
   assertNotInIndexRegion(pbn);
 
+  // A metadata vio may be submitted with less than its full size.
   int result;
-  struct vio *vio = bio->bi_private;
+  block_count_t blocks = DIV_ROUND_UP(bio->bi_iter.bi_size, VDO_BLOCK_SIZE);
   if (bio_data_dir(bio) == WRITE) {
     result = ramLayer->writer(ramLayer,
                               pbn,
-                              vio->block_count,
+                              blocks,
                               (char *) bio->bi_io_vec->bv_page);
   } else {
     result = ramLayer->reader(ramLayer,
                               pbn,
-                              vio->block_count,
+                              blocks,
                               (char *) bio->bi_io_vec->bv_page);
   }
 
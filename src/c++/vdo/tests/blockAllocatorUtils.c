@@ -8,6 +8,7 @@
 
 #include "blockAllocatorUtils.h"
 
+#include <linux/bitops.h>
 #include <linux/list.h>
 
 #include "slab-depot.h"
@@ -155,6 +156,9 @@ void resetReferenceCounts(struct vdo_slab *slab)
   for (i = 0; i < slab->reference_block_count; i++)
     slab->reference_blocks[i].allocated_count = 0;
 
+  memset(slab->full_blocks, 0,
+         BITS_TO_LONGS(slab->reference_block_count) * sizeof(unsigned long));
+
   vdo_waitq_notify_all_waiters(&slab->dirty_blocks, clearDirtyReferenceBlocks, NULL);
 }
 
@@ -30,6 +30,7 @@ static block_count_t                 logicalBlockCount;
 static MappingExpectation           *expectedMappings;
 static PopulateBlockMapConfigurator *populateConfigurator;
 static struct zoned_pbn              lookupResult;
+static bool                          cacheBusy;
 
 /**********************************************************************/
 void initializeBlockMapUtils(block_count_t logicalBlocks)
@@ -263,3 +264,89 @@ void setBlockMappingError(logical_block_number_t lbn, int error)
 {
   expectedMappings[lbn].result = error;
 }
+
+/**********************************************************************/
+TestParameters getBlockMapCacheParameters(page_count_t leafPages,
+                                          page_count_t cacheSize)
+{
+  return (TestParameters) {
+    .logicalBlocks         = leafPages * VDO_BLOCK_MAP_ENTRIES_PER_PAGE,
+    .physicalBlocks        = 4096,
+    .slabSize              = 1024,
+    .journalBlocks         = 16,
+    .cacheSize             = cacheSize,
+    .noIndexRegion         = true,
+    .disableDeduplication  = true,
+    .disableBlockMapWarmup = true,
+  };
+}
+
+/**********************************************************************/
+void initializePopulatedBlockMap(const TestParameters *parameters,
+                                 bool                  restart)
+{
+  initializeVDOTest(parameters);
+  populateBlockMapTree();
+  if (restart) {
+    restartVDO(false);
+  }
+}
+
+/**
+ * Check whether the block map zone on the current thread is warming up or
+ * reading pages.
+ *
+ * Implements vdo_action_fn.
+ **/
+static void checkZoneIdle(struct vdo_completion *completion)
+{
+  thread_id_t threadID = vdo_get_callback_thread_id();
+  for (zone_count_t z = 0; z < vdo->block_map->zone_count; z++) {
+    struct block_map_zone *zone = &vdo->block_map->zones[z];
+    if ((zone->thread_id == threadID)
+        && (zone->warming_up || (zone->page_cache.outstanding_reads > 0))) {
+      cacheBusy = true;
+    }
+  }
+
+  vdo_finish_completion(completion);
+}
+
+/**********************************************************************/
+void waitForBlockMapCacheIdle(void)
+{
+  do {
+    cacheBusy = false;
+    for (zone_count_t z = 0; z < vdo->block_map->zone_count; z++) {
+      performSuccessfulActionOnThread(checkZoneIdle,
+                                      vdo->block_map->zones[z].thread_id);
+    }
+  } while (cacheBusy);
+}
+
+/**********************************************************************/
+void readLeafPages(page_number_t start, page_count_t count)
+{
+  for (page_number_t page = start; page < start + count; page++) {
+    verifyZeros(page * VDO_BLOCK_MAP_ENTRIES_PER_PAGE, 1);
+  }
+}
+
+/**********************************************************************/
+void writeLeafPages(page_number_t start, page_count_t count,
+                    page_count_t step)
+{
+  for (page_number_t page = start; page < start + count; page += step) {
+    writeData(page * VDO_BLOCK_MAP_ENTRIES_PER_PAGE, page + 1, 1,
+              VDO_SUCCESS);
+  }
+}
+
+/**********************************************************************/
+void verifyLeafPages(page_number_t start, page_count_t count,
+                     page_count_t step)
+{
+  for (page_number_t page = start; page < start + count; page += step) {
+    verifyData(page * VDO_BLOCK_MAP_ENTRIES_PER_PAGE, page + 1, 1);
+  }
+}
@@ -11,6 +11,8 @@
 
 #include "types.h"
 
+#include "testParameters.h"
+
 typedef void PopulateBlockMapConfigurator(struct data_vio *dataVIO);
 
 /**
@@ -83,4 +85,65 @@ void setBlockMapping(logical_block_number_t   lbn,
  **/
 void setBlockMappingError(logical_block_number_t lbn, int error);
 
+/**
+ * Get the parameters for a test of the block map page cache: a VDO with one
+ * logical block for each entry of a number of leaf pages, a cache of a given
+ * size which is not warmed up on load, and no index or deduplication.
+ *
+ * @param leafPages  The number of block map leaf pages
+ * @param cacheSize  The number of pages in the block map cache
+ *
+ * @return The test parameters, which the caller may adjust
+ **/
+TestParameters getBlockMapCacheParameters(page_count_t leafPages,
+                                          page_count_t cacheSize)
+  __attribute__((warn_unused_result));
+
+/**
+ * Initialize a VDO and allocate its whole block map tree, so that most leaf
+ * pages have consecutive PBNs.
+ *
+ * @param parameters  The test parameters
+ * @param restart     Whether to restart the VDO afterwards, so that neither
+ *                    the tree nor the cache is loaded
+ **/
+void initializePopulatedBlockMap(const TestParameters *parameters,
+                                 bool                  restart);
+
+/**
+ * Wait until no block map zone is warming up its cache or has any page reads
+ * outstanding, so that the cache statistics are stable.
+ **/
+void waitForBlockMapCacheIdle(void);
+
+/**
+ * Read the first block mapped by each leaf page in a range, in order,
+ * checking that it holds zeros.
+ *
+ * @param start  The first leaf page to read
+ * @param count  The number of leaf pages to read
+ **/
+void readLeafPages(page_number_t start, page_count_t count);
+
+/**
+ * Write one block mapped by each leaf page in a range. Each page gets
+ * different data.
+ *
+ * @param start  The first leaf page to write
+ * @param count  The number of leaf pages in the range
+ * @param step   The distance between leaf pages to write
+ **/
+void writeLeafPages(page_number_t start, page_count_t count,
+                    page_count_t step);
+
+/**
+ * Verify the blocks written by writeLeafPages().
+ *
+ * @param start  The first leaf page to verify
+ * @param count  The number of leaf pages in the range
+ * @param step   The distance between leaf pages to verify
+ **/
+void verifyLeafPages(page_number_t start, page_count_t count,
+                     page_count_t step);
+
 #endif // BLOCK_MAP_UTILS_H
@@ -9,6 +9,7 @@
 #include "mutexUtils.h"
 
 #include <linux/delay.h>
+#include <linux/kthread.h>
 #include <linux/sched.h>
 #include <linux/wait.h>
 
@@ -35,6 +36,12 @@ typedef struct {
 struct task_struct {
   pthread_t id;
   int state;
+  // The remaining fields are only used by threads made with kthread_create_on_node()
+  struct thread *thread;
+  int (*threadfn)(void *data);
+  void *data;
+  bool shouldStop;
+  int result;
 };
 
 static struct mutex mutex = {
@@ -487,6 +494,12 @@ void init_waitqueue_head(struct wait_queue_head *wq_head)
 
 /**********************************************************************/
 void io_schedule(void)
+{
+  schedule();
+}
+
+/**********************************************************************/
+void schedule(void)
 {
   struct task_struct *task = getCurrentTaskStruct();
   lockMutex();
@@ -508,7 +521,7 @@ void io_schedule(void)
 
 /**********************************************************************/
 void __wake_up(struct wait_queue_head *wq_head,
-               unsigned int mode __attribute__((unused)),
+               unsigned int mode,
                int nr,
                void *key __attribute__((unused)))
 {
@@ -518,7 +531,7 @@ void __wake_up(struct wait_queue_head *wq_head,
     struct task_struct *task = container_of(entry,
                                             struct wait_queue_entry,
                                             entry)->private;
-    if (task->state == TASK_UNINTERRUPTIBLE) {
+    if ((task->state & mode) != 0) {
       task->state = TASK_PARKED;
       if (--nr == 0) {
         break;
@@ -530,6 +543,22 @@ void __wake_up(struct wait_queue_head *wq_head,
   broadcast();
 }
 
+/**
+ * Exclusive and non-exclusive waiters are not distinguished, since a wakeup
+ * here always names how many waiters to wake.
+ **/
+void prepare_to_wait(struct wait_queue_head *wq_head,
+		     struct wait_queue_entry *wq_entry,
+		     int state)
+{
+  mutex_lock(&wq_head->lock);
+  if (list_empty(&wq_entry->entry)) {
+    list_add(&wq_entry->entry, &wq_head->head);
+  }
+  set_current_state(state);
+  mutex_unlock(&wq_head->lock);
+}
+
 /**********************************************************************/
 void prepare_to_wait_exclusive(struct wait_queue_head *wq_head,
 			       struct wait_queue_entry *wq_entry,
@@ -544,6 +573,7 @@ void prepare_to_wait_exclusive(struct wait_queue_head *wq_head,
 /**********************************************************************/
 void finish_wait(struct wait_queue_head *wq_head, struct wait_queue_entry *wq_entry)
 {
+  set_current_state(TASK_RUNNING);
   mutex_lock(&wq_head->lock);
   list_del_init(&wq_entry->entry);
   mutex_unlock(&wq_head->lock);
@@ -575,3 +605,121 @@ void set_current_state(int state_value)
 {
   runLocked(setCurrentStateLocked, &state_value);
 }
+
+/**
+ * Wake a task if it is sleeping or about to sleep.
+ *
+ * Implements LockedMethod.
+ **/
+static bool wakeTaskLocked(void *context)
+{
+  struct task_struct *task = context;
+  if (task->state == TASK_RUNNING) {
+    return false;
+  }
+
+  task->state = TASK_PARKED;
+  return true;
+}
+
+/**********************************************************************/
+int wake_up_process(struct task_struct *task)
+{
+  return runLocked(wakeTaskLocked, task);
+}
+
+/**********************************************************************/
+char task_state_to_char(struct task_struct *task)
+{
+  switch (READ_ONCE(task->state)) {
+  case TASK_RUNNING:
+    return 'R';
+
+  case TASK_INTERRUPTIBLE:
+    return 'S';
+
+  case TASK_UNINTERRUPTIBLE:
+    return 'D';
+
+  default:
+    return '?';
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Implementation of kernel threads from linux/kthread.h                 //
+///////////////////////////////////////////////////////////////////////////
+
+/**
+ * The body of a thread made by kthread_create_on_node(). Like a kernel
+ * thread, it does not run its function until it has been woken.
+ **/
+static void kthreadRunner(void *arg)
+{
+  struct task_struct *task = arg;
+  VDO_ASSERT_SUCCESS(pthread_setspecific(taskKey, task));
+  schedule();
+  task->result = task->threadfn(task->data);
+  // The task is freed by kthread_stop(), not by the thread key destructor.
+  VDO_ASSERT_SUCCESS(pthread_setspecific(taskKey, NULL));
+}
+
+/**********************************************************************/
+struct task_struct *kthread_create_on_node(int (*threadfn)(void *data),
+                                           void *data,
+                                           int node __attribute__((unused)),
+                                           const char namefmt[], ...)
+{
+  char name[TASK_COMM_LEN];
+  va_list args;
+  va_start(args, namefmt);
+  vsnprintf(name, sizeof(name), namefmt, args);
+  va_end(args);
+
+  struct task_struct *task;
+  int result = vdo_allocate(1, struct task_struct, __func__, &task);
+  if (result != VDO_SUCCESS) {
+    return ERR_PTR(-ENOMEM);
+  }
+
+  task->state    = TASK_UNINTERRUPTIBLE;
+  task->threadfn = threadfn;
+  task->data     = data;
+  result = vdo_create_thread(kthreadRunner, task, name, &task->thread);
+  if (result != VDO_SUCCESS) {
+    vdo_free(task);
+    return ERR_PTR(-ENOMEM);
+  }
+
+  return task;
+}
+
+/**********************************************************************/
+bool kthread_should_stop(void)
+{
+  return READ_ONCE(getCurrentTaskStruct()->shouldStop);
+}
+
+/**********************************************************************/
+int kthread_stop(struct task_struct *task)
+{
+  WRITE_ONCE(task->shouldStop, true);
+  wake_up_process(task);
+  vdo_join_threads(task->thread);
+
+  int result = task->result;
+  vdo_free(task);
+  return result;
+}
+
+/**********************************************************************/
+int (*kthread_func(struct task_struct *task))(void *data)
+{
+  return ((task->thread == NULL) ? NULL : task->threadfn);
+}
+
+/**********************************************************************/
+void *kthread_data(struct task_struct *task)
+{
+  return task->data;
+}
@@ -36,6 +36,8 @@ void initializeRecoveryModeTest(const TestParameters *testParameters)
   mutex_init(&mutex);
   uds_init_cond(&condition);
   VDO_ASSERT_SUCCESS(vdo_int_map_create(8, &latchedVIOs));
+  // Latching a slab should stop each scrubber, as these tests expect.
+  vdo_set_slab_scrubbing_depth(1);
   initializeVDOTest(testParameters);
 }
 
@@ -43,6 +45,7 @@ void initializeRecoveryModeTest(const TestParameters *testParameters)
 void tearDownRecoveryModeTest(void)
 {
   tearDownVDOTest();
+  vdo_set_slab_scrubbing_depth(SLAB_SCRUBBER_DEPTH);
   vdo_int_map_free(vdo_forget(latchedVIOs));
 #ifndef __KERNEL__
   uds_destroy_cond(&condition);
@@ -202,6 +205,38 @@ slab_count_t waitForAnySlabToLatch(slab_count_t slabs)
   return latchedSlab;
 }
 
+/**********************************************************************/
+static slab_count_t countLatchedSlabsLocked(slab_count_t slabs)
+{
+  slab_count_t latched = 0;
+  for (slab_count_t slab = 0; slab < slabs; slab++) {
+    if (isSlabLatched(slab, NULL)) {
+      latched++;
+    }
+  }
+
+  return latched;
+}
+
+/**********************************************************************/
+void waitForSlabsToLatch(slab_count_t count, slab_count_t slabs)
+{
+  mutex_lock(&mutex);
+  while (countLatchedSlabsLocked(slabs) < count) {
+    uds_wait_cond(&condition, &mutex);
+  }
+  mutex_unlock(&mutex);
+}
+
+/**********************************************************************/
+slab_count_t countLatchedSlabs(slab_count_t slabs)
+{
+  mutex_lock(&mutex);
+  slab_count_t latched = countLatchedSlabsLocked(slabs);
+  mutex_unlock(&mutex);
+  return latched;
+}
+
 /**********************************************************************/
 void releaseSlabLatch(slab_count_t slabNumber)
 {
@@ -68,6 +68,23 @@ void waitForSlabLatch(slab_count_t slabNumber);
  **/
 slab_count_t waitForAnySlabToLatch(slab_count_t slabs);
 
+/**
+ * Block until at least a given number of slabs have latched.
+ *
+ * @param count  the number of latched slabs to wait for
+ * @param slabs  the total number of slabs
+ **/
+void waitForSlabsToLatch(slab_count_t count, slab_count_t slabs);
+
+/**
+ * Count the slabs which are currently latched.
+ *
+ * @param slabs  the total number of slabs
+ *
+ * @return The number of latched slabs
+ **/
+slab_count_t countLatchedSlabs(slab_count_t slabs);
+
 /**
  * Release the latched reference count write.
  *
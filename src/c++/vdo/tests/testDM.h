@@ -9,6 +9,9 @@
 #ifndef TEST_DM_H
 #define TEST_DM_H
 
+/** The path which names the fake block map cache device. */
+#define BLOCK_MAP_CACHE_DEVICE_PATH "/dev/fake-block-map-cache"
+
 /**
  * Initialize the fake DM subsystem. This function should only be called from
  * initializeVDOTestBase().
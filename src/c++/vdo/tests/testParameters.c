@@ -40,9 +40,11 @@ static const TestParameters DEFAULT_PARAMETERS = {
   .logicalThreadCount   = 0,
   .physicalThreadCount  = 0,
   .hashZoneThreadCount  = 0,
+  .cpuThreadCount       = 1,
   .synchronousStorage   = false,
   .dataFormatter        = fillWithOffset,
   .compressionLevel     = 1,
+  .compressionCodec     = VDO_CODEC_LZ4,
   .enableCompression    = false,
   .disableDeduplication = false,
   .noIndexRegion        = false,
@@ -118,6 +120,10 @@ static TestParameters applyDefaults(const TestParameters *parameters)
     applied.hashZoneThreadCount = parameters->hashZoneThreadCount;
   }
 
+  if (parameters->cpuThreadCount != 0) {
+    applied.cpuThreadCount = parameters->cpuThreadCount;
+  }
+
   if (parameters->dataFormatter != NULL) {
     applied.dataFormatter = parameters->dataFormatter;
   }
@@ -126,6 +132,58 @@ static TestParameters applyDefaults(const TestParameters *parameters)
     applied.compressionLevel = parameters->compressionLevel;
   }
 
+  if (parameters->compressionCodec != applied.compressionCodec) {
+    applied.compressionCodec = parameters->compressionCodec;
+  }
+
+  if (parameters->compressionFastReject) {
+    applied.compressionFastReject = true;
+  }
+
+  if (parameters->packerBucketed) {
+    applied.packerBucketed = true;
+  }
+
+  if (parameters->packerMaxAge > 0) {
+    applied.packerMaxAge = parameters->packerMaxAge;
+  }
+
+  if (parameters->blockMapCache2Q) {
+    applied.blockMapCache2Q = true;
+  }
+
+  if (parameters->blockMapReadahead > 0) {
+    applied.blockMapReadahead = parameters->blockMapReadahead;
+  }
+
+  if (parameters->disableBlockMapWarmup) {
+    applied.disableBlockMapWarmup = true;
+  }
+
+  if (parameters->blockMapCacheDeviceBlocks > 0) {
+    applied.blockMapCacheDeviceBlocks = parameters->blockMapCacheDeviceBlocks;
+  }
+
+  if (parameters->allocationLocality) {
+    applied.allocationLocality = true;
+  }
+
+  if (parameters->lazyRefCounts) {
+    applied.lazyRefCounts = true;
+  }
+
+  if (parameters->streamingRebuild) {
+    applied.streamingRebuild = true;
+  }
+
+  if (parameters->journalGroupCommit) {
+    applied.journalGroupCommit = true;
+  }
+
+  if (parameters->journalCommitDelay > 0) {
+    applied.journalCommitDelay = parameters->journalCommitDelay;
+  }
+
   if (parameters->enableCompression != applied.enableCompression) {
     applied.enableCompression = parameters->enableCompression;
   }
@@ -347,14 +405,27 @@ TestConfiguration makeTestConfiguration(const TestParameters *parameters)
         .bio_threads           = DEFAULT_VDO_BIO_SUBMIT_QUEUE_COUNT,
         .bio_rotation_interval = DEFAULT_VDO_BIO_SUBMIT_QUEUE_ROTATE_INTERVAL,
         .bio_ack_threads       = 1,
-        .cpu_threads           = 1,
+        .cpu_threads           = params.cpuThreadCount,
       },
       .max_discard_blocks = 1500,
       .parent_device_name = DEVICE_NAME,
       .logical_blocks     = params.logicalBlocks,
       .logical_block_size = VDO_BLOCK_SIZE,
       .physical_blocks    = params.physicalBlocks + indexBlocks,
+      .compression_codec  = params.compressionCodec,
       .compression_level  = params.compressionLevel,
+      .compression_fast_reject = params.compressionFastReject,
+      .packer_bucketed    = params.packerBucketed,
+      .packer_max_age     = params.packerMaxAge,
+      .block_map_cache_2q = params.blockMapCache2Q,
+      .block_map_readahead = params.blockMapReadahead,
+      .block_map_warmup   = !params.disableBlockMapWarmup,
+      .block_map_tier_blocks = params.blockMapCacheDeviceBlocks,
+      .allocation_locality = params.allocationLocality,
+      .lazy_ref_counts    = params.lazyRefCounts,
+      .streaming_rebuild  = params.streamingRebuild,
+      .journal_group_commit = params.journalGroupCommit,
+      .journal_commit_delay = params.journalCommitDelay,
       .compression        = params.enableCompression,
       .deduplication      = !params.disableDeduplication,
     },
@@ -54,6 +54,8 @@ typedef struct testParameters {
   thread_count_t            physicalThreadCount;
   /** The number of hash zone threads */
   thread_count_t            hashZoneThreadCount;
+  /** The number of cpu threads */
+  thread_count_t            cpuThreadCount;
   /** Whether the underlying storage is synchronous */
   bool                      synchronousStorage;
   /** A function to modify the config generated from these parameters */
@@ -66,6 +68,32 @@ typedef struct testParameters {
   bool                      enableCompression;
   /** The compression level to use if compression is enabled */
   int                       compressionLevel;
+  /** The codec to use if compression is enabled */
+  enum vdo_compression_codec compressionCodec;
+  /** Whether to skip compressing blocks which look incompressible */
+  bool                      compressionFastReject;
+  /** Whether the packer should use bucketed bin selection */
+  bool                      packerBucketed;
+  /** The maximum time in ms a fragment may wait in the packer (0 for none) */
+  unsigned int              packerMaxAge;
+  /** Whether the block map cache should use the 2Q replacement policy */
+  bool                      blockMapCache2Q;
+  /** The number of block map pages to read ahead of a sequential stream */
+  unsigned int              blockMapReadahead;
+  /** Whether to skip warming up the block map cache when the VDO is loaded */
+  bool                      disableBlockMapWarmup;
+  /** The size of the block map cache device in blocks (0 for none) */
+  block_count_t             blockMapCacheDeviceBlocks;
+  /** Whether to keep sequential writes physically contiguous */
+  bool                      allocationLocality;
+  /** Whether to load the reference counts of clean slabs after starting */
+  bool                      lazyRefCounts;
+  /** Whether a read-only rebuild should stream the block map leaves */
+  bool                      streamingRebuild;
+  /** Whether to write adjacent recovery journal blocks together */
+  bool                      journalGroupCommit;
+  /** The recovery journal commit delay in microseconds (0 for none) */
+  unsigned int              journalCommitDelay;
   /** Whether deduplication should be enabled */
   bool                      disableDeduplication;
   /** Whether physicalBlocks should include an index region */
@@ -20,6 +20,7 @@
 #include "admin-state.h"
 #include "block-map.h"
 #include "completionUtils.h"
+#include "compression.h"
 #include "constants.h"
 #include "encodings.h"
 #include "recovery-journal.h"
@@ -600,7 +601,8 @@ static int makeTableLine(TestConfiguration configuration, char **argv)
   addString(&argv[argc++], "bioRotationInterval");
   addUInt32(&argv[argc++], DEFAULT_VDO_BIO_SUBMIT_QUEUE_ROTATE_INTERVAL);
   addString(&argv[argc++], "cpu");
-  addUInt32(&argv[argc++], 1);
+  addUInt32(&argv[argc++],
+            configuration.deviceConfig.thread_counts.cpu_threads);
   if (configuration.deviceConfig.thread_counts.hash_zones > 0) {
     addString(&argv[argc++], "hash");
     addUInt32(&argv[argc++],
@@ -631,8 +633,70 @@ static int makeTableLine(TestConfiguration configuration, char **argv)
             (configuration.deviceConfig.compression ? "on" : "off"));
 
   addString(&argv[argc++], "compressionType");
-  addCompressionType(&argv[argc++], VDO_COMPRESS_LZ4,
-                     configuration.deviceConfig.compression_level);
+  struct device_config *config = &configuration.deviceConfig;
+  addCompressionType(&argv[argc++],
+                     vdo_get_compression_codec_name(config->compression_codec),
+                     config->compression_level);
+
+  if (config->compression_fast_reject) {
+    addString(&argv[argc++], "compressionFastReject");
+    addString(&argv[argc++], "on");
+  }
+
+  if (config->packer_bucketed) {
+    addString(&argv[argc++], "packerMode");
+    addString(&argv[argc++], "bucketed");
+  }
+
+  if (config->packer_max_age > 0) {
+    addString(&argv[argc++], "packerMaxAge");
+    addUInt32(&argv[argc++], config->packer_max_age);
+  }
+
+  if (config->block_map_cache_2q) {
+    addString(&argv[argc++], "blockMapCachePolicy");
+    addString(&argv[argc++], "2q");
+  }
+
+  if (config->block_map_readahead > 0) {
+    addString(&argv[argc++], "blockMapReadahead");
+    addUInt32(&argv[argc++], config->block_map_readahead);
+  }
+
+  if (!config->block_map_warmup) {
+    addString(&argv[argc++], "blockMapWarmup");
+    addString(&argv[argc++], "off");
+  }
+
+  if (config->block_map_tier_blocks > 0) {
+    addString(&argv[argc++], "blockMapCacheDevice");
+    addString(&argv[argc++], BLOCK_MAP_CACHE_DEVICE_PATH);
+  }
+
+  if (config->allocation_locality) {
+    addString(&argv[argc++], "allocationLocality");
+    addString(&argv[argc++], "on");
+  }
+
+  if (config->lazy_ref_counts) {
+    addString(&argv[argc++], "lazyRefCounts");
+    addString(&argv[argc++], "on");
+  }
+
+  if (config->streaming_rebuild) {
+    addString(&argv[argc++], "streamingRebuild");
+    addString(&argv[argc++], "on");
+  }
+
+  if (config->journal_group_commit) {
+    addString(&argv[argc++], "journalGroupCommit");
+    addString(&argv[argc++], "on");
+  }
+
+  if (config->journal_commit_delay > 0) {
+    addString(&argv[argc++], "journalCommitDelay");
+    addUInt32(&argv[argc++], config->journal_commit_delay);
+  }
   return argc;
 }
 
@@ -642,10 +706,13 @@ int loadTable(TestConfiguration configuration, struct dm_target *target)
   struct dm_dev *dm_dev;
   dm_get_device(NULL, NULL, 0, &dm_dev);
   dm_dev->bdev->size = configuration.config.physical_blocks * VDO_BLOCK_SIZE;
+  dm_get_device(NULL, BLOCK_MAP_CACHE_DEVICE_PATH, 0, &dm_dev);
+  dm_dev->bdev->size
+    = configuration.deviceConfig.block_map_tier_blocks * VDO_BLOCK_SIZE;
 
   target->len = configuration.config.logical_blocks * VDO_SECTORS_PER_BLOCK;
 
-  char *argv[32];
+  char *argv[64];
   int argc = makeTableLine(fixThreadCounts(configuration), argv);
   int result = vdoTargetType->ctr(target, argc, argv);
   while (argc-- > 0) {
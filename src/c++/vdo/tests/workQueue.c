@@ -152,6 +152,7 @@ int vdo_make_work_queue(const char *thread_name_prefix,
                         const char *name,
                         struct vdo_thread *owner,
                         const struct vdo_work_queue_type *type,
+                        int node __attribute__((unused)),
                         unsigned int thread_count  __attribute__((unused)),
                         void *privates[],
                         struct vdo_work_queue **queue_ptr)
@@ -330,3 +331,12 @@ void vdo_dump_work_queue(struct vdo_work_queue *queue)
                queue->name,
                (READ_ONCE(queue->running) ? "running" : "idle"));
 }
+
+/**********************************************************************/
+void vdo_add_work_queue_statistics(struct vdo_work_queue *queue
+                                   __attribute__((unused)),
+                                   struct vdo_work_queue_statistics *stats
+                                   __attribute__((unused)))
+{
+  // The test work queues don't keep statistics.
+}
@@ -128,6 +128,76 @@ static int read_block_allocator_statistics(char **buf,
 	if (result != VDO_SUCCESS) {
 		return result;
 	}
+	/** The number of sequential allocations which were physically contiguous */
+	result = skip_string(buf, "contiguousAllocations : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->contiguous_allocations);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** The number of sequential allocations which were not physically contiguous */
+	result = skip_string(buf, "fragmentedAllocations : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->fragmented_allocations);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** The number of slabs which have yet to be scrubbed since loading */
+	result = skip_string(buf, "slabsToScrub : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->slabs_to_scrub);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** The number of slabs which have been scrubbed since loading */
+	result = skip_string(buf, "slabsScrubbed : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->slabs_scrubbed);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** The estimated number of seconds until all slabs are scrubbed */
+	result = skip_string(buf, "scrubSecondsRemaining : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->scrub_seconds_remaining);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** The number of clean slabs whose reference counts were deferred when loading */
+	result = skip_string(buf, "lazySlabs : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->lazy_slabs);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** The number of deferred slabs whose reference counts have since been loaded */
+	result = skip_string(buf, "lazySlabsLoaded : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->lazy_slabs_loaded);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
 	return VDO_SUCCESS;
 }
 
@@ -169,6 +239,162 @@ static int read_commit_statistics(char **buf,
 	return VDO_SUCCESS;
 }
 
+static int read_stage_latency_statistics(char **buf,
+					 struct stage_latency_statistics *stats)
+{
+	int result = 0;
+
+	/** Number of times a write has completed this stage */
+	result = skip_string(buf, "count : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->count);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Total time spent in this stage, in microseconds */
+	result = skip_string(buf, "totalMicroseconds : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->total_microseconds);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of times the stage took less than 10 microseconds */
+	result = skip_string(buf, "under10us : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->under_10us);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of times the stage took 10 to 100 microseconds */
+	result = skip_string(buf, "under100us : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->under_100us);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of times the stage took 100 microseconds to 1 millisecond */
+	result = skip_string(buf, "under1ms : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->under_1ms);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of times the stage took 1 to 10 milliseconds */
+	result = skip_string(buf, "under10ms : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->under_10ms);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of times the stage took 10 to 100 milliseconds */
+	result = skip_string(buf, "under100ms : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->under_100ms);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of times the stage took 100 milliseconds to 1 second */
+	result = skip_string(buf, "under1s : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->under_1s);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of times the stage took 1 second or more */
+	result = skip_string(buf, "over1s : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->over_1s);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	return VDO_SUCCESS;
+}
+
+static int read_commit_size_statistics(char **buf,
+				       struct commit_size_statistics *stats)
+{
+	int result = 0;
+
+	/** Number of commits of a single entry */
+	result = skip_string(buf, "oneEntry : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->one_entry);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of commits of 2 to 15 entries */
+	result = skip_string(buf, "under16 : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->under_16);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of commits of 16 to 63 entries */
+	result = skip_string(buf, "under64 : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->under_64);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of commits of 64 entries up to a full block */
+	result = skip_string(buf, "oneBlock : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->one_block);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of commits of more than a full block of entries */
+	result = skip_string(buf, "multipleBlocks : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->multiple_blocks);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	return VDO_SUCCESS;
+}
+
 static int read_recovery_journal_statistics(char **buf,
 					    struct recovery_journal_statistics *stats)
 {
@@ -214,6 +440,46 @@ static int read_recovery_journal_statistics(char **buf,
 	if (result != VDO_SUCCESS) {
 		return result;
 	}
+	/** Number of commits which wrote several adjacent blocks at once */
+	result = skip_string(buf, "multiBlockWrites : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->multi_block_writes);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of commits which waited for more entries */
+	result = skip_string(buf, "delayedCommits : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->delayed_commits);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** The number of new entries in each commit */
+	result = skip_string(buf, "commitSize : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_commit_size_statistics(buf,
+					     &stats->commit_size);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** The time from issuing each commit until it completes */
+	result = skip_string(buf, "commitLatency : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_stage_latency_statistics(buf,
+					       &stats->commit_latency);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
 	return VDO_SUCCESS;
 }
 
@@ -255,6 +521,64 @@ static int read_packer_statistics(char **buf,
 	return VDO_SUCCESS;
 }
 
+static int read_compression_statistics(char **buf,
+				       struct compression_statistics *stats)
+{
+	int result = 0;
+
+	/** Number of blocks given to the compression codec to compress */
+	result = skip_string(buf, "attempts : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->attempts);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of compression attempts which did not produce a fragment */
+	result = skip_string(buf, "failures : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->failures);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of blocks not compressed because fast-reject judged them incompressible */
+	result = skip_string(buf, "fastRejectSkips : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->fast_reject_skips);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of blocks judged incompressible which were compressed anyway to check fast-reject */
+	result = skip_string(buf, "fastRejectChecks : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->fast_reject_checks);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of fast-reject checks which produced a fragment */
+	result = skip_string(buf, "fastRejectMispredictions : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->fast_reject_mispredictions);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	return VDO_SUCCESS;
+}
+
 static int read_slab_journal_statistics(char **buf,
 					struct slab_journal_statistics *stats)
 {
@@ -554,6 +878,96 @@ static int read_block_map_statistics(char **buf,
 	if (result != VDO_SUCCESS) {
 		return result;
 	}
+	/** number of fetched pages which were recently evicted from probation */
+	result = skip_string(buf, "ghostHits : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->ghost_hits);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** number of pages loaded speculatively by readahead */
+	result = skip_string(buf, "readaheadPages : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->readahead_pages);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** number of readahead pages which were used before being evicted */
+	result = skip_string(buf, "readaheadUsed : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->readahead_used);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** number of readahead pages evicted without being used */
+	result = skip_string(buf, "readaheadWasted : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->readahead_wasted);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** number of writes issued to save pages */
+	result = skip_string(buf, "writesIssued : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->writes_issued);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** number of pages loaded to warm up the cache */
+	result = skip_string(buf, "warmupPages : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->warmup_pages);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** number of pages read from the cache device */
+	result = skip_string(buf, "tierPagesRead : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->tier_pages_read);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** number of evicted pages written to the cache device */
+	result = skip_string(buf, "tierPagesWritten : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->tier_pages_written);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** number of cache device pages which were invalid or could not be read or written */
+	result = skip_string(buf, "tierPagesRejected : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->tier_pages_rejected);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
 	return VDO_SUCCESS;
 }
 
@@ -612,6 +1026,36 @@ static int read_hash_lock_statistics(char **buf,
 	if (result != VDO_SUCCESS) {
 		return result;
 	}
+	/** Number of writes which requested a hash lock, summed over all hash zones */
+	result = skip_string(buf, "lockRequests : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->lock_requests);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of hash lock requests handled by the busiest hash zone */
+	result = skip_string(buf, "maxZoneLockRequests : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->max_zone_lock_requests);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Number of hash lock requests handled by the least busy hash zone */
+	result = skip_string(buf, "minZoneLockRequests : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_u64(buf,
+			  &stats->min_zone_lock_requests);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
 	return VDO_SUCCESS;
 }
 
@@ -721,6 +1165,104 @@ static int read_bio_stats(char **buf,
 	return VDO_SUCCESS;
 }
 
+static int read_write_latency_statistics(char **buf,
+					 struct write_latency_statistics *stats)
+{
+	int result = 0;
+
+	/** From accepting the bio until the block map lookup starts */
+	result = skip_string(buf, "launch : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_stage_latency_statistics(buf,
+					       &stats->launch);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Waiting for and computing the record name */
+	result = skip_string(buf, "hash : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_stage_latency_statistics(buf,
+					       &stats->hash);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Waiting for a hash lock */
+	result = skip_string(buf, "hashLock : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_stage_latency_statistics(buf,
+					       &stats->hash_lock);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Querying the dedupe index */
+	result = skip_string(buf, "dedupeQuery : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_stage_latency_statistics(buf,
+					       &stats->dedupe_query);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Allocating a physical block */
+	result = skip_string(buf, "allocation : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_stage_latency_statistics(buf,
+					       &stats->allocation);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Writing the data to storage */
+	result = skip_string(buf, "dataWrite : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_stage_latency_statistics(buf,
+					       &stats->data_write);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Making the recovery journal entry */
+	result = skip_string(buf, "journal : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_stage_latency_statistics(buf,
+					       &stats->journal);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Updating the block map */
+	result = skip_string(buf, "blockMap : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_stage_latency_statistics(buf,
+					       &stats->block_map);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	/** Acknowledging the bio */
+	result = skip_string(buf, "acknowledge : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_stage_latency_statistics(buf,
+					       &stats->acknowledge);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	return VDO_SUCCESS;
+}
+
 static int read_memory_usage(char **buf,
 			     struct memory_usage *stats)
 {
@@ -981,6 +1523,16 @@ static int read_vdo_statistics(char **buf,
 	if (result != VDO_SUCCESS) {
 		return result;
 	}
+	/** The statistics for compressing data blocks */
+	result = skip_string(buf, "compression : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_compression_statistics(buf,
+					     &stats->compression);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
 	/** Counters for events in the block allocator */
 	result = skip_string(buf, "allocator : ");
 	if (result != VDO_SUCCESS) {
@@ -1242,6 +1794,16 @@ static int read_vdo_statistics(char **buf,
 	if (result != VDO_SUCCESS) {
 		return result;
 	}
+	/** Time spent in each stage of the write path */
+	result = skip_string(buf, "writeLatency : ");
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	result = read_write_latency_statistics(buf,
+					       &stats->write_latency);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
 	/** Memory usage stats. */
 	result = skip_string(buf, "memoryUsage : ");
 	if (result != VDO_SUCCESS) {
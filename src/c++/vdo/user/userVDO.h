@@ -118,7 +118,8 @@ int __must_check writeVolumeGeometryWithVersion(PhysicalLayer          *layer,
 static inline int __must_check
 writeVolumeGeometry(PhysicalLayer *layer, struct volume_geometry *geometry)
 {
-  return writeVolumeGeometryWithVersion(layer, geometry, VDO_DEFAULT_GEOMETRY_BLOCK_VERSION);
+  return writeVolumeGeometryWithVersion(layer, geometry,
+                                        vdo_get_geometry_block_version(geometry));
 }
 
 /**
@@ -142,12 +142,8 @@ int formatVDO(const struct vdo_config   *config,
               const struct index_config *indexConfig,
               PhysicalLayer             *layer)
 {
-  // Generate a uuid.
-  uuid_t uuid;
-  uuid_generate(uuid);
-
-  return formatVDOWithNonce(config, indexConfig, layer, current_time_us(),
-                            &uuid);
+  return formatVDOWithHashAlgorithm(config, indexConfig, VDO_HASH_MURMUR3,
+                                    layer);
 }
 
 /**********************************************************************/
@@ -291,12 +287,14 @@ int initializeVolumeGeometry(nonce_t                    nonce,
  * @param vdo               The VDO to create
  * @param config            The configuration parameters for the VDO
  * @param indexConfig       The configuration parameters for the index
+ * @param hashAlgorithm     The record name hash algorithm for the VDO
  * @param nonce             The nonce for the VDO
  * @param uuid              The uuid for the VDO
  **/
 static int configureAndWriteVDO(UserVDO                   *vdo,
                                 const struct vdo_config   *config,
                                 const struct index_config *indexConfig,
+                                enum vdo_hash_algorithm    hashAlgorithm,
                                 nonce_t                    nonce,
                                 uuid_t                    *uuid)
 {
@@ -305,6 +303,8 @@ static int configureAndWriteVDO(UserVDO                   *vdo,
     return result;
   }
 
+  vdo->geometry.hash_algorithm = hashAlgorithm;
+
   char *block;
   result = vdo->layer->allocateIOBuffer(vdo->layer, VDO_BLOCK_SIZE, "geometry block", &block);
   if (result != VDO_SUCCESS) {
@@ -339,13 +339,31 @@ static int configureAndWriteVDO(UserVDO                   *vdo,
   return saveVDO(vdo, true);
 }
 
-/**********************************************************************/
-int formatVDOWithNonce(const struct vdo_config   *config,
-                       const struct index_config *indexConfig,
-                       PhysicalLayer             *layer,
-                       nonce_t                    nonce,
-                       uuid_t                    *uuid)
+/**
+ * Format a VDO with a given nonce, uuid, and record name hash algorithm.
+ *
+ * @param config            The configuration parameters for the VDO
+ * @param indexConfig       The configuration parameters for the index
+ * @param hashAlgorithm     The record name hash algorithm for the VDO
+ * @param layer             The physical layer the VDO will sit on
+ * @param nonce             The nonce for the VDO
+ * @param uuid              The uuid for the VDO
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+static int formatVDOWithAllOptions(const struct vdo_config   *config,
+                                   const struct index_config *indexConfig,
+                                   enum vdo_hash_algorithm    hashAlgorithm,
+                                   PhysicalLayer             *layer,
+                                   nonce_t                    nonce,
+                                   uuid_t                    *uuid)
 {
+  if (hashAlgorithm >= VDO_HASH_ALGORITHM_COUNT) {
+    return vdo_log_error_strerror(VDO_BAD_CONFIGURATION,
+                                  "unknown record name hash algorithm %u",
+                                  hashAlgorithm);
+  }
+
   int result = vdo_register_status_codes();
   if (result != VDO_SUCCESS) {
     return result;
@@ -362,11 +380,37 @@ int formatVDOWithNonce(const struct vdo_config   *config,
     return result;
   }
 
-  result = configureAndWriteVDO(vdo, config, indexConfig, nonce, uuid);
+  result = configureAndWriteVDO(vdo, config, indexConfig, hashAlgorithm,
+                                nonce, uuid);
   freeUserVDO(&vdo);
   return result;
 }
 
+/**********************************************************************/
+int formatVDOWithHashAlgorithm(const struct vdo_config   *config,
+                               const struct index_config *indexConfig,
+                               enum vdo_hash_algorithm    hashAlgorithm,
+                               PhysicalLayer             *layer)
+{
+  // Generate a uuid.
+  uuid_t uuid;
+  uuid_generate(uuid);
+
+  return formatVDOWithAllOptions(config, indexConfig, hashAlgorithm, layer,
+                                 current_time_us(), &uuid);
+}
+
+/**********************************************************************/
+int formatVDOWithNonce(const struct vdo_config   *config,
+                       const struct index_config *indexConfig,
+                       PhysicalLayer             *layer,
+                       nonce_t                    nonce,
+                       uuid_t                    *uuid)
+{
+  return formatVDOWithAllOptions(config, indexConfig, VDO_HASH_MURMUR3, layer,
+                                 nonce, uuid);
+}
+
 /**
  * Change the state of an inactive VDO image.
  *
@@ -39,6 +39,24 @@ int __must_check formatVDO(const struct vdo_config *config,
 			   const struct index_config *indexConfig,
 			   PhysicalLayer *layer);
 
+/**
+ * This is a version of formatVDO() which allows the caller to choose the
+ * function used to compute the record names of data blocks. The choice is
+ * recorded in the geometry block and cannot be changed after formatting.
+ *
+ * @param config            The configuration parameters for the VDO
+ * @param indexConfig       The configuration parameters for the index
+ * @param hashAlgorithm     The record name hash algorithm for the VDO
+ * @param layer             The physical layer the VDO will sit on
+ *
+ * @return VDO_SUCCESS or an error
+ **/
+int __must_check
+formatVDOWithHashAlgorithm(const struct vdo_config   *config,
+                           const struct index_config *indexConfig,
+                           enum vdo_hash_algorithm    hashAlgorithm,
+                           PhysicalLayer             *layer);
+
 /**
  * Calculate minimal VDO based on config parameters.
  *
@@ -73,6 +73,14 @@ static const char helpString[] =
   "       gigabytes, T for terabytes, or P for petabytes is optional. The\n"
   "       default unit is megabytes.\n"
   "\n"
+  "    --record-name-hash=<algorithm>\n"
+  "       Choose the function used to fingerprint data blocks for\n"
+  "       deduplication. <algorithm> is either murmur3 (the default) or\n"
+  "       murmur3-striped, which hashes each block as four interleaved\n"
+  "       stripes and is faster on a single core. The choice cannot be\n"
+  "       changed after formatting, and volumes not using murmur3 cannot\n"
+  "       be loaded by older versions of VDO.\n"
+  "\n"
   "    --slab-bits=<bits>\n"
   "      Set the free space allocator's slab size to 2^<bits> 4 KB blocks.\n"
   "      <bits> must be a value between 13 and 23 (inclusive), corresponding\n"
@@ -108,6 +116,7 @@ static struct option options[] = {
   { "force",           no_argument,       NULL, 'f' },
   { "help",            no_argument,       NULL, 'h' },
   { "logical-size",    required_argument, NULL, 'l' },
+  { "record-name-hash", required_argument, NULL, 'r' },
   { "slab-bits",       required_argument, NULL, 'S' },
   { "uds-memory-size", required_argument, NULL, 'm' },
   { "uds-sparse",      no_argument,       NULL, 's' },
@@ -115,13 +124,34 @@ static struct option options[] = {
   { "version",         no_argument,       NULL, 'V' },
   { NULL,              0,                 NULL,  0  },
 };
-static char optionString[] = "fhil:S:m:svV";
+static char optionString[] = "fhil:r:S:m:svV";
 
 static void usage(const char *progname, const char *usageOptionsString)
 {
   errx(1, "Usage: %s%s\n", progname, usageOptionsString);
 }
 
+/**
+ * Parse the name of a record name hash algorithm.
+ *
+ * @param [in]  name       The name to parse
+ * @param [out] algorithm  The algorithm with that name
+ *
+ * @return VDO_SUCCESS or VDO_BAD_CONFIGURATION
+ **/
+static int parseHashAlgorithm(const char *name,
+                              enum vdo_hash_algorithm *algorithm)
+{
+  for (enum vdo_hash_algorithm a = 0; a < VDO_HASH_ALGORITHM_COUNT; a++) {
+    if (strcmp(name, vdo_get_hash_algorithm_name(a)) == 0) {
+      *algorithm = a;
+      return VDO_SUCCESS;
+    }
+  }
+
+  return VDO_BAD_CONFIGURATION;
+}
+
 /**********************************************************************/
 static void printReadableSize(size_t size)
 {
@@ -408,6 +438,7 @@ int main(int argc, char *argv[])
 
   uint64_t     logicalSize  = 0; // defaults to physicalSize
   unsigned int slabBits     = DEFAULT_SLAB_BITS;
+  enum vdo_hash_algorithm hashAlgorithm = VDO_HASH_MURMUR3;
 
   UdsConfigStrings configStrings;
   memset(&configStrings, 0, sizeof(configStrings));
@@ -436,6 +467,16 @@ int main(int argc, char *argv[])
       logicalSize = sizeArg;
       break;
 
+    case 'r':
+      result = parseHashAlgorithm(optarg, &hashAlgorithm);
+      if (result != VDO_SUCCESS) {
+        warnx("invalid record name hash, must be %s or %s",
+              vdo_get_hash_algorithm_name(VDO_HASH_MURMUR3),
+              vdo_get_hash_algorithm_name(VDO_HASH_MURMUR3_STRIPED));
+        usage(argv[0], usageString);
+      }
+      break;
+
     case 'S':
       result = parseUInt(optarg, MIN_SLAB_BITS, MAX_VDO_SLAB_BITS, &slabBits);
       if (result != VDO_SUCCESS) {
@@ -581,9 +622,12 @@ int main(int argc, char *argv[])
              filename, (unsigned long long) config.physical_blocks,
              VDO_BLOCK_SIZE);
     }
+    printf("Data blocks will be fingerprinted with %s.\n",
+           vdo_get_hash_algorithm_name(hashAlgorithm));
   }
 
-  result = formatVDO(&config, &indexConfig, layer);
+  result = formatVDOWithHashAlgorithm(&config, &indexConfig, hashAlgorithm,
+                                      layer);
   if (result != VDO_SUCCESS) {
     const char *extraHelp = "";
     if (result == VDO_TOO_MANY_SLABS) {
@@ -328,7 +328,7 @@ static void process_device(const char *original, const char *name)
     errx(1, "'%s': Could not retrieve VDO device stats information", name);
   }
 
-  char statsBuf[8192];
+  char statsBuf[16384];
   if (fgets(statsBuf, sizeof(statsBuf), fp) != NULL) {
     read_vdo_stats(statsBuf, &stats);
     switch (style) {
@@ -24,7 +24,7 @@
 #include "types.h"
 #include "vdoStats.h"
 
-#define MAX_STATS 239
+#define MAX_STATS 320
 #define MAX_STAT_LENGTH 80
 
 int fieldCount = 0;
@@ -167,6 +167,76 @@ static int write_block_allocator_statistics(char *prefix,
 	if (result != VDO_SUCCESS) {
 		return result;
 	}
+
+	/** The number of sequential allocations which were physically contiguous */
+	if (asprintf(&joined, "%s contiguous allocations", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->contiguous_allocations);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** The number of sequential allocations which were not physically contiguous */
+	if (asprintf(&joined, "%s fragmented allocations", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->fragmented_allocations);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** The number of slabs which have yet to be scrubbed since loading */
+	if (asprintf(&joined, "%s slabs to scrub", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->slabs_to_scrub);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** The number of slabs which have been scrubbed since loading */
+	if (asprintf(&joined, "%s slabs scrubbed", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->slabs_scrubbed);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** The estimated number of seconds until all slabs are scrubbed */
+	if (asprintf(&joined, "%s scrub seconds remaining", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->scrub_seconds_remaining);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** The number of clean slabs whose reference counts were deferred when loading */
+	if (asprintf(&joined, "%s lazy slabs", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->lazy_slabs);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** The number of deferred slabs whose reference counts have since been loaded */
+	if (asprintf(&joined, "%s lazy slabs loaded", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->lazy_slabs_loaded);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
 	return VDO_SUCCESS;
 }
 
@@ -229,6 +299,164 @@ static int write_commit_statistics(char *prefix,
 	return VDO_SUCCESS;
 }
 
+static int write_stage_latency_statistics(char *prefix,
+					  struct stage_latency_statistics *stats)
+{
+	int result = 0;
+	char *joined = NULL;
+
+
+	/** Number of times a write has completed this stage */
+	if (asprintf(&joined, "%s count", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->count);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Total time spent in this stage, in microseconds */
+	if (asprintf(&joined, "%s total microseconds", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->total_microseconds);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of times the stage took less than 10 microseconds */
+	if (asprintf(&joined, "%s under 10us", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->under_10us);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of times the stage took 10 to 100 microseconds */
+	if (asprintf(&joined, "%s under 100us", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->under_100us);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of times the stage took 100 microseconds to 1 millisecond */
+	if (asprintf(&joined, "%s under 1ms", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->under_1ms);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of times the stage took 1 to 10 milliseconds */
+	if (asprintf(&joined, "%s under 10ms", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->under_10ms);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of times the stage took 10 to 100 milliseconds */
+	if (asprintf(&joined, "%s under 100ms", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->under_100ms);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of times the stage took 100 milliseconds to 1 second */
+	if (asprintf(&joined, "%s under 1s", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->under_1s);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of times the stage took 1 second or more */
+	if (asprintf(&joined, "%s over 1s", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->over_1s);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	return VDO_SUCCESS;
+}
+
+static int write_commit_size_statistics(char *prefix,
+					struct commit_size_statistics *stats)
+{
+	int result = 0;
+	char *joined = NULL;
+
+
+	/** Number of commits of a single entry */
+	if (asprintf(&joined, "%s one entry", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->one_entry);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of commits of 2 to 15 entries */
+	if (asprintf(&joined, "%s under 16", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->under_16);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of commits of 16 to 63 entries */
+	if (asprintf(&joined, "%s under 64", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->under_64);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of commits of 64 entries up to a full block */
+	if (asprintf(&joined, "%s one block", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->one_block);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of commits of more than a full block of entries */
+	if (asprintf(&joined, "%s multiple blocks", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->multiple_blocks);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	return VDO_SUCCESS;
+}
+
 static int write_recovery_journal_statistics(char *prefix,
 					     struct recovery_journal_statistics *stats)
 {
@@ -275,6 +503,46 @@ static int write_recovery_journal_statistics(char *prefix,
 	if (result != VDO_SUCCESS) {
 		return result;
 	}
+
+	/** Number of commits which wrote several adjacent blocks at once */
+	if (asprintf(&joined, "%s multi-block writes", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->multi_block_writes);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of commits which waited for more entries */
+	if (asprintf(&joined, "%s delayed commits", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->delayed_commits);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** The number of new entries in each commit */
+	if (asprintf(&joined, "%s commit size", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_commit_size_statistics(joined, &stats->commit_size);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** The time from issuing each commit until it completes */
+	if (asprintf(&joined, "%s commit latency", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_stage_latency_statistics(joined, &stats->commit_latency);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
 	return VDO_SUCCESS;
 }
 
@@ -317,6 +585,65 @@ static int write_packer_statistics(char *prefix,
 	return VDO_SUCCESS;
 }
 
+static int write_compression_statistics(char *prefix,
+					struct compression_statistics *stats)
+{
+	int result = 0;
+	char *joined = NULL;
+
+
+	/** Number of blocks given to the compression codec to compress */
+	if (asprintf(&joined, "%s compression attempts", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->attempts);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of compression attempts which did not produce a fragment */
+	if (asprintf(&joined, "%s compression failures", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->failures);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of blocks not compressed because fast-reject judged them incompressible */
+	if (asprintf(&joined, "%s fast reject skips", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->fast_reject_skips);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of blocks judged incompressible which were compressed anyway to check fast-reject */
+	if (asprintf(&joined, "%s fast reject checks", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->fast_reject_checks);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of fast-reject checks which produced a fragment */
+	if (asprintf(&joined, "%s fast reject mispredictions", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->fast_reject_mispredictions);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	return VDO_SUCCESS;
+}
+
 static int write_slab_journal_statistics(char *prefix,
 					 struct slab_journal_statistics *stats)
 {
@@ -620,6 +947,96 @@ static int write_block_map_statistics(char *prefix,
 	if (result != VDO_SUCCESS) {
 		return result;
 	}
+
+	/** number of fetched pages which were recently evicted from probation */
+	if (asprintf(&joined, "%s ghost hits", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->ghost_hits);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** number of pages loaded speculatively by readahead */
+	if (asprintf(&joined, "%s readahead pages", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->readahead_pages);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** number of readahead pages which were used before being evicted */
+	if (asprintf(&joined, "%s readahead used", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->readahead_used);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** number of readahead pages evicted without being used */
+	if (asprintf(&joined, "%s readahead wasted", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->readahead_wasted);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** number of writes issued to save pages */
+	if (asprintf(&joined, "%s writes issued", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->writes_issued);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** number of pages loaded to warm up the cache */
+	if (asprintf(&joined, "%s warmup pages", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->warmup_pages);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** number of pages read from the cache device */
+	if (asprintf(&joined, "%s tier pages read", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->tier_pages_read);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** number of evicted pages written to the cache device */
+	if (asprintf(&joined, "%s tier pages written", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->tier_pages_written);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** number of cache device pages which were invalid or could not be read or written */
+	if (asprintf(&joined, "%s tier pages rejected", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->tier_pages_rejected);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
 	return VDO_SUCCESS;
 }
 
@@ -679,6 +1096,36 @@ static int write_hash_lock_statistics(char *prefix,
 	if (result != VDO_SUCCESS) {
 		return result;
 	}
+
+	/** Number of writes which requested a hash lock, summed over all hash zones */
+	if (asprintf(&joined, "%s lock requests", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->lock_requests);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of hash lock requests handled by the busiest hash zone */
+	if (asprintf(&joined, "%s max zone lock requests", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->max_zone_lock_requests);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Number of hash lock requests handled by the least busy hash zone */
+	if (asprintf(&joined, "%s min zone lock requests", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_u64(joined, stats->min_zone_lock_requests);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
 	return VDO_SUCCESS;
 }
 
@@ -790,6 +1237,105 @@ static int write_bio_stats(char *prefix,
 	return VDO_SUCCESS;
 }
 
+static int write_write_latency_statistics(char *prefix,
+					  struct write_latency_statistics *stats)
+{
+	int result = 0;
+	char *joined = NULL;
+
+
+	/** From accepting the bio until the block map lookup starts */
+	if (asprintf(&joined, "%s launch", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_stage_latency_statistics(joined, &stats->launch);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Waiting for and computing the record name */
+	if (asprintf(&joined, "%s hash", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_stage_latency_statistics(joined, &stats->hash);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Waiting for a hash lock */
+	if (asprintf(&joined, "%s hash lock", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_stage_latency_statistics(joined, &stats->hash_lock);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Querying the dedupe index */
+	if (asprintf(&joined, "%s dedupe query", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_stage_latency_statistics(joined, &stats->dedupe_query);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Allocating a physical block */
+	if (asprintf(&joined, "%s allocation", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_stage_latency_statistics(joined, &stats->allocation);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Writing the data to storage */
+	if (asprintf(&joined, "%s data write", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_stage_latency_statistics(joined, &stats->data_write);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Making the recovery journal entry */
+	if (asprintf(&joined, "%s journal", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_stage_latency_statistics(joined, &stats->journal);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Updating the block map */
+	if (asprintf(&joined, "%s block map", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_stage_latency_statistics(joined, &stats->block_map);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
+	/** Acknowledging the bio */
+	if (asprintf(&joined, "%s acknowledge", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_stage_latency_statistics(joined, &stats->acknowledge);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+	return VDO_SUCCESS;
+}
+
 static int write_memory_usage(char *prefix,
 			      struct memory_usage *stats)
 {
@@ -1130,6 +1676,16 @@ static int write_vdo_statistics(char *prefix,
 		return result;
 	}
 
+	/** The statistics for compressing data blocks */
+	if (asprintf(&joined, "%s", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_compression_statistics(joined, &stats->compression);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
 	/** Counters for events in the block allocator */
 	if (asprintf(&joined, "%s", prefix) == -1) {
 		return VDO_UNEXPECTED_EOF;
@@ -1399,6 +1955,16 @@ static int write_vdo_statistics(char *prefix,
 		return result;
 	}
 
+	/** Time spent in each stage of the write path */
+	if (asprintf(&joined, "%s write", prefix) == -1) {
+		return VDO_UNEXPECTED_EOF;
+	}
+	result = write_write_latency_statistics(joined, &stats->write_latency);
+	free(joined);
+	if (result != VDO_SUCCESS) {
+		return result;
+	}
+
 	/** Memory usage stats. */
 	if (asprintf(&joined, "%s KVDO module", prefix) == -1) {
 		return VDO_UNEXPECTED_EOF;
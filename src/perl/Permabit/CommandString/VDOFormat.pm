@@ -26,6 +26,8 @@ our %COMMANDSTRING_PROPERTIES
      force              => undef,
      # executable name
      name               => "vdoformat",
+     # record name hash algorithm (murmur3 or murmur3-striped)
+     recordNameHash     => undef,
      # the absolute file name of the underlying file or device
      storage            => undef,
      # verbosity flag
@@ -61,6 +63,7 @@ sub getArguments {
   } else {
     $self->addSimpleOption(\@args, "force",         "--force");
     $self->addValueOption(\@args,  "logicalSize",   "--logical-size");
+    $self->addValueOption(\@args,  "recordNameHash", "--record-name-hash");
     $self->addValueOption(\@args,  "slabBits",      "--slab-bits");
     $self->addValueOption(\@args,  "albireoMem",    "--uds-memory-size");
     $self->addSimpleOption(\@args, "albireoSparse", "--uds-sparse");
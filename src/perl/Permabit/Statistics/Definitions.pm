@@ -141,6 +141,36 @@ our $VDO_STATISTICS_DEFINITIONS = {
                                                   'Blocks',
                                                   undef
                                                 ],
+                                                [
+                                                  'compression attempts',
+                                                  'counter',
+                                                  'Blocks',
+                                                  undef
+                                                ],
+                                                [
+                                                  'compression failures',
+                                                  'counter',
+                                                  'Blocks',
+                                                  undef
+                                                ],
+                                                [
+                                                  'fast reject skips',
+                                                  'counter',
+                                                  'Blocks',
+                                                  undef
+                                                ],
+                                                [
+                                                  'fast reject checks',
+                                                  'counter',
+                                                  'Blocks',
+                                                  undef
+                                                ],
+                                                [
+                                                  'fast reject mispredictions',
+                                                  'counter',
+                                                  'Blocks',
+                                                  undef
+                                                ],
                                                 [
                                                   'slab count',
                                                   'counter',
@@ -159,6 +189,48 @@ our $VDO_STATISTICS_DEFINITIONS = {
                                                   'Count',
                                                   undef
                                                 ],
+                                                [
+                                                  'contiguous allocations',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'fragmented allocations',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'slabs to scrub',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'slabs scrubbed',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'scrub seconds remaining',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'lazy slabs',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'lazy slabs loaded',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
                                                 [
                                                   'journal disk full count',
                                                   'counter',
@@ -231,6 +303,102 @@ our $VDO_STATISTICS_DEFINITIONS = {
                                                   'Count',
                                                   undef
                                                 ],
+                                                [
+                                                  'journal multi-block writes',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal delayed commits',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit size one entry',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit size under 16',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit size under 64',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit size one block',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit size multiple blocks',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit latency count',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit latency total microseconds',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit latency under 10us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit latency under 100us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit latency under 1ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit latency under 10ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit latency under 100ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit latency under 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'journal commit latency over 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
                                                 [
                                                   'slab journal disk full count',
                                                   'counter',
@@ -393,6 +561,60 @@ our $VDO_STATISTICS_DEFINITIONS = {
                                                   'Count',
                                                   undef
                                                 ],
+                                                [
+                                                  'block map ghost hits',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'block map readahead pages',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'block map readahead used',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'block map readahead wasted',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'block map writes issued',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'block map warmup pages',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'block map tier pages read',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'block map tier pages written',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'block map tier pages rejected',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
                                                 [
                                                   'dedupe advice valid',
                                                   'counter',
@@ -423,6 +645,24 @@ our $VDO_STATISTICS_DEFINITIONS = {
                                                   'Count',
                                                   undef
                                                 ],
+                                                [
+                                                  'lock requests',
+                                                  'counter',
+                                                  'Blocks',
+                                                  undef
+                                                ],
+                                                [
+                                                  'max zone lock requests',
+                                                  'counter',
+                                                  'Blocks',
+                                                  undef
+                                                ],
+                                                [
+                                                  'min zone lock requests',
+                                                  'counter',
+                                                  'Blocks',
+                                                  undef
+                                                ],
                                                 [
                                                   'invalid advice PBN count',
                                                   'snapshot',
@@ -951,6 +1191,492 @@ our $VDO_STATISTICS_DEFINITIONS = {
                                                   'Count',
                                                   undef
                                                 ],
+                                                [
+                                                  'write launch count',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write launch total microseconds',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write launch under 10us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write launch under 100us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write launch under 1ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write launch under 10ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write launch under 100ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write launch under 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write launch over 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash count',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash total microseconds',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash under 10us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash under 100us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash under 1ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash under 10ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash under 100ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash under 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash over 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash lock count',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash lock total microseconds',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash lock under 10us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash lock under 100us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash lock under 1ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash lock under 10ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash lock under 100ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash lock under 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write hash lock over 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write dedupe query count',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write dedupe query total microseconds',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write dedupe query under 10us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write dedupe query under 100us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write dedupe query under 1ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write dedupe query under 10ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write dedupe query under 100ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write dedupe query under 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write dedupe query over 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write allocation count',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write allocation total microseconds',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write allocation under 10us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write allocation under 100us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write allocation under 1ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write allocation under 10ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write allocation under 100ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write allocation under 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write allocation over 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write data write count',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write data write total microseconds',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write data write under 10us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write data write under 100us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write data write under 1ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write data write under 10ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write data write under 100ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write data write under 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write data write over 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write journal count',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write journal total microseconds',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write journal under 10us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write journal under 100us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write journal under 1ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write journal under 10ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write journal under 100ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write journal under 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write journal over 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write block map count',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write block map total microseconds',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write block map under 10us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write block map under 100us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write block map under 1ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write block map under 10ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write block map under 100ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write block map under 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write block map over 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write acknowledge count',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write acknowledge total microseconds',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write acknowledge under 10us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write acknowledge under 100us',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write acknowledge under 1ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write acknowledge under 10ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write acknowledge under 100ms',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write acknowledge under 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
+                                                [
+                                                  'write acknowledge over 1s',
+                                                  'counter',
+                                                  'Count',
+                                                  undef
+                                                ],
                                                 [
                                                   'KVDO module bytes used',
                                                   'snapshot',
@@ -1012,7 +1738,7 @@ our $VDO_STATISTICS_DEFINITIONS = {
                                                   undef
                                                 ]
                                               ],
-                                'StatisticsVersion' => '36'
+                                'StatisticsVersion' => '48'
                               };
 
 1;
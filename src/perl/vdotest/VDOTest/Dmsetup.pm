@@ -317,6 +317,12 @@ sub testCompressionType {
 
   $device->{compressionType} = "lz4:-5";
   $device->restart();
+
+  $device->{compressionType} = "deflate";
+  $device->restart();
+
+  $device->{compressionType} = "deflate:9";
+  $device->restart();
 }
 
 ###############################################################################
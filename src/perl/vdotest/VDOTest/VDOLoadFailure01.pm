@@ -112,6 +112,10 @@ sub testIllegalValues {
 		     "integer needed, found");
   $self->_tryIllegal({ compressionType => "lz4:"},
 		     "integer needed, found");
+  $self->_tryIllegal({ compressionType => "deflate:0"},
+		     "invalid deflate level");
+  $self->_tryIllegal({ compressionType => "deflate:10"},
+		     "invalid deflate level");
 }
 
 #############################################################################